@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <cmath>
+
+#include "cv_utils.h"
+#include "ball_candidate_set.h"
+
+
+namespace golf_sim {
+
+    // Keeps the grid from becoming huge if a caller asks for a tiny cell size
+    static const int kMaxGridCellsPerAxis = 128;
+
+
+    BallCandidateSet::BallCandidateSet(const std::vector<GolfBall>& balls, const double grid_cell_size_pixels) {
+
+        const size_t number_balls = balls.size();
+
+        center_x_.resize(number_balls);
+        center_y_.resize(number_balls);
+        pixel_x_.resize(number_balls);
+        pixel_y_.resize(number_balls);
+        radius_.resize(number_balls);
+        quality_ranking_.resize(number_balls);
+        alive_.assign(number_balls, 1);
+        number_alive_ = number_balls;
+
+        for (size_t i = 0; i < number_balls; i++) {
+            const GolfBall& b = balls[i];
+            center_x_[i] = CvUtils::CircleX(b.ball_circle_);
+            center_y_[i] = CvUtils::CircleY(b.ball_circle_);
+            pixel_x_[i] = b.x();
+            pixel_y_[i] = b.y();
+            radius_[i] = b.measured_radius_pixels_;
+            quality_ranking_[i] = b.quality_ranking;
+        }
+
+        if (grid_cell_size_pixels > 0.0 && number_balls > 0) {
+            BuildGrid(grid_cell_size_pixels);
+        }
+    }
+
+    void BallCandidateSet::BuildGrid(const double grid_cell_size_pixels) {
+
+        const auto [min_x, max_x] = std::minmax_element(center_x_.begin(), center_x_.end());
+        const auto [min_y, max_y] = std::minmax_element(center_y_.begin(), center_y_.end());
+
+        grid_origin_x_ = *min_x;
+        grid_origin_y_ = *min_y;
+
+        const double width = (double)(*max_x - *min_x) + 1.0;
+        const double height = (double)(*max_y - *min_y) + 1.0;
+
+        grid_cell_size_ = std::max({ grid_cell_size_pixels, width / kMaxGridCellsPerAxis, height / kMaxGridCellsPerAxis });
+        grid_cells_x_ = (int)std::floor(width / grid_cell_size_) + 1;
+        grid_cells_y_ = (int)std::floor(height / grid_cell_size_) + 1;
+
+        // Counting sort of the balls into their cells
+        const int number_cells = grid_cells_x_ * grid_cells_y_;
+        grid_cell_start_.assign(number_cells + 1, 0);
+        grid_entries_.resize(Size());
+
+        std::vector<int> ball_cell(Size());
+
+        for (size_t i = 0; i < Size(); i++) {
+            ball_cell[i] = GridCellY(center_y_[i]) * grid_cells_x_ + GridCellX(center_x_[i]);
+            grid_cell_start_[ball_cell[i] + 1]++;
+        }
+
+        for (int cell = 0; cell < number_cells; cell++) {
+            grid_cell_start_[cell + 1] += grid_cell_start_[cell];
+        }
+
+        std::vector<int> next_entry(grid_cell_start_.begin(), grid_cell_start_.end() - 1);
+
+        for (size_t i = 0; i < Size(); i++) {
+            grid_entries_[next_entry[ball_cell[i]]++] = (int)i;
+        }
+
+        has_grid_ = true;
+    }
+
+    // Clamp before converting so that unbounded (e.g., +/- max double) query boxes are safe
+    int BallCandidateSet::GridCellX(const double x) const {
+        const double cell = std::floor((x - grid_origin_x_) / grid_cell_size_);
+        return (int)std::clamp(cell, 0.0, (double)(grid_cells_x_ - 1));
+    }
+
+    int BallCandidateSet::GridCellY(const double y) const {
+        const double cell = std::floor((y - grid_origin_y_) / grid_cell_size_);
+        return (int)std::clamp(cell, 0.0, (double)(grid_cells_y_ - 1));
+    }
+
+    int BallCandidateSet::NextAlive(const int index) const {
+        for (int i = index + 1; i < (int)Size(); i++) {
+            if (alive_[i] != 0) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    int BallCandidateSet::PreviousAlive(const int index) const {
+        for (int i = std::min(index, (int)Size()) - 1; i >= 0; i--) {
+            if (alive_[i] != 0) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    double BallCandidateSet::PixelDistance(const size_t index1, const size_t index2) const {
+        double x_distance = std::abs(center_x_[index1] - center_x_[index2]);
+        double y_distance = std::abs(center_y_[index1] - center_y_[index2]);
+
+        return std::sqrt(x_distance * x_distance + y_distance * y_distance);
+    }
+
+    void BallCandidateSet::CompactInto(std::vector<GolfBall>& balls) const {
+
+        if (number_alive_ == Size()) {
+            return;
+        }
+
+        size_t next_survivor = 0;
+
+        for (size_t i = 0; i < balls.size() && i < Size(); i++) {
+            if (alive_[i] != 0) {
+                if (next_survivor != i) {
+                    balls[next_survivor] = std::move(balls[i]);
+                }
+                next_survivor++;
+            }
+        }
+
+        balls.resize(next_survivor);
+    }
+
+}
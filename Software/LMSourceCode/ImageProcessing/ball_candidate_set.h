@@ -0,0 +1,143 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A compact, structure-of-arrays view of a vector of candidate GolfBalls that is used by
+// the ball-pruning passes (RemoveNearbyPoorQualityBalls, RemoveOffTrajectoryBalls, etc.).
+// Passes mark balls as removed (a "tombstone") instead of erasing them from the middle of
+// the vector, and the surviving GolfBalls are moved back into the vector once at the end.
+// An optional uniform grid over the ball centers makes the "what's near this ball" queries
+// roughly linear instead of quadratic, which matters when the Hough search returns dozens
+// of candidates.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "golf_ball.h"
+
+
+namespace golf_sim {
+
+    class BallCandidateSet {
+
+    public:
+
+        // If grid_cell_size_pixels is > 0, a spatial index with (about) that cell size is built
+        // so that ForEachAliveInBox only has to look at nearby balls.
+        BallCandidateSet(const std::vector<GolfBall>& balls, const double grid_cell_size_pixels = 0.0);
+
+        // The number of balls the set was built from, including removed ones
+        size_t Size() const { return quality_ranking_.size(); }
+        size_t NumberAlive() const { return number_alive_; }
+
+        bool IsAlive(const size_t index) const { return alive_[index] != 0; }
+
+        void Remove(const size_t index) {
+            if (alive_[index] != 0) {
+                alive_[index] = 0;
+                number_alive_--;
+            }
+        }
+
+        // Returns the index of the next (or previous) ball that has not been removed, or -1 if none
+        int NextAlive(const int index) const;
+        int PreviousAlive(const int index) const;
+
+        // Same values as CvUtils::CircleX/Y(ball.ball_circle_)
+        int CenterX(const size_t index) const { return center_x_[index]; }
+        int CenterY(const size_t index) const { return center_y_[index]; }
+
+        // Same values as ball.x() and ball.y()
+        long PixelX(const size_t index) const { return pixel_x_[index]; }
+        long PixelY(const size_t index) const { return pixel_y_[index]; }
+
+        double Radius(const size_t index) const { return radius_[index]; }
+        uint QualityRanking(const size_t index) const { return quality_ranking_[index]; }
+
+        // Same result as GolfBall::PixelDistanceFromBall
+        double PixelDistance(const size_t index1, const size_t index2) const;
+
+        // Calls visitor(index) for each ball that has not been removed and whose center is within
+        // the (inclusive) box.  Balls are not visited in any particular order.
+        template <typename Visitor>
+        void ForEachAliveInBox(const double min_x, const double max_x,
+                               const double min_y, const double max_y,
+                               Visitor visitor) const;
+
+        // Removes the tombstoned balls from the vector that the set was built from, moving
+        // (not copying) the survivors and keeping their order.
+        void CompactInto(std::vector<GolfBall>& balls) const;
+
+    protected:
+
+        void BuildGrid(const double grid_cell_size_pixels);
+
+        int GridCellX(const double x) const;
+        int GridCellY(const double y) const;
+
+        std::vector<int> center_x_;
+        std::vector<int> center_y_;
+        std::vector<long> pixel_x_;
+        std::vector<long> pixel_y_;
+        std::vector<double> radius_;
+        std::vector<uint> quality_ranking_;
+        std::vector<uint8_t> alive_;
+        size_t number_alive_ = 0;
+
+        // Uniform grid, stored compactly:  the balls in cell c are
+        // grid_entries_[grid_cell_start_[c]] up to (but not including) grid_entries_[grid_cell_start_[c + 1]]
+        bool has_grid_ = false;
+        double grid_origin_x_ = 0.0;
+        double grid_origin_y_ = 0.0;
+        double grid_cell_size_ = 1.0;
+        int grid_cells_x_ = 0;
+        int grid_cells_y_ = 0;
+        std::vector<int> grid_cell_start_;
+        std::vector<int> grid_entries_;
+    };
+
+
+    template <typename Visitor>
+    void BallCandidateSet::ForEachAliveInBox(const double min_x, const double max_x,
+                                             const double min_y, const double max_y,
+                                             Visitor visitor) const {
+
+        auto in_box = [&](const int index) {
+            return center_x_[index] >= min_x && center_x_[index] <= max_x &&
+                   center_y_[index] >= min_y && center_y_[index] <= max_y;
+        };
+
+        if (!has_grid_) {
+            for (int index = 0; index < (int)Size(); index++) {
+                if (alive_[index] != 0 && in_box(index)) {
+                    visitor(index);
+                }
+            }
+            return;
+        }
+
+        const int first_cell_x = GridCellX(min_x);
+        const int last_cell_x = GridCellX(max_x);
+        const int first_cell_y = GridCellY(min_y);
+        const int last_cell_y = GridCellY(max_y);
+
+        for (int cell_y = first_cell_y; cell_y <= last_cell_y; cell_y++) {
+            for (int cell_x = first_cell_x; cell_x <= last_cell_x; cell_x++) {
+                const int cell = cell_y * grid_cells_x_ + cell_x;
+
+                for (int entry = grid_cell_start_[cell]; entry < grid_cell_start_[cell + 1]; entry++) {
+                    const int index = grid_entries_[entry];
+
+                    if (alive_[index] != 0 && in_box(index)) {
+                        visitor(index);
+                    }
+                }
+            }
+        }
+    }
+
+}
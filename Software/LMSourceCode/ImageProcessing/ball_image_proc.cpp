@@ -11,6 +11,11 @@
  */
 
 
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <ranges>
 #include <algorithm>
 #include <vector>
@@ -29,6 +34,9 @@
 #include "gs_config.h"
 #include "gs_options.h"
 #include "gs_ui_system.h"
+#include "gs_thread_pool.h"
+#include "gs_metrics.h"
+#include "gs_spin_search_planner.h"
 #include "EllipseDetectorCommon.h"
 #include "EllipseDetectorYaed.h"
 
@@ -77,6 +85,13 @@ namespace golf_sim {
     int BallImageProc::kCoarseZRotationDegreesStart = -50;
     int BallImageProc::kCoarseZRotationDegreesEnd = 60;
 
+    int BallImageProc::kSpinScoringThreads = 0;
+    int BallImageProc::kSpinScoringChunkSize = 16;
+
+    bool BallImageProc::kSpinRefinementUseContinuousOptimizer = true;
+    double BallImageProc::kSpinRefinementToleranceDegrees = 0.25;
+    int BallImageProc::kSpinRefinementMaxEvaluations = 60;
+
     double BallImageProc::kPlacedBallCannyLower;
     double BallImageProc::kPlacedBallCannyUpper;
     double BallImageProc::kPlacedBallStartingParam2 = 40;
@@ -162,6 +177,11 @@ namespace golf_sim {
     double BallImageProc::kPlacedNarrowingRadiiDpParam = 2.0;
     double BallImageProc::kPlacedNarrowingParam1 = 130.0;
 
+    bool BallImageProc::kPlacedBallUsePyramidSearch = false;
+    int BallImageProc::kPlacedBallPyramidLevels = 1;
+    int BallImageProc::kPlacedBallPyramidMaxCandidates = 3;
+    int BallImageProc::kPlacedBallPyramidMinCoarseRadius = 8;
+
     int BallImageProc::kPlacedPreCannyBlurSize = 5;
     int BallImageProc::kPlacedPreHoughBlurSize = 11;
     int BallImageProc::kPuttingPreHoughBlurSize = 9;
@@ -213,6 +233,12 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseZRotationDegreesIncrement", kCoarseZRotationDegreesIncrement);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseZRotationDegreesStart", kCoarseZRotationDegreesStart);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kCoarseZRotationDegreesEnd", kCoarseZRotationDegreesEnd);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinScoringThreads", kSpinScoringThreads);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinScoringChunkSize", kSpinScoringChunkSize);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinRefinementUseContinuousOptimizer", kSpinRefinementUseContinuousOptimizer);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinRefinementToleranceDegrees", kSpinRefinementToleranceDegrees);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinRefinementMaxEvaluations", kSpinRefinementMaxEvaluations);
+        GsSpinSearchPlanner::ReadConfiguration();
 
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kGaborMinWhitePercent", kGaborMinWhitePercent);
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kGaborMaxWhitePercent", kGaborMaxWhitePercent);
@@ -333,6 +359,11 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedNarrowingStartingParam2", kPlacedNarrowingStartingParam2);
         GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedNarrowingRadiiDpParam", kPlacedNarrowingRadiiDpParam);
 
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallUsePyramidSearch", kPlacedBallUsePyramidSearch);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallPyramidLevels", kPlacedBallPyramidLevels);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallPyramidMaxCandidates", kPlacedBallPyramidMaxCandidates);
+        GolfSimConfiguration::SetConstant("gs_config.ball_identification.kPlacedBallPyramidMinCoarseRadius", kPlacedBallPyramidMinCoarseRadius);
+
 
         GolfSimConfiguration::SetConstant("gs_config.logging.kLogIntermediateSpinImagesToFile", kLogIntermediateSpinImagesToFile);
     }
@@ -381,10 +412,10 @@ namespace golf_sim {
             return false;
         }
 
-        // Create a CLAHE object
+        // The steps are run by the (re-usable) preparation graph for this search mode
+        std::vector<ImagePrepGraph::Node> prep_nodes;
 
         if (use_clahe_processing) {
-            cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE();
 
             // Set CLAHE parameters
 
@@ -400,14 +431,7 @@ namespace golf_sim {
             GS_LOG_TRACE_MSG(trace, "Using CLAHE Pre-processing with GridSize = " + std::to_string(clahe_tiles_grid_size) +
                 ", ClipLimit = " + std::to_string(clahe_clip_limit));
 
-            clahe->setClipLimit(clahe_clip_limit);
-            clahe->setTilesGridSize(cv::Size(clahe_tiles_grid_size, clahe_tiles_grid_size));
-
-            // Apply CLAHE
-            cv::Mat equalizedImage;
-            clahe->apply(search_image, search_image);
-
-            LoggingTools::DebugShowImage(image_name_ + "  Strobed Ball Image - After CLAHE equalization", search_image);
+            prep_nodes.push_back(ImagePrepGraph::Clahe("Strobed Ball Image - After CLAHE equalization", clahe_clip_limit, clahe_tiles_grid_size));
         }
 
         double canny_lower = 0.0;
@@ -458,35 +482,45 @@ namespace golf_sim {
 
 
         if (pre_canny_blur_size > 0) {
-            cv::GaussianBlur(search_image, search_image, cv::Size(pre_canny_blur_size, pre_canny_blur_size), 0);
+            prep_nodes.push_back(ImagePrepGraph::GaussianBlur("Strobed Ball Image - Ready for Edge Detection", pre_canny_blur_size));
         }
         else {
             GS_LOG_TRACE_MSG(trace, "Skipping pre-Canny Blur");
         }
 
-        // TBD - REMOVED THIS FOR NOW - IT DOESN'T SEEM TO HELP
-        for (int i = 0; i < 0; i++) {
-            cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-            cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+        // Don't do the Canny at all if the blur size is zero and we're in comparison mode
+        if (!(search_mode == kExternallyStrobed && pre_canny_blur_size == 0)) {
+            prep_nodes.push_back(ImagePrepGraph::Canny("cannyOutput_for_balls", canny_lower, canny_upper));
         }
 
-        LoggingTools::DebugShowImage(image_name_ + "  Strobed Ball Image - Ready for Edge Detection", search_image);
+        // Blur the lines-only image back to the search_image that the code below uses
+        prep_nodes.push_back(ImagePrepGraph::GaussianBlur("Strobed Ball Image - Ready for Hough", pre_hough_blur_size));   // Nominal is 7x7
 
-        cv::Mat cannyOutput_for_balls;
-        if (search_mode == kExternallyStrobed && pre_canny_blur_size == 0) {
-            // Don't do the Canny at all if the blur size is zero and we're in comparison mode
-            cannyOutput_for_balls = search_image.clone();
-        }
-        else {
-            cv::Canny(search_image, cannyOutput_for_balls, canny_lower, canny_upper);
-        }
+        return GetPrepGraph(search_mode).Run(prep_nodes, search_image, search_image, image_name_);
+    }
 
-        LoggingTools::DebugShowImage(image_name_ + "  cannyOutput_for_balls", cannyOutput_for_balls);
+    ImagePrepGraph& BallImageProc::GetPrepGraph(const BallSearchMode search_mode) {
 
-        // Blur the lines-only image back to the search_image that the code below uses
-        cv::GaussianBlur(cannyOutput_for_balls, search_image, cv::Size(pre_hough_blur_size, pre_hough_blur_size), 0);   // Nominal is 7x7
+        // One graph (and set of buffers) per search mode, kept across shots
+        static std::mutex prep_graphs_mutex;
+        static std::map<BallSearchMode, std::unique_ptr<ImagePrepGraph>> prep_graphs;
 
-        return true;
+        const std::lock_guard<std::mutex> lock(prep_graphs_mutex);
+
+        std::unique_ptr<ImagePrepGraph>& graph = prep_graphs[search_mode];
+
+        if (graph == nullptr) {
+            graph = std::make_unique<ImagePrepGraph>();
+        }
+
+        return *graph;
+    }
+
+    // Every Hough circle transform counts, whichever search performed it
+    static GsMetricCounter& GetHoughPassesCounter() {
+        static GsMetricCounter& hough_passes = GsMetrics::GetCounter("pitrac_ball_hough_passes_total",
+            "Number of Hough circle transforms performed while searching for balls");
+        return hough_passes;
     }
 
     // Given a picture, see if we can find the golf ball somewhere in that picture.
@@ -504,6 +538,10 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "GetBall called with PREBLUR_IMAGE = " + std::to_string(PREBLUR_IMAGE) + " IS_COLOR_MASKING = " + 
                     std::to_string(IS_COLOR_MASKING) + " FINAL_BLUR = " + std::to_string(FINAL_BLUR) + " search_mode = " + std::to_string(search_mode));
 
+        static GsMetricHistogram& get_ball_seconds = GsMetrics::GetHistogram("pitrac_ball_search_seconds",
+            "Time to search each image for balls", GsMetricHistogram::kLatencyBucketsSeconds);
+        GsMetricHistogram::ScopedTimer get_ball_timer(get_ball_seconds);
+
         if (rgbImg.empty()) {
             GS_LOG_MSG(error, "GetBall called with no image to work with (rgbImg)");
             return false;
@@ -516,7 +554,7 @@ namespace golf_sim {
         // Blur the image to reduce noise - TBD - Would medianBlur be better ?
         // img_blur = cv::medianBlur(grayImage, 5)
         // Blur the image before trying to identify circles (if desired)
-        cv::Mat blurImg = area_mask_image_.clone();
+        cv::Mat blurImg;
 
         // This seems touchy, too.  Nominal is 7 right now.
         if (PREBLUR_IMAGE) {
@@ -581,18 +619,26 @@ namespace golf_sim {
 
         LoggingTools::DebugShowImage(image_name_ + "  Final color AND area-masked image (search_image)", search_image);
 
-        switch (search_mode) {
-            case kFindPlacedBall: {
+        // Placed-ball checks run continuously between shots, so try the much cheaper coarse-to-fine
+        // search first.  If it finds nothing, fall through to the full-resolution search below.
+        std::vector<GsCircle> pyramid_circles;
+        bool used_pyramid_search = false;
 
-               cv::GaussianBlur(search_image, search_image, cv::Size(kPlacedPreCannyBlurSize, kPlacedPreCannyBlurSize), 0);
+        if (search_mode == kFindPlacedBall && kPlacedBallUsePyramidSearch) {
+            used_pyramid_search = FindPlacedBallCandidatesWithPyramid(search_image, expectedBallArea, chooseLargestFinalBall, pyramid_circles);
 
-                 // TBD - REMOVED THIS FOR NOW
-                 for (int i = 0; i < 0; i++) {
-                     cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-                     cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-                 }
+            if (!used_pyramid_search) {
+                GS_LOG_TRACE_MSG(trace, "Pyramid placed-ball search found nothing.  Searching at full resolution.");
+            }
+        }
 
-                 LoggingTools::DebugShowImage(image_name_ + "  Placed Ball Image - Ready for Edge Detection", search_image);
+        switch (search_mode) {
+            case kFindPlacedBall: {
+
+               if (used_pyramid_search) {
+                   // The edge detection and Hough transform have already been done on the coarse image
+                   break;
+               }
 
                  /*
                  EDPF testEDPF = EDPF(search_image);
@@ -600,13 +646,17 @@ namespace golf_sim {
                  edgePFImage = edgePFImage * -1 + 255;
                  search_image = edgePFImage;
                  */
-                 cv::Mat cannyOutput_for_balls;
-                 cv::Canny(search_image, cannyOutput_for_balls, kPlacedBallCannyLower, kPlacedBallCannyUpper);
-
-                 LoggingTools::DebugShowImage(image_name_ + "  cannyOutput_for_balls", cannyOutput_for_balls);
-
-                 // Blur the lines-only image back to the search_image that the code below uses
-                 cv::GaussianBlur(cannyOutput_for_balls, search_image, cv::Size(kPlacedPreHoughBlurSize, kPlacedPreHoughBlurSize), 0);   // Nominal is 7x7
+                 const std::vector<ImagePrepGraph::Node> prep_nodes = {
+                     ImagePrepGraph::GaussianBlur("Placed Ball Image - Ready for Edge Detection", kPlacedPreCannyBlurSize),
+                     ImagePrepGraph::Canny("cannyOutput_for_balls", kPlacedBallCannyLower, kPlacedBallCannyUpper),
+                     // Blur the lines-only image back to the search_image that the code below uses
+                     ImagePrepGraph::GaussianBlur("Placed Ball Image - Ready for Hough", kPlacedPreHoughBlurSize)   // Nominal is 7x7
+                 };
+
+                 if (!GetPrepGraph(kFindPlacedBall).Run(prep_nodes, search_image, search_image, image_name_)) {
+                     GS_LOG_MSG(error, "Failed to prepare the placed-ball image");
+                     return false;
+                 }
 
 
                  break;
@@ -647,22 +697,21 @@ namespace golf_sim {
 
             case kPutting: {
 
-                cv::medianBlur(search_image, search_image, kPuttingPreHoughBlurSize);
-
-                for (int i = 0; i < 0; i++) {
-                    cv::erode(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
-                    cv::dilate(search_image, search_image, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3)), cv::Point(-1, -1), 3);
+                const std::vector<ImagePrepGraph::Node> prep_nodes = {
+                    ImagePrepGraph::MedianBlur("Putting Image - Ready for Edge Detection", kPuttingPreHoughBlurSize),
+                    // Inverted edges
+                    ImagePrepGraph::Function("Putting Image - EDPF edges", [](const cv::Mat& input, cv::Mat& output) {
+                        EDPF testEDPF = EDPF(input);
+                        cv::subtract(cv::Scalar(255), testEDPF.getEdgeImage(), output);
+                    }),
+                    ImagePrepGraph::GaussianBlur("Putting Image - Ready for Hough", 5)   // Nominal is 7x7
+                };
+
+                if (!GetPrepGraph(kPutting).Run(prep_nodes, search_image, search_image, image_name_)) {
+                    GS_LOG_MSG(error, "Failed to prepare the putting image");
+                    return false;
                 }
 
-                LoggingTools::DebugShowImage(image_name_ + "  Putting Image - Ready for Edge Detection", search_image);
-
-                EDPF testEDPF = EDPF(search_image);
-                Mat edgePFImage = testEDPF.getEdgeImage();
-                edgePFImage = edgePFImage * -1 + 255;
-                search_image = edgePFImage;
-
-                cv::GaussianBlur(search_image, search_image, cv::Size(5, 5), 0);   // Nominal is 7x7
-
                 break;
             }
 
@@ -696,7 +745,7 @@ namespace golf_sim {
         // circles further below.But if we don't get any circles with the starting point, loosen the parameter up to see if we 
         // can get at least one.
 
-        bool done = false;
+        bool done = used_pyramid_search;
         std::vector<GsCircle> circles;
         double starting_param2;
         double min_param2;
@@ -861,6 +910,16 @@ namespace golf_sim {
             final_search_image = search_image;
         }
 
+        // For strobed balls, an area mask (the flight corridor) blanks out any part of the search
+        // area where the ball cannot be.  The placed-ball area mask is not applied here (see above).
+        if ((search_mode == kStrobed || search_mode == kExternallyStrobed) &&
+            !area_mask_image_.empty() && area_mask_image_.size() == search_image.size()) {
+
+            cv::Rect search_area(offset_sub_to_full.x, offset_sub_to_full.y, final_search_image.cols, final_search_image.rows);
+            cv::Mat outside_mask = (area_mask_image_(search_area) == 0);
+            final_search_image.setTo(cv::Scalar(0), outside_mask);
+        }
+
         // LoggingTools::DebugShowImage(image_name_ + "  Final sub-image search_image for Hough Transform{ ", final_search_image);
         // LoggingTools::LogImage("", final_search_image, std::vector < cv::Point >{}, true, "log_view_final_sub_image_for_Hough.png");
 
@@ -879,7 +938,7 @@ namespace golf_sim {
 
         if (search_mode == kStrobed || search_mode == kExternallyStrobed || search_mode == kFindPlacedBall) {
 
-            if (kUseDynamicRadiiAdjustment) {
+            if (kUseDynamicRadiiAdjustment && !used_pyramid_search) {
 
                 double min_ratio;
                 double max_ratio;
@@ -922,6 +981,7 @@ namespace golf_sim {
                 // TBD - Need to set minDist to rows / 8, roughly ?
                 // The _ALT mode seems to work best for this purpose
                 std::vector<GsCircle> test_circles;
+                GetHoughPassesCounter().Increment();
                 cv::HoughCircles(final_search_image,
                     test_circles,
                     cv::HOUGH_GRADIENT_ALT,
@@ -1008,6 +1068,7 @@ namespace golf_sim {
             // NOTE - Param 1 may be sensitive as well - needs to be 100 for large pictures ?
             // TBD - Need to set minDist to rows / 8, roughly ?
             std::vector<GsCircle> test_circles;
+            GetHoughPassesCounter().Increment();
             cv::HoughCircles(final_search_image,
                 test_circles,
                 hough_mode,
@@ -1149,6 +1210,17 @@ namespace golf_sim {
             GS_LOG_TRACE_MSG(trace, "Found " + std::to_string(numCircles) + " circles.");
         }
 
+        if (used_pyramid_search) {
+            // These circles are already in full-image coordinates
+            circles = pyramid_circles;
+            finalNumberOfFoundCircles = (int)circles.size();
+            offset_sub_to_full = cv::Point(0, 0);
+        }
+
+        static GsMetricHistogram& candidates_per_image = GsMetrics::GetHistogram("pitrac_ball_candidates_per_image",
+            "Number of candidate circles that the Hough search produced for each image", GsMetricHistogram::kCountBuckets);
+        candidates_per_image.Observe((double)circles.size());
+
 
 
         cv::Mat candidates_image_ = rgbImg.clone();
@@ -1436,6 +1508,133 @@ namespace golf_sim {
     }
 
 
+    bool BallImageProc::FindPlacedBallCandidatesWithPyramid(const cv::Mat& gray_search_image,
+                                                            const cv::Rect& expected_ball_area,
+                                                            bool choose_largest_final_ball,
+                                                            std::vector<GsCircle>& circles) {
+
+        circles.clear();
+
+        // Same defaults as the full-resolution search
+        const int minimum_search_radius = (min_ball_radius_ < 0) ? int(CvUtils::CvHeight(gray_search_image) / 15) : min_ball_radius_;
+        const int maximum_search_radius = (max_ball_radius_ < 0) ? int(CvUtils::CvHeight(gray_search_image) / 6) : max_ball_radius_;
+
+        // Don't shrink the image so far that the ball is only a few pixels across
+        int levels = std::clamp(kPlacedBallPyramidLevels, 0, 2);
+
+        while (levels > 0 && (minimum_search_radius >> levels) < kPlacedBallPyramidMinCoarseRadius) {
+            levels--;
+        }
+
+        if (levels == 0) {
+            GS_LOG_TRACE_MSG(trace, "FindPlacedBallCandidatesWithPyramid - ball too small (min radius " + std::to_string(minimum_search_radius) + ") to downscale.");
+            return false;
+        }
+
+        const int scale = 1 << levels;
+
+        cv::Rect search_area = expected_ball_area;
+        cv::Point offset_sub_to_full;
+        cv::Point offset_full_to_sub;
+        cv::Mat coarse_image;
+
+        if (search_area.area() > 0) {
+            coarse_image = CvUtils::GetSubImage(gray_search_image, search_area, offset_sub_to_full, offset_full_to_sub);
+        }
+        else {
+            coarse_image = gray_search_image;
+        }
+
+        for (int i = 0; i < levels; i++) {
+            cv::pyrDown(coarse_image, coarse_image);
+        }
+
+        // The same preparation as the full-resolution search, with the blur kernels scaled down
+        auto scaled_kernel_size = [scale](const int full_size) { return std::max(3, (full_size / scale) | 1); };
+
+        cv::GaussianBlur(coarse_image, coarse_image, cv::Size(scaled_kernel_size(kPlacedPreCannyBlurSize), scaled_kernel_size(kPlacedPreCannyBlurSize)), 0);
+
+        cv::Mat coarse_canny_output;
+        cv::Canny(coarse_image, coarse_canny_output, kPlacedBallCannyLower, kPlacedBallCannyUpper);
+
+        cv::GaussianBlur(coarse_canny_output, coarse_image, cv::Size(scaled_kernel_size(kPlacedPreHoughBlurSize), scaled_kernel_size(kPlacedPreHoughBlurSize)), 0);
+
+        LoggingTools::DebugShowImage(image_name_ + "  Pyramid (coarse) placed-ball search image", coarse_image);
+
+        const int coarse_minimum_radius = minimum_search_radius / scale;
+        const int coarse_maximum_radius = std::max(coarse_minimum_radius + 1, maximum_search_radius / scale);
+        const double coarse_minimum_distance = std::max(1.0, coarse_minimum_radius * 0.5);
+
+        // Loosen param2 until something is found.  The coarse Hough is cheap enough to repeat.
+        std::vector<GsCircle> coarse_circles;
+        double param2 = kPlacedBallStartingParam2;
+
+        while (true) {
+            GS_LOG_TRACE_MSG(trace, "Executing coarse (1/" + std::to_string(scale) + " scale) houghCircles with param2 = " + std::to_string(param2) +
+                ", minRadius = " + std::to_string(coarse_minimum_radius) + ", maxRadius = " + std::to_string(coarse_maximum_radius));
+
+            GetHoughPassesCounter().Increment();
+            cv::HoughCircles(coarse_image,
+                coarse_circles,
+                cv::HOUGH_GRADIENT_ALT,
+                kPlacedBallHoughDpParam1,
+                coarse_minimum_distance,
+                kPlacedBallCurrentParam1,
+                param2,
+                coarse_minimum_radius,
+                coarse_maximum_radius);
+
+            if (!coarse_circles.empty() || kPlacedBallParam2Increment <= 0.0 || param2 - kPlacedBallParam2Increment < kPlacedBallMinParam2) {
+                break;
+            }
+
+            param2 -= kPlacedBallParam2Increment;
+        }
+
+        if (coarse_circles.empty()) {
+            return false;
+        }
+
+        if (!RemoveSmallestConcentricCircles(coarse_circles)) {
+            GS_LOG_TRACE_MSG(warning, "Failed to RemoveSmallestConcentricCircles.");
+            return false;
+        }
+
+        if ((int)coarse_circles.size() > kPlacedBallPyramidMaxCandidates) {
+            coarse_circles.resize(std::max(1, kPlacedBallPyramidMaxCandidates));
+        }
+
+        GS_LOG_TRACE_MSG(trace, "Coarse placed-ball search found the following circles: {     " + LoggingTools::FormatCircleList(coarse_circles));
+
+        // Refine each candidate at full resolution in a tight area around it
+        for (const GsCircle& c : coarse_circles) {
+
+            // Each coarse pixel covers scale x scale full-resolution pixels
+            const float half_pixel = (float)(scale - 1) / 2.0f;
+            GsCircle full_circle(c[0] * scale + half_pixel + offset_sub_to_full.x,
+                                 c[1] * scale + half_pixel + offset_sub_to_full.y,
+                                 c[2] * scale);
+
+            GolfBall reference_ball;
+            reference_ball.set_circle(full_circle);
+
+            GsCircle refined_circle;
+
+            if (DetermineBestCircle(gray_search_image, reference_ball, choose_largest_final_ball, refined_circle)) {
+                circles.push_back(refined_circle);
+            }
+            else {
+                GS_LOG_TRACE_MSG(trace, "Could not refine coarse circle - using its up-scaled position.");
+                circles.push_back(full_circle);
+            }
+        }
+
+        GS_LOG_TRACE_MSG(trace, "Pyramid placed-ball search found the following circles: {     " + LoggingTools::FormatCircleList(circles));
+
+        return true;
+    }
+
+
     bool BallImageProc::DetermineBestCircle(const cv::Mat& input_gray_image, 
                                             const GolfBall& reference_ball, 
                                             bool choose_largest_final_ball,
@@ -1446,7 +1645,8 @@ namespace golf_sim {
         //cv::equalizeHist(finalChoiceImg, finalChoiceImg);
 #endif
 
-        cv::Mat gray_image = input_gray_image.clone();
+        // Only the area around the ball is copied (below), because the image is modified in place
+        const cv::Mat& gray_image = input_gray_image;
 
         // We are pretty sure we got the correct ball, or at least something really close.
         // Now, try to find the best circle within the area around the candidate ball to see
@@ -1508,7 +1708,7 @@ namespace golf_sim {
         cv::Point offset_sub_to_full;
         cv::Point offset_full_to_sub;
 
-        cv::Mat finalChoiceSubImg = CvUtils::GetSubImage(gray_image, ball_ROI_rect, offset_sub_to_full, offset_full_to_sub);
+        cv::Mat finalChoiceSubImg = CvUtils::GetSubImage(gray_image, ball_ROI_rect, offset_sub_to_full, offset_full_to_sub).clone();
 
         // LoggingTools::DebugShowImage("DetermineBestCircle - finalChoiceSubImg", finalChoiceSubImg);
 
@@ -1581,6 +1781,7 @@ namespace golf_sim {
         std::vector<GsCircle> finalTargetedCircles;
 
         // The _ALT mode appears to be too stringent and often ends up missing balls
+        GetHoughPassesCounter().Increment();
         cv::HoughCircles(
             finalChoiceSubImg,
             finalTargetedCircles,
@@ -2478,7 +2679,7 @@ namespace golf_sim {
         int hh = original_image.rows;
         int ww = original_image.cols;
 
-        static int imgNumber = 1;
+        static std::atomic<int> imgNumber = 1;
         // LoggingTools::DebugShowImage("RemoveReflections - input img# " + std::to_string(imgNumber) + " = ", original_image);
         // LoggingTools::DebugShowImage("filtered_image - input img# " + std::to_string(imgNumber) + " = ", filtered_image);
         imgNumber++;
@@ -2498,12 +2699,28 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "Lower cutoff for brightness is " + std::to_string(brightness_percentage) + "%, grayscale value = " + std::to_string(brightness_cutoff));
 
         brightness_cutoff--;  // Make sure we don't filter out EVERYTHING
-        // GsColorTriplet lower = ((uchar)brightness_cutoff, (uchar)brightness_cutoff, (uchar)brightness_cutoff);
-        GsColorTriplet lower = ((uchar)kReflectionMinimumRGBValue, (uchar)kReflectionMinimumRGBValue, (uchar)kReflectionMinimumRGBValue);
-        GsColorTriplet upper{ 255,255,255 };
+        // The cutoff is currently fixed at kReflectionMinimumRGBValue.  See GetReflectionMask.
+        cv::Mat morph;
+        GetReflectionMask(original_image, morph);
+
+        // LoggingTools::DebugShowImage("RemoveReflections - Expanded thresholded image = ", morph);
+
+        // Set the pixels under the morphed, expanded mask image to "ignore" in the filtered_image
+        filtered_image.setTo(kPixelIgnoreValue, morph);
+
+        LoggingTools::DebugShowImage("RemoveReflections - final filtered image = ", filtered_image);
+    }
+
+    void BallImageProc::GetReflectionMask(const cv::Mat& original_image, cv::Mat& reflection_mask) {
 
-        cv::Mat thresh(original_image.rows, original_image.cols, original_image.type(), cv::Scalar(0));
-        cv::inRange(original_image, lower, upper, thresh);
+        CV_Assert((original_image.type() == CV_8UC1));
+
+        // Re-used from call to call (per thread) so that the spin pre-processing does not allocate
+        // a new threshold image for every ball
+        thread_local cv::Mat thresh;
+
+        // Same as an inRange() of kReflectionMinimumRGBValue to 255
+        cv::threshold(original_image, thresh, kReflectionMinimumRGBValue - 1, 255, cv::THRESH_BINARY);
 
         // LoggingTools::DebugShowImage("RemoveReflections - Initial thresholded image = ", thresh);
 
@@ -2514,28 +2731,75 @@ namespace golf_sim {
 
         const int kCloseKernelSize = 3;  // 7
 
-        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kCloseKernelSize, kCloseKernelSize));
-        // Morph is a binary (0 or 255) mask
-        cv::Mat morph;
-        cv::morphologyEx(thresh, morph, cv::MORPH_CLOSE, kernel, cv::Point(-1, -1), /*iterations = */ 1);
+        // The kernels are kept (per thread) between calls, and only rebuilt if their size changes
+        thread_local cv::Mat close_kernel;
+        thread_local cv::Mat dilate_kernel;
 
-        kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kReflectionKernelDilationSize, kReflectionKernelDilationSize));   // originally 25,25
-        cv::morphologyEx(morph, morph, cv::MORPH_DILATE, kernel, cv::Point(-1, -1),  /*iterations = */ 1);
+        if (close_kernel.rows != kCloseKernelSize) {
+            close_kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kCloseKernelSize, kCloseKernelSize));
+        }
 
-        // LoggingTools::DebugShowImage("RemoveReflections - Expanded thresholded image = ", morph);
+        if (dilate_kernel.rows != kReflectionKernelDilationSize) {
+            dilate_kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kReflectionKernelDilationSize, kReflectionKernelDilationSize));   // originally 25,25
+        }
 
-        // Iterate through the morphed, expanded mask image and set the corresponding pixels to "ignore" in the filtered_image
-        for (int x = 0; x < original_image.cols; x++) {
-            for (int y = 0; y < original_image.rows; y++) {
-                uchar p1 = morph.at<uchar>(x, y);
+        // The mask is a binary (0 or 255) image
+        cv::morphologyEx(thresh, reflection_mask, cv::MORPH_CLOSE, close_kernel, cv::Point(-1, -1), /*iterations = */ 1);
+        cv::morphologyEx(reflection_mask, reflection_mask, cv::MORPH_DILATE, dilate_kernel, cv::Point(-1, -1),  /*iterations = */ 1);
+    }
 
-                if (p1 == 255) {
-                    filtered_image.at<uchar>(x, y) = kPixelIgnoreValue;
-                }
-             }
+    void BallImageProc::MaskSpinDimpleImage(const cv::Mat& ball_image,
+                                            const GolfBall& ball,
+                                            const float mask_reduction_factor,
+                                            cv::Mat& dimple_image) {
+
+        CV_Assert((dimple_image.type() == CV_8UC1) && dimple_image.size() == ball_image.size());
+
+        thread_local cv::Mat reflection_mask;
+        GetReflectionMask(ball_image, reflection_mask);
+
+        // Same circle as MaskAreaOutsideBall would use
+        const int center_x = (int)ball.x();
+        const int center_y = (int)ball.y();
+        const int mask_radius = (int)(ball.measured_radius_pixels_ * mask_reduction_factor);
+
+        // One row-major pass.  A pixel is ignored if it is part of a reflection or is outside the circle.
+        for (int y = 0; y < dimple_image.rows; y++) {
+            uchar* dimple_row = dimple_image.ptr<uchar>(y);
+            const uchar* reflection_row = reflection_mask.ptr<uchar>(y);
+
+            int inside_start;
+            int inside_end;
+            GetCircleRowExtent(center_x, center_y, mask_radius, y, dimple_image.cols, inside_start, inside_end);
+
+            for (int x = 0; x < dimple_image.cols; x++) {
+                const bool inside = (x >= inside_start && x < inside_end);
+                dimple_row[x] = (inside && reflection_row[x] == 0) ? dimple_row[x] : (uchar)kPixelIgnoreValue;
+            }
         }
 
-        LoggingTools::DebugShowImage("RemoveReflections - final filtered image = ", filtered_image);
+        LoggingTools::DebugShowImage("MaskSpinDimpleImage - final dimple image = ", dimple_image);
+    }
+
+    void BallImageProc::GetCircleRowExtent(const int center_x,
+                                           const int center_y,
+                                           const int radius,
+                                           const int y,
+                                           const int image_width,
+                                           int& inside_start,
+                                           int& inside_end) {
+        const int dy = y - center_y;
+
+        if (radius < 0 || std::abs(dy) > radius) {
+            inside_start = 0;
+            inside_end = 0;
+            return;
+        }
+
+        const int half_width = (int)std::floor(std::sqrt((double)radius * radius - (double)dy * dy));
+
+        inside_start = std::clamp(center_x - half_width, 0, image_width);
+        inside_end = std::clamp(center_x + half_width + 1, 0, image_width);
     }
 
     // DEPRECATED - No longer used
@@ -2638,27 +2902,30 @@ namespace golf_sim {
 
         // LoggingTools::DebugShowImage("MaskAreaOutsideBall - ball_image", ball_image);
 
-        // A white circle on a black background will act as our first mask to preserve the ball portion of the image
+        CV_Assert((ball_image.type() == CV_8UC1));
 
-        int mask_radius = (int)(ball.measured_radius_pixels_ * mask_reduction_factor);
+        // Copy the ball's circle and set everything outside of it to the mask value, all in one
+        // row-major pass instead of building and combining separate mask images
 
-        cv::Mat maskImage = cv::Mat::zeros(ball_image.rows, ball_image.cols, ball_image.type());
-        cv::circle(maskImage, cv::Point(ball.x(), ball.y()), mask_radius, cv::Scalar(255, 255, 255), -1);
-        //LoggingTools::DebugShowImage("1st maskImage", maskImage);
+        const int mask_radius = (int)(ball.measured_radius_pixels_ * mask_reduction_factor);
+        const int center_x = (int)ball.x();
+        const int center_y = (int)ball.y();
+        const uchar outside_value = cv::saturate_cast<uchar>(maskValue[0]);
 
-        // At this point, maskImage is an image with a white circle and a black outside
+        cv::Mat result(ball_image.rows, ball_image.cols, ball_image.type());
 
-        cv::Mat result = ball_image.clone();
-        cv::bitwise_and(ball_image, maskImage, result);
-        //LoggingTools::DebugShowImage("Intermediate result", result);
+        for (int y = 0; y < ball_image.rows; y++) {
+            const uchar* source_row = ball_image.ptr<uchar>(y);
+            uchar* result_row = result.ptr<uchar>(y);
 
-        // Now XOR the image-on-black with a on a rectangle of desired color and a black circle in the middle
-        cv::Rect r(cv::Point(0, 0), cv::Point(ball_image.cols, ball_image.rows));
-        cv::rectangle(maskImage, r, maskValue, cv::FILLED);
-        cv::circle(maskImage, cv::Point(ball.x(), ball.y()), mask_radius, cv::Scalar(0, 0, 0), -1);
-        //LoggingTools::DebugShowImage("2nd maskImage", maskImage);
+            int inside_start;
+            int inside_end;
+            GetCircleRowExtent(center_x, center_y, mask_radius, y, ball_image.cols, inside_start, inside_end);
 
-        cv::bitwise_xor(result, maskImage, result);
+            std::fill(result_row, result_row + inside_start, outside_value);
+            std::copy(source_row + inside_start, source_row + inside_end, result_row + inside_start);
+            std::fill(result_row + inside_end, result_row + ball_image.cols, outside_value);
+        }
 
         // LoggingTools::DebugShowImage("MaskAreaOutsideBall: result", result);
 
@@ -2669,7 +2936,9 @@ namespace golf_sim {
     cv::Vec3d BallImageProc::GetBallRotation(const cv::Mat& full_gray_image1, 
                                              const GolfBall& ball1, 
                                              const cv::Mat& full_gray_image2, 
-                                             const GolfBall& ball2) {
+                                             const GolfBall& ball2,
+                                             double* best_match_score,
+                                             const SpinSearchHints* search_hints) {
         // NOTE - This function (and downstream functions) assumes that ball1 is the earlier-in-time ball
         // for a right-handed shot.  So, for example, the expected spin will be largely counter-clockwise
         // from ball 1 to ball 2.
@@ -2682,22 +2951,52 @@ namespace golf_sim {
         LoggingTools::DebugShowImage("full_gray_image1", full_gray_image1);
         LoggingTools::DebugShowImage("full_gray_image2", full_gray_image2);
 
-        // First, get a clean picture of each ball with nothing in the background, both sized the exactly same way 
-        // Resize the images so that the balls are the same radius. 
+        // First, get a clean picture of each ball with nothing in the background
+        IsolatedSpinBall isolated_ball1;
+        IsolatedSpinBall isolated_ball2;
+        IsolateSpinBall(full_gray_image1, ball1, isolated_ball1);
+        IsolateSpinBall(full_gray_image2, ball2, isolated_ball2);
 
-        GolfBall local_ball1 = ball1;
-        GolfBall local_ball2 = ball2;
+        return GetBallRotation(isolated_ball1, ball1, isolated_ball2, ball2, best_match_score, true, search_hints);
+    }
 
+    void BallImageProc::IsolateSpinBall(const cv::Mat& full_gray_image, const GolfBall& ball, IsolatedSpinBall& isolated_ball) {
 
         // NOTE - The ball that is passed into the IsolateBall image will be adjusted
         // to have the new x, y, and radius values relative to the smaller, isolated picture
-        cv::Mat ball_image1 = IsolateBall(full_gray_image1, local_ball1);
-        cv::Mat ball_image2 = IsolateBall(full_gray_image2, local_ball2);
+        isolated_ball.local_ball = ball;
+        isolated_ball.image = IsolateBall(full_gray_image, isolated_ball.local_ball);
+    }
+
+    cv::Vec3d BallImageProc::GetBallRotation(const IsolatedSpinBall& isolated_ball1,
+                                             const GolfBall& ball1,
+                                             const IsolatedSpinBall& isolated_ball2,
+                                             const GolfBall& ball2,
+                                             double* best_match_score,
+                                             const bool save_result_images,
+                                             const SpinSearchHints* search_hints) {
+
+        static GsMetricHistogram& spin_seconds = GsMetrics::GetHistogram("pitrac_spin_analysis_seconds",
+            "Time to determine the ball's rotation between two images", GsMetricHistogram::kLatencyBucketsSeconds);
+        GsMetricHistogram::ScopedTimer spin_timer(spin_seconds);
+
+        if (best_match_score != nullptr) {
+            *best_match_score = -1.0;
+        }
+
+        // Resize the images so that the balls are the same radius.  The isolated images may be
+        // shared with other ball pairs, so they are only read here.  A resized image is a new Mat.
+
+        GolfBall local_ball1 = isolated_ball1.local_ball;
+        GolfBall local_ball2 = isolated_ball2.local_ball;
+
+        cv::Mat ball_image1 = isolated_ball1.image;
+        cv::Mat ball_image2 = isolated_ball2.image;
 
         LoggingTools::DebugShowImage("ISOLATED full_gray_image1", ball_image1);
         LoggingTools::DebugShowImage("ISOLATED full_gray_image2", ball_image2);
 
-        if (GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
+        if (save_result_images && GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
             LoggingTools::LogImage("", ball_image1, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image1.png");
             LoggingTools::LogImage("", ball_image2, std::vector < cv::Point >{}, true, "log_view_ISOLATED_full_gray_image2.png");
         }
@@ -2715,18 +3014,19 @@ namespace golf_sim {
             ball2RadiusMultiplier = (double)ball_image1.rows / (double)ball_image2.rows;
             int upWidth = ball_image1.cols;
             int upHeight = ball_image1.rows;
-            cv::resize(ball_image2, ball_image2, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
+            cv::resize(isolated_ball2.image, ball_image2, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
         }
         else if (ball_image2.rows > ball_image1.rows || ball_image2.cols > ball_image1.cols) {
             ball1RadiusMultiplier = (double)ball_image2.rows / (double)ball_image1.rows;
             int upWidth = ball_image2.cols;
             int upHeight = ball_image2.rows;
-            cv::resize(ball_image1, ball_image1, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
+            cv::resize(isolated_ball1.image, ball_image1, cv::Size(upWidth, upHeight), cv::INTER_LINEAR);
         }
 
-        // Save the original, non-equalized images for later QA
-        cv::Mat originalBallImg1 = ball_image1.clone();
-        cv::Mat originalBallImg2 = ball_image2.clone();
+        // Save the original, non-equalized images for later QA.  Nothing below writes to the
+        // ball images, so these can share their data.
+        const cv::Mat originalBallImg1 = ball_image1;
+        const cv::Mat originalBallImg2 = ball_image2;
 
         // Adjust relevant ball radius information accordingly
         local_ball1.measured_radius_pixels_ = local_ball1.measured_radius_pixels_ * ball1RadiusMultiplier;
@@ -2759,19 +3059,15 @@ namespace golf_sim {
         // LoggingTools::DebugShowImage("Ball1 Dimple Image", ball_image1DimpleEdges);
         // LoggingTools::DebugShowImage("Ball2 Dimple Image", ball_image2DimpleEdges);
 
-        cv::Mat area_mask_image_;
-        RemoveReflections(ball_image1, ball_image1DimpleEdges, area_mask_image_);
-        RemoveReflections(ball_image2, ball_image2DimpleEdges, area_mask_image_);
-
         // TBD - In addition to removing reflections, we may also want to remove really dark areas which will
         // comprise the registration marks.  That seems counter-intuitive, but those marks sometimes create large
         // "positive" (on) areas in the Gabor filters
 
-        // The outer edge of the ball doesn't provide much information, so ignore it
+        // Ignore the reflections and the outer edge of the ball (which doesn't provide much information),
+        // in place and in a single pass
         const float finalBallMaskReductionFactor = 0.92f;
-        cv::Scalar ignoreColor = cv::Scalar(kPixelIgnoreValue, kPixelIgnoreValue, kPixelIgnoreValue);
-        ball_image1DimpleEdges = MaskAreaOutsideBall(ball_image1DimpleEdges, local_ball1, finalBallMaskReductionFactor, ignoreColor);
-        ball_image2DimpleEdges = MaskAreaOutsideBall(ball_image2DimpleEdges, local_ball2, finalBallMaskReductionFactor, ignoreColor);
+        MaskSpinDimpleImage(ball_image1, local_ball1, finalBallMaskReductionFactor, ball_image1DimpleEdges);
+        MaskSpinDimpleImage(ball_image2, local_ball2, finalBallMaskReductionFactor, ball_image2DimpleEdges);
         LoggingTools::DebugShowImage("Final ball_image1DimpleEdges after masking outside", ball_image1DimpleEdges);
         LoggingTools::DebugShowImage("Final ball_image2DimpleEdges after masking outside", ball_image2DimpleEdges);
 
@@ -2800,7 +3096,8 @@ namespace golf_sim {
         cv::Vec3i angleOffsetDeltas1 = CvUtils::Round(angleOffsetDeltas1Float);
 
 
-        cv::Mat unrotatedBallImg1DimpleEdges = ball_image1DimpleEdges.clone();
+        // GetRotatedImage always creates a new output image, so the unrotated image can just keep the old data
+        const cv::Mat unrotatedBallImg1DimpleEdges = ball_image1DimpleEdges;
         GetRotatedImage(unrotatedBallImg1DimpleEdges, local_ball1, angleOffsetDeltas1, ball_image1DimpleEdges);
 
         GS_LOG_TRACE_MSG(trace, "Adjusting rotation for camera view of ball 1 to offset (x,y,z)=" + std::to_string(angleOffsetDeltas1[0]) + "," + std::to_string(angleOffsetDeltas1[1]) + "," + std::to_string(angleOffsetDeltas1[2]));
@@ -2813,25 +3110,27 @@ namespace golf_sim {
         }
 
 
-        cv::Mat unrotatedBallImg2DimpleEdges = ball_image2DimpleEdges.clone();
+        const cv::Mat unrotatedBallImg2DimpleEdges = ball_image2DimpleEdges;
         GetRotatedImage(unrotatedBallImg2DimpleEdges, local_ball2, angleOffsetDeltas2, ball_image2DimpleEdges);
         GS_LOG_TRACE_MSG(trace, "Adjusting rotation for camera view of ball 2 to offset (x,y,z)=" + std::to_string(angleOffsetDeltas2[0]) + "," + std::to_string(angleOffsetDeltas2[1]) + "," + std::to_string(angleOffsetDeltas2[2]));
         LoggingTools::DebugShowImage("Final perspective-de-rotated filtered ball_image2DimpleEdges: ", ball_image2DimpleEdges, center1);
 
         // Although unnecessary for the algorithm, the following DEBUG code shows the original image as it would appear rotated in the same way as the Gabor-filtered balls
         
-        cv::Mat normalizedOriginalBallImg1 = originalBallImg1.clone();
+        cv::Mat normalizedOriginalBallImg1;
         GetRotatedImage(originalBallImg1, local_ball1, angleOffsetDeltas1, normalizedOriginalBallImg1);
         LoggingTools::DebugShowImage("Final rotated originalBall1: ", normalizedOriginalBallImg1, center1);
-        cv::Mat normalizedOriginalBallImg2 = originalBallImg2.clone();
+        cv::Mat normalizedOriginalBallImg2;
         GetRotatedImage(originalBallImg2, local_ball2, angleOffsetDeltas2, normalizedOriginalBallImg2);
         LoggingTools::DebugShowImage("Final rotated originalBall2: ", normalizedOriginalBallImg2, center2);
         
 #ifdef __unix__ 
         // Save the normalized ball images to the webserver shared directory so that the user
         // can compare them to the final rotated image.
-        GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultSpinBall1Image, normalizedOriginalBallImg1);
-        GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultSpinBall2Image, normalizedOriginalBallImg2);
+        if (save_result_images) {
+            GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultSpinBall1Image, normalizedOriginalBallImg1);
+            GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultSpinBall2Image, normalizedOriginalBallImg2);
+        }
 #endif
 
 
@@ -2850,15 +3149,47 @@ namespace golf_sim {
         initialSearchSpace.anglez_rotation_degrees_start = kCoarseZRotationDegreesStart;
         initialSearchSpace.anglez_rotation_degrees_end = kCoarseZRotationDegreesEnd;
 
+        // If what is known about the shot allows, only search the part of the coarse cube
+        // where the rotation could plausibly be
+        RotationSearchSpace plannedSearchSpace = initialSearchSpace;
+        bool search_was_planned = false;
+
+        if (search_hints != nullptr) {
+            search_was_planned = GsSpinSearchPlanner::PlanCoarseSearchSpace(*search_hints, initialSearchSpace, plannedSearchSpace);
+        }
+
         cv::Mat outputCandidateElementsMat;
         std::vector< RotationCandidate> candidates;
         cv::Vec3i output_candidate_elements_mat_size;
 
-        ComputeCandidateAngleImages(ball_image1DimpleEdges, initialSearchSpace, outputCandidateElementsMat, output_candidate_elements_mat_size, candidates, local_ball1);
+        ComputeCandidateAngleImages(ball_image1DimpleEdges, plannedSearchSpace, outputCandidateElementsMat, output_candidate_elements_mat_size, candidates, local_ball1);
 
         // Compare the second (presumably rotated) ball image to different candidate rotations of the first ball image to determine the angular change
         std::vector<std::string> comparison_csv_data;
         int best_candidate_index = CompareCandidateAngleImages(&ball_image2DimpleEdges, &outputCandidateElementsMat, &output_candidate_elements_mat_size, &candidates, comparison_csv_data);
+
+        if (search_was_planned) {
+            static GsMetricCounter& planned_searches = GsMetrics::GetCounter("pitrac_spin_search_planned_total",
+                "Spin analyses whose coarse rotation search was narrowed using the shot's speed, launch angle and club");
+            planned_searches.Increment();
+
+            if (best_candidate_index < 0 ||
+                GsSpinSearchPlanner::ShouldWidenSearch(candidates[best_candidate_index], plannedSearchSpace, initialSearchSpace)) {
+
+                static GsMetricCounter& widened_searches = GsMetrics::GetCounter("pitrac_spin_search_widened_total",
+                    "Narrowed spin searches that had to fall back to the full coarse rotation search");
+                widened_searches.Increment();
+
+                GS_LOG_TRACE_MSG(trace, "Narrowed spin search did not find a good rotation.  Searching all coarse rotations.");
+
+                outputCandidateElementsMat.release();
+                candidates.clear();
+                comparison_csv_data.clear();
+
+                ComputeCandidateAngleImages(ball_image1DimpleEdges, initialSearchSpace, outputCandidateElementsMat, output_candidate_elements_mat_size, candidates, local_ball1);
+                best_candidate_index = CompareCandidateAngleImages(&ball_image2DimpleEdges, &outputCandidateElementsMat, &output_candidate_elements_mat_size, &candidates, comparison_csv_data);
+            }
+        }
         
         cv::Vec3f rotationResult;
 
@@ -2871,7 +3202,7 @@ namespace golf_sim {
 
         GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kWriteSpinAnalysisCsvFiles", write_spin_analysis_CSV_files);
         
-        if (write_spin_analysis_CSV_files) {
+        if (write_spin_analysis_CSV_files && save_result_images) {
             // This data export can be used for, say, Excel analysis - CSV format
             std::string csv_fname_coarse = "spin_analysis_coarse.csv";
             ofstream csv_file_coarse(csv_fname_coarse);
@@ -2885,75 +3216,130 @@ namespace golf_sim {
         }
 
         // See which angle looked best and then iterate more closely near those angles
-        RotationCandidate c = candidates[best_candidate_index];
+        const RotationCandidate& c = candidates[best_candidate_index];
 
         std::string s = "Best Coarse Initial Rotation Candidate was #" + std::to_string(best_candidate_index) + " - Rot: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ") ";
         GS_LOG_MSG(debug, s);
 
-        // Now iterate more closely in the area that looks best
-        RotationSearchSpace finalSearchSpace;
+        // Analyze the fine-grained results
+        double best_rot_x = 0;
+        double best_rot_y = 0;
+        double best_rot_z = 0;
+        bool found_final_rotation = false;
 
-        int anglex_window_width = (int)std::round(ceil(initialSearchSpace.anglex_rotation_degrees_increment / 2.));
-        int angley_window_width = (int)std::round(ceil(initialSearchSpace.angley_rotation_degrees_increment / 2.));
-        int anglez_window_width = (int)std::round(ceil(initialSearchSpace.anglez_rotation_degrees_increment / 2.));
+        // Refine the coarse rotation continuously, which gives sub-degree angles from
+        // far fewer scored rotations than a fine grid
+        if (kSpinRefinementUseContinuousOptimizer) {
+            cv::Vec3d refined_rotation;
+            double refined_score = -1.0;
 
+            if (RefineBallRotation(ball_image1DimpleEdges, ball_image2DimpleEdges, local_ball1, c, initialSearchSpace, refined_rotation, refined_score)) {
 
-        finalSearchSpace.anglex_rotation_degrees_increment = 1;
-        finalSearchSpace.anglex_rotation_degrees_start = c.x_rotation_degrees - anglex_window_width;
-        finalSearchSpace.anglex_rotation_degrees_end = c.x_rotation_degrees + anglex_window_width;
-        // Probably not worth it to be too fine-grained on the Y axis.
-        finalSearchSpace.angley_rotation_degrees_increment = (int) std::round(kCoarseYRotationDegreesIncrement / 2.);
-        finalSearchSpace.angley_rotation_degrees_start = c.y_rotation_degrees - angley_window_width;
-        finalSearchSpace.angley_rotation_degrees_end = c.y_rotation_degrees + angley_window_width;
-        finalSearchSpace.anglez_rotation_degrees_increment = 1;
-        finalSearchSpace.anglez_rotation_degrees_start = c.z_rotation_degrees - anglez_window_width;
-        finalSearchSpace.anglez_rotation_degrees_end = c.z_rotation_degrees + anglez_window_width;
+                if (best_match_score != nullptr) {
+                    // Report the same matched-pixel fraction as the grid searches do, so that the scores of
+                    // different image pairs can be compared however each rotation was found
+                    *best_match_score = c.score;
 
-        cv::Mat finalOutputCandidateElementsMat;
-        cv::Vec3i finalOutputCandidateElementsMatSize;
-        std::vector< RotationCandidate> finalCandidates;
+                    const cv::Vec3i refined_rotation_rounded((int)std::round(refined_rotation[0]), (int)std::round(refined_rotation[1]), (int)std::round(refined_rotation[2]));
+                    cv::Mat refined_image_3D = Project2dImageTo3dBall(ball_image1DimpleEdges, local_ball1, refined_rotation_rounded);
 
-        // After this, the finalOutputCandidateElementsMat will have X,Y,Z elements with an index into the finalCandidates vector.
-        // Each candidate in finalCandidates will have an image, associated X,Y,Z information and a place to put a score
-        ComputeCandidateAngleImages(ball_image1DimpleEdges, finalSearchSpace, finalOutputCandidateElementsMat, finalOutputCandidateElementsMatSize, finalCandidates, local_ball1);
+                    PackedBinaryImage packed_target_image;
+                    PackedBinaryImage packed_refined_image;
 
-        // TBD - change CompareCandidateAngleImages to work directly with the "3D" images
-        best_candidate_index = CompareCandidateAngleImages(&ball_image2DimpleEdges, &finalOutputCandidateElementsMat, &finalOutputCandidateElementsMatSize, &finalCandidates, comparison_csv_data);
+                    if (packed_target_image.PackGrayImage(ball_image2DimpleEdges, kPixelIgnoreValue) &&
+                        packed_refined_image.PackProjectedImage(refined_image_3D, kPixelIgnoreValue)) {
 
-        // Save all the candidate scores to a CSV file if requested
-        if (write_spin_analysis_CSV_files) {
+                        const cv::Vec2i results = CompareRotationImage(packed_target_image, packed_refined_image);
 
-            std::string csv_fname_fine = "spin_analysis_fine.csv";
-            ofstream csv_file_fine(csv_fname_fine);
-            GS_LOG_TRACE_MSG(trace, "Writing CSV spin data to: " + csv_fname_fine);
-            for (auto& element : comparison_csv_data)
-            {
-                // Don't use logging utility so that we don't have all the timing crap in the output
-                csv_file_fine << element;
+                        if (results[1] > 0) {
+                            *best_match_score = (double)results[0] / (double)results[1];
+                        }
+                    }
+                }
+
+                best_rot_x = refined_rotation[0];
+                best_rot_y = refined_rotation[1];
+                best_rot_z = refined_rotation[2];
+                found_final_rotation = true;
+            }
+            else {
+                LoggingTools::Warning("Continuous spin refinement failed.  Searching a fine grid instead.");
             }
-            csv_file_fine.close();
         }
 
-        // Analyze the fine-grained results
-        int best_rot_x = 0;
-        int best_rot_y = 0;
-        int best_rot_z = 0;
+        if (!found_final_rotation) {
+            // Now iterate more closely in the area that looks best
+            RotationSearchSpace finalSearchSpace;
 
-        if (best_candidate_index >= 0) {
-            RotationCandidate finalC = finalCandidates[best_candidate_index];
-            best_rot_x = finalC.x_rotation_degrees;
-            best_rot_y = finalC.y_rotation_degrees;
-            best_rot_z = finalC.z_rotation_degrees;
+            int anglex_window_width = (int)std::round(ceil(initialSearchSpace.anglex_rotation_degrees_increment / 2.));
+            int angley_window_width = (int)std::round(ceil(initialSearchSpace.angley_rotation_degrees_increment / 2.));
+            int anglez_window_width = (int)std::round(ceil(initialSearchSpace.anglez_rotation_degrees_increment / 2.));
+
+
+            finalSearchSpace.anglex_rotation_degrees_increment = 1;
+            finalSearchSpace.anglex_rotation_degrees_start = c.x_rotation_degrees - anglex_window_width;
+            finalSearchSpace.anglex_rotation_degrees_end = c.x_rotation_degrees + anglex_window_width;
+            // Probably not worth it to be too fine-grained on the Y axis.
+            finalSearchSpace.angley_rotation_degrees_increment = (int) std::round(kCoarseYRotationDegreesIncrement / 2.);
+            finalSearchSpace.angley_rotation_degrees_start = c.y_rotation_degrees - angley_window_width;
+            finalSearchSpace.angley_rotation_degrees_end = c.y_rotation_degrees + angley_window_width;
+            finalSearchSpace.anglez_rotation_degrees_increment = 1;
+            finalSearchSpace.anglez_rotation_degrees_start = c.z_rotation_degrees - anglez_window_width;
+            finalSearchSpace.anglez_rotation_degrees_end = c.z_rotation_degrees + anglez_window_width;
+
+            cv::Mat finalOutputCandidateElementsMat;
+            cv::Vec3i finalOutputCandidateElementsMatSize;
+            std::vector< RotationCandidate> finalCandidates;
+
+            // After this, the finalOutputCandidateElementsMat will have X,Y,Z elements with an index into the finalCandidates vector.
+            // Each candidate in finalCandidates will have an image, associated X,Y,Z information and a place to put a score
+            ComputeCandidateAngleImages(ball_image1DimpleEdges, finalSearchSpace, finalOutputCandidateElementsMat, finalOutputCandidateElementsMatSize, finalCandidates, local_ball1);
+
+            // TBD - change CompareCandidateAngleImages to work directly with the "3D" images
+            best_candidate_index = CompareCandidateAngleImages(&ball_image2DimpleEdges, &finalOutputCandidateElementsMat, &finalOutputCandidateElementsMatSize, &finalCandidates, comparison_csv_data);
+
+            // Save all the candidate scores to a CSV file if requested
+            if (write_spin_analysis_CSV_files && save_result_images) {
+
+                std::string csv_fname_fine = "spin_analysis_fine.csv";
+                ofstream csv_file_fine(csv_fname_fine);
+                GS_LOG_TRACE_MSG(trace, "Writing CSV spin data to: " + csv_fname_fine);
+                for (auto& element : comparison_csv_data)
+                {
+                    // Don't use logging utility so that we don't have all the timing crap in the output
+                    csv_file_fine << element;
+                }
+                csv_file_fine.close();
+            }
 
-            // TBD - Experiment - are Y and X reversed?  Try it here...
-            // best_rot_x = finalC.y_rotation_degrees;
-            // best_rot_y = finalC.x_rotation_degrees;
+            if (best_candidate_index >= 0) {
+                const RotationCandidate& finalC = finalCandidates[best_candidate_index];
 
-            std::string s = "Best Raw Fine (and final) Rotation Candidate was #" + std::to_string(best_candidate_index) + " - Rot: (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) + ") ";
+                if (best_match_score != nullptr) {
+                    *best_match_score = finalC.score;
+                }
+
+                best_rot_x = finalC.x_rotation_degrees;
+                best_rot_y = finalC.y_rotation_degrees;
+                best_rot_z = finalC.z_rotation_degrees;
+                found_final_rotation = true;
+
+                // TBD - Experiment - are Y and X reversed?  Try it here...
+                // best_rot_x = finalC.y_rotation_degrees;
+                // best_rot_y = finalC.x_rotation_degrees;
+            }
+        }
+
+        // The debug images can only show whole-degree rotations
+        const cv::Vec3i best_rotation_rounded((int)std::round(best_rot_x), (int)std::round(best_rot_y), (int)std::round(best_rot_z));
+
+        if (found_final_rotation) {
+            std::string s = "Best Raw Fine (and final) Rotation was (" + std::to_string(best_rot_x) + ", " + std::to_string(best_rot_y) + ", " + std::to_string(best_rot_z) + ") ";
             GS_LOG_MSG(debug, s);
 
             /*** FOR DEBUG ***/
-            cv::Mat bestImg3D = finalCandidates[best_candidate_index].img;
+            // The candidates only keep the packed images, so re-create this one
+            cv::Mat bestImg3D = Project2dImageTo3dBall(ball_image1DimpleEdges, local_ball1, best_rotation_rounded);
             cv::Mat bestImg2D = cv::Mat::zeros(ball_image1DimpleEdges.rows, ball_image1DimpleEdges.cols, ball_image1DimpleEdges.type());
             Unproject3dBallTo2dImage(bestImg3D, bestImg2D, ball2);
             LoggingTools::DebugShowImage("Best Final Rotation Candidate Image", bestImg2D);
@@ -2983,12 +3369,13 @@ namespace golf_sim {
         double spin_offset_angle_radians_Z = CvUtils::DegreesToRadians(spin_offset_angle[2]);
 
         // Perform the normalization to the real-world axes
-        int normalized_rot_x = (int)round( (double)best_rot_x * cos(spin_offset_angle_radians_Y) + (double)best_rot_z * sin(spin_offset_angle_radians_Y) );
-        int normalized_rot_y = (int)round( (double)best_rot_y * cos(spin_offset_angle_radians_X) - (double)best_rot_z * sin(spin_offset_angle_radians_X) );
+        // The angles are not rounded, so that the sub-degree refinement is kept
+        double normalized_rot_x = best_rot_x * cos(spin_offset_angle_radians_Y) + best_rot_z * sin(spin_offset_angle_radians_Y);
+        double normalized_rot_y = best_rot_y * cos(spin_offset_angle_radians_X) - best_rot_z * sin(spin_offset_angle_radians_X);
 
-        int normalized_rot_z = (int)round((double)best_rot_z * cos(spin_offset_angle_radians_X) * cos(spin_offset_angle_radians_Y));
-        normalized_rot_z -= (int)round((double)best_rot_y * sin(spin_offset_angle_radians_X));
-        normalized_rot_z -= (int)round((double)best_rot_x * sin(spin_offset_angle_radians_Y));
+        double normalized_rot_z = best_rot_z * cos(spin_offset_angle_radians_X) * cos(spin_offset_angle_radians_Y);
+        normalized_rot_z -= best_rot_y * sin(spin_offset_angle_radians_X);
+        normalized_rot_z -= best_rot_x * sin(spin_offset_angle_radians_Y);
 
         rotationResult = cv::Vec3d(normalized_rot_x, normalized_rot_y, normalized_rot_z);
 
@@ -3002,16 +3389,16 @@ namespace golf_sim {
 
         cv::Mat resultBball2DImage;
 
-        GetRotatedImage(ball_image1DimpleEdges, local_ball1, cv::Vec3i(best_rot_x, best_rot_y, best_rot_z), resultBball2DImage);
+        GetRotatedImage(ball_image1DimpleEdges, local_ball1, best_rotation_rounded, resultBball2DImage);
 
 
-        if (GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
+        if (save_result_images && GolfSimOptions::GetCommandLineOptions().artifact_save_level_ != ArtifactSaveLevel::kNoArtifacts && kLogIntermediateSpinImagesToFile) {
             LoggingTools::LogImage("", resultBball2DImage, std::vector < cv::Point >{}, true, "Filtered Ball1_Rotated_By_Best_Angles.png");
         }
 
         // We want to show apples to apples, so show the normalized images
         cv::Mat test_ball1_image = normalizedOriginalBallImg1.clone();
-        GetRotatedImage(normalizedOriginalBallImg1, local_ball1, cv::Vec3i(best_rot_x, best_rot_y, best_rot_z), test_ball1_image);
+        GetRotatedImage(normalizedOriginalBallImg1, local_ball1, best_rotation_rounded, test_ball1_image);
 
         // We'll draw a center-dot on the final image here, but we're not going to re-use that image, so it's ok
         cv::Scalar color{ 0, 0, 0 };
@@ -3023,7 +3410,9 @@ namespace golf_sim {
 #ifdef __unix__ 
         // Save the final, rotated, normalized ball result image to the webserver shared directory so that the user
         // can compare them to the original normalized images.
-        GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultBallRotatedByBestAngles, test_ball1_image);
+        if (save_result_images) {
+            GsUISystem::SaveWebserverImage(GsUISystem::kWebServerResultBallRotatedByBestAngles, test_ball1_image);
+        }
 #endif
 
         // Looks like golf folks consider the X (side) spin to be positive if the surface is
@@ -3037,70 +3426,44 @@ namespace golf_sim {
 
 
 
-    // This structure is used as a callback for the OpenCV forEach() call.
-    // After first being setup, the operator() will be called in parallel across
-    // different processing cores.
-    struct ImgComparisonOp {
-        // Must be called prior to using the iteration() operator
-        static void setup(const cv::Mat* target_image,
-                          const cv::Mat* candidate_elements_mat,
-                          std::vector<RotationCandidate>* candidates,
-                          std::vector<std::string>* comparisonData ) {
-            ImgComparisonOp::comparisonData_ = comparisonData;
-            ImgComparisonOp::target_image_ = target_image;
-            ImgComparisonOp::candidate_elements_mat_ = candidate_elements_mat;
-            ImgComparisonOp::candidates_ = candidates;
-        }
+    // Everything that one call to CompareCandidateAngleImages needs in order to score its
+    // candidates.  Each call has its own context, so several spin analyses (e.g., for different
+    // ball pairs or different shots) can be scored at the same time.
+    struct SpinScoringContext {
+        const PackedBinaryImage* target_image = nullptr;
+        std::vector<RotationCandidate>* candidates = nullptr;
+        std::vector<std::string>* comparison_data = nullptr;
+    };
 
-        void operator ()(ushort& unusedValue, const int* position) const {
-            int x = position[0];
-            int y = position[1];
-            int z = position[2];
+    // Scores candidates [begin, end).  Each candidate is only touched by one thread.
+    static void ScoreRotationCandidates(const SpinScoringContext& context, const size_t begin, const size_t end) {
 
-            int elementIndex = (*candidate_elements_mat_).at<ushort>(x, y, z);
-            RotationCandidate& c = (*candidates_)[elementIndex];
+        for (size_t candidate_index = begin; candidate_index < end; candidate_index++) {
+            RotationCandidate& c = (*context.candidates)[candidate_index];
 
             // For DEBUG
             // std::string s = "Idx: " + std::to_string(c.index) +
             //   " Rot: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ") ";
             // GS_LOG_TRACE_MSG(trace, "Rotation Candidate: " + s);
-            // LoggingTools::DebugShowImage("Img #" + std::to_string(c.index), c.img);
 
             // Compare the second ball image to each of the rotated versions of the first ball image to see which is closest
-            cv::Vec2i results = BallImageProc::CompareRotationImage(*target_image_, c.img, c.index);
+            cv::Vec2i results = BallImageProc::CompareRotationImage(*context.target_image, c.packed_img, c.index);
             double scaledScore = (double)results[0] / (double)results[1];
-            
+
             // Save the calculated score for later analysis
             c.pixels_matching = results[0];
             c.pixels_examined = results[1];
             c.score = scaledScore;
 
-            // GS_LOG_TRACE_MSG(trace, "I=" + std::to_string(elementIndex) + ", Rot: (" + std::to_string(c.x_rotation_degrees) + ", " + std::to_string(c.y_rotation_degrees) + ", " + std::to_string(c.z_rotation_degrees) + ") " + ".Score : " + std::to_string(results[0]) + " out of " + std::to_string(results[1]) +
-            //    ". Scaled = " + std::to_string(scaledScore);
-
             // CSV (Excel) File format - Comma-Seperated-Values for Excel spreadsheet export
             // Columns are Idx, Rotx, Roty, Rotz, Score, Out-of, ScaledScore
             std::string s = std::to_string(c.index) + "\t" + std::to_string(c.x_rotation_degrees) + "\t" + std::to_string(c.y_rotation_degrees) + "\t" + std::to_string(c.z_rotation_degrees) + "\t" + std::to_string(results[0]) + "\t" + std::to_string(results[1]) +
                 "\t" + std::to_string(scaledScore) + "\n";
 
             // DEBUG - Save a CSV-compatible string for later analysis
-            (*comparisonData_)[c.index] = s;
+            (*context.comparison_data)[c.index] = s;
         }
-
-        static const cv::Mat* target_image_;
-        static const cv::Mat* candidate_elements_mat_;
-        static std::vector<std::string>* comparisonData_;
-        static std::vector<RotationCandidate>* candidates_;
-    };
-
-    // Complete storage for ImgComparisonOp struct
-    // Create temporary nonce objects because C++ requires references to point to a valid object.
-    // the null/nonce references will go out of scope after setup() is called and these references
-    // are set to valid objects
-    std::vector<std::string>* ImgComparisonOp::comparisonData_ = nullptr;
-    const cv::Mat* ImgComparisonOp::target_image_ = nullptr;
-    const cv::Mat* ImgComparisonOp::candidate_elements_mat_ = nullptr;
-    std::vector<RotationCandidate>* ImgComparisonOp::candidates_ = nullptr;
+    }
 
 
     // Returns the index within candidates that has the best comparison.
@@ -3123,24 +3486,35 @@ namespace golf_sim {
         std::vector<std::string> comparisonData(numCandidates);
 
 
-        // Iterate through the matrix of candidates
+        // The target is compared against every candidate, so pack it just once
+        PackedBinaryImage packed_target_image;
+        if (!packed_target_image.PackGrayImage(*target_image, kPixelIgnoreValue)) {
+            GS_LOG_MSG(error, "CompareCandidateAngleImages - could not pack the target image.");
+            return -1;
+        }
+
+        SpinScoringContext context;
+        context.target_image = &packed_target_image;
+        context.candidates = candidates;
+        context.comparison_data = &comparisonData;
 
-        ImgComparisonOp::setup(target_image, candidate_elements_mat, candidates, &comparisonData);
+        // Every element of the candidate_elements_mat is an index into candidates, so just score
+        // the candidates directly
+        const size_t number_candidates = std::min((size_t)numCandidates, candidates->size());
+
+        static GsMetricCounter& candidates_scored = GsMetrics::GetCounter("pitrac_spin_candidates_scored_total",
+            "Number of candidate ball rotations compared against the second ball image");
+        candidates_scored.Increment(number_candidates);
 
-        //  Serialized version for debugging
         if (kSerializeOpsForDebug) {
-            for (int x = 0; x < xSize; x++) {
-                for (int y = 0; y < ySize; y++) {
-                    for (int z = 0; z < zSize; z++) {
-                        ushort unusedValue = 0;
-                        int position[]{ x, y, z };
-                        ImgComparisonOp()(unusedValue, position);
-                    }
-                }
-            }
+            //  Serialized version for debugging
+            ScoreRotationCandidates(context, 0, number_candidates);
         }
         else {
-            (*candidate_elements_mat).forEach<ushort>(ImgComparisonOp());
+            const size_t chunk_size = (kSpinScoringChunkSize > 0) ? (size_t)kSpinScoringChunkSize : 16;
+            GsThreadPool::GetSharedPool().ParallelFor(number_candidates, chunk_size,
+                [&context](size_t begin, size_t end) { ScoreRotationCandidates(context, begin, end); },
+                (unsigned int)std::max(0, kSpinScoringThreads));
         }
 
         // Find the best candidate from the comparison results
@@ -3177,7 +3551,7 @@ namespace golf_sim {
         // a combined score
         for (auto& element : *candidates)
         {
-            RotationCandidate c = element;
+            const RotationCandidate& c = element;
 
             if (c.pixels_examined > maxPixelsExamined) {
                 maxPixelsExamined = c.pixels_examined;
@@ -3195,7 +3569,7 @@ namespace golf_sim {
 
         for (auto& element : *candidates)
         {
-            RotationCandidate c = element;
+            const RotationCandidate& c = element;
 
             low_count_penalty = std::pow((maxPixelsExamined - (double)c.pixels_examined) / kSpinLowCountDifferenceWeightingFactor,
                                 kSpinLowCountPenaltyPower) / kSpinLowCountPenaltyScalingFactor;
@@ -3279,6 +3653,284 @@ namespace golf_sim {
         return result;
     }
 
+    cv::Vec2i BallImageProc::CompareRotationImage(const PackedBinaryImage& img1, const PackedBinaryImage& img2, const int index) {
+
+        CV_Assert((img1.rows() == img2.rows() && img1.cols() == img2.cols()));
+
+        return PackedBinaryImage::Compare(img1, img2);
+    }
+
+    // Bilinearly samples a spin dimple image (whose pixels are 0, 255, or kPixelIgnoreValue) at a
+    // fractional position, leaving out any kPixelIgnoreValue neighbors.  Returns false if most of
+    // the neighborhood is ignored.  Indexes the image the same way (x is the first index) as projectionOp.
+    static bool SampleDimpleImageBilinear(const cv::Mat& dimple_image, const double x, const double y, double& value) {
+
+        const int x0 = (int)std::floor(x);
+        const int y0 = (int)std::floor(y);
+
+        if (x0 < 0 || y0 < 0 || x0 + 1 >= dimple_image.rows || y0 + 1 >= dimple_image.cols) {
+            return false;
+        }
+
+        const double fx = x - x0;
+        const double fy = y - y0;
+        const double weights[4] = { (1.0 - fx) * (1.0 - fy), (1.0 - fx) * fy, fx * (1.0 - fy), fx * fy };
+        const uchar pixels[4] = { dimple_image.at<uchar>(x0, y0), dimple_image.at<uchar>(x0, y0 + 1),
+                                  dimple_image.at<uchar>(x0 + 1, y0), dimple_image.at<uchar>(x0 + 1, y0 + 1) };
+
+        double total_weight = 0.0;
+        double weighted_sum = 0.0;
+
+        for (int i = 0; i < 4; i++) {
+            if (pixels[i] != kPixelIgnoreValue) {
+                total_weight += weights[i];
+                weighted_sum += weights[i] * pixels[i];
+            }
+        }
+
+        if (total_weight < 0.5) {
+            return false;
+        }
+
+        value = weighted_sum / total_weight;
+        return true;
+    }
+
+    double BallImageProc::ScoreContinuousRotation(const cv::Mat& base_dimple_image,
+                                                  const cv::Mat& target_dimple_image,
+                                                  const GolfBall& ball,
+                                                  const cv::Vec3d& rotation_angles_degrees,
+                                                  int& pixels_examined) {
+
+        CV_Assert((base_dimple_image.rows == target_dimple_image.rows && base_dimple_image.cols == target_dimple_image.cols));
+
+        // Same axes, order, and signs as the projectionOp used by Project2dImageTo3dBall
+        const double x_angle_rad = -CvUtils::DegreesToRadians(rotation_angles_degrees[0]);
+        const double y_angle_rad = CvUtils::DegreesToRadians(rotation_angles_degrees[1]);
+        const double z_angle_rad = CvUtils::DegreesToRadians(rotation_angles_degrees[2]);
+
+        const cv::Matx33d x_rotation(1, 0, 0,
+                                     0, cos(x_angle_rad), -sin(x_angle_rad),
+                                     0, sin(x_angle_rad), cos(x_angle_rad));
+        const cv::Matx33d y_rotation(cos(y_angle_rad), 0, sin(y_angle_rad),
+                                     0, 1, 0,
+                                     -sin(y_angle_rad), 0, cos(y_angle_rad));
+        const cv::Matx33d z_rotation(cos(z_angle_rad), -sin(z_angle_rad), 0,
+                                     sin(z_angle_rad), cos(z_angle_rad), 0,
+                                     0, 0, 1);
+
+        // Takes a point on the rotated ball back to where it was on the original ball
+        const cv::Matx33d inverse_rotation = (z_rotation * y_rotation * x_rotation).t();
+
+        const double r = ball.measured_radius_pixels_;
+        const double ball_center_x = ball.x();
+        const double ball_center_y = ball.y();
+
+        const int min_x = std::max(0, (int)std::floor(ball_center_x - r));
+        const int max_x = std::min(target_dimple_image.rows - 1, (int)std::ceil(ball_center_x + r));
+        const int min_y = std::max(0, (int)std::floor(ball_center_y - r));
+        const int max_y = std::min(target_dimple_image.cols - 1, (int)std::ceil(ball_center_y + r));
+
+        double total_agreement = 0.0;
+        pixels_examined = 0;
+
+        for (int x = min_x; x <= max_x; x++) {
+            const uchar* target_row = target_dimple_image.ptr<uchar>(x);
+
+            for (int y = min_y; y <= max_y; y++) {
+                const uchar target_pixel = target_row[y];
+
+                if (target_pixel == kPixelIgnoreValue) {
+                    continue;
+                }
+
+                const double x_from_center = x - ball_center_x;
+                const double y_from_center = y - ball_center_y;
+                const double z_squared = r * r - x_from_center * x_from_center - y_from_center * y_from_center;
+
+                if (z_squared <= 0.0) {
+                    continue;
+                }
+
+                const cv::Vec3d original_point = inverse_rotation * cv::Vec3d(x_from_center, y_from_center, std::sqrt(z_squared));
+
+                // Points that came from the far side of the ball were never seen in the first image
+                if (original_point[2] <= 0.0) {
+                    continue;
+                }
+
+                double base_pixel = 0.0;
+                if (!SampleDimpleImageBilinear(base_dimple_image, original_point[0] + ball_center_x, original_point[1] + ball_center_y, base_pixel)) {
+                    continue;
+                }
+
+                pixels_examined++;
+                total_agreement += 1.0 - std::abs((double)target_pixel - base_pixel) / 255.0;
+            }
+        }
+
+        return (pixels_examined > 0) ? total_agreement / pixels_examined : 0.0;
+    }
+
+    bool BallImageProc::RefineBallRotation(const cv::Mat& base_dimple_image,
+                                           const cv::Mat& target_dimple_image,
+                                           const GolfBall& ball,
+                                           const RotationCandidate& coarse_best_candidate,
+                                           const RotationSearchSpace& coarse_search_space,
+                                           cv::Vec3d& refined_rotation,
+                                           double& refined_score) {
+
+        // The initial simplex alone needs four evaluations
+        if (kSpinRefinementMaxEvaluations < 4) {
+            GS_LOG_MSG(warning, "RefineBallRotation - kSpinRefinementMaxEvaluations must be at least 4.");
+            return false;
+        }
+
+        boost::timer::cpu_timer timer1;
+
+        const cv::Vec3d start_rotation(coarse_best_candidate.x_rotation_degrees,
+                                       coarse_best_candidate.y_rotation_degrees,
+                                       coarse_best_candidate.z_rotation_degrees);
+
+        // The best rotation should be no further than one coarse increment from the coarse winner
+        const cv::Vec3d coarse_increment(std::max(1, coarse_search_space.anglex_rotation_degrees_increment),
+                                         std::max(1, coarse_search_space.angley_rotation_degrees_increment),
+                                         std::max(1, coarse_search_space.anglez_rotation_degrees_increment));
+        const cv::Vec3d lower_bound = start_rotation - coarse_increment;
+        const cv::Vec3d upper_bound = start_rotation + coarse_increment;
+
+        // Same low-pixel-count penalty as CompareCandidateAngleImages, relative to the
+        // number of pixels that could be compared at the coarse winner
+        const double kSpinLowCountPenaltyPower = 2.0;
+        const double kSpinLowCountPenaltyScalingFactor = 1000.0;
+        const double kSpinLowCountDifferenceWeightingFactor = 500.0;
+
+        struct SimplexVertex {
+            cv::Vec3d rotation;
+            double score = 0.0;
+            // Lower is better
+            double cost = 0.0;
+        };
+
+        int number_evaluations = 0;
+        int reference_pixels_examined = -1;
+
+        auto evaluate = [&](const cv::Vec3d& rotation) {
+            SimplexVertex vertex;
+
+            for (int axis = 0; axis < 3; axis++) {
+                vertex.rotation[axis] = std::clamp(rotation[axis], lower_bound[axis], upper_bound[axis]);
+            }
+
+            int pixels_examined = 0;
+            vertex.score = ScoreContinuousRotation(base_dimple_image, target_dimple_image, ball, vertex.rotation, pixels_examined);
+            number_evaluations++;
+
+            if (reference_pixels_examined < 0) {
+                reference_pixels_examined = pixels_examined;
+            }
+
+            const double low_count_penalty = std::pow(std::max(0, reference_pixels_examined - pixels_examined) / kSpinLowCountDifferenceWeightingFactor,
+                                                      kSpinLowCountPenaltyPower) / kSpinLowCountPenaltyScalingFactor;
+            vertex.cost = -((vertex.score * 10.) - low_count_penalty);
+
+            return vertex;
+        };
+
+        // The initial simplex spans half a coarse increment on each axis
+        std::array<SimplexVertex, 4> simplex;
+        simplex[0] = evaluate(start_rotation);
+
+        if (reference_pixels_examined <= 0) {
+            GS_LOG_MSG(warning, "RefineBallRotation - no pixels could be compared at the coarse rotation.");
+            return false;
+        }
+
+        for (int axis = 0; axis < 3; axis++) {
+            cv::Vec3d rotation = start_rotation;
+            rotation[axis] += coarse_increment[axis] / 2.0;
+            simplex[axis + 1] = evaluate(rotation);
+        }
+
+        auto by_cost = [](const SimplexVertex& a, const SimplexVertex& b) { return a.cost < b.cost; };
+        auto can_evaluate = [&]() { return number_evaluations < kSpinRefinementMaxEvaluations; };
+
+        while (true) {
+            std::sort(simplex.begin(), simplex.end(), by_cost);
+
+            double simplex_size = 0.0;
+            for (int i = 1; i < 4; i++) {
+                for (int axis = 0; axis < 3; axis++) {
+                    simplex_size = std::max(simplex_size, std::abs(simplex[i].rotation[axis] - simplex[0].rotation[axis]));
+                }
+            }
+
+            if (simplex_size <= kSpinRefinementToleranceDegrees || !can_evaluate()) {
+                break;
+            }
+
+            const cv::Vec3d centroid = (simplex[0].rotation + simplex[1].rotation + simplex[2].rotation) / 3.0;
+            const SimplexVertex& worst = simplex[3];
+
+            const SimplexVertex reflected = evaluate(centroid + (centroid - worst.rotation));
+
+            if (reflected.cost < simplex[0].cost) {
+                if (can_evaluate()) {
+                    const SimplexVertex expanded = evaluate(centroid + 2.0 * (centroid - worst.rotation));
+                    simplex[3] = (expanded.cost < reflected.cost) ? expanded : reflected;
+                }
+                else {
+                    simplex[3] = reflected;
+                }
+            }
+            else if (reflected.cost < simplex[2].cost) {
+                simplex[3] = reflected;
+            }
+            else if (!can_evaluate()) {
+                // Out of evaluations, so keep whichever of the reflected and worst vertices is better
+                if (reflected.cost < worst.cost) {
+                    simplex[3] = reflected;
+                }
+            }
+            else {
+                // Contract toward whichever of the reflected and worst vertices is better
+                const bool outside = (reflected.cost < worst.cost);
+                const SimplexVertex contracted = evaluate(centroid + 0.5 * ((outside ? reflected.rotation : worst.rotation) - centroid));
+
+                if (contracted.cost < std::min(reflected.cost, worst.cost)) {
+                    simplex[3] = contracted;
+                }
+                else {
+                    // Shrink everything toward the best vertex, as far as the evaluations allow
+                    for (int i = 1; i < 4 && can_evaluate(); i++) {
+                        simplex[i] = evaluate(simplex[0].rotation + 0.5 * (simplex[i].rotation - simplex[0].rotation));
+                    }
+                }
+            }
+        }
+
+        refined_rotation = simplex[0].rotation;
+        refined_score = simplex[0].score;
+
+        static GsMetricCounter& refinement_evaluations = GsMetrics::GetCounter("pitrac_spin_refinement_evaluations_total",
+            "Number of ball rotations scored by the continuous spin refinement");
+        refinement_evaluations.Increment(number_evaluations);
+
+        GS_LOG_TRACE_MSG(trace, "RefineBallRotation refined (" + std::to_string(start_rotation[0]) + ", " + std::to_string(start_rotation[1]) + ", " +
+            std::to_string(start_rotation[2]) + ") to (" + std::to_string(refined_rotation[0]) + ", " + std::to_string(refined_rotation[1]) + ", " +
+            std::to_string(refined_rotation[2]) + ") with a score of " + std::to_string(refined_score) + " after " + std::to_string(number_evaluations) + " evaluations.");
+
+        timer1.stop();
+        boost::timer::cpu_times times = timer1.elapsed();
+        std::cout << "RefineBallRotation: ";
+        std::cout << std::fixed << std::setprecision(8)
+            << times.wall / 1.0e9 << "s wall, "
+            << times.user / 1.0e9 << "s user + "
+            << times.system / 1.0e9 << "s system.\n";
+
+        return true;
+    }
+
 
     cv::Mat BallImageProc::CreateGaborKernel(int ks, double sig, double th, double lm, double gm, double ps) {
 
@@ -3403,7 +4055,7 @@ namespace golf_sim {
         const int kernel_size, double sig, double lm, double th, double ps, double gm, float binary_threshold,
         int &white_percent  ) {
 
-        cv::Mat dest = cv::Mat::zeros(img_f32.rows, img_f32.cols, img_f32.type());
+        cv::Mat dest;
         cv::Mat accum = cv::Mat::zeros(img_f32.rows, img_f32.cols, img_f32.type());
         cv::Mat kernel;
 
@@ -3418,19 +4070,26 @@ namespace golf_sim {
             cv::max(accum, dest, accum);
         }
 
-        cv::Mat accumGray;
+        cv::Mat dimpleEdges(accum.rows, accum.cols, CV_8UC1);
 
-        // Convert from the 0.0 to 1.0 range into 0-255
-        accum.convertTo(accumGray, CV_8U, 255, 0);
+        // Convert from the 0.0 to 1.0 range into 0-255, threshold the image to either 0 or 255, and
+        // count the white pixels, all in one pass
+        const int edgeThresholdLow = (int)std::round(binary_threshold * 10.);
+        const uchar edgeThresholdHigh = 255;
+        int number_white_pixels = 0;
 
-        cv::Mat dimpleEdges = cv::Mat::zeros(accum.rows, accum.cols, accum.type());
+        for (int y = 0; y < accum.rows; y++) {
+            const float* accum_row = accum.ptr<float>(y);
+            uchar* edges_row = dimpleEdges.ptr<uchar>(y);
 
-        // Threshold the image to either 0 or 255
-        const int edgeThresholdLow = (int)std::round(binary_threshold * 10.);
-        const int edgeThresholdHigh = 255;
-        cv::threshold(accumGray, dimpleEdges, edgeThresholdLow, edgeThresholdHigh, cv::THRESH_BINARY);
+            for (int x = 0; x < accum.cols; x++) {
+                const bool is_edge = (cv::saturate_cast<uchar>(accum_row[x] * 255.f) > edgeThresholdLow);
+                edges_row[x] = is_edge ? edgeThresholdHigh : 0;
+                number_white_pixels += is_edge;
+            }
+        }
 
-        white_percent = (int)std::round(((double)cv::countNonZero(dimpleEdges) * 100.) / ((double)dimpleEdges.rows * dimpleEdges.cols));
+        white_percent = (int)std::round(((double)number_white_pixels * 100.) / ((double)dimpleEdges.rows * dimpleEdges.cols));
 
         return dimpleEdges;
     }
@@ -3521,7 +4180,8 @@ namespace golf_sim {
                     // The angles in the set of images we are building are angles calculated as if the ball was
                     // centered in the camera's image
                     c.index = vectorIndex;
-                    c.img = ball13DImage;
+                    // Only the packed form is kept.  The unpacked image is 8 bytes per pixel.
+                    c.packed_img.PackProjectedImage(ball13DImage, kPixelIgnoreValue);
                     c.x_rotation_degrees = x_rotation_degrees - xAngleOffset;
                     c.y_rotation_degrees = y_rotation_degrees - yAngleOffset;
                     c.z_rotation_degrees = z_rotation_degrees;
@@ -3575,21 +4235,18 @@ namespace golf_sim {
    }
 
    // The following struct is used as a callback for the OpenCV forEach() call.
-   // After first being setup, the operator() will be called in parallel across
-   // different processing cores.
+   // The operator() will be called in parallel across different processing cores.
+   // All of its state is per-instance (forEach copies the object), so that several
+   // projections can be in progress at the same time.
     struct projectionOp {
-        // Must be called prior to using the iteration() operator
-        static void setup(const GolfBall *currentBall,
-                          cv::Mat& projectedImg,
-                          const double& x_rotation_degreesAngleRad,
-                          const double& y_rotation_degreesAngleRad,
-                          const double& z_rotation_degreesAngleRad ) {
+        projectionOp(const GolfBall *currentBall,
+                     cv::Mat& projectedImg,
+                     const double& x_rotation_degreesAngleRad,
+                     const double& y_rotation_degreesAngleRad,
+                     const double& z_rotation_degreesAngleRad ) {
             currentBall_ = currentBall;
-            projectedImg_ = projectedImg;
-            // Copy the rows/cols from the image because openCV will not do so otherwise
-            // TBD - Kind of a hack
-            projectedImg_.rows = projectedImg.rows;
-            projectedImg_.cols = projectedImg.cols;
+            // The rows/cols of the projected image have already been set by the caller.
+            projectedImg_ = &projectedImg;
             x_rotation_degreesAngleRad_ = x_rotation_degreesAngleRad;
             y_rotation_degreesAngleRad_ = y_rotation_degreesAngleRad;
             z_rotation_degreesAngleRad_ = z_rotation_degreesAngleRad;
@@ -3614,7 +4271,7 @@ namespace golf_sim {
         }
 
         // The returned imageXFromCenter and imageYFromCenter are the original imageX & Y in a new coordinate system with the center of the ball at (0,0)
-        static void getBallZ(const double imageX, const double imageY, double& imageXFromCenter, double& imageYFromCenter, double& ball3dZ) {
+        void getBallZ(const double imageX, const double imageY, double& imageXFromCenter, double& imageYFromCenter, double& ball3dZ) const {
             // Basic idea:  x2 + y2 + z2 = r2  (2's are squared).  Just solve for z where we can
 
             double r = currentBall_->measured_radius_pixels_;
@@ -3670,8 +4327,8 @@ namespace golf_sim {
                 // std::cout << "CV_ELEM_SIZE1(traits::Depth<_Tp>::value): " << CV_ELEM_SIZE1(projectedImg_.traits::Depth<_Tp>::value) << "elemSize1()" << projectedImg_.elemSize1() << std::endl;
                 // TBD - Not sure we even need to bother with this?
 
-                projectedImg_.at<cv::Vec2i>((int)imageX, (int)imageY)[0] = (int)ball3dZOfUnrotatedPoint;    // TBD - Wait, is this right?  Why change the Z??
-                projectedImg_.at<cv::Vec2i>((int)imageX, (int)imageY)[1] = kPixelIgnoreValue;
+                projectedImg_->at<cv::Vec2i>((int)imageX, (int)imageY)[0] = (int)ball3dZOfUnrotatedPoint;    // TBD - Wait, is this right?  Why change the Z??
+                projectedImg_->at<cv::Vec2i>((int)imageX, (int)imageY)[1] = kPixelIgnoreValue;
             }
 
 
@@ -3702,8 +4359,8 @@ namespace golf_sim {
             }
 
             // Shift back to coordinates with the origin in the top-left
-            imageX = imageXFromCenter + projectionOp::currentBall_->x();
-            imageY = imageYFromCenter + projectionOp::currentBall_->y();
+            imageX = imageXFromCenter + currentBall_->x();
+            imageY = imageYFromCenter + currentBall_->y();
 
             // Get the Z value of the destination, rotated-to point.
             double ball3dZOfRotatedPoint = 0;
@@ -3723,15 +4380,15 @@ namespace golf_sim {
             // and do absolutely nothing
             if (imageX >= 0 &&
                 imageY >= 0 &&
-                imageX < projectedImg_.cols &&
-                imageY < projectedImg_.rows &&
+                imageX < projectedImg_->cols &&
+                imageY < projectedImg_->rows &&
                 ball3dZOfRotatedPoint > 0.0) {
                     // The rotated-to point is on the visible surface of the hemisphere
 
                     // Instead of performing a zillion round operations, we'll just effectively floor (truncate)
                     // each x and y value.  We'll lose some accuracy, but if everything is floored, it should at least
                     // still be consistent.
-                    // projectedImg_.at<cv::Vec2i>((int)imageX, (int)imageY)[0] = (int)std::round(ball3dZOfRotatedPoint);
+                    // projectedImg_->at<cv::Vec2i>((int)imageX, (int)imageY)[0] = (int)std::round(ball3dZOfRotatedPoint);
 
                     int roundedImageX = (int)(imageX + 0.5);
                     int roundedImageY = (int)(imageY + 0.5);
@@ -3741,7 +4398,7 @@ namespace golf_sim {
 
                     // If the final, new pixel came from an invalid place, don't allow it to pollute the rotated image
                     // Not rounding here helped increase performance
-                    projectedImg_.at<cv::Vec2i>(roundedImageX, roundedImageY)[0] = (int)(ball3dZOfRotatedPoint);
+                    projectedImg_->at<cv::Vec2i>(roundedImageX, roundedImageY)[0] = (int)(ball3dZOfRotatedPoint);
 
                     /** TBD - DEBUG ONLY 
                     if (currentBall_->PointIsInsideBall(roundedImageX, roundedImageY) && pixelValue == kPixelIgnoreValue) {
@@ -3749,7 +4406,7 @@ namespace golf_sim {
                                     ", " + std::to_string(roundedImageY) + ").");
                     }
                     */
-                    projectedImg_.at<cv::Vec2i>(roundedImageX, roundedImageY)[1] = (prerotatedPointNotValid ? kPixelIgnoreValue : pixelValue);
+                    projectedImg_->at<cv::Vec2i>(roundedImageX, roundedImageY)[1] = (prerotatedPointNotValid ? kPixelIgnoreValue : pixelValue);
             }
             else {
                 /** TBD - DEBUG ONLY
@@ -3762,46 +4419,30 @@ namespace golf_sim {
         }
 
         // The ball information that we are currently operating with
-        // Null if not yet set
-        static const GolfBall* currentBall_;
+        const GolfBall* currentBall_ = nullptr;
 
-        // The 3D grayscale image we are working on
-        static cv::Mat projectedImg_;
+        // The 3D grayscale image we are working on.  Only the pixel data is written, which
+        // the pointer (unlike a const cv::Mat) allows from the const operator().
+        cv::Mat* projectedImg_ = nullptr;
 
         // The angles to rotate the Mat when we project it to 3D
-        static double x_rotation_degreesAngleRad_;
-        static double y_rotation_degreesAngleRad_;
-        static double z_rotation_degreesAngleRad_;
+        double x_rotation_degreesAngleRad_ = 0;
+        double y_rotation_degreesAngleRad_ = 0;
+        double z_rotation_degreesAngleRad_ = 0;
 
         // Precomputed trig results for rotation
-        static double sinX_;
-        static double cosX_;
-        static double sinY_;
-        static double cosY_;
-        static double sinZ_;
-        static double cosZ_;
-
-        static bool rotatingOnX_;
-        static bool rotatingOnY_;
-        static bool rotatingOnZ_;
+        double sinX_ = 0;
+        double cosX_ = 0;
+        double sinY_ = 0;
+        double cosY_ = 0;
+        double sinZ_ = 0;
+        double cosZ_ = 0;
+
+        bool rotatingOnX_ = true;
+        bool rotatingOnY_ = true;
+        bool rotatingOnZ_ = true;
     };
 
-    // Complete storage for projectionOp struct
-    const GolfBall* projectionOp::currentBall_ = NULL;
-    cv::Mat projectionOp::projectedImg_;
-    double projectionOp::x_rotation_degreesAngleRad_ = 0;
-    double projectionOp::y_rotation_degreesAngleRad_ = 0;
-    double projectionOp::z_rotation_degreesAngleRad_ = 0;
-    double projectionOp::sinX_ = 0;
-    double projectionOp::cosX_ = 0;
-    double projectionOp::sinY_ = 0;
-    double projectionOp::cosY_ = 0;
-    double projectionOp::sinZ_ = 0;
-    double projectionOp::cosZ_ = 0;
-    bool projectionOp::rotatingOnX_ = true;
-    bool projectionOp::rotatingOnY_ = true;
-    bool projectionOp::rotatingOnZ_ = true;
-
 
     // Positive X-axis angles rotate so that the ball appears to go from left to right
     // positive Y-axis angles move the ball from the top to the bottom
@@ -3819,13 +4460,13 @@ namespace golf_sim {
         projectedImg.rows = image_gray.rows;
         projectedImg.cols = image_gray.cols;
 
-        // Setup the global structures we need before we do the parallelized callback to process
+        // Setup the structure we need before we do the parallelized callback to process
         // the 2D image
-        projectionOp::setup(&ball, 
-                            projectedImg, 
-                            -(float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[0]),  /* Negative due to rotation in X axis being backward */
-                            (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[1]),
-                            (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[2])  );
+        const projectionOp projection_op(&ball, 
+                                         projectedImg, 
+                                         -(float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[0]),  /* Negative due to rotation in X axis being backward */
+                                         (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[1]),
+                                         (float)CvUtils::DegreesToRadians((double)rotation_angles_degrees[2])  );
 
         if (kSerializeOpsForDebug) {
             /*  Serialized version for debugging - use the parallel stuff below for release */
@@ -3843,13 +4484,13 @@ namespace golf_sim {
                     }
 
 
-                    projectionOp()(pixel, position);
+                    projection_op(pixel, position);
                 }
             }
         }
         else {
             // Parallel execution with function object.
-            image_gray.forEach<uchar>(projectionOp());
+            image_gray.forEach<uchar>(projection_op);
         }
 
         return projectedImg;
@@ -21,6 +21,9 @@
 #include "gs_camera.h"
 #include "colorsys.h"
 #include "golf_ball.h"
+#include "gs_clubs.h"
+#include "packed_binary_image.h"
+#include "image_prep_graph.h"
 
 
 namespace golf_sim {
@@ -32,7 +35,8 @@ const uchar kPixelIgnoreValue = 128;
 // Holds one potential rotated golf ball candidate image and associated data
 struct RotationCandidate {
     short index = 0;
-    cv::Mat img;
+    // The candidate's projected (rotated) ball image, packed to 1 bit per pixel for comparison
+    PackedBinaryImage packed_img;
     int x_rotation_degrees = 0; // All Rotations are in degrees
     int y_rotation_degrees = 0;
     int z_rotation_degrees = 0;
@@ -41,6 +45,24 @@ struct RotationCandidate {
     double score = 0;
 };
 
+// A ball that has been cut out of its full image for spin analysis.  The isolation does not
+// depend on which other ball this ball is paired with, so it can be shared between pairs.
+struct IsolatedSpinBall {
+    cv::Mat image;
+    // The ball, with its position and radius relative to the isolated image
+    GolfBall local_ball;
+};
+
+// What is already known about a shot when its spin is analyzed.  Used to narrow the
+// rotations that the spin analysis searches (see GsSpinSearchPlanner).
+struct SpinSearchHints {
+    double ball_speed_mph = 0.0;
+    double vla_deg = 0.0;
+    GolfSimClubs::GsClubType club_type = GolfSimClubs::GsClubType::kNotSelected;
+    // Between the two balls whose rotation is being found
+    double interval_uS = 0.0;
+};
+
 class BallImageProc
 {
 public:
@@ -58,6 +80,19 @@ public:
     static int kCoarseZRotationDegreesStart;
     static int kCoarseZRotationDegreesEnd;
 
+    // How many threads (including the caller) may score spin candidates for one
+    // CompareCandidateAngleImages call, and how many candidates each thread claims at a time.
+    // 0 threads means one per core.
+    static int kSpinScoringThreads;
+    static int kSpinScoringChunkSize;
+
+    // If true, the coarse spin rotation is refined by a continuous (Nelder-Mead) search instead
+    // of by a fine grid.  The search stops once its simplex is within the tolerance on every axis,
+    // or after the maximum number of rotations has been scored.
+    static bool kSpinRefinementUseContinuousOptimizer;
+    static double kSpinRefinementToleranceDegrees;
+    static int kSpinRefinementMaxEvaluations;
+
     static double kPlacedBallCannyLower;
     static double kPlacedBallCannyUpper;
     static double kPlacedBallStartingParam2;
@@ -148,6 +183,14 @@ public:
     static double kPlacedNarrowingRadiiDpParam;
     static double kPlacedNarrowingParam1;
 
+    // The pyramid (coarse-to-fine) search for a placed ball.  Candidates are found on an image
+    // that is downscaled by 2^kPlacedBallPyramidLevels, and then refined at full resolution.
+    static bool kPlacedBallUsePyramidSearch;
+    static int kPlacedBallPyramidLevels;
+    static int kPlacedBallPyramidMaxCandidates;
+    // Fewer levels are used if the smallest expected ball would be smaller than this in the coarse image
+    static int kPlacedBallPyramidMinCoarseRadius;
+
 
     static bool kLogIntermediateSpinImagesToFile;
     static double kPlacedBallHoughDpParam1;
@@ -265,10 +308,30 @@ public:
 
     // Inputs are two balls and the images within which those balls exist
     // Returns the estimated amount of rotation in x, y, and z axes in degrees
+    // If search_hints is not null, the rotation search is first narrowed to the rotations that
+    // are plausible for the shot (see GsSpinSearchPlanner).
     static cv::Vec3d GetBallRotation(const cv::Mat& full_gray_image1, 
                                     const GolfBall& ball1, 
                                     const cv::Mat& full_gray_image2, 
-                                    const GolfBall& ball2);
+                                    const GolfBall& ball2,
+                                    double* best_match_score = nullptr,
+                                    const SpinSearchHints* search_hints = nullptr);
+
+    static void IsolateSpinBall(const cv::Mat& full_gray_image, const GolfBall& ball, IsolatedSpinBall& isolated_ball);
+
+    // Same as above, but works from balls that have already been isolated.
+    // If best_match_score is not null, it is set to the fraction (0-1) of the compared pixels that
+    // matched (per CompareRotationImage) for the best rotation, rounded to whole degrees, or -1 if no
+    // rotation was found.  This is the same whether or not kSpinRefinementUseContinuousOptimizer is set.
+    // Set save_result_images to false when more than one rotation is being computed at the same
+    // time, so that the webserver and CSV output files are only written by one of them.
+    static cv::Vec3d GetBallRotation(const IsolatedSpinBall& isolated_ball1,
+                                    const GolfBall& ball1,
+                                    const IsolatedSpinBall& isolated_ball2,
+                                    const GolfBall& ball2,
+                                    double* best_match_score = nullptr,
+                                    const bool save_result_images = true,
+                                    const SpinSearchHints* search_hints = nullptr);
 
     static bool ComputeCandidateAngleImages(const cv::Mat& base_dimple_image, 
                                     const RotationSearchSpace& search_space, 
@@ -287,6 +350,29 @@ public:
 
     static cv::Vec2i CompareRotationImage(const cv::Mat& img1, const cv::Mat& img2, const int index = 0);
 
+    // Same result as above, but much faster.  Used for the spin candidate search.
+    static cv::Vec2i CompareRotationImage(const PackedBinaryImage& img1, const PackedBinaryImage& img2, const int index = 0);
+
+    // A smooth version of the comparison above for a (possibly fractional) rotation of base_dimple_image.
+    // Each pixel of target_dimple_image is traced back to where it came from on the rotated ball, and that
+    // place is bilinearly sampled, so the score changes gradually with the rotation angles.
+    // Returns the average agreement (0-1) of the pixels_examined pixels that could be compared.
+    static double ScoreContinuousRotation(const cv::Mat& base_dimple_image,
+                                          const cv::Mat& target_dimple_image,
+                                          const GolfBall& ball,
+                                          const cv::Vec3d& rotation_angles_degrees,
+                                          int& pixels_examined);
+
+    // Starting from the best coarse candidate, searches (within one coarse increment on each axis)
+    // for the rotation with the best ScoreContinuousRotation score.  Returns false on failure.
+    static bool RefineBallRotation(const cv::Mat& base_dimple_image,
+                                   const cv::Mat& target_dimple_image,
+                                   const GolfBall& ball,
+                                   const RotationCandidate& coarse_best_candidate,
+                                   const RotationSearchSpace& coarse_search_space,
+                                   cv::Vec3d& refined_rotation,
+                                   double& refined_score);
+
     static cv::Mat MaskAreaOutsideBall(cv::Mat& ball_image, const GolfBall& ball, float mask_reduction_factor, const cv::Scalar& maskValue = (255, 255, 255));
 
     static void GetRotatedImage(const cv::Mat& gray_2D_input_image, const GolfBall& ball, const cv::Vec3i rotation, cv::Mat& outputGrayImg);
@@ -308,6 +394,18 @@ public:
 
     bool PreProcessStrobedImage(cv::Mat& search_image, BallSearchMode search_mode);
 
+    // The image-preparation graph for the search mode.  Its buffers are kept from shot to shot.
+    static ImagePrepGraph& GetPrepGraph(const BallSearchMode search_mode);
+
+    // Finds placed-ball candidates on a downscaled copy of the (pre-edge-detection) gray search
+    // image, and then refines the best few at full resolution with DetermineBestCircle.
+    // The returned circles are in full-image coordinates, best first.  Returns false if the
+    // coarse search found nothing, in which case the caller should search at full resolution.
+    bool FindPlacedBallCandidatesWithPyramid(const cv::Mat& gray_search_image,
+                                             const cv::Rect& expected_ball_area,
+                                             bool choose_largest_final_ball,
+                                             std::vector<GsCircle>& circles);
+
 private:
 
     // When we create a candidate ball list, the elements of that list include not only 
@@ -352,6 +450,25 @@ private:
     // in the filtered_image.
     static void RemoveReflections(const cv::Mat& original_image, cv::Mat& filtered_image, const cv::Mat& mask);
 
+    // Sets reflection_mask to 255 wherever the original_image has (an expanded area around) a bright reflection
+    static void GetReflectionMask(const cv::Mat& original_image, cv::Mat& reflection_mask);
+
+    // The spin pre-processing of a Gabor-filtered dimple_image.  In one pass, and in place, sets the
+    // reflections in the ball_image and everything outside of the (reduced) ball circle to kPixelIgnoreValue.
+    static void MaskSpinDimpleImage(const cv::Mat& ball_image,
+                                    const GolfBall& ball,
+                                    const float mask_reduction_factor,
+                                    cv::Mat& dimple_image);
+
+    // Returns the [inside_start, inside_end) columns of row y that are within the circle, clipped to the image
+    static void GetCircleRowExtent(const int center_x,
+                                   const int center_y,
+                                   const int radius,
+                                   const int y,
+                                   const int image_width,
+                                   int& inside_start,
+                                   int& inside_end);
+
     // If prior_binary_threshold < 0, then there is no prior threshold and a new one will be determined and returns 
     // in the calibrated_binary_threshold variable.
     static cv::Mat ApplyGaborFilterToBall(const cv::Mat& img, const GolfBall& ball, float& calibrated_binary_threshold, float prior_binary_threshold = -1);
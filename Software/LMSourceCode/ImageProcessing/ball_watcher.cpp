@@ -21,6 +21,7 @@
 
 #include "logging_tools.h"
 #include "gs_globals.h"
+#include "gs_frame_monitor.h"
 
 namespace gs = golf_sim;
 
@@ -77,7 +78,12 @@ bool ball_watcher_event_loop(RPiCamEncoder &app, bool & motion_detected)
 		}
 
 
+		gs::GsFrameMonitor::RecordQueueDepth(app.GetMessageQueueDepth());
+
 		RPiCamEncoder::Msg msg = app.Wait();
+
+		gs::GsFrameMonitor::LogPeriodicSummary();
+
 		if (msg.type == RPiCamApp::MsgType::Timeout)
 		{
 			GS_LOG_MSG(error, "ERROR: Device timeout detected, attempting a restart!!!");
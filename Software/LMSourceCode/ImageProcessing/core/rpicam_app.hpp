@@ -147,6 +147,8 @@ public:
 
 	Msg Wait();
 	void PostMessage(MsgType &t, MsgPayload &p);
+	// The number of messages waiting to be handled
+	size_t GetMessageQueueDepth() { return msg_queue_.Size(); }
 
 	Stream *GetStream(std::string const &name, StreamInfo *info = nullptr) const;
 	Stream *ViewfinderStream(StreamInfo *info = nullptr) const;
@@ -218,6 +220,11 @@ private:
 			std::unique_lock<std::mutex> lock(mutex_);
 			queue_ = {};
 		}
+		size_t Size()
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			return queue_.size();
+		}
 
 	private:
 		std::queue<T> queue_;
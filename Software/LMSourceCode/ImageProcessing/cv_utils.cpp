@@ -220,6 +220,10 @@ namespace golf_sim {
         return (mps * 2.23694);
     }
 
+    double CvUtils::MPHToMetersPerSecond(double mph) {
+        return (mph / 2.23694);
+    }
+
     double CvUtils::MetersToYards(double m) {
         return (MetersToFeet(m) / 3.0);
     }
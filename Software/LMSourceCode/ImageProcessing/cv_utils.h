@@ -73,6 +73,7 @@ struct CvUtils
     static double MetersToInches(double m);
     static double InchesToMeters(double i);
     static double MetersPerSecondToMPH(double mps);
+    static double MPHToMetersPerSecond(double mph);
     static double MetersToYards(double m);
 
     static double GetDistance(const cv::Vec3d& location);
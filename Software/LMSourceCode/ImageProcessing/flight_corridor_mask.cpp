@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <cmath>
+
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_camera.h"
+#include "flight_corridor_mask.h"
+
+
+namespace golf_sim {
+
+    // The number of points sampled along each edge of the corridor
+    static const int kNumberTravelSamples = 16;
+
+    // The number of points used to approximate the outline of each sampled ball
+    static const int kNumberBallOutlinePoints = 12;
+
+
+    std::vector<double> FlightCorridorMask::GetCalibrationSignature(const GolfSimCamera& camera) {
+
+        const CameraHardware& hardware = camera.camera_hardware_;
+
+        return std::vector<double>{ (double)hardware.resolution_x_,
+                                    (double)hardware.resolution_y_,
+                                    (double)hardware.focal_length_,
+                                    (double)hardware.sensor_width_,
+                                    (double)hardware.sensor_height_,
+                                    hardware.camera_angles_[0],
+                                    hardware.camera_angles_[1],
+                                    GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters[0],
+                                    GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters[1],
+                                    GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters[2] };
+    }
+
+    bool FlightCorridorMask::IsBuiltFor(const GolfSimCamera& camera, const Parameters& parameters) const {
+        return !mask_.empty() && parameters_ == parameters && calibration_signature_ == GetCalibrationSignature(camera);
+    }
+
+    bool FlightCorridorMask::Build(const GolfSimCamera& camera, const Parameters& parameters) {
+
+        mask_.release();
+        bounding_rect_ = cv::Rect();
+
+        const CameraHardware& hardware = camera.camera_hardware_;
+
+        if (hardware.resolution_x_ <= 0 || hardware.resolution_y_ <= 0 || hardware.focal_length_ <= 0.0 || hardware.sensor_width_ <= 0.0) {
+            GS_LOG_MSG(error, "FlightCorridorMask::Build - camera is not calibrated.");
+            return false;
+        }
+
+        // The camera positions are relative to each camera, so move the teed ball into camera 2's frame
+        const cv::Vec3d teed_ball_position = parameters.teed_ball_position_meters - GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters;
+
+        const double launch_angles[] = { parameters.min_launch_angle_degrees, parameters.max_launch_angle_degrees };
+        const double side_angles[] = { -parameters.max_side_angle_degrees, parameters.max_side_angle_degrees };
+
+        mask_ = cv::Mat::zeros(hardware.resolution_y_, hardware.resolution_x_, CV_8UC1);
+
+        // The ball flies across camera 2's X axis, up the Y axis, and (with any side angle) along the Z axis.
+        // Each direction of travel gets its own (convex) corridor.
+        for (const double direction : { -1.0, 1.0 }) {
+
+            std::vector<cv::Point> corridor_points;
+
+            for (int sample = 0; sample <= kNumberTravelSamples; sample++) {
+
+                const double travel = parameters.max_travel_meters * sample / kNumberTravelSamples;
+
+                for (const double launch_angle : launch_angles) {
+                    for (const double side_angle : side_angles) {
+
+                        const cv::Vec3d position = teed_ball_position + cv::Vec3d(direction * travel,
+                                                                                  travel * std::tan(CvUtils::DegreesToRadians(launch_angle)),
+                                                                                  travel * std::tan(CvUtils::DegreesToRadians(side_angle)));
+                        cv::Point2d center;
+                        double distance;
+
+                        if (!GolfSimCamera::ComputePixelFromOrthoCamPerspective(camera, position, center, distance)) {
+                            continue;
+                        }
+
+                        // See ComputeDistanceToBallUsingRadius
+                        const double radius = parameters.ball_radius_margin_ratio * hardware.resolution_x_ * GolfBall::kBallRadiusMeters *
+                                              hardware.focal_length_ / (hardware.sensor_width_ * distance);
+
+                        for (int i = 0; i < kNumberBallOutlinePoints; i++) {
+                            const double angle = 2.0 * CV_PI * i / kNumberBallOutlinePoints;
+                            corridor_points.push_back(cv::Point((int)std::round(center.x + radius * std::cos(angle)),
+                                                                (int)std::round(center.y + radius * std::sin(angle))));
+                        }
+                    }
+                }
+            }
+
+            if (corridor_points.size() < 3) {
+                continue;
+            }
+
+            std::vector<cv::Point> hull;
+            cv::convexHull(corridor_points, hull);
+            cv::fillConvexPoly(mask_, hull, cv::Scalar(255));
+        }
+
+        bounding_rect_ = cv::boundingRect(mask_);
+
+        if (bounding_rect_.area() == 0) {
+            GS_LOG_MSG(warning, "FlightCorridorMask::Build - the flight corridor is entirely outside of the camera's view.");
+            mask_.release();
+            return false;
+        }
+
+        parameters_ = parameters;
+        calibration_signature_ = GetCalibrationSignature(camera);
+
+        GS_LOG_TRACE_MSG(trace, "FlightCorridorMask::Build - corridor bounding rectangle is (" + std::to_string(bounding_rect_.x) + ", " +
+            std::to_string(bounding_rect_.y) + ") " + std::to_string(bounding_rect_.width) + "x" + std::to_string(bounding_rect_.height) +
+            ", covering " + std::to_string((100.0 * cv::countNonZero(mask_)) / mask_.total()) + "% of the image.");
+
+        LoggingTools::DebugShowImage("FlightCorridorMask", mask_);
+
+        return true;
+    }
+
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Predicts where in the camera-2 image a hit ball can possibly be, given where the ball
+// was teed up and some bounds on how it can be launched.  The result is a mask (and its
+// bounding rectangle) that limits the strobed-ball Hough search to that flight corridor.
+//
+// The corridor is the convex hull of the ball's image at points along the extreme launch
+// directions, for a ball travelling either way across the frame (so that it works for
+// both left- and right-handed golfers).  The mask depends only on the calibration of the
+// camera and on the (quantized) teed-ball position, so it is built once and re-used
+// until one of those changes.
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+
+namespace golf_sim {
+
+    class GolfSimCamera;
+
+    class FlightCorridorMask {
+
+    public:
+
+        struct Parameters {
+            // Where the ball was teed up, in camera-1 ortho-camera-perspective meters
+            cv::Vec3d teed_ball_position_meters;
+
+            double min_launch_angle_degrees = 0.0;
+            double max_launch_angle_degrees = 0.0;
+            // Either side of straight down-range
+            double max_side_angle_degrees = 0.0;
+            // How far down-range (across the camera-2 frame) the corridor extends
+            double max_travel_meters = 0.0;
+            // The ball's image is enlarged by this ratio to allow for measurement error
+            double ball_radius_margin_ratio = 1.0;
+
+            bool operator==(const Parameters& other) const = default;
+        };
+
+        // Builds the mask for camera (camera 2).  Returns false if none of the corridor
+        // falls within the camera's image.
+        bool Build(const GolfSimCamera& camera, const Parameters& parameters);
+
+        // True if Build was last (successfully) called with the same parameters and camera calibration
+        bool IsBuiltFor(const GolfSimCamera& camera, const Parameters& parameters) const;
+
+        // 255 within the corridor, 0 elsewhere.  The same size as the camera's images.
+        const cv::Mat& GetMask() const { return mask_; }
+
+        const cv::Rect& GetBoundingRect() const { return bounding_rect_; }
+
+    protected:
+
+        // The camera values that the mask depends on
+        static std::vector<double> GetCalibrationSignature(const GolfSimCamera& camera);
+
+        Parameters parameters_;
+        std::vector<double> calibration_signature_;
+
+        cv::Mat mask_;
+        cv::Rect bounding_rect_;
+    };
+
+}
@@ -3,6 +3,9 @@
  * Copyright (C) 2022-2025, Verdant Consultants, LLC.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "gs_format_lib.h"
 #include "golf_ball.h"
 #include "logging_tools.h"
@@ -16,24 +19,21 @@ namespace golf_sim {
 // Use the hsv_range_finder utility in this same directory
 // Calibrate this dynamically when a ball is placed in a known position
 // static const std::map< BallColor, BallColorRange> BallHSVRangeDict;
-static std::map< GolfBall::BallColor, BallColorRange> BallHSVRangeDict;
+// This is built once, rather than per-GolfBall, so that constructing and destroying the
+// many temporary balls during ball detection does not re-allocate it.
+static std::map< GolfBall::BallColor, BallColorRange> BallHSVRangeDict = {
+    { GolfBall::BallColor::kWhite, BallColorRange(cv::Vec3b(30, 0, 100), cv::Vec3b(170, 100, 255), cv::Vec3b(90, 0, 255)) },
+    { GolfBall::BallColor::kOrange, BallColorRange(cv::Vec3b(0, 30, 80), cv::Vec3b(35, 255, 255), cv::Vec3b(5, 225, 222)) },   // Very touchy, much higher Hmax and things fail
+    { GolfBall::BallColor::kYellow, BallColorRange(cv::Vec3b(20, 50, 70), cv::Vec3b(70, 255, 255), cv::Vec3b(12, 123, 210)) },
+    { GolfBall::BallColor::kOpticGreen, BallColorRange(cv::Vec3b(10, 80, 130), cv::Vec3b(35, 165, 255), cv::Vec3b(20, 124, 208)) },
+    { GolfBall::BallColor::kUnknown, BallColorRange(cv::Vec3b(0, 0, 40), cv::Vec3b(180, 255, 255), cv::Vec3b(0, 0, 0)) }
+};
 
 double GolfBall::kBallRadiusMeters = 21.335e-3;
 
 
 void GolfBall::InitMembers()
 {
-    if (BallHSVRangeDict.size() == 0)
-    {
-        BallColorRange cr{ cv::Vec3b(30, 0, 100), cv::Vec3b(170, 100, 255), cv::Vec3b(90, 0, 255) };
-
-        BallHSVRangeDict[BallColor::kWhite] = BallColorRange(cv::Vec3b(30, 0, 100), cv::Vec3b(170, 100, 255), cv::Vec3b(90, 0, 255));
-        BallHSVRangeDict[BallColor::kOrange] = BallColorRange(cv::Vec3b(0, 30, 80), cv::Vec3b(35, 255, 255), cv::Vec3b(5, 225, 222));   // Very touchy, much higher Hmax and things fail
-        BallHSVRangeDict[BallColor::kYellow] = BallColorRange(cv::Vec3b(20, 50, 70), cv::Vec3b(70, 255, 255), cv::Vec3b(12, 123, 210));
-        BallHSVRangeDict[BallColor::kOpticGreen] = BallColorRange(cv::Vec3b(10, 80, 130), cv::Vec3b(35, 165, 255), cv::Vec3b(20, 124, 208));
-        BallHSVRangeDict[BallColor::kUnknown] = BallColorRange(cv::Vec3b(0, 0, 40), cv::Vec3b(180, 255, 255), cv::Vec3b(0, 0, 0));
-    }
-
     // All zero's signifies thaht there is no average color set yet
     average_color_ = (0, 0, 0);
     median_color_ = (0, 0, 0);
@@ -47,21 +47,11 @@ void GolfBall::InitMembers()
     angles_camera_ortho_perspective_ = cv::Vec2f(0, 0);
 }
 
-void GolfBall::DeInitMembers()
-{
-    BallHSVRangeDict.clear();
-}
-
 GolfBall::GolfBall() 
 {
     InitMembers();
 }
 
-GolfBall::~GolfBall()
-{
-    DeInitMembers();
-}
-
 void GolfBall::set_circle(const GsCircle& c){ 
     ball_circle_ = c;  
     x_ = (int)std::round(c[0]);
@@ -289,6 +279,35 @@ double GolfBall::PixelDistanceFromBall(const GolfBall& ball2) const {
     return distance;
 }
 
+GolfBallCandidate GolfBall::GetCandidate(const int index) const {
+    GolfBallCandidate candidate;
+    candidate.x = x_;
+    candidate.y = y_;
+    candidate.measured_radius_pixels = measured_radius_pixels_;
+    candidate.quality_ranking = quality_ranking;
+    candidate.index = index;
+    return candidate;
+}
+
+std::vector<GolfBallCandidate> GolfBall::GetCandidates(const std::vector<GolfBall>& balls) {
+    std::vector<GolfBallCandidate> candidates;
+    candidates.reserve(balls.size());
+
+    for (size_t i = 0; i < balls.size(); i++) {
+        candidates.push_back(balls[i].GetCandidate((int)i));
+    }
+
+    return candidates;
+}
+
+int GolfBall::GetConfidence() const {
+    if (spin_match_score_ < 0.0) {
+        return 5;
+    }
+
+    return (int)std::round(10.0 * std::clamp(spin_match_score_, 0.0, 1.0));
+}
+
 bool GolfBall::PointIsInsideBall(double x, double y) const {
     double x_distance = std::abs(CvUtils::CircleX(ball_circle_) - x);
     double y_distance = std::abs(CvUtils::CircleY(ball_circle_) - y);
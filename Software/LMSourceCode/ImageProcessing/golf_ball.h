@@ -12,6 +12,8 @@
 #include <map>
 #include <numbers>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <opencv2/core.hpp>
 #include <opencv2/core/matx.hpp>
 
@@ -53,6 +55,21 @@ struct BallColorRange {
 };
 
 
+// A small, trivially-copyable summary of a GolfBall.  Candidate balls are sorted, paired and
+// scored many times during strobed-ball analysis, and copying one of these is much cheaper than
+// copying the full GolfBall.  The index refers back to the GolfBall in whichever vector the
+// candidate was made from, so that the full ball is only copied once a ball is finally selected.
+struct GolfBallCandidate {
+    long x = 0;                         // Same as GolfBall::x()
+    long y = 0;                         // Same as GolfBall::y()
+    double measured_radius_pixels = 0.0;
+    uint quality_ranking = 0;
+    int index = -1;
+};
+
+static_assert(std::is_trivially_copyable_v<GolfBallCandidate>, "GolfBallCandidate must stay trivially copyable");
+
+
 class GolfBall {
 
 public:
@@ -137,6 +154,7 @@ public:
     double velocity_ = 0; // In m/s
     long time_between_ball_positions_for_velocity_uS_ = 0;
     long time_between_angle_measures_for_rpm_uS_ = 0;
+    double spin_match_score_ = -1.0;    // Fraction (0-1) of the compared pixels that matched for the spin.  -1 if not analyzed
 
     // This next variable may be important to help create a good colorMask that will remove unwanted parts
     // of the image while still preserving the likely ball portion of the iamge
@@ -150,8 +168,9 @@ public:
     cv::Vec2i search_area_center_;
     int search_area_radius_ = 0;
 
+    // The destructor is deliberately left implicit so that GolfBall keeps its (noexcept)
+    // move constructor and move assignment, and vectors of balls can be moved instead of copied.
     GolfBall();
-    ~GolfBall();
 
     // Again, we're moving away from using the ball color for processing in most instances
     GsColorTriplet GetBallLowerHSV(BallColor ball_color) const;
@@ -175,6 +194,16 @@ public:
 
     double PixelDistanceFromBall(const GolfBall& ball2) const;
 
+    // Returns 0 (no confidence) to 10 (as confident as the system can be) in the ball's
+    // results, based on how well the spin analysis matched.  Returns 5 if there was none.
+    int GetConfidence() const;
+
+    // Returns the lightweight summary of this ball.  index should be this ball's position
+    // in the vector that it came from.
+    GolfBallCandidate GetCandidate(const int index) const;
+
+    static std::vector<GolfBallCandidate> GetCandidates(const std::vector<GolfBall>& balls);
+
     static void AverageBalls(const std::vector<GolfBall>& ball_vector, GolfBall& averaged_ball);
 
     bool PointIsInsideBall(const double x, const double y) const;
@@ -184,9 +213,8 @@ private:
     long x_ = 0;                         // Position on screen.  In pixels in openCV coordinate system
     long y_ = 0;                         // In pixels in openCV coordinate system
 
-    // (De)Initialize any members -- called from (de)constructors.
+    // Initialize any members -- called from the constructor.
     void InitMembers();
-    void DeInitMembers();
 
 };
 }
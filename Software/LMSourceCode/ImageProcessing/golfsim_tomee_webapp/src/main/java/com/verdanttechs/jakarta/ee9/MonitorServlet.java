@@ -80,6 +80,8 @@ public class MonitorServlet extends HttpServlet {
 
     final static int kClubChangeToPutterControlMsgType = 1;
     final static int kClubChangeToDriverControlMsgType = 2;
+    // Asks the LM to re-read its .json configuration file before the next shot
+    final static int kReloadConfigurationControlMsgType = 3;
 
     public static class GsControlMessage {
         public GsClubType club_type_ = GsClubType.kNotSelected;
@@ -97,6 +99,32 @@ public class MonitorServlet extends HttpServlet {
         logger.info("SetClubType called with club type = " + String.valueOf(club));
         System.out.println("SetClubType called with club type = " + String.valueOf(club));
 
+        int control_msg_type = 0;
+
+        if (club == GsClubType.kPutter) {
+            control_msg_type = kClubChangeToPutterControlMsgType;
+        } else if (club == GsClubType.kIron) {
+            // TBD - Not yet supported
+        } else if (club == GsClubType.kDriver) {
+            control_msg_type = kClubChangeToDriverControlMsgType;
+        }
+
+        if (SendControlMessage(control_msg_type)) {
+            // Also set the current result object to have the same club type
+            current_result_.club_type_ = club;
+        }
+    }
+
+    public static void RequestConfigurationReload() {
+        logger.info("RequestConfigurationReload called.");
+        System.out.println("RequestConfigurationReload called.");
+
+        SendControlMessage(kReloadConfigurationControlMsgType);
+    }
+
+    // Sends a kControlMessage IPC message of the given type to the LM.  Returns false if
+    // the message could not be sent.
+    public static boolean SendControlMessage(int control_msg_type) {
         try {
             if (!producer_created) {
                 producer_connection_factory = new ActiveMQConnectionFactory(kWebActiveMQHostAddress);
@@ -123,16 +151,6 @@ public class MonitorServlet extends HttpServlet {
 
             MessageBufferPacker packer = MessagePack.newDefaultBufferPacker();
 
-            int control_msg_type = 0;
-
-            if (club == GsClubType.kPutter) {
-                control_msg_type = kClubChangeToPutterControlMsgType;
-            } else if (club == GsClubType.kIron) {
-                // TBD - Not yet supported
-            } else if (club == GsClubType.kDriver) {
-                control_msg_type = kClubChangeToDriverControlMsgType;
-            }
-
             packer
                     .packInt(control_msg_type);
 
@@ -146,12 +164,11 @@ public class MonitorServlet extends HttpServlet {
 
             producer.send(bytesMessage);
 
-            // Also set the current result object to have the same club type
-            current_result_.club_type_ = club;
-
+            return true;
             }
             catch (Exception e) {
-                logger.error("Exception publishing changed club event", e);
+                logger.error("Exception publishing control message of type " + String.valueOf(control_msg_type), e);
+                return false;
             }
     }
 
@@ -402,6 +419,7 @@ public class MonitorServlet extends HttpServlet {
                     "<input type=\"submit\" name=\"P2\" value=\"P2\" style=\"font-family: 'Arial'; font-size:30px;\" />" +
                     "<input type=\"submit\" name=\"P3\" value=\"P3\" style=\"font-family: 'Arial'; font-size:30px;\" />" +
                     "<input type=\"submit\" name=\"P4\" value=\"P4\" style=\"font-family: 'Arial'; font-size:30px;\" />" +
+                    "<input type=\"submit\" name=\"reload_config\" value=\"Reload Config\" style=\"font-family: 'Arial'; font-size:30px;\" />" +
                     " </form>";
             request.setAttribute("control_buttons", control_buttons_str);
 
@@ -687,6 +705,8 @@ public class MonitorServlet extends HttpServlet {
             SetCurrentClubType(GsClubType.kPutter);
         } else if (request.getParameter("driver") != null) {
             SetCurrentClubType(GsClubType.kDriver);
+        } else if (request.getParameter("reload_config") != null) {
+            RequestConfigurationReload();
         } else {
             System.out.println("doPost received unknown request parameter.");
         }
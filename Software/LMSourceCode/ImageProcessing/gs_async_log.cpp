@@ -0,0 +1,361 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gs_async_log.h"
+
+
+namespace golf_sim {
+
+    std::atomic<bool> GsAsyncLog::running_{ false };
+    std::atomic<int> GsAsyncLog::min_level_{ 0 };
+
+    // A single-producer (the owning thread), single-consumer (the drain thread) ring of
+    // records.  The head and tail only ever increase, and are reduced modulo the capacity
+    // to find a position in the buffer.  A record never wraps around the end of the buffer.
+    struct GsAsyncLogRing {
+        std::unique_ptr<uint8_t[]> buffer;
+        size_t capacity = 0;
+        uint32_t thread_index = 0;
+
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<uint64_t> tail{ 0 };
+
+        // Set when the owning thread exits, so that the ring can be discarded once drained
+        std::atomic<bool> abandoned{ false };
+    };
+
+    struct GsAsyncLogRingHolder {
+        std::shared_ptr<GsAsyncLogRing> ring;
+
+        ~GsAsyncLogRingHolder() {
+            if (ring != nullptr) {
+                ring->abandoned = true;
+            }
+        }
+    };
+
+    static std::mutex rings_mutex;
+    static std::vector<std::shared_ptr<GsAsyncLogRing>> rings;
+    static std::atomic<uint32_t> next_thread_index{ 0 };
+    static thread_local GsAsyncLogRingHolder thread_ring_holder;
+
+    static std::mutex start_stop_mutex;
+    static std::thread drain_thread;
+    static std::atomic<bool> stop_requested{ false };
+    static std::ofstream output_file;
+
+    static int echo_level = 3;
+    static std::function<void(int level, const std::string& text)> echo_function;
+
+    static std::atomic<uint64_t> number_records_written{ 0 };
+    static std::atomic<uint64_t> number_records_dropped{ 0 };
+
+    static constexpr size_t kDrainIdleSleepMs = 5;
+
+    static size_t PaddedRecordSize(const size_t unpadded_size) {
+        return (unpadded_size + 7) & ~(size_t)7;
+    }
+
+    static GsAsyncLogRing* GetThreadRing() {
+
+        if (thread_ring_holder.ring == nullptr) {
+            auto ring = std::make_shared<GsAsyncLogRing>();
+            ring->capacity = GsAsyncLog::kThreadRingBytes;
+            ring->buffer = std::make_unique<uint8_t[]>(ring->capacity);
+            ring->thread_index = next_thread_index++;
+
+            const std::lock_guard<std::mutex> lock(rings_mutex);
+            rings.push_back(ring);
+            thread_ring_holder.ring = ring;
+        }
+
+        return thread_ring_holder.ring.get();
+    }
+
+
+    bool GsAsyncLog::Start(const std::string& file_name,
+                           const int min_level,
+                           const int echo_min_level,
+                           std::function<void(int level, const std::string& text)> echo) {
+
+        const std::lock_guard<std::mutex> lock(start_stop_mutex);
+
+        if (running_) {
+            return true;
+        }
+
+        output_file.open(file_name, std::ios::binary | std::ios::trunc);
+
+        if (!output_file.is_open()) {
+            return false;
+        }
+
+        output_file.write(kFileMagic, sizeof(kFileMagic));
+
+        min_level_ = min_level;
+        echo_level = echo_min_level;
+        echo_function = std::move(echo);
+
+        stop_requested = false;
+        drain_thread = std::thread(DrainLoop);
+
+        static bool exit_handler_registered = false;
+
+        if (!exit_handler_registered) {
+            std::atexit(Stop);
+            exit_handler_registered = true;
+        }
+
+        running_ = true;
+
+        return true;
+    }
+
+    void GsAsyncLog::Stop() {
+
+        const std::lock_guard<std::mutex> lock(start_stop_mutex);
+
+        if (!running_) {
+            return;
+        }
+
+        // New records go back to the synchronous logs from here on
+        running_ = false;
+
+        stop_requested = true;
+
+        if (drain_thread.joinable()) {
+            drain_thread.join();
+        }
+
+        output_file.close();
+
+        if (echo_function) {
+            echo_function(2, "GsAsyncLog stopped.  Records written = " + std::to_string(number_records_written.load()) +
+                ", dropped = " + std::to_string(number_records_dropped.load()) + ".");
+        }
+    }
+
+    void GsAsyncLog::Write(const int level, const char* file, const int line, std::string_view message) {
+
+        GsAsyncLogRing* ring = GetThreadRing();
+
+        // Only the file's base name is kept
+        std::string_view file_name = (file != nullptr) ? std::string_view(file) : std::string_view();
+        const size_t last_separator = file_name.find_last_of("/\\");
+
+        if (last_separator != std::string_view::npos) {
+            file_name.remove_prefix(last_separator + 1);
+        }
+
+        file_name = file_name.substr(0, 255);
+        message = message.substr(0, kMaxMessageBytes);
+
+        const size_t record_size = PaddedRecordSize(sizeof(GsBinaryLogRecordHeader) + file_name.size() + message.size());
+
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+
+        size_t offset = (size_t)(tail % ring->capacity);
+        const size_t contiguous = ring->capacity - offset;
+        const size_t padding = (contiguous < record_size) ? contiguous : 0;
+
+        if (ring->capacity - (size_t)(tail - head) < record_size + padding) {
+            number_records_dropped++;
+            return;
+        }
+
+        uint64_t new_tail = tail;
+
+        if (padding > 0) {
+            // Every record size is a multiple of 8, so there is always room for the size and level
+            const uint32_t padding_size = (uint32_t)padding;
+            std::memcpy(ring->buffer.get() + offset, &padding_size, sizeof(padding_size));
+            ring->buffer[offset + offsetof(GsBinaryLogRecordHeader, level)] = kPaddingLevel;
+
+            new_tail += padding;
+            offset = 0;
+        }
+
+        GsBinaryLogRecordHeader header{};
+        header.record_size = (uint32_t)record_size;
+        header.level = (uint8_t)level;
+        header.file_name_length = (uint16_t)file_name.size();
+        header.line = (uint32_t)line;
+        header.thread_index = ring->thread_index;
+        header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        header.message_length = (uint32_t)message.size();
+
+        uint8_t* destination = ring->buffer.get() + offset;
+        std::memcpy(destination, &header, sizeof(header));
+        std::memcpy(destination + sizeof(header), file_name.data(), file_name.size());
+        std::memcpy(destination + sizeof(header) + file_name.size(), message.data(), message.size());
+
+        ring->tail.store(new_tail + record_size, std::memory_order_release);
+    }
+
+    bool GsAsyncLog::DrainAllRings() {
+
+        std::vector<std::shared_ptr<GsAsyncLogRing>> current_rings;
+        {
+            const std::lock_guard<std::mutex> lock(rings_mutex);
+            current_rings = rings;
+        }
+
+        bool drained_any = false;
+
+        for (const std::shared_ptr<GsAsyncLogRing>& ring : current_rings) {
+
+            uint64_t head = ring->head.load(std::memory_order_relaxed);
+            const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+
+            while (head < tail) {
+                const uint8_t* record = ring->buffer.get() + (size_t)(head % ring->capacity);
+
+                uint32_t record_size = 0;
+                std::memcpy(&record_size, record, sizeof(record_size));
+                const uint8_t level = record[offsetof(GsBinaryLogRecordHeader, level)];
+
+                if (level != kPaddingLevel) {
+                    output_file.write((const char*)record, record_size);
+                    number_records_written++;
+
+                    if (echo_function && level >= echo_level) {
+                        GsBinaryLogRecordHeader header;
+                        std::memcpy(&header, record, sizeof(header));
+
+                        // The text logs add their own time, thread and level
+                        const char* text = (const char*)record + sizeof(header) + header.file_name_length;
+                        echo_function(level, std::string(text, header.message_length));
+                    }
+                }
+
+                head += record_size;
+                drained_any = true;
+            }
+
+            ring->head.store(head, std::memory_order_release);
+
+            if (ring->abandoned && head == ring->tail.load(std::memory_order_acquire)) {
+                const std::lock_guard<std::mutex> lock(rings_mutex);
+                std::erase(rings, ring);
+            }
+        }
+
+        if (drained_any) {
+            output_file.flush();
+        }
+
+        return drained_any;
+    }
+
+    void GsAsyncLog::DrainLoop() {
+
+        while (!stop_requested) {
+            if (!DrainAllRings()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kDrainIdleSleepMs));
+            }
+        }
+
+        DrainAllRings();
+    }
+
+    uint64_t GsAsyncLog::GetNumberRecordsWritten() {
+        return number_records_written.load();
+    }
+
+    uint64_t GsAsyncLog::GetNumberRecordsDropped() {
+        return number_records_dropped.load();
+    }
+
+    bool GsAsyncLog::ReadFileHeader(std::istream& input) {
+        char magic[sizeof(kFileMagic)];
+
+        if (!input.read(magic, sizeof(magic))) {
+            return false;
+        }
+
+        return std::memcmp(magic, kFileMagic, sizeof(magic)) == 0;
+    }
+
+    bool GsAsyncLog::ReadRecord(std::istream& input,
+                                GsBinaryLogRecordHeader& header,
+                                std::string& file_name,
+                                std::string& message) {
+
+        if (!input.read((char*)&header, sizeof(header))) {
+            return false;
+        }
+
+        const size_t body_size = (size_t)header.record_size - sizeof(header);
+
+        if (header.record_size < sizeof(header) ||
+            header.message_length > kMaxMessageBytes ||
+            (size_t)header.file_name_length + header.message_length > body_size) {
+            return false;
+        }
+
+        std::string body(body_size, '\0');
+
+        if (!input.read(body.data(), body_size)) {
+            return false;
+        }
+
+        file_name.assign(body, 0, header.file_name_length);
+        message.assign(body, header.file_name_length, header.message_length);
+
+        return true;
+    }
+
+    std::string GsAsyncLog::FormatRecord(const GsBinaryLogRecordHeader& header,
+                                         std::string_view file_name,
+                                         std::string_view message,
+                                         const bool include_source_location) {
+
+        static const char* kLevelNames[] = { "trace", "debug", "info", "warning", "error", "fatal" };
+
+        const std::time_t seconds = (std::time_t)(header.timestamp_ns / 1000000000);
+        const long microseconds = (long)((header.timestamp_ns % 1000000000) / 1000);
+
+        std::tm local_time{};
+#ifdef __unix__
+        localtime_r(&seconds, &local_time);
+#else
+        localtime_s(&local_time, &seconds);
+#endif
+
+        char time_string[32];
+        std::strftime(time_string, sizeof(time_string), "%Y-%m-%d %H:%M:%S", &local_time);
+
+        char microsecond_string[8];
+        std::snprintf(microsecond_string, sizeof(microsecond_string), "%06ld", microseconds);
+
+        std::string s = "[" + std::string(time_string) + "." + microsecond_string + "] (" +
+            std::to_string(header.thread_index) + ") [" +
+            (header.level < 6 ? kLevelNames[header.level] : "unknown") + "] ";
+
+        if (include_source_location && !file_name.empty()) {
+            s += "[" + std::string(file_name) + ":" + std::to_string(header.line) + "] ";
+        }
+
+        s += message;
+
+        return s;
+    }
+
+}
@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// An asynchronous, binary back-end for the GS_LOG_MSG and GS_LOG_TRACE_MSG macros.
+//
+// When it is running (--binary_log_file=<file>), each log call only copies a small binary
+// record (time, thread, level, source file/line, and the message text) into a lock-free ring
+// buffer that belongs to the calling thread.  A background thread drains the rings into
+// the binary log file, and echoes just the more-important records (warnings and above, by
+// default) to the normal text logs.  If a thread's ring is full, its record is
+// dropped (and counted) rather than making the thread wait.
+//
+// The binary log is turned back into text by the pitrac_log_decoder tool (gs_log_decoder.cpp).
+//
+// Independently of the back-end, any log level below GS_LOG_COMPILE_MIN_LEVEL (set by the
+// log_compile_min_level build option) is compiled out of the macros entirely.
+//
+// This module does not depend on boost or OpenCV so that the decoder can be built alone.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// 0 = trace, 1 = debug, 2 = info, 3 = warning, 4 = error, 5 = fatal, as in boost::log::trivial
+#ifndef GS_LOG_COMPILE_MIN_LEVEL
+#define GS_LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+
+namespace golf_sim {
+
+    // The on-disk (and in-ring) layout of each record.  The file name and then the message
+    // text follow the header, and each record is padded to a multiple of 8 bytes.
+    struct GsBinaryLogRecordHeader {
+        uint32_t record_size;
+        uint8_t level;
+        uint8_t reserved;
+        uint16_t file_name_length;
+        uint32_t line;
+        uint32_t thread_index;
+        int64_t timestamp_ns;       // Since the system-clock epoch
+        uint32_t message_length;
+        uint32_t reserved2;
+    };
+
+    class GsAsyncLog {
+
+    public:
+
+        static constexpr char kFileMagic[8] = { 'G', 'S', 'B', 'L', 'O', 'G', '0', '1' };
+
+        // Used for the filler record at the end of a ring when the next record does not fit
+        static constexpr uint8_t kPaddingLevel = 0xFF;
+
+        static constexpr size_t kThreadRingBytes = 1 << 20;
+
+        // The largest message that will be kept.  Longer messages are truncated.
+        static constexpr size_t kMaxMessageBytes = 16 * 1024;
+
+        static constexpr bool IsCompiledIn(const int level) {
+            return level >= GS_LOG_COMPILE_MIN_LEVEL;
+        }
+
+        // Starts the background thread and opens the binary log file.  Records below
+        // min_level are not logged, and the messages of records at or above echo_level
+        // are also passed to the echo function.
+        static bool Start(const std::string& file_name,
+                          const int min_level,
+                          const int echo_level,
+                          std::function<void(int level, const std::string& text)> echo);
+
+        // Drains all of the rings and closes the file.  Also called at exit.
+        static void Stop();
+
+        static bool IsRunning() {
+            return running_.load(std::memory_order_relaxed);
+        }
+
+        static bool IsLevelEnabled(const int level) {
+            return level >= min_level_.load(std::memory_order_relaxed);
+        }
+
+        static void Write(const int level, const char* file, const int line, std::string_view message);
+
+        // Lets the macros accept anything that the boost log stream would have
+        static std::string_view ToLogText(const std::string& message) { return message; }
+        static std::string_view ToLogText(const char* message) { return message; }
+        static std::string_view ToLogText(std::string_view message) { return message; }
+
+        template <typename T>
+        static std::string ToLogText(const T& message) {
+            std::ostringstream s;
+            s << message;
+            return s.str();
+        }
+
+        static uint64_t GetNumberRecordsWritten();
+        static uint64_t GetNumberRecordsDropped();
+
+        // Used by the decoder.  Returns false at the end of the file or on a corrupt record.
+        static bool ReadFileHeader(std::istream& input);
+        static bool ReadRecord(std::istream& input,
+                               GsBinaryLogRecordHeader& header,
+                               std::string& file_name,
+                               std::string& message);
+
+        // Formats a record the same way as the text logs:  [time] (thread) [level] message
+        static std::string FormatRecord(const GsBinaryLogRecordHeader& header,
+                                        std::string_view file_name,
+                                        std::string_view message,
+                                        const bool include_source_location = false);
+
+    protected:
+
+        static void DrainLoop();
+        static bool DrainAllRings();
+
+        static std::atomic<bool> running_;
+        static std::atomic<int> min_level_;
+    };
+
+}
@@ -13,6 +13,7 @@
 
 
 
+#include <algorithm>
 #include <fstream>
 
 #include <boost/timer/timer.hpp>
@@ -22,6 +23,9 @@
 
 #include "gs_config.h"
 #include "pulse_strobe.h"
+#include "gs_shot_capture.h"
+#include "gs_shot_store.h"
+#include "gs_spin_search_planner.h"
 
 #include "gs_automated_testing.h"
 
@@ -320,7 +324,9 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
             continue;
         }
 
-        // Run the test using whatever current .json configuration we have
+        // Run the test using whatever current .json configuration we have.
+        // Each test is analyzed on its own, without the spin history of the earlier ones.
+        GsSpinSearchPlanner::Reset();
 
         GolfBall result_ball;
         cv::Vec3d rotation_results;
@@ -419,6 +425,182 @@ bool GsAutomatedTesting::TestFinalShotResultData() {
 
 
 
+#ifdef __unix__
+bool GsAutomatedTesting::TestCapturedShots(const std::string& capture_dir) {
+
+    std::string kAutomatedTestResultsCSV;
+    GsResults tolerances;
+
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestResultsCSV", kAutomatedTestResultsCSV);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestToleranceBallSpeedMPH", tolerances.speed_mph_);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestToleranceHLA", tolerances.hla_deg_);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestToleranceVLA", tolerances.vla_deg_);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestToleranceBackSpin", tolerances.back_spin_rpm_);
+    GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestToleranceSideSpin", tolerances.side_spin_rpm_);
+
+    std::vector<std::string> capture_files;
+
+    try {
+        for (const fs::directory_entry& entry : fs::directory_iterator(capture_dir)) {
+            if (entry.path().extension().string() == GsShotCapture::kFileExtension) {
+                capture_files.push_back(entry.path().string());
+            }
+        }
+    }
+    catch (std::exception& ex) {
+        GS_LOG_MSG(error, "Could not read the capture directory " + capture_dir + " - " + ex.what());
+        return false;
+    }
+
+    // The file names start with the session and shot numbers, so this is the order they were taken in
+    std::sort(capture_files.begin(), capture_files.end());
+
+    if (capture_files.empty()) {
+        GS_LOG_MSG(error, "No shot captures were found in " + capture_dir + ".");
+        return false;
+    }
+
+    // The strobe profiles are needed, even though the intervals come from the captures
+    if (!PulseStrobe::InitGPIOSystem(nullptr /* Signal handler not needed here */)) {
+        GS_LOG_MSG(error, "Failed to InitGPIOSystem.");
+        return false;
+    }
+
+    uint64_t current_config_generation = 0;
+    const uint64_t current_config_hash = GsShotStore::Hash64(GsShotCapture::GetConfigurationJson(current_config_generation));
+
+    std::ofstream testing_results_csv_file(capture_dir + "/" + kAutomatedTestResultsCSV);
+    testing_results_csv_file << "Capture, Shot, Same Config, Live Speed (mph), Replay Speed (mph), Live VLA, Replay VLA, Live HLA, Replay HLA, "
+        "Live Back Spin, Replay Back Spin, Live Side Spin, Replay Side Spin, Test Result" << std::endl;
+
+    boost::timer::cpu_timer timer1;
+
+    int numTotalTests = 0;
+    int numTestsFailed = 0;
+    int numTestsReplayed = 0;
+
+    // Everything that a replay changes is put back afterward
+    const GolfSimClubs::GsClubType original_club_type = GolfSimClubs::GetCurrentClubType();
+    const int original_resolution_x_override = CameraHardware::resolution_x_override_;
+    const int original_resolution_y_override = CameraHardware::resolution_y_override_;
+    const std::vector<float> original_pulse_intervals_override = PulseStrobe::GetPulseIntervalsOverride();
+    const std::shared_ptr<const GsConfigurationSnapshot> live_configuration = GolfSimConfiguration::GetSnapshot();
+
+    for (const std::string& capture_file : capture_files) {
+
+        numTotalTests++;
+
+        GsShotCapture capture;
+
+        if (!capture.Read(capture_file)) {
+            GS_LOG_MSG(warning, "Could not read the shot capture " + capture_file + ".");
+            numTestsFailed++;
+            continue;
+        }
+
+        const cv::Mat& teed_ball_image = capture.GetFrame(GsShotCapture::FrameRole::kTeedBall);
+        const cv::Mat& strobed_image = capture.GetFrame(GsShotCapture::FrameRole::kStrobed);
+
+        if (teed_ball_image.empty() || strobed_image.empty()) {
+            GS_LOG_MSG(warning, "The shot capture " + capture_file + " does not have both a teed-ball and a strobed image.");
+            numTestsFailed++;
+            continue;
+        }
+
+        // Analyze the shot the way it was analyzed during live play
+        GolfSimClubs::SetCurrentClubType((GolfSimClubs::GsClubType)capture.club_type);
+        PulseStrobe::SetPulseIntervalsOverride(capture.pulse_intervals_ms);
+        CameraHardware::resolution_x_override_ = teed_ball_image.cols;
+        CameraHardware::resolution_y_override_ = teed_ball_image.rows;
+
+        const bool same_config = (capture.config_hash == current_config_hash);
+
+        // Replay with the configuration that the shot was taken with, starting from the live one each time
+        GolfSimConfiguration::RestoreSnapshot(live_configuration);
+
+        if (capture.configuration_json.empty()) {
+            GS_LOG_MSG(warning, "Shot capture " + capture_file + " has no configuration.  Replaying with the current configuration.");
+        }
+        else if (!GolfSimConfiguration::InstallSnapshotFromJson(capture.configuration_json)) {
+            GS_LOG_MSG(warning, "Could not use the configuration of shot capture " + capture_file + ".  Replaying with the current configuration.");
+        }
+        else if (!same_config) {
+            GS_LOG_MSG(info, "Shot capture " + capture_file + " was taken with a different configuration (generation " +
+                std::to_string(capture.config_generation) + ") than the current one.  Replaying with the captured configuration.");
+        }
+
+        // Each capture is analyzed on its own, without the spin history of the earlier ones
+        GsSpinSearchPlanner::Reset();
+
+        GolfBall result_ball;
+        cv::Vec3d rotation_results;
+        cv::Mat exposures_image;
+        std::vector<GolfBall> exposure_balls;
+
+        const bool processed = GolfSimCamera::ProcessReceivedCam2Image(teed_ball_image,
+                                                                       strobed_image,
+                                                                       capture.GetFrame(GsShotCapture::FrameRole::kPreImage),
+                                                                       result_ball,
+                                                                       rotation_results,
+                                                                       exposures_image,
+                                                                       exposure_balls);
+        numTestsReplayed++;
+
+        // A shot passes if it has the same outcome as it did live, and (if it was analyzed)
+        // results that are within the tolerances of the live results
+        bool test_passed = (processed == capture.has_results);
+        GsResults replay_results;
+
+        if (processed) {
+            replay_results = GsResults(result_ball);
+        }
+
+        if (processed && capture.has_results) {
+            test_passed = AbsResultsPass(replay_results.speed_mph_, capture.results.speed_mph_, (float)tolerances.speed_mph_) &&
+                AbsResultsPass(replay_results.hla_deg_, capture.results.hla_deg_, (float)tolerances.hla_deg_) &&
+                AbsResultsPass(replay_results.vla_deg_, capture.results.vla_deg_, (float)tolerances.vla_deg_) &&
+                AbsResultsPass(replay_results.back_spin_rpm_, capture.results.back_spin_rpm_, tolerances.back_spin_rpm_) &&
+                AbsResultsPass(replay_results.side_spin_rpm_, capture.results.side_spin_rpm_, tolerances.side_spin_rpm_);
+        }
+
+        if (!test_passed) {
+            GS_LOG_TRACE_MSG(info, "Shot capture " + capture_file + " - replay does not match live play.");
+            numTestsFailed++;
+        }
+
+        testing_results_csv_file << fs::path(capture_file).filename().string() << "," << capture.shot_number << ","
+            << (same_config ? "Y" : "N") << ","
+            << capture.results.speed_mph_ << "," << replay_results.speed_mph_ << ","
+            << capture.results.vla_deg_ << "," << replay_results.vla_deg_ << ","
+            << capture.results.hla_deg_ << "," << replay_results.hla_deg_ << ","
+            << capture.results.back_spin_rpm_ << "," << replay_results.back_spin_rpm_ << ","
+            << capture.results.side_spin_rpm_ << "," << replay_results.side_spin_rpm_ << ","
+            << (test_passed ? "PASS" : "FAIL") << std::endl;
+    }
+
+    PulseStrobe::SetPulseIntervalsOverride(original_pulse_intervals_override);
+    GolfSimClubs::SetCurrentClubType(original_club_type);
+    CameraHardware::resolution_x_override_ = original_resolution_x_override;
+    CameraHardware::resolution_y_override_ = original_resolution_y_override;
+    GolfSimConfiguration::RestoreSnapshot(live_configuration);
+
+    testing_results_csv_file.close();
+
+    GS_LOG_MSG(info, "Shot capture replay statistics:\nTotal Captures: " + std::to_string(numTotalTests) +
+        ".\nReplays Not Matching Live Play: " + std::to_string(numTestsFailed) + ".");
+
+    timer1.stop();
+    boost::timer::cpu_times times = timer1.elapsed();
+    std::cout << "TestCapturedShots timing: ";
+    std::cout << std::fixed << std::setprecision(8)
+        << times.wall / 1.0e9 << "s wall, "
+        << times.user / 1.0e9 << "s user + "
+        << times.system / 1.0e9 << "s system.\n";
+
+    return numTestsReplayed > 0;
+}
+#endif
+
 cv::Mat GsAutomatedTesting::UndistortImage(const cv::Mat& img, CameraHardware::CameraModel camera_model) {
     // Get a camera object just to be able to get the calibration values
     GolfSimCamera c;
@@ -62,6 +62,14 @@ namespace golf_sim {
 
         static bool TestFinalShotResultData();
 
+#ifdef __unix__
+        // Re-analyzes each shot capture (see gs_shot_capture.h) in the directory with the
+        // strobe intervals and club that it was taken with, and compares the results to the
+        // results from live play.  Writes the comparison to kAutomatedTestResultsCSV in the
+        // same directory.  Returns false if no captures could be replayed.
+        static bool TestCapturedShots(const std::string& capture_dir);
+#endif
+
         static void ConvertInchesToMeters(const cv::Vec3d& expectedPositionsInches, cv::Vec3d& expectedPositionsMeters);
 
         static bool ReadTestImages(const std::string& img_1_base_filename, 
@@ -4,6 +4,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 
 #include "gs_options.h"
 #include "ball_image_proc.h"
@@ -11,6 +12,9 @@
 #include "gs_ui_system.h"
 #include "gs_config.h"
 #include "gs_clubs.h"
+#include "ball_candidate_set.h"
+#include "gs_thread_pool.h"
+#include "gs_spin_search_planner.h"
 
 #include "libcamera_interface.h"
 
@@ -46,6 +50,16 @@ namespace golf_sim {
     double GolfSimCamera::kMaxDistanceFromTrajectory = 20.;
 
     int GolfSimCamera::kClosestBallPairEdgeBackoffPixels = 200;
+    int GolfSimCamera::kMaxSpinBallPairs = 1;
+    double GolfSimCamera::kMaxTrajectoryFitResidualMeters = 0.05;
+
+    bool GolfSimCamera::kUseFlightCorridorMask = true;
+    double GolfSimCamera::kFlightCorridorMinLaunchAngleDegrees = -5.0;
+    double GolfSimCamera::kFlightCorridorMaxLaunchAngleDegrees = 55.0;
+    double GolfSimCamera::kFlightCorridorMaxSideAngleDegrees = 25.0;
+    double GolfSimCamera::kFlightCorridorMaxTravelMeters = 1.0;
+    double GolfSimCamera::kFlightCorridorBallRadiusMarginRatio = 1.5;
+    double GolfSimCamera::kFlightCorridorPositionQuantizationMeters = 0.01;
 
     double GolfSimCamera::kMaxIntermediateBallRadiusChangePercent = 10.0;
     double GolfSimCamera::kMaxPuttingIntermediateBallRadiusChangePercent = 10.0;
@@ -117,11 +131,26 @@ namespace golf_sim {
     CameraHardware::CameraModel GolfSimCamera::kSystemSlot1CameraType = CameraHardware::CameraModel::PiGSCam6mmWideLens;
     CameraHardware::CameraModel GolfSimCamera::kSystemSlot2CameraType = CameraHardware::CameraModel::PiGSCam6mmWideLens;
 
+    StrobeRatioMatcher GolfSimCamera::strobe_ratio_matchers_[StrobeProfile::kNumberStrobeProfiles];
+    FlightCorridorMask GolfSimCamera::flight_corridor_mask_;
+
     BallImageProc* get_image_processor() {
         static BallImageProc* ip = nullptr;
+        static uint64_t ip_configuration_generation = 0;
+
+        // The BallImageProc constructor reads the image-processing constants, so it is re-built
+        // if the configuration has been reloaded since (which only happens between shots)
+        const uint64_t configuration_generation = GolfSimConfiguration::GetGeneration();
+
+        if (ip != nullptr && ip_configuration_generation != configuration_generation) {
+            GS_LOG_TRACE_MSG(trace, "get_image_processor - configuration was reloaded.  Re-creating the BallImageProc.");
+            delete ip;
+            ip = nullptr;
+        }
 
         if (ip == nullptr) {
             ip = new BallImageProc;
+            ip_configuration_generation = configuration_generation;
         }
 
         return ip;
@@ -155,6 +184,15 @@ namespace golf_sim {
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kMaxDistanceFromTrajectory", kMaxDistanceFromTrajectory);
 
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kClosestBallPairEdgeBackoffPixels", kClosestBallPairEdgeBackoffPixels);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kMaxSpinBallPairs", kMaxSpinBallPairs);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kMaxTrajectoryFitResidualMeters", kMaxTrajectoryFitResidualMeters);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kUseFlightCorridorMask", kUseFlightCorridorMask);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorMinLaunchAngleDegrees", kFlightCorridorMinLaunchAngleDegrees);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorMaxLaunchAngleDegrees", kFlightCorridorMaxLaunchAngleDegrees);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorMaxSideAngleDegrees", kFlightCorridorMaxSideAngleDegrees);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorMaxTravelMeters", kFlightCorridorMaxTravelMeters);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorBallRadiusMarginRatio", kFlightCorridorBallRadiusMarginRatio);
+        GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kFlightCorridorPositionQuantizationMeters", kFlightCorridorPositionQuantizationMeters);
         GolfSimConfiguration::SetConstant("gs_config.ball_exposure_selection.kMaxBallsToRetain", kMaxBallsToRetain);
         
         GolfSimConfiguration::SetConstant("gs_config.strobing.kStandardBallSpeedSlowdownPercentage", kStandardBallSpeedSlowdownPercentage);
@@ -236,28 +274,26 @@ namespace golf_sim {
             return false;
         }
 
-        // Get a copy of the input balls so that we can sort it ourselves.
-        std::vector<GolfBall> balls(input_balls);
+        // Sort lightweight copies of the input balls so that we don't have to copy the balls themselves.
+        std::vector<GolfBallCandidate> balls = GolfBall::GetCandidates(input_balls);
 
         // Sort by x-position, with the first balls being the left-most
-        std::sort(balls.begin(), balls.end(), [](const GolfBall& a, const GolfBall& b)
-            { return (a.x() < b.x()); });
-
-        LoggingTools::Trace("Sorted Balls: ", balls);
+        std::sort(balls.begin(), balls.end(), [](const GolfBallCandidate& a, const GolfBallCandidate& b)
+            { return (a.x < b.x); });
 
         // Counts the pairs of balls where the left ball is lower than the right ball
         int positive_slope_count = 0;
 
         for (int i = 0; i < (int)balls.size() - 1; i++) {
-            const GolfBall& ball1 = balls[i];
-            const GolfBall& ball2 = balls[i + 1];
+            const GolfBallCandidate& ball1 = balls[i];
+            const GolfBallCandidate& ball2 = balls[i + 1];
 
             // Don't compare concentric balls
-            if (ball1.x() == ball2.x() && ball1.y() == ball2.y()) {
+            if (ball1.x == ball2.x && ball1.y == ball2.y) {
                 continue;
             }
 
-            if (ball1.y() >= ball2.y()) {
+            if (ball1.y >= ball2.y) {
                 positive_slope_count++;
             }
             else {
@@ -1067,25 +1103,39 @@ namespace golf_sim {
                 return false;
             }
 
+            return ComputeXyzDistanceFromOrthoCamPerspective(camera, b1.x(), b1.y(), b1.distance_to_z_plane_from_lens_, distances);
+        }
+
+        bool GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective(const GolfSimCamera& camera,
+                                                                      const double x,
+                                                                      const double y,
+                                                                      const double distance_to_z_plane_from_lens,
+                                                                      cv::Vec3d& distances) {
+
+            if (std::abs(distance_to_z_plane_from_lens) <= 0.0001) {
+                LoggingTools::Warning("ComputeXyzDistanceFromOrthoCamPerspective called without a ball line-of-sight-distance");
+                return false;
+            }
+
             // First calculate the distances as if the camera was facing straight ahead toward 
             // the ball flight plane
 
-            double xFromCameraCenter = b1.x() - std::round(camera.camera_hardware_.resolution_x_ / 2.0);
-            double yFromCameraCenter = b1.y() - std::round(camera.camera_hardware_.resolution_y_ / 2.0);
+            double xFromCameraCenter = x - std::round(camera.camera_hardware_.resolution_x_ / 2.0);
+            double yFromCameraCenter = y - std::round(camera.camera_hardware_.resolution_y_ / 2.0);
 
             cv::Vec3d camera_perspective_distances;
 
             // Direct-to-ball-PLANE distance is already in real-world meters.   
             // However, we do not have the exact direct-to-ball distance due to the lens.
             // We will figure out the Z axis distance (which will generally be a little shorter) first.
-            double xDistanceFromCamCenter = convertXDistanceToMeters(camera, b1.distance_to_z_plane_from_lens_, xFromCameraCenter);
+            double xDistanceFromCamCenter = convertXDistanceToMeters(camera, distance_to_z_plane_from_lens, xFromCameraCenter);
             camera_perspective_distances[0] = xDistanceFromCamCenter;  // X distance, negative means to the left of the camera
             
-            double yDistanceFromCamCenter = convertYDistanceToMeters(camera, b1.distance_to_z_plane_from_lens_, yFromCameraCenter);
+            double yDistanceFromCamCenter = convertYDistanceToMeters(camera, distance_to_z_plane_from_lens, yFromCameraCenter);
 
-            camera_perspective_distances[1] = -yDistanceFromCamCenter;  // Y distance, positive is upward (smaller Y values)  // TBD - sqrt(pow(b1.distance_to_z_plane_from_lens_, 2) - pow(yDistanceFromCamCenter, 2));  // Y distance.  Positive values are above the camera center
+            camera_perspective_distances[1] = -yDistanceFromCamCenter;  // Y distance, positive is upward (smaller Y values)  // TBD - sqrt(pow(distance_to_z_plane_from_lens, 2) - pow(yDistanceFromCamCenter, 2));  // Y distance.  Positive values are above the camera center
 
-            camera_perspective_distances[2] = b1.distance_to_z_plane_from_lens_;// FOR NON_DIRECT sqrt(pow(b1.distance_to_z_plane_from_lens_, 2) - pow(xDistanceFromCamCenter, 2));  // Z distance.  Only positive values in front of camera
+            camera_perspective_distances[2] = distance_to_z_plane_from_lens;// FOR NON_DIRECT sqrt(pow(distance_to_z_plane_from_lens, 2) - pow(xDistanceFromCamCenter, 2));  // Z distance.  Only positive values in front of camera
 
             GS_LOG_TRACE_MSG(trace, "GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective computed camera_perspective_distances of: " +
                 std::to_string(camera_perspective_distances[0]) + ", " +
@@ -1106,8 +1156,8 @@ namespace golf_sim {
             // Positive X degrees is to the left looking out the camera
             // Negative Y degrees is tilting down looking out the camera
             cv::Vec2d deltaAnglesCameraPerspective;
-            deltaAnglesCameraPerspective[0] = -CvUtils::RadiansToDegrees(atan(camera_perspective_distances[0] / b1.distance_to_z_plane_from_lens_));
-            deltaAnglesCameraPerspective[1] = CvUtils::RadiansToDegrees(atan(camera_perspective_distances[1] / b1.distance_to_z_plane_from_lens_));
+            deltaAnglesCameraPerspective[0] = -CvUtils::RadiansToDegrees(atan(camera_perspective_distances[0] / distance_to_z_plane_from_lens));
+            deltaAnglesCameraPerspective[1] = CvUtils::RadiansToDegrees(atan(camera_perspective_distances[1] / distance_to_z_plane_from_lens));
 
             // Account for the angle of the camera, which will adjust the camera perspective angles
             // to the real-world orthogonal-to-the-LM-perspective polar coordinates.
@@ -1147,6 +1197,55 @@ namespace golf_sim {
             return true;
         }
 
+        bool GolfSimCamera::ComputePixelFromOrthoCamPerspective(const GolfSimCamera& camera,
+                                                                const cv::Vec3d& distances,
+                                                                cv::Point2d& pixel,
+                                                                double& distance_to_z_plane_from_lens) {
+
+            const CameraHardware& hardware = camera.camera_hardware_;
+
+            if (hardware.focal_length_ <= 0.0 || hardware.resolution_x_ <= 0 || hardware.resolution_y_ <= 0) {
+                return false;
+            }
+
+            // Undo each step of ComputeXyzDistanceFromOrthoCamPerspective, in reverse order
+            const double cartesian_x = distances[2];
+            const double cartesian_y = -distances[0];
+            const double cartesian_z = -distances[1];
+
+            const double p_rho = std::sqrt(cartesian_x * cartesian_x + cartesian_y * cartesian_y + cartesian_z * cartesian_z);
+
+            if (p_rho < 0.0001) {
+                return false;
+            }
+
+            const double theta_degrees = CvUtils::RadiansToDegrees(std::atan2(cartesian_y, cartesian_x));
+            const double phi_degrees = CvUtils::RadiansToDegrees(std::acos(cartesian_z / p_rho));
+
+            cv::Vec2d deltaAnglesCameraPerspective;
+            deltaAnglesCameraPerspective[0] = theta_degrees - hardware.camera_angles_[0];
+            deltaAnglesCameraPerspective[1] = (phi_degrees - 90.) - hardware.camera_angles_[1];
+
+            // Behind (or beside) the camera
+            if (std::abs(deltaAnglesCameraPerspective[0]) >= 90. || std::abs(deltaAnglesCameraPerspective[1]) >= 90.) {
+                return false;
+            }
+
+            const double xDistanceFromCamCenter = -std::tan(CvUtils::DegreesToRadians(deltaAnglesCameraPerspective[0])) * p_rho;
+            const double yDistanceFromCamCenter = -std::tan(CvUtils::DegreesToRadians(deltaAnglesCameraPerspective[1])) * p_rho;
+
+            // See convertXDistanceToMeters and convertYDistanceToMeters
+            const double halfWidthMeters = (p_rho / hardware.focal_length_) * (hardware.sensor_width_ / 2.0);
+            const double halfHeightMeters = (p_rho / hardware.focal_length_) * (hardware.sensor_height_ / 2.0);
+
+            pixel.x = (xDistanceFromCamCenter / halfWidthMeters) * (hardware.resolution_x_ / 2.0) + std::round(hardware.resolution_x_ / 2.0);
+            pixel.y = (yDistanceFromCamCenter / halfHeightMeters) * (hardware.resolution_y_ / 2.0) + std::round(hardware.resolution_y_ / 2.0);
+
+            distance_to_z_plane_from_lens = p_rho;
+
+            return true;
+        }
+
         // The delta angles are the angles between the two balls, in either the camera's position,
         // or, alternatively, the ball's position (i.e., looking down-range)
         bool GolfSimCamera::getXYDeltaAnglesBallPerspective(const cv::Vec3d& position_deltas_ball_perspective,
@@ -1478,12 +1577,8 @@ namespace golf_sim {
                 return;
             }
 
-            int original_number_balls = (int)balls.size();
-            int ball_to_delete = original_number_balls - 1;
-            for (int i = 0; i < original_number_balls - adjusted_max_balls_to_retain; i++) {
-                balls.erase(balls.begin() + ball_to_delete);
-                ball_to_delete--;
-            }
+            // The lowest-scoring balls are at the end
+            balls.resize(std::max(0, adjusted_max_balls_to_retain));
         }
 
 
@@ -1500,14 +1595,24 @@ namespace golf_sim {
             // We should never drop the <n> best balls
             uint kNumberHighQualityBallsToRetain_ = 2;
 
-            // Identify any balls that are outside the expected radius range by retaining them only in the initial ball vector
-            for (int i = (int)initial_balls.size() - 3; i >= 0; i--) {
-                double b1_radius = initial_balls[i].measured_radius_pixels_;
-                double b2_radius = initial_balls[i + 1].measured_radius_pixels_;
-                double b3_radius = initial_balls[i + 2].measured_radius_pixels_;
+            BallCandidateSet candidates(initial_balls);
+
+            // Identify any balls that are outside the expected radius range.  Removed balls are skipped
+            // over, so that each window is always three adjacent remaining balls.
+            for (int i = (int)candidates.Size() - 3; i >= 0; i--) {
+                const int middle = candidates.NextAlive(i);
+                const int right = (middle < 0) ? -1 : candidates.NextAlive(middle);
 
-                double middle_to_right_ball_proximity_pixels = initial_balls[i + 1].PixelDistanceFromBall(initial_balls[i + 2]);
-                double middle_to_left_ball_proximity_pixels = initial_balls[i].PixelDistanceFromBall(initial_balls[i + 1]);
+                if (!candidates.IsAlive(i) || right < 0) {
+                    continue;
+                }
+
+                double b1_radius = candidates.Radius(i);
+                double b2_radius = candidates.Radius(middle);
+                double b3_radius = candidates.Radius(right);
+
+                double middle_to_right_ball_proximity_pixels = candidates.PixelDistance(middle, right);
+                double middle_to_left_ball_proximity_pixels = candidates.PixelDistance(i, middle);
 
                 double  middle_to_right_distance_adjustment = (middle_to_right_ball_proximity_pixels / 150.0) / 100.0;
                 double  middle_to_left_distance_adjustment = (middle_to_left_ball_proximity_pixels / 150.0) / 100.0;
@@ -1517,12 +1622,12 @@ namespace golf_sim {
                     (b2_radius < (b1_radius * (1.0 - max_change_percent / 100. - middle_to_left_distance_adjustment)) &&
                         b2_radius < (b3_radius * (1.0 - max_change_percent / 100. - middle_to_right_distance_adjustment))) ) {
 
-                    if (initial_balls[i + 1].quality_ranking >= kNumberHighQualityBallsToRetain_) {
-                        GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i + 1) + " because it was too much smaller/larger than both adjacent balls.");
-                        initial_balls.erase(initial_balls.begin() + i + 1);
+                    if (candidates.QualityRanking(middle) >= kNumberHighQualityBallsToRetain_) {
+                        GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(middle) + " because it was too much smaller/larger than both adjacent balls.");
+                        candidates.Remove(middle);
                     }
                     else {
-                        GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls NOT removing ball " + std::to_string(i + 1) + " because although it was larger than both adjacent balls, it was a high-quality circle.");
+                        GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls NOT removing ball " + std::to_string(middle) + " because although it was larger than both adjacent balls, it was a high-quality circle.");
                     }
                     // Also, if the middle ball is already overlapping with the ball to the left,
                     // then it's likely that ALL the balls from the middle ball to the left-most
@@ -1541,10 +1646,10 @@ namespace golf_sim {
                         // The right-most ball shouldn't have changed in size this much when
                         // it hasn't moved very far.  Likely it's a mis-identification
                         if (right_radius_change > max_overlapped_ball_radius_change_ratio * left_radius_change) {
-                            if (initial_balls[i + 2].quality_ranking >= kNumberHighQualityBallsToRetain_ ||
+                            if (candidates.QualityRanking(right) >= kNumberHighQualityBallsToRetain_ ||
                                 preserve_high_quality_balls == false) {
-                                GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i + 2) + " because it was much larger/smaller than the ball it overlaps.");
-                                initial_balls.erase(initial_balls.begin() + i + 2);
+                                GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(right) + " because it was much larger/smaller than the ball it overlaps.");
+                                candidates.Remove(right);
                             }
                         }
                     }
@@ -1557,15 +1662,17 @@ namespace golf_sim {
                         // The left-most ball shouldn't have changed in size this much when
                         // it hasn't moved very far.  Likely it's a mis-identification
                         if (left_radius_change > max_overlapped_ball_radius_change_ratio * right_radius_change) {
-                            if (initial_balls[i].quality_ranking > kNumberHighQualityBallsToRetain_ - 1 ||
+                            if (candidates.QualityRanking(i) > kNumberHighQualityBallsToRetain_ - 1 ||
                                 preserve_high_quality_balls == false) {
                                 GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyRadiusChangeBalls removing ball " + std::to_string(i) + " because it was much larger/smaller than the ball it overlaps.");
-                                initial_balls.erase(initial_balls.begin() + i);
+                                candidates.Remove(i);
                             }
                         }
                     }
                 }
             }
+
+            candidates.CompactInto(initial_balls);
         }
 
 
@@ -1579,23 +1686,26 @@ namespace golf_sim {
                 return;
             }
 
+            BallCandidateSet candidates(initial_balls);
+
             // Identify any balls that are far from the projected trajectory
-            for (int i = (int)initial_balls.size() - 1; i >= 0; i--) {
-                GolfBall& b = initial_balls[i];
+            for (size_t i = 0; i < candidates.Size(); i++) {
 
                 // Don't both examining the two balls we're using to draw the trajectory line
-                if (b.quality_ranking == best_ball.quality_ranking ||
-                    b.quality_ranking == second_best_ball.quality_ranking ) {
+                if (candidates.QualityRanking(i) == best_ball.quality_ranking ||
+                    candidates.QualityRanking(i) == second_best_ball.quality_ranking ) {
                     continue;
                 }
 
-                double ball_distance = GetPerpendicularDistanceFromLine(b.x(), b.y(), best_ball.x(), best_ball.y(), second_best_ball.x(), second_best_ball.y());
+                double ball_distance = GetPerpendicularDistanceFromLine(candidates.PixelX(i), candidates.PixelY(i), best_ball.x(), best_ball.y(), second_best_ball.x(), second_best_ball.y());
 
                 if (ball_distance > max_distance_from_trajectory) {
                     // GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to it having off - trajectory distance of : " + std::to_string(ball_distance));
-                    initial_balls.erase(initial_balls.begin() + i);
+                    candidates.Remove(i);
                 }
             }
+
+            candidates.CompactInto(initial_balls);
         }
 
 
@@ -1608,28 +1718,37 @@ namespace golf_sim {
                 return;
             }
 
-            // Examine each of the search balls and remove any other balls that are both
-            // much worse in quality and nearby the search ball
+            // Examine each of the search balls and remove any later balls that are both
+            // much worse in quality and nearby the search ball.  A ball that has already been
+            // removed can still cause nearby, even-worse balls to be removed.
+            // Only the balls in the grid cells around each search ball need to be checked.
 
-            std::vector<GolfBall> balls_copy = initial_balls;
+            BallCandidateSet candidates(initial_balls, max_ball_proximity);
 
-            for (size_t outer_index = 0; outer_index < balls_copy.size(); outer_index++) {
+            for (size_t outer_index = 0; outer_index < candidates.Size(); outer_index++) {
 
-                GolfBall& current_ball = balls_copy[outer_index];
+                const double center_x = candidates.CenterX(outer_index);
+                const double center_y = candidates.CenterY(outer_index);
 
-                for (int i = (int)initial_balls.size() - 1; i > (int)outer_index; i--) {
-                    GolfBall& b = initial_balls[i];
+                candidates.ForEachAliveInBox(center_x - max_ball_proximity, center_x + max_ball_proximity,
+                                             center_y - max_ball_proximity, center_y + max_ball_proximity,
+                                             [&](const int i) {
+                    if (i <= (int)outer_index) {
+                        return;
+                    }
 
-                    double ball_distance = current_ball.PixelDistanceFromBall(b);
-                    int quality_difference = b.quality_ranking - current_ball.quality_ranking;
+                    double ball_distance = candidates.PixelDistance(outer_index, i);
+                    int quality_difference = candidates.QualityRanking(i) - candidates.QualityRanking(outer_index);
 
                     if (ball_distance < max_ball_proximity && quality_difference > max_quality_difference) {
                         GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to its proximity of : " 
-                                    + std::to_string(ball_distance) + " and poor quality of " + std::to_string(b.quality_ranking));
-                        initial_balls.erase(initial_balls.begin() + i);
+                                    + std::to_string(ball_distance) + " and poor quality of " + std::to_string(candidates.QualityRanking(i)));
+                        candidates.Remove(i);
                     }
-                }
+                });
             }
+
+            candidates.CompactInto(initial_balls);
         }
 
         uint GolfSimCamera::RemoveOverlappingBalls(const std::vector<GolfBall>& initial_balls, 
@@ -1804,18 +1923,21 @@ namespace golf_sim {
             int min_strobed_ball_radius = int(expected_best_ball.measured_radius_pixels_ * kMinStrobedBallRadiusRation);
             int max_strobed_ball_radius = int(expected_best_ball.measured_radius_pixels_ * kMaxStrobedBallRadiusRation);
 
+            BallCandidateSet candidates(initial_balls);
+
             // Identify any balls that are outside the expected radius range by retaining them only in the initial ball vector
-            for (int i = (int)initial_balls.size() - 1; i >= 0 ;i--) {
-                GolfBall& b = initial_balls[i];
+            for (size_t i = 0; i < candidates.Size(); i++) {
 
-                double radius = b.measured_radius_pixels_;
+                double radius = candidates.Radius(i);
 
                 if (radius < min_strobed_ball_radius ||
                     radius > max_strobed_ball_radius) {
                     GS_LOG_TRACE_MSG(trace, "  Not analyzing found ball due to it having radius = {" + std::to_string(radius));
-                    initial_balls.erase(initial_balls.begin() + i);
+                    candidates.Remove(i);
                 }
             }
+
+            candidates.CompactInto(initial_balls);
         }
 
         void GolfSimCamera::DetermineSecondBall(std::vector<GolfBall>& return_balls, 
@@ -1857,46 +1979,58 @@ namespace golf_sim {
             // near another high-quality ball (e.g., position 1), but the second ball is a mistake and is
             // at a weird angle below/above the higher-quality ball.
 
-            std::vector<GolfBall> balls_copy = initial_balls;
+            // Only balls within kUnlikelyAngleMinimumDistancePixels (in X) of each other are compared,
+            // so the grid lets us skip everything else.
+            BallCandidateSet candidates(initial_balls, kUnlikelyAngleMinimumDistancePixels);
 
-            // This index should point to the highest-quality ball
-            size_t outer_index = 0;
+            // This index should point to the highest-quality ball.  Each remaining ball is compared
+            // with the remaining balls after it.
+            for (int outer_index = 0; outer_index >= 0 && candidates.NextAlive(outer_index) >= 0; outer_index = candidates.NextAlive(outer_index)) {
 
-            while ( (outer_index < initial_balls.size() - 1) && (initial_balls.size() > 0) ) {
+                const long current_ball_x = candidates.PixelX(outer_index);
+                const long current_ball_y = candidates.PixelY(outer_index);
 
-                GolfBall& current_ball = initial_balls[outer_index];
+                // The grid is keyed on the circle center, which can differ from x() by a fraction of a pixel
+                const double search_min_x = candidates.CenterX(outer_index) - kUnlikelyAngleMinimumDistancePixels - 1.0;
+                const double search_max_x = candidates.CenterX(outer_index) + kUnlikelyAngleMinimumDistancePixels + 1.0;
+
+                candidates.ForEachAliveInBox(search_min_x, search_max_x,
+                                             std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max(),
+                                             [&](const int i) {
+                    if (i <= outer_index) {
+                        return;
+                    }
 
-                for (size_t i = initial_balls.size() - 1; (initial_balls.size() > 0) && (i > outer_index); i--) {
-                    GolfBall& b = initial_balls[i];
+                    const long b_x = candidates.PixelX(i);
+                    const long b_y = candidates.PixelY(i);
 
                     double ball_angle_degrees = 0;
 
                     // TBD - This is only an approximation.  It might not work at very high
                     // camera in(de)clinations
 
-                    int x_distance_pixels = std::abs(b.x() - current_ball.x());
+                    int x_distance_pixels = std::abs(b_x - current_ball_x);
 
                     if (x_distance_pixels > kUnlikelyAngleMinimumDistancePixels) {
                         // The balls are too far apart to want to check for unlikely angles
-                        continue;
+                        return;
                     }
-                    else if (x_distance_pixels == 0 && b.y() == current_ball.y()) {
+                    else if (x_distance_pixels == 0 && b_y == current_ball_y) {
                         // The balls are concentric, so don't do anything
-                        continue;
+                        return;
                     }
                     else if (x_distance_pixels < 0.001) {
-                        // GS_LOG_TRACE_MSG(trace, "RemoveUnlikelyAngleLowerQualityBalls not analyzing ball " + std::to_string(i) + " because its X coordinate is too far from ball number " + std::to_string(outer_index));
                         // If the balls are right above/below each other, just pick a very big angle to avoid doing a divide by zero
                         // The large angle should ensure that the 'bad' ball is removed
                         ball_angle_degrees = 89;
                     }
                     else {
                         // Calculate angle so that it doesn't matter which ball is to the left
-                        ball_angle_degrees = CvUtils::RadiansToDegrees(atan((double)(b.y() - current_ball.y()) /
-                            (double)std::abs(b.x() - current_ball.x())));;
+                        ball_angle_degrees = CvUtils::RadiansToDegrees(atan((double)(b_y - current_ball_y) /
+                            (double)std::abs(b_x - current_ball_x)));
                     }
 
-                    if (b.x() > current_ball.x()) {
+                    if (b_x > current_ball_x) {
                         // The ball to be compared to the outer loop ball is to the right of the outer loop
                         ball_angle_degrees = -ball_angle_degrees;
                     }
@@ -1927,12 +2061,12 @@ namespace golf_sim {
                         GS_LOG_TRACE_MSG(trace, "Not analyzing ball " + std::to_string(i) + " due to its unlikely angle of "
                             + std::to_string(ball_angle_degrees) + " degrees with respect to ball number " + std::to_string(outer_index));
 
-                        initial_balls.erase(initial_balls.begin() + i);
+                        candidates.Remove(i);
                     }
-                }
-
-                outer_index++;
+                });
             }
+
+            candidates.CompactInto(initial_balls);
         }
 
 
@@ -2151,6 +2285,18 @@ namespace golf_sim {
                 roi = cv::Rect{ 0, (int)(0.5 * strobed_balls_color_image.rows),
                            strobed_balls_color_image.cols, (int)(strobed_balls_color_image.rows * 0.49) };
             }
+            else if (kUseFlightCorridorMask) {
+                // Only search where the ball could have flown from where it was teed up
+                const FlightCorridorMask* corridor = GetFlightCorridorMask(calibrated_ball);
+
+                if (corridor != nullptr && corridor->GetMask().size() == strobed_balls_color_image.size()) {
+                    roi = corridor->GetBoundingRect();
+                    ip->area_mask_image_ = corridor->GetMask();
+                }
+                else {
+                    GS_LOG_MSG(warning, "AnalyzeStrobedBalls - could not use the flight corridor mask.  Searching the whole image.");
+                }
+            }
             else {
                 // Leave the ROI as it was originally constructed by default - all 0's
             }
@@ -2161,6 +2307,9 @@ namespace golf_sim {
 
             bool result = ip->GetBall(strobed_balls_color_image, non_const_ball, initial_balls, roi, processing_mode, useLargestFoundBall, dontReportErrors);
 
+            // The image processor is shared, so don't leave the corridor mask behind for other searches
+            ip->area_mask_image_ = nullAreaMaskImage;
+
             int number_of_initial_balls = (int)initial_balls.size();
 
             if (!result || number_of_initial_balls < 2) {
@@ -2558,13 +2707,13 @@ namespace golf_sim {
         }
 
 
-        int GolfSimCamera::FindClosestRatioPatternMatchOffset(const std::vector<double> distance_ratios,
-                                                              const std::vector<double> pulse_ratios,
+        int GolfSimCamera::FindClosestRatioPatternMatchOffset(const std::vector<double>& distance_ratios,
+                                                              const std::vector<double>& pulse_ratios,
                                                               double& delta_to_closest_ratio) {
 
             // The current offset within the pulse interval ratios at which the pattern
             // of distance ratios is most closely correlated.
-            delta_to_closest_ratio = 99999.0;
+            delta_to_closest_ratio = StrobeRatioMatcher::kNoMatchRatioDistance;
             int closest_timing_interval_offset = -1;
 
             if (pulse_ratios.size() < distance_ratios.size()) {
@@ -2575,18 +2724,11 @@ namespace golf_sim {
 
                 double difference_in_ratios = ComputeRatioDistance(distance_ratios, pulse_ratios, distance_pattern_offset);
 
-                GS_LOG_TRACE_MSG(trace, "difference_in_ratios for offset " + std::to_string(distance_pattern_offset) + " is: " + std::to_string(difference_in_ratios));
-
                 // If the current offest of the distance ratios within the pulse ratio pattern
                 // results in the lowest error (distance), then assume it's the best for now.
                 if (difference_in_ratios < delta_to_closest_ratio) {
-
-                    // This is the smallest difference we've seen so far, so keep it!
-                    // Also, figure out if the interval is to the left or to the right of the 
-                    // middle ball (depending on which ball we chose as ball 2).
                     delta_to_closest_ratio = difference_in_ratios;
                     closest_timing_interval_offset = distance_pattern_offset;
-
                 }
             }
 
@@ -2596,53 +2738,59 @@ namespace golf_sim {
 
         // Returns a score of the closeness of the vector of distance_ratios within the pulse_ratios at an offset
         // of the distance_ratios from the beginning of the pulse_ratios
-        double GolfSimCamera::ComputeRatioDistance(const std::vector<double> distance_ratios,
-            const std::vector<double> pulse_ratios,
-            int& distance_pattern_offset) {
+        double GolfSimCamera::ComputeRatioDistance(const std::vector<double>& distance_ratios,
+                                                   const std::vector<double>& pulse_ratios,
+                                                   const int distance_pattern_offset) {
 
-            // TBD - Do some error checking on the inputs
+            // If we got more ball distance ratios than we have collapsed (and thus down-sized) pulse
+            // ratios, then just return a big error number to drop this comparison from the best-of list.
+            if (distance_pattern_offset < 0 || distance_ratios.size() + distance_pattern_offset > pulse_ratios.size()) {
+                LoggingTools::Warning("GolfSimCamera::ComputeRatioDistance received a distance_ratio_index higher than the number of pulse ratios.");
+                return StrobeRatioMatcher::kMaxRatioDistance;
+            }
 
-            double kMaxRatioDistance = 1000.0;
+            return StrobeRatioMatcher::ComputeRatioDistance(distance_ratios.data(), pulse_ratios.data() + distance_pattern_offset, distance_ratios.size());
+        }
 
-            double difference_in_ratios = 0;
 
-            // Compute the differences between each distance ratio in the pattern of distances as compared
-            // to each possible offset of those ratios to the pulse interval ratios.
-            for (size_t distance_ratio_index = 0; distance_ratio_index < distance_ratios.size(); distance_ratio_index++) {
+        const StrobeRatioMatcher& GolfSimCamera::GetStrobeRatioMatcher(const std::vector<float>& pulse_intervals_ms) {
 
-                // If we got more ball distance ratios than we have collapsed (and thus down-sized) pulse
-                // ratios, then just stop and return a big error number to drop this comparison from the
-                // best-of list.
+            StrobeRatioMatcher& matcher = strobe_ratio_matchers_[(int)PulseStrobe::GetStrobeProfileIdForCurrentClub()];
 
-                if ((distance_ratio_index + distance_pattern_offset) >= pulse_ratios.size()) {
-                    LoggingTools::Warning("GolfSimCamera::ComputeRatioDistance received a distance_ratio_index higher than the number of pulse ratios.");
-                    return kMaxRatioDistance;
-                }
-                // Compute the difference as a percent of the distance ratio so that each element
-                // of the pattern of ratios can contribute a meaningful amount of error/difference
-                // even if the distance is small.
-                double distance_ratio = distance_ratios[distance_ratio_index];
-                double pulse_ratio = pulse_ratios[distance_ratio_index + distance_pattern_offset];
+            if (!matcher.IsBuiltFor(pulse_intervals_ms)) {
+                GS_LOG_TRACE_MSG(trace, "GolfSimCamera::GetStrobeRatioMatcher - (re)building the strobe ratio table.");
+                matcher.Build(pulse_intervals_ms);
+            }
 
-                // Get a difference that is >= 0 so that squaring it will not decrease the number
-                // double single_ratio_difference = 100. * std::abs(distance_ratio - pulse_ratio) / std::min(distance_ratio, pulse_ratio);
-                double single_ratio_difference = 100. * std::abs(distance_ratio - pulse_ratio);
+            return matcher;
+        }
 
 
-                // If we get a crazy number, cap it so that we don't go out of bounds of our variable
-                if (single_ratio_difference > kMaxRatioDistance) {
-                    GS_LOG_TRACE_MSG(trace, "single_ratio_difference > kMaxRatioDistance!");
-                    single_ratio_difference = kMaxRatioDistance;
-                }
+        const FlightCorridorMask* GolfSimCamera::GetFlightCorridorMask(const GolfBall& calibrated_ball) const {
+
+            FlightCorridorMask::Parameters parameters;
+
+            const double quantization = std::max(kFlightCorridorPositionQuantizationMeters, 0.0001);
+
+            for (int i = 0; i < 3; i++) {
+                parameters.teed_ball_position_meters[i] = quantization * std::round(calibrated_ball.distances_ortho_camera_perspective_[i] / quantization);
+            }
+
+            parameters.min_launch_angle_degrees = kFlightCorridorMinLaunchAngleDegrees;
+            parameters.max_launch_angle_degrees = kFlightCorridorMaxLaunchAngleDegrees;
+            parameters.max_side_angle_degrees = kFlightCorridorMaxSideAngleDegrees;
+            parameters.max_travel_meters = kFlightCorridorMaxTravelMeters;
+            parameters.ball_radius_margin_ratio = kFlightCorridorBallRadiusMarginRatio;
 
-                // Square to highlight/emphasize larger errors
-                single_ratio_difference = pow(single_ratio_difference, 2);
-                GS_LOG_TRACE_MSG(trace, "   single_ratio_difference: " + std::to_string(single_ratio_difference));
+            if (!flight_corridor_mask_.IsBuiltFor(*this, parameters)) {
+                GS_LOG_TRACE_MSG(trace, "GolfSimCamera::GetFlightCorridorMask - (re)building the flight corridor mask.");
 
-                difference_in_ratios += single_ratio_difference;
+                if (!flight_corridor_mask_.Build(*this, parameters)) {
+                    return nullptr;
+                }
             }
 
-            return difference_in_ratios;
+            return &flight_corridor_mask_;
         }
 
 
@@ -2714,63 +2862,29 @@ namespace golf_sim {
                 // There shouldn't be too many missed pulses, but they could occur anywhere, so make sure
                 // that we consider possible collapsed pulses all the way to the end
 
-                std::vector<float>best_pulse_intervals;
-                double best_ratio_distance = 999999.;
-                int best_final_offset_of_distance_ratios = -1;
-                int best_pulses_to_collapse = -1;
-                int best_collapse_offset = -1;
-
-
-                for (int pulses_to_collapse = 0; pulses_to_collapse < std::floor(test_pulse_intervals.size() / 2); pulses_to_collapse++) {
-                 
-                    // Only the earlier pulses will typically be overlapped, as the pulse intervals grow as time
-                    // progresses.  TBD - For now, try looking for collapsed pulses only in the first third
-                    for (size_t collapse_offset = 0; (collapse_offset < (test_pulse_intervals.size() - pulses_to_collapse) - 1 );
-                                                    collapse_offset++) {
-
-                        // We don't go through any offsets other than 0 if we are not collapsing any pulse intervals.
-                        if (pulses_to_collapse == 0 && collapse_offset > 0) {
-                            break;
-                        }
-
-                        std::vector<double>pulse_ratios;
-                        std::vector<float>pulse_intervals;
-
-                        // We will retrieve the actual pulse interval (in uS) from the list of such intervals.
-                        // Just need to figure out WHICH interval coresponds to the two balls of interest.
-                        bool result = GetPulseIntervalsAndRatios(pulse_intervals, pulse_ratios, pulses_to_collapse, (int)collapse_offset);
-
-                        LoggingTools::Trace("The (potentially collapsed) pulse_intervals were (ignore last '0' interval): ", pulse_intervals);
-                        LoggingTools::Trace("The (potentially collapsed) pulse_ratios were : ", pulse_ratios);
-
-                        double delta_to_closest_ratio;
+                // Every combination of collapsed pulses and offsets is scored in a single pass over
+                // the pre-computed ratio table for the current strobe profile.
+                const StrobeRatioMatcher& ratio_matcher = GetStrobeRatioMatcher(test_pulse_intervals);
 
-                        int best_local_offset_of_distance_ratios = FindClosestRatioPatternMatchOffset(distance_ratios, pulse_ratios, delta_to_closest_ratio);
+                StrobeRatioMatch ratio_matches[StrobeRatioMatcher::kMaxMatches];
+                const int number_ratio_matches = ratio_matcher.FindBestMatches(distance_ratios, ratio_matches, StrobeRatioMatcher::kMaxMatches);
 
-                        // It shouldn't frequently be necessary to collapse pulses, because the images will widen out substantially as the ball 
-                        // crosses the field of view, and the "lost" balls are likely to be far to the left, and not the balls that we are going
-                        // focus on in the middle.  For that reason, we will penalize otherwise-low distances for cases where the pulses are 
-                        // being collapsed.
-                        double kLostPulsePenaltyPercent = 70.;
-
-                        if (pulses_to_collapse > 0) {
-                            delta_to_closest_ratio *= (1.0 + kLostPulsePenaltyPercent / 100.);
-                        }
-
-                        // If this is the closest match seen so far, save the information
-                        if (best_local_offset_of_distance_ratios >= 0 && delta_to_closest_ratio < best_ratio_distance) {
+                for (int i = 0; i < number_ratio_matches; i++) {
+                    GS_LOG_TRACE_MSG(trace, "Pulse ratio pattern match " + std::to_string(i) + ": score= " + std::to_string(ratio_matches[i].score)
+                        + " confidence= " + std::to_string(ratio_matches[i].confidence)
+                        + " offset_of_distance_ratios= " + std::to_string(ratio_matches[i].ratio_offset)
+                        + " pulses_to_collapse= " + std::to_string(ratio_matches[i].pulses_to_collapse)
+                        + " collapse_offset= " + std::to_string(ratio_matches[i].collapse_offset));
+                }
 
-                            best_ratio_distance = delta_to_closest_ratio;
-                            best_final_offset_of_distance_ratios = best_local_offset_of_distance_ratios;
-                            best_pulses_to_collapse = pulses_to_collapse;
-                            best_collapse_offset = (int)collapse_offset;
+                int best_final_offset_of_distance_ratios = -1;
+                int best_pulses_to_collapse = -1;
+                int best_collapse_offset = -1;
 
-                            GS_LOG_TRACE_MSG(trace, "------------> Found best (so far) pulse ratio pattern match.  best_ratio_distance= " + std::to_string(best_ratio_distance)
-                                + " best_final_offset_of_distance_ratios= " + std::to_string(best_ratio_distance)
-                                + " best_pulses_to_collapse= " + std::to_string(best_pulses_to_collapse)
-                                + " best_collapse_offset= " + std::to_string(best_collapse_offset));
-                        }
-                    }
+                if (number_ratio_matches > 0) {
+                    best_final_offset_of_distance_ratios = ratio_matches[0].ratio_offset;
+                    best_pulses_to_collapse = ratio_matches[0].pulses_to_collapse;
+                    best_collapse_offset = ratio_matches[0].collapse_offset;
                 }
 
                 if (best_collapse_offset < 0 || best_final_offset_of_distance_ratios < 0) {
@@ -2791,14 +2905,14 @@ namespace golf_sim {
                 // Transfer the pulse intervals to the array of balls and associated timing
                 // The first ball doesn't get a prior interval
 
+                return_balls_and_timing.reserve(return_balls_and_timing.size() + input_balls.size());
+
                 for (size_t i = 0; i < input_balls.size(); i++) {
-                    GolfBall& b = input_balls[i];
-                    GsBallAndTimingElement be;
-                    be.ball = b;
+                    GsBallAndTimingElement& be = return_balls_and_timing.emplace_back();
+                    be.ball = input_balls[i];
                     if (i > 0) {
                         be.time_interval_before_ball_ms = 1000 * pulse_intervals[best_final_offset_of_distance_ratios + i - 1];
                     }
-                    return_balls_and_timing.push_back(be);
                 }
                 // Sort the ball and timing vector by ball.x position, left to right
                 std::sort(return_balls_and_timing.begin(), return_balls_and_timing.end(), [](const GsBallAndTimingElement& a, const GsBallAndTimingElement& b)
@@ -2854,8 +2968,8 @@ namespace golf_sim {
                         be2.ball = input_balls[last_ball_index];
                         be2.time_interval_before_ball_ms = time_between_ball_images_uS;
 
-                        return_balls_and_timing.push_back(be1);
-                        return_balls_and_timing.push_back(be2);
+                        return_balls_and_timing.push_back(std::move(be1));
+                        return_balls_and_timing.push_back(std::move(be2));
                     }
                     else {
                         GS_LOG_MSG(error, "GetPulseIntervalsAndRatios failed - Input balls < 3 and not 2 (?.");
@@ -2897,8 +3011,8 @@ namespace golf_sim {
                             be2.ball = input_balls[1];
                             be2.time_interval_before_ball_ms = time_between_ball_images_uS;
 
-                            return_balls_and_timing.push_back(be1);
-                            return_balls_and_timing.push_back(be2);
+                            return_balls_and_timing.push_back(std::move(be1));
+                            return_balls_and_timing.push_back(std::move(be2));
                         }
                         else {
                             GS_LOG_MSG(error, "GetPulseIntervalsAndRatios failed - Input balls < 3 and not 2 (?.");
@@ -3164,6 +3278,7 @@ namespace golf_sim {
 
             // Setup to return the exposures that were found to the caller
             exposures_image = strobed_balls_color_image.clone();
+            exposure_balls.reserve(exposure_balls.size() + return_balls_and_timing.size());
             for (auto& exposure_ball_and_timing : return_balls_and_timing) {
                 exposure_balls.push_back(exposure_ball_and_timing.ball);
             }
@@ -3352,6 +3467,14 @@ namespace golf_sim {
                                         GolfBall& result_ball,
                                         cv::Vec3d& rotationResults) {
 
+            if (kMaxSpinBallPairs > 1) {
+                std::vector<GsBallPairAndSpinCandidateScoreElement> ball_pair_elements;
+
+                if (FindBestSpinBallPairs(strobed_balls_gray_image, non_overlapping_balls_and_timing, true, ball_pair_elements)) {
+                    return ProcessMultiPairSpin(camera, strobed_balls_gray_image, non_overlapping_balls_and_timing, ball_pair_elements, result_ball, rotationResults);
+                }
+            }
+
             GolfBall spin_ball1;
             GolfBall spin_ball2;
             double spin_timing_interval_uS = 0.0;
@@ -3381,19 +3504,199 @@ namespace golf_sim {
             ShowAndLogBalls("ProcessSpin - Final Spin Balls", strobed_balls_gray_image, finalSpinBalls, kLogIntermediateExposureImagesToFile);
 
 
+            // The ball's speed and launch angle are already known, and narrow down the likely spin
+            SpinSearchHints search_hints;
+            search_hints.ball_speed_mph = CvUtils::MetersPerSecondToMPH(result_ball.velocity_);
+            search_hints.vla_deg = result_ball.angles_ball_perspective_[1];
+            search_hints.club_type = GolfSimClubs::GetCurrentClubType();
+            search_hints.interval_uS = spin_timing_interval_uS;
+
+            double match_score = -1.0;
+
             // The best spin analysis will likely be between the two closest balls that are non-overlapping
-            rotationResults = BallImageProc::GetBallRotation(strobed_balls_gray_image, spin_ball1, strobed_balls_gray_image, spin_ball2);
+            rotationResults = BallImageProc::GetBallRotation(strobed_balls_gray_image, spin_ball1, strobed_balls_gray_image, spin_ball2,
+                                                             &match_score, &search_hints);
 
             // TBD - Find the interval between spin_ball1 and spin_ball2
             // 
             // Calculate the spin RPMs into the result ball
             camera.CalculateBallSpinRates(result_ball, rotationResults, (long)std::round(spin_timing_interval_uS));
 
+            result_ball.spin_match_score_ = match_score;
+
+            if (match_score >= GsSpinSearchPlanner::kSpinSearchMinHistoryScore) {
+                GsSpinSearchPlanner::RecordShotSpin(search_hints.club_type, result_ball.rotation_speeds_RPM_[0], result_ball.rotation_speeds_RPM_[2]);
+            }
+
             result_ball.time_between_angle_measures_for_rpm_uS_ = (long)std::round(spin_timing_interval_uS);
 
             return true;
         }
 
+        bool GolfSimCamera::ProcessMultiPairSpin(GolfSimCamera& camera,
+                                                 const cv::Mat& strobed_balls_gray_image,
+                                                 const GsBallsAndTimingVector& non_overlapping_balls_and_timing,
+                                                 const std::vector<GsBallPairAndSpinCandidateScoreElement>& ball_pair_elements,
+                                                 GolfBall& result_ball,
+                                                 cv::Vec3d& rotationResults) {
+
+            struct SpinBallPair {
+                int ball1_index = -1;
+                int ball2_index = -1;
+                GolfBall ball1;
+                GolfBall ball2;
+                double interval_uS = 0.0;
+                cv::Vec3d rotation;
+                double match_score = -1.0;
+            };
+
+            std::vector<SpinBallPair> spin_pairs;
+            spin_pairs.reserve(kMaxSpinBallPairs);
+
+            for (const GsBallPairAndSpinCandidateScoreElement& ball_pair_element : ball_pair_elements) {
+
+                if ((int)spin_pairs.size() >= kMaxSpinBallPairs) {
+                    break;
+                }
+
+                // Apart from the best pair, leave out overlapping balls, as they are too smudgy to help
+                if (!spin_pairs.empty() && ball_pair_element.pair_proximity_score <= 0) {
+                    continue;
+                }
+
+                SpinBallPair spin_pair;
+                spin_pair.ball1_index = std::min(ball_pair_element.ball1_index, ball_pair_element.ball2_index);
+                spin_pair.ball2_index = std::max(ball_pair_element.ball1_index, ball_pair_element.ball2_index);
+                spin_pair.ball1 = non_overlapping_balls_and_timing[spin_pair.ball1_index].ball;
+                spin_pair.ball2 = non_overlapping_balls_and_timing[spin_pair.ball2_index].ball;
+
+                // The pair may not be adjacent, so add up all the intervals between the two balls
+                for (int k = spin_pair.ball1_index + 1; k <= spin_pair.ball2_index; k++) {
+                    spin_pair.interval_uS += non_overlapping_balls_and_timing[k].time_interval_before_ball_ms;
+                }
+
+                if (spin_pair.interval_uS <= 0.0 || !camera.ComputeBallDeltas(spin_pair.ball1, spin_pair.ball2, camera, camera)) {
+                    if (spin_pairs.empty()) {
+                        GS_LOG_MSG(error, "ProcessMultiPairSpin - failed to ComputeBallDeltas for the best spin ball pair.");
+                        return false;
+                    }
+
+                    GS_LOG_TRACE_MSG(warning, "ProcessMultiPairSpin - skipping spin ball pair (" + std::to_string(spin_pair.ball1_index) + ", " + std::to_string(spin_pair.ball2_index) + ").");
+                    continue;
+                }
+
+                spin_pairs.push_back(std::move(spin_pair));
+            }
+
+            const SpinBallPair& best_pair = spin_pairs[0];
+
+            std::vector<GolfBall> finalSpinBalls;
+            finalSpinBalls.push_back(best_pair.ball1);
+            finalSpinBalls.push_back(best_pair.ball2);
+
+            LoggingTools::Trace("Best two balls (for spin analysis) are:\n" + best_pair.ball1.Format() + "\nand\n" + best_pair.ball2.Format());
+
+            ShowAndLogBalls("ProcessSpin - Final Spin Balls", strobed_balls_gray_image, finalSpinBalls, kLogIntermediateExposureImagesToFile);
+
+            // Each ball is isolated only once, even if it is part of several pairs.  The resizing and
+            // filtering that follow depend on both balls of a pair, so they are still done per pair.
+            std::vector<IsolatedSpinBall> isolated_balls(non_overlapping_balls_and_timing.size());
+
+            for (const SpinBallPair& spin_pair : spin_pairs) {
+                for (const int ball_index : { spin_pair.ball1_index, spin_pair.ball2_index }) {
+                    if (isolated_balls[ball_index].image.empty()) {
+                        BallImageProc::IsolateSpinBall(strobed_balls_gray_image, non_overlapping_balls_and_timing[ball_index].ball, isolated_balls[ball_index]);
+                    }
+                }
+            }
+
+            // The ball's speed and launch angle are already known, and narrow down the likely spin
+            SpinSearchHints shot_search_hints;
+            shot_search_hints.ball_speed_mph = CvUtils::MetersPerSecondToMPH(result_ball.velocity_);
+            shot_search_hints.vla_deg = result_ball.angles_ball_perspective_[1];
+            shot_search_hints.club_type = GolfSimClubs::GetCurrentClubType();
+
+            // Only the best pair writes the result images, as the pairs run at the same time
+            GsThreadPool::GetSharedPool().ParallelFor(spin_pairs.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    SpinBallPair& spin_pair = spin_pairs[i];
+
+                    SpinSearchHints search_hints = shot_search_hints;
+                    search_hints.interval_uS = spin_pair.interval_uS;
+
+                    spin_pair.rotation = BallImageProc::GetBallRotation(isolated_balls[spin_pair.ball1_index], spin_pair.ball1,
+                                                                        isolated_balls[spin_pair.ball2_index], spin_pair.ball2,
+                                                                        &spin_pair.match_score, i == 0, &search_hints);
+                }
+            });
+
+            // Fuse the pairs as rates, because the pairs may span different intervals
+            std::vector<std::pair<double, double>> rates_and_weights[3];
+
+            for (const SpinBallPair& spin_pair : spin_pairs) {
+
+                GS_LOG_TRACE_MSG(trace, "Spin ball pair (" + std::to_string(spin_pair.ball1_index) + ", " + std::to_string(spin_pair.ball2_index) +
+                    ") over " + std::to_string(spin_pair.interval_uS) + " uS rotated (" + std::to_string(spin_pair.rotation[0]) + ", " +
+                    std::to_string(spin_pair.rotation[1]) + ", " + std::to_string(spin_pair.rotation[2]) + ") with a match score of " + std::to_string(spin_pair.match_score));
+
+                if (spin_pair.match_score <= 0.0) {
+                    continue;
+                }
+
+                for (int axis = 0; axis < 3; axis++) {
+                    rates_and_weights[axis].emplace_back(spin_pair.rotation[axis] / spin_pair.interval_uS, spin_pair.match_score);
+                }
+            }
+
+            if (rates_and_weights[0].empty()) {
+                GS_LOG_TRACE_MSG(warning, "ProcessMultiPairSpin - no ball pair had a usable match.  Using the best pair's rotation.");
+                rotationResults = best_pair.rotation;
+            }
+            else {
+                for (int axis = 0; axis < 3; axis++) {
+                    rotationResults[axis] = ComputeWeightedMedian(rates_and_weights[axis]) * best_pair.interval_uS;
+                }
+            }
+
+            GS_LOG_TRACE_MSG(trace, "Fused rotation from " + std::to_string(rates_and_weights[0].size()) + " spin ball pairs is (" +
+                std::to_string(rotationResults[0]) + ", " + std::to_string(rotationResults[1]) + ", " + std::to_string(rotationResults[2]) + ").");
+
+            camera.CalculateBallSpinRates(result_ball, rotationResults, (long)std::round(best_pair.interval_uS));
+
+            result_ball.time_between_angle_measures_for_rpm_uS_ = (long)std::round(best_pair.interval_uS);
+            result_ball.spin_match_score_ = best_pair.match_score;
+
+            if (best_pair.match_score >= GsSpinSearchPlanner::kSpinSearchMinHistoryScore) {
+                GsSpinSearchPlanner::RecordShotSpin(shot_search_hints.club_type, result_ball.rotation_speeds_RPM_[0], result_ball.rotation_speeds_RPM_[2]);
+            }
+
+            return true;
+        }
+
+        double GolfSimCamera::ComputeWeightedMedian(std::vector<std::pair<double, double>>& values_and_weights) {
+
+            std::sort(values_and_weights.begin(), values_and_weights.end());
+
+            double total_weight = 0.0;
+            for (const auto& [value, weight] : values_and_weights) {
+                total_weight += std::max(0.0, weight);
+            }
+
+            if (total_weight <= 0.0) {
+                return 0.0;
+            }
+
+            double accumulated_weight = 0.0;
+            for (const auto& [value, weight] : values_and_weights) {
+                accumulated_weight += std::max(0.0, weight);
+                if (accumulated_weight >= total_weight / 2.0) {
+                    return value;
+                }
+            }
+
+            return values_and_weights.back().first;
+        }
+
 
         bool GolfSimCamera::FindClosestTwoBalls(const cv::Mat& img,
                                                 const GsBallsAndTimingVector& balls,
@@ -3419,6 +3722,7 @@ namespace golf_sim {
             // backoffs entirely.
 
             std::vector<GolfBall> only_balls;
+            only_balls.reserve(balls.size());
             for (const GsBallAndTimingElement& b : balls) {
                 only_balls.push_back(b.ball);
             }
@@ -3507,36 +3811,168 @@ namespace golf_sim {
         }
 
 
-        bool GolfSimCamera::ComputeAveragedStrobedBallData(const GolfSimCamera& camera, const GsBallsAndTimingVector& balls_and_timing,
-                                                           GolfBall& output_averaged_ball) {
+        bool GolfSimCamera::FitStrobedBallTrajectory(const GolfSimCamera& camera,
+                                                     const GsBallsAndTimingVector& balls_and_timing,
+                                                     GsBallTrajectoryFit& fit) {
 
-            std::vector<GolfBall> delta_balls;
+            fit = GsBallTrajectoryFit();
 
-            // Go through the second-to-last ball on the outer loop, as the inner
-            // loop will take care of the next ball
-            for (size_t i = 0; i < balls_and_timing.size() - 1; i++) {
+            const int number_balls = (int)balls_and_timing.size();
 
-                GolfBall ball1 = balls_and_timing[i].ball;
+            if (number_balls < 2 || number_balls > GsBallTrajectoryFit::kMaxExposures) {
+                GS_LOG_MSG(error, "FitStrobedBallTrajectory called with " + std::to_string(number_balls) + " balls.  Need between 2 and " +
+                    std::to_string(GsBallTrajectoryFit::kMaxExposures) + ".");
+                return false;
+            }
 
-                // For each ball, pair it with all the other balls 
-                // (shouldn't be more than 100 pairs)
-                for (size_t j = i + 1; j < balls_and_timing.size(); j++) {
+            std::array<cv::Vec3d, GsBallTrajectoryFit::kMaxExposures> positions;
+            std::array<double, GsBallTrajectoryFit::kMaxExposures> times_seconds;
 
-                    GolfBall ball2 = balls_and_timing[j].ball;
+            // Each ball's interval is the strobe time since the ball before it, so the
+            // first ball's interval does not matter here
+            double time_uS = 0;
 
-                    GS_LOG_MSG(trace, "ComputeAveragedStrobedBallData comparing the following two balls (indexes are within the vector): Balls (" + std::to_string(i) + ", " + std::to_string(j) + ").");
+            for (int i = 0; i < number_balls; i++) {
+                const GolfBall& ball = balls_and_timing[i].ball;
 
-                    // Ball2 will have the averaged information
-                    if (!ComputeBallDeltas(ball1, ball2, camera, camera /* all_balls_camera2 */)) {
-                        GS_LOG_MSG(error, "ComputeAveragedStrobedBallData failed.");
-                        return false;
+                if (i > 0) {
+                    time_uS += balls_and_timing[i].time_interval_before_ball_ms;
+                }
+
+                times_seconds[i] = time_uS / 1000000.;
+
+                cv::Vec3d distances;
+                const double distance_to_z_plane_from_lens = ComputeDistanceToBallUsingRadius(camera, ball);
+
+                if (!ComputeXyzDistanceFromOrthoCamPerspective(camera, ball.x(), ball.y(), distance_to_z_plane_from_lens, distances)) {
+                    GS_LOG_MSG(error, "FitStrobedBallTrajectory could not ComputeXyzDistanceFromOrthoCamPerspective for ball " + std::to_string(i));
+                    return false;
+                }
+
+                // Ball X is -Camera Z, Ball Y is Camera Y, Ball Z is Camera X, as in ComputeXyzDeltaDistances
+                positions[i] = cv::Vec3d(-distances[2], distances[1], distances[0]);
+                fit.exposure_used[i] = true;
+            }
+
+            fit.number_exposures = number_balls;
+            fit.number_exposures_used = number_balls;
+
+            // Least squares for p(t) = p0 + v*t, separately for each axis:
+            //      v = sum((t - t_mean) * (p - p_mean)) / sum((t - t_mean)^2)
+            //      p0 = p_mean - v * t_mean
+            // Each time an outlier is dropped, the fit is re-solved from scratch.
+            while (true) {
+
+                double t_mean = 0;
+                cv::Vec3d p_mean(0, 0, 0);
+
+                for (int i = 0; i < number_balls; i++) {
+                    if (fit.exposure_used[i]) {
+                        t_mean += times_seconds[i];
+                        p_mean += positions[i];
+                    }
+                }
+
+                t_mean /= fit.number_exposures_used;
+                p_mean /= (double)fit.number_exposures_used;
+
+                double s_tt = 0;
+                cv::Vec3d s_tp(0, 0, 0);
+
+                for (int i = 0; i < number_balls; i++) {
+                    if (fit.exposure_used[i]) {
+                        const double dt = times_seconds[i] - t_mean;
+                        s_tt += dt * dt;
+                        s_tp += dt * (positions[i] - p_mean);
                     }
+                }
 
-                    delta_balls.push_back(ball2);
+                if (s_tt <= 1.0e-12) {
+                    GS_LOG_MSG(error, "FitStrobedBallTrajectory - the strobe times of the balls do not differ.");
+                    return false;
                 }
+
+                fit.velocity_ball_perspective = s_tp / s_tt;
+                fit.position_at_first_exposure = p_mean - fit.velocity_ball_perspective * t_mean;
+
+                int worst_exposure = -1;
+                double sum_squared_residuals = 0;
+
+                for (int i = 0; i < number_balls; i++) {
+                    const cv::Vec3d fitted_position = fit.position_at_first_exposure + fit.velocity_ball_perspective * times_seconds[i];
+                    fit.residuals_meters[i] = cv::norm(positions[i] - fitted_position);
+
+                    if (fit.exposure_used[i]) {
+                        sum_squared_residuals += fit.residuals_meters[i] * fit.residuals_meters[i];
+
+                        if (worst_exposure < 0 || fit.residuals_meters[i] > fit.residuals_meters[worst_exposure]) {
+                            worst_exposure = i;
+                        }
+                    }
+                }
+
+                fit.rms_residual_meters = std::sqrt(sum_squared_residuals / fit.number_exposures_used);
+
+                if (fit.number_exposures_used > 3 && fit.residuals_meters[worst_exposure] > kMaxTrajectoryFitResidualMeters) {
+                    GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory dropping ball " + std::to_string(worst_exposure) + " with residual of " +
+                        std::to_string(fit.residuals_meters[worst_exposure]) + " meters.");
+                    fit.exposure_used[worst_exposure] = false;
+                    fit.number_exposures_used--;
+                    continue;
+                }
+
+                break;
             }
 
-            GolfBall::AverageBalls(delta_balls, output_averaged_ball);
+            fit.speed_meters_per_second = cv::norm(fit.velocity_ball_perspective);
+
+            if (!getXYDeltaAnglesBallPerspective(fit.velocity_ball_perspective, fit.angles_ball_perspective)) {
+                GS_LOG_MSG(error, "FitStrobedBallTrajectory could not getXYDeltaAnglesBallPerspective.");
+                return false;
+            }
+
+            // The strobe times only increase, so the sum of (t_j - t_i) over every pair i < j
+            // is the sum of each time weighted by (2k - m + 1) for its rank k of the m used times.
+            double sum_pairwise_intervals = 0;
+            int rank = 0;
+
+            for (int i = 0; i < number_balls; i++) {
+                if (fit.exposure_used[i]) {
+                    sum_pairwise_intervals += times_seconds[i] * (2 * rank - fit.number_exposures_used + 1);
+                    rank++;
+                }
+            }
+
+            const double number_pairs = fit.number_exposures_used * (fit.number_exposures_used - 1) / 2.0;
+            fit.mean_pairwise_interval_seconds = sum_pairwise_intervals / number_pairs;
+
+            GS_LOG_TRACE_MSG(trace, "FitStrobedBallTrajectory used " + std::to_string(fit.number_exposures_used) + " of " + std::to_string(number_balls) +
+                " balls.  Speed = " + std::to_string(fit.speed_meters_per_second) + " m/s, angles (X, Y) = (" +
+                std::to_string(fit.angles_ball_perspective[0]) + ", " + std::to_string(fit.angles_ball_perspective[1]) +
+                ") degrees, RMS residual = " + std::to_string(fit.rms_residual_meters) + " meters.");
+
+            return true;
+        }
+
+
+        bool GolfSimCamera::ComputeAveragedStrobedBallData(const GolfSimCamera& camera, const GsBallsAndTimingVector& balls_and_timing,
+                                                           GolfBall& output_averaged_ball) {
+
+            GsBallTrajectoryFit fit;
+
+            if (!FitStrobedBallTrajectory(camera, balls_and_timing, fit)) {
+                GS_LOG_MSG(error, "ComputeAveragedStrobedBallData failed.");
+                return false;
+            }
+
+            for (int i = 0; i < fit.number_exposures; i++) {
+                GS_LOG_TRACE_MSG(trace, "ComputeAveragedStrobedBallData - ball " + std::to_string(i) + " residual = " +
+                    std::to_string(fit.residuals_meters[i]) + " meters" + (fit.exposure_used[i] ? "." : " (not used)."));
+            }
+
+            output_averaged_ball.position_deltas_ball_perspective_ = fit.velocity_ball_perspective * fit.mean_pairwise_interval_seconds;
+            output_averaged_ball.angles_ball_perspective_ = fit.angles_ball_perspective;
+            output_averaged_ball.velocity_ = fit.speed_meters_per_second;
 
             return true;
         }
@@ -3551,7 +3987,45 @@ namespace golf_sim {
 
             int closest_ball1 = -1;
             int closest_ball2 = -1;
-            double closest_distance_so_far = 100000;
+
+            std::vector<GsBallPairAndSpinCandidateScoreElement> ball_pair_elements;
+
+            if (!FindBestSpinBallPairs(img, balls_and_timing, use_edge_backoffs, ball_pair_elements)) {
+                return false;
+            }
+
+            // Find the balls with the two highest scores
+
+            closest_ball1 = ball_pair_elements[0].ball1_index;
+            closest_ball2 = ball_pair_elements[0].ball2_index;
+
+            if (closest_ball1 == -1 || closest_ball2 == -1) {
+                GS_LOG_TRACE_MSG(warning, "Could not find any potential ball pairs for spin analysis");
+                return false;
+            }
+
+            // If necessary, reverse the ball order so that the ball on the left will be first.
+            if (ball_pair_elements[0].ball1.x > ball_pair_elements[0].ball2.x) {
+                closest_ball1 = ball_pair_elements[0].ball1_index;
+                closest_ball2 = ball_pair_elements[0].ball2_index;
+            }
+
+            output_ball1 = balls_and_timing[closest_ball1].ball;
+            output_ball2 = balls_and_timing[closest_ball2].ball;
+
+            int index_of_ball_with_interval = std::max(closest_ball1, closest_ball2);
+
+            timing_interval_uS = balls_and_timing[index_of_ball_with_interval].time_interval_before_ball_ms;
+
+            return true;
+        }
+
+        bool GolfSimCamera::FindBestSpinBallPairs(const cv::Mat& img,
+                                                  const GsBallsAndTimingVector& balls_and_timing,
+                                                  const bool use_edge_backoffs,
+                                                  std::vector<GsBallPairAndSpinCandidateScoreElement>& ball_pair_elements) {
+
+            ball_pair_elements.clear();
 
             int minX = kClosestBallPairEdgeBackoffPixels;
             int minY = kClosestBallPairEdgeBackoffPixels;
@@ -3565,9 +4039,7 @@ namespace golf_sim {
             // Of course, if use_edge_backoffs == false, we're going to ignore the
             // backoffs entirely.
 
-            std::vector<GolfBall> balls;
-            std::vector<GsBallPairAndSpinCandidateScoreElement> ball_pairs_and_scores;
-            std::vector<GsBallPairAndSpinCandidateScoreElement> ball_pair_elements;
+            ball_pair_elements.reserve(balls_and_timing.size() * balls_and_timing.size() / 2);
 
             // See header file for descrip[tions
             double kEdgeProximityScoreWeighting = 4;
@@ -3580,8 +4052,6 @@ namespace golf_sim {
 
             for (size_t i = 0; i < balls_and_timing.size(); i++) { 
                 const GolfBall& ball1 = balls_and_timing[i].ball;
-                // Create one vector of just the balls (no timing) to use for averaging
-                balls.push_back(ball1);
 
                 // For each ball, pair it with all the other balls 
                 // (shouldn't be much more than 100 pairs)
@@ -3590,8 +4060,8 @@ namespace golf_sim {
 
                     GsBallPairAndSpinCandidateScoreElement ball_pair_element;
 
-                    ball_pair_element.ball1 = ball1;
-                    ball_pair_element.ball2 = ball2;
+                    ball_pair_element.ball1 = ball1.GetCandidate((int)i);
+                    ball_pair_element.ball2 = ball2.GetCandidate((int)j);
 
                     ball_pair_element.ball1_index = (int)i;
                     ball_pair_element.ball2_index = (int)j;
@@ -3707,29 +4177,6 @@ namespace golf_sim {
                 GS_LOG_TRACE_MSG(trace, "Potential Spin Ball Combination of balls ( " + std::to_string(ball_pair_element.ball1_index) + ", " + std::to_string(ball_pair_element.ball2_index) + ") scored: " + spin_ball_score_text);
             }
 
-            // Find the balls with the two highest scores
-
-            closest_ball1 = ball_pair_elements[0].ball1_index;
-            closest_ball2 = ball_pair_elements[0].ball2_index;
-
-            if (closest_ball1 == -1 || closest_ball2 == -1) {
-                GS_LOG_TRACE_MSG(warning, "Could not find any potential ball pairs for spin analysis");
-                return false;
-            }
-
-            // If necessary, reverse the ball order so that the ball on the left will be first.
-            if (ball_pair_elements[0].ball1.x() > ball_pair_elements[0].ball2.x()) {
-                closest_ball1 = ball_pair_elements[0].ball1_index;
-                closest_ball2 = ball_pair_elements[0].ball2_index;
-            }
-
-            output_ball1 = balls[closest_ball1];
-            output_ball2 = balls[closest_ball2];
-
-            int index_of_ball_with_interval = std::max(closest_ball1, closest_ball2);
-
-            timing_interval_uS = balls_and_timing[index_of_ball_with_interval].time_interval_before_ball_ms;
-
             return true;
         }
 
@@ -15,12 +15,16 @@
     See U.S. Patent Application No. 18/428,191 for more details.
 */
 
+#include <array>
 #include <string>
 #include "logging_tools.h"
 #include "cv_utils.h"
 #include "gs_globals.h"
 #include "camera_hardware.h"
 #include "golf_ball.h"
+#include "pulse_strobe_profile.h"
+#include "strobe_ratio_matcher.h"
+#include "flight_corridor_mask.h"
 
 namespace golf_sim {
 
@@ -38,8 +42,9 @@ namespace golf_sim {
     // Higher pair scores are better.  Each sub-score should attempt to
     // be between 0 (no good) to 10 (great)
     struct GsBallPairAndSpinCandidateScoreElement {
-        GolfBall ball1;
-        GolfBall ball2;
+        // Only lightweight copies are kept here, as there is one element per pair of balls
+        GolfBallCandidate ball1;
+        GolfBallCandidate ball2;
 
         // -1 means not set
         int ball1_index = -1;
@@ -62,6 +67,36 @@ namespace golf_sim {
         double total_pair_score = 0;
     };
 
+    // The result of fitting a single constant-velocity trajectory to all of the strobed
+    // ball exposures at once (see GolfSimCamera::FitStrobedBallTrajectory).
+    // Positions (meters) and velocities (meters/second) are from the ball perspective,
+    // as in GolfBall::position_deltas_ball_perspective_.
+    struct GsBallTrajectoryFit {
+        // The most exposures that a single fit will consider
+        static constexpr int kMaxExposures = 64;
+
+        int number_exposures = 0;
+        int number_exposures_used = 0;
+
+        // The fitted position at the time of the first exposure
+        cv::Vec3d position_at_first_exposure{ 0, 0, 0 };
+        cv::Vec3d velocity_ball_perspective{ 0, 0, 0 };
+        double speed_meters_per_second = 0;
+
+        // Launch (X) and side (Y) angles in degrees, as in GolfBall::angles_ball_perspective_
+        cv::Vec2d angles_ball_perspective{ 0, 0 };
+
+        // The distance of each exposure from the fitted trajectory at that exposure's
+        // strobe time.  Exposures rejected as outliers are still reported here.
+        std::array<double, kMaxExposures> residuals_meters{};
+        std::array<bool, kMaxExposures> exposure_used{};
+        double rms_residual_meters = 0;
+
+        // The mean of the time differences over every pair of the exposures that were used.
+        // Scaling the velocity by this gives the average of the pairwise position deltas.
+        double mean_pairwise_interval_seconds = 0;
+    };
+
 
     class GolfSimCamera
     {
@@ -124,6 +159,27 @@ namespace golf_sim {
 
         static int kClosestBallPairEdgeBackoffPixels;
 
+        // The number of the best-scoring ball pairs that the spin is measured on.  Each pair's
+        // rotation is converted to a rate and the rates are combined by a median weighted by how
+        // well each pair matched.  1 measures only the single best pair.
+        static int kMaxSpinBallPairs;
+
+        // Exposures that are further than this from the fitted strobed-ball trajectory are
+        // dropped from the fit (worst first) as long as at least 3 exposures remain.
+        static double kMaxTrajectoryFitResidualMeters;
+
+        // Bounds the camera-2 strobed-ball search to where a ball hit from the teed-up position
+        // could possibly be.  See flight_corridor_mask.h.  Not used for putting.
+        static bool kUseFlightCorridorMask;
+        static double kFlightCorridorMinLaunchAngleDegrees;
+        static double kFlightCorridorMaxLaunchAngleDegrees;
+        static double kFlightCorridorMaxSideAngleDegrees;
+        static double kFlightCorridorMaxTravelMeters;
+        static double kFlightCorridorBallRadiusMarginRatio;
+        // The teed-ball position is rounded to this before it is used, so that the corridor
+        // does not have to be rebuilt for every small change in where the ball is placed
+        static double kFlightCorridorPositionQuantizationMeters;
+
         static double kMaxIntermediateBallRadiusChangePercent;
         static double kMaxPuttingIntermediateBallRadiusChangePercent;
         static double kMaxOverlappedBallRadiusChangeRatio;
@@ -317,6 +373,22 @@ namespace golf_sim {
         // plane of the expected ball's line of flight.
         static bool ComputeXyzDistanceFromOrthoCamPerspective(const GolfSimCamera& camera, const GolfBall& b1, cv::Vec3d& distance_deltas);
 
+        // As above, but for a ball center at (x, y) in the image that is distance_to_z_plane_from_lens
+        // away from the lens.  Does not require the ball to have been updated with that distance.
+        static bool ComputeXyzDistanceFromOrthoCamPerspective(const GolfSimCamera& camera,
+                                                              const double x,
+                                                              const double y,
+                                                              const double distance_to_z_plane_from_lens,
+                                                              cv::Vec3d& distances);
+
+        // The inverse of ComputeXyzDistanceFromOrthoCamPerspective.  Returns the (x, y) image position of
+        // a point at the given ortho-camera-perspective distances, and the point's distance from the lens.
+        // Returns false if the point cannot be seen by the camera.
+        static bool ComputePixelFromOrthoCamPerspective(const GolfSimCamera& camera,
+                                                        const cv::Vec3d& distances,
+                                                        cv::Point2d& pixel,
+                                                        double& distance_to_z_plane_from_lens);
+
         static bool ComputeBallXYAnglesFromCameraPerspective(const cv::Vec3d& distances_camera_perspective,
                                               cv::Vec2d& deltaAnglesCameraPerspective);
         
@@ -367,8 +439,8 @@ namespace golf_sim {
                                       long& time_between_ball_images_ms,
                                       GsBallsAndTimingVector& return_balls_and_timing);
 
-        int FindClosestRatioPatternMatchOffset(const std::vector<double> distance_ratios,
-                                               const std::vector<double> pulse_ratios,
+        int FindClosestRatioPatternMatchOffset(const std::vector<double>& distance_ratios,
+                                               const std::vector<double>& pulse_ratios,
                                                double& delta_to_closest_ratio);
 
         bool GetPulseIntervalsAndRatios(std::vector<float>& pulse_pause_intervals, 
@@ -388,9 +460,18 @@ namespace golf_sim {
 
         // Returns a score of the closeness of the vector of distance_ratios within the pulse_ratios at an offset
         // of the distance_ratios from the beginning of the pulse_ratios
-        double ComputeRatioDistance(const std::vector<double> distance_ratios,
-                                    const std::vector<double> pulse_ratios,
-                                    int& distance_pattern_offset);
+        double ComputeRatioDistance(const std::vector<double>& distance_ratios,
+                                    const std::vector<double>& pulse_ratios,
+                                    const int distance_pattern_offset);
+
+        // Returns the ratio matcher for the current strobe profile, (re)building
+        // it if the pulse intervals have changed since it was last used
+        static const StrobeRatioMatcher& GetStrobeRatioMatcher(const std::vector<float>& pulse_intervals_ms);
+
+        // Returns the flight-corridor mask for a ball teed up at the calibrated_ball's position,
+        // (re)building it if the position or the calibration has changed since it was last used.
+        // Returns nullptr if no corridor could be built.
+        const FlightCorridorMask* GetFlightCorridorMask(const GolfBall& calibrated_ball) const;
 
         // If we identified a lot of balls, only retain the top <n>
         void RemoveLowScoringBalls(std::vector<GolfBall>& initial_balls, const int max_balls_to_retain);
@@ -443,8 +524,28 @@ namespace golf_sim {
             GolfBall& ball2,
             double& timing_interval_uS);
 
-        // For each pair of balls, determines the angles and velocity, and then averages
-        // all of them and returns that average in output_averaged_ball
+        // Scores every pair of balls as FindBestTwoSpinBalls does, and returns the pairs
+        // sorted best-first
+        static bool FindBestSpinBallPairs(const cv::Mat& img,
+            const GsBallsAndTimingVector& balls,
+            const bool use_edge_backoffs,
+            std::vector<GsBallPairAndSpinCandidateScoreElement>& ball_pair_elements);
+
+        // Returns the value at which the accumulated weight reaches half of the total weight.
+        // Re-orders values_and_weights.  Returns 0 if there are no positively-weighted values.
+        static double ComputeWeightedMedian(std::vector<std::pair<double, double>>& values_and_weights);
+
+        // Fits one constant-velocity trajectory to all of the strobed balls by least squares,
+        // using each ball's strobe time.  Each pass over the balls is O(n) and nothing is
+        // allocated.  Exposures whose residual is over kMaxTrajectoryFitResidualMeters are
+        // dropped and the fit is re-solved.
+        static bool FitStrobedBallTrajectory(const GolfSimCamera& camera,
+                                             const GsBallsAndTimingVector& balls_and_timing,
+                                             GsBallTrajectoryFit& fit);
+
+        // Determines the angles and velocity of the strobed balls from a single trajectory
+        // fit, and returns them in output_averaged_ball in the same form that averaging the
+        // ComputeBallDeltas of every pair of the balls would have.
         static bool ComputeAveragedStrobedBallData(const GolfSimCamera& camera, 
                                             const GsBallsAndTimingVector& balls_and_timing,
                                             GolfBall& output_averaged_ball);
@@ -478,6 +579,16 @@ namespace golf_sim {
                                 GolfBall& result_ball,
                                 cv::Vec3d& rotationResults);
 
+        // Measures the rotation of up to kMaxSpinBallPairs of the ball_pair_elements (which
+        // must be sorted best-first) at the same time and fuses them.  The returned rotation is
+        // scaled to the interval of the best pair, which is the pair that is shown in the UI.
+        static bool ProcessMultiPairSpin(GolfSimCamera& camera,
+                                         const cv::Mat& strobed_balls_gray_image,
+                                         const GsBallsAndTimingVector& non_overlapping_balls_and_timing,
+                                         const std::vector<GsBallPairAndSpinCandidateScoreElement>& ball_pair_elements,
+                                         GolfBall& result_ball,
+                                         cv::Vec3d& rotationResults);
+
         static void DrawFilterLines(const std::vector<cv::Vec4i>& lines,
                                     cv::Mat& image, 
                                     const cv::Scalar& color, 
@@ -517,6 +628,11 @@ namespace golf_sim {
 
     private:
 
+        // One per strobe profile (driver, putter, ...), indexed by StrobeProfileId
+        static StrobeRatioMatcher strobe_ratio_matchers_[StrobeProfile::kNumberStrobeProfiles];
+
+        static FlightCorridorMask flight_corridor_mask_;
+
         // Distance is meters that the ball is from the lens.
         // The size of the ball is assumed to be a standard constant
         // NOTE - getCameraParameters must already have been called before this function is called
@@ -9,6 +9,7 @@
 #include <boost/foreach.hpp>
 #include <cstdlib>
 #include <memory>
+#include <sstream>
 
 #include "logging_tools.h"
 #include "gs_camera.h"
@@ -22,27 +23,157 @@
 
 namespace golf_sim {
 
-	boost::property_tree::ptree GolfSimConfiguration::configuration_root_;
+	std::string GolfSimConfiguration::configuration_filename_;
+
+	std::shared_ptr<const GsConfigurationSnapshot> GolfSimConfiguration::snapshot_ = std::make_shared<GsConfigurationSnapshot>();
+	std::mutex GolfSimConfiguration::snapshot_mutex_;
+
+	std::atomic<bool> GolfSimConfiguration::reload_requested_{ false };
 
 	bool GolfSimConfiguration::Initialize(const std::string& configuration_filename) {
 
+		configuration_filename_ = configuration_filename;
+
+		std::shared_ptr<GsConfigurationSnapshot> snapshot;
+
+		if (!ParseConfigurationFile(snapshot)) {
+			return false;
+		}
+
+		PublishSnapshot(snapshot);
+
+		// Read any values that we want to set early, here at initialization
+		if (!ReadValues()) {
+			return false;
+		}
+
+		return true;
+	}
+
+	bool GolfSimConfiguration::ParseConfigurationFile(std::shared_ptr<GsConfigurationSnapshot>& snapshot) {
+
+		snapshot = std::make_shared<GsConfigurationSnapshot>();
+
 		try {
-			boost::property_tree::read_json(configuration_filename, configuration_root_);
+			snapshot->file_write_time = std::filesystem::last_write_time(configuration_filename_);
+			boost::property_tree::read_json(configuration_filename_, snapshot->root);
 		}
 		catch (std::exception const& e)
 		{
-			GS_LOG_MSG(error, "GolfSimConfiguration::Initialize failed. ERROR: *** " + std::string(e.what()) + " ***");
+			GS_LOG_MSG(error, "GolfSimConfiguration::ParseConfigurationFile failed for " + configuration_filename_ + ". ERROR: *** " + std::string(e.what()) + " ***");
 			return false;
 		}
 
-		// Read any values that we want to set early, here at initialization
+		return true;
+	}
+
+	std::shared_ptr<const GsConfigurationSnapshot> GolfSimConfiguration::GetSnapshot() {
+		const std::lock_guard<std::mutex> lock(snapshot_mutex_);
+		return snapshot_;
+	}
+
+	uint64_t GolfSimConfiguration::GetGeneration() {
+		return GetSnapshot()->generation;
+	}
+
+	void GolfSimConfiguration::PublishSnapshot(const std::shared_ptr<const GsConfigurationSnapshot>& snapshot) {
+		const std::lock_guard<std::mutex> lock(snapshot_mutex_);
+		snapshot_ = snapshot;
+	}
+
+	std::shared_ptr<GsConfigurationSnapshot> GolfSimConfiguration::CopySnapshot() {
+		return std::make_shared<GsConfigurationSnapshot>(*GetSnapshot());
+	}
+
+	void GolfSimConfiguration::RequestReload() {
+		GS_LOG_MSG(info, "GolfSimConfiguration - configuration reload requested.  It will be applied before the next shot.");
+		reload_requested_ = true;
+	}
+
+	bool GolfSimConfiguration::ApplyPendingReload() {
+
+		if (configuration_filename_.empty()) {
+			return false;
+		}
+
+		std::shared_ptr<const GsConfigurationSnapshot> current_snapshot = GetSnapshot();
+
+		bool file_changed = false;
+
+		try {
+			file_changed = (std::filesystem::last_write_time(configuration_filename_) != current_snapshot->file_write_time);
+		}
+		catch (std::exception const& e)
+		{
+			GS_LOG_MSG(warning, "GolfSimConfiguration::ApplyPendingReload could not check the configuration file: " + std::string(e.what()));
+		}
+
+		if (!reload_requested_.exchange(false) && !file_changed) {
+			return false;
+		}
+
+		std::shared_ptr<GsConfigurationSnapshot> snapshot;
+
+		if (!ParseConfigurationFile(snapshot)) {
+			GS_LOG_MSG(error, "GolfSimConfiguration::ApplyPendingReload could not parse " + configuration_filename_ + ".  Keeping the current configuration.");
+			return false;
+		}
+
+		snapshot->generation = current_snapshot->generation + 1;
+		PublishSnapshot(snapshot);
+
 		if (!ReadValues()) {
+			GS_LOG_MSG(error, "GolfSimConfiguration::ApplyPendingReload - ReadValues failed.");
+		}
+
+		GS_LOG_MSG(info, "GolfSimConfiguration - reloaded " + configuration_filename_ + " (generation " + std::to_string(snapshot->generation) + ").");
+
+		return true;
+	}
+
+	bool GolfSimConfiguration::InstallSnapshotFromJson(const std::string& configuration_json) {
+
+		std::shared_ptr<const GsConfigurationSnapshot> current_snapshot = GetSnapshot();
+		std::shared_ptr<GsConfigurationSnapshot> snapshot = std::make_shared<GsConfigurationSnapshot>();
+
+		try {
+			std::istringstream configuration_stream(configuration_json);
+			boost::property_tree::read_json(configuration_stream, snapshot->root);
+		}
+		catch (std::exception const& e)
+		{
+			GS_LOG_MSG(error, "GolfSimConfiguration::InstallSnapshotFromJson could not parse the configuration. ERROR: *** " + std::string(e.what()) + " ***");
 			return false;
 		}
 
+		// Keep the file's time, so that the unchanged file is not reloaded over this snapshot.
+		// The new generation makes anything that caches constants re-read them.
+		snapshot->file_write_time = current_snapshot->file_write_time;
+		snapshot->generation = current_snapshot->generation + 1;
+		PublishSnapshot(snapshot);
+
+		if (!ReadValues()) {
+			GS_LOG_MSG(error, "GolfSimConfiguration::InstallSnapshotFromJson - ReadValues failed.");
+		}
+
 		return true;
 	}
 
+	void GolfSimConfiguration::RestoreSnapshot(const std::shared_ptr<const GsConfigurationSnapshot>& snapshot) {
+
+		if (!snapshot) {
+			return;
+		}
+
+		std::shared_ptr<GsConfigurationSnapshot> restored_snapshot = std::make_shared<GsConfigurationSnapshot>(*snapshot);
+		restored_snapshot->generation = GetGeneration() + 1;
+		PublishSnapshot(restored_snapshot);
+
+		if (!ReadValues()) {
+			GS_LOG_MSG(error, "GolfSimConfiguration::RestoreSnapshot - ReadValues failed.");
+		}
+	}
+
 	// Helper function to safely get environment variable as std::string
 	std::string GolfSimConfiguration::safe_getenv(const std::string& varname) {
 		char* buffer = nullptr;
@@ -74,7 +205,7 @@ namespace golf_sim {
 			SetConstant("gs_config.testing.kInterShotInjectionPauseSeconds", kInterShotInjectionPauseSeconds);
 
 			// Retrirve as many shots as are defined in the json file
-			boost::property_tree::ptree shots_json = configuration_root_.get_child("gs_config.testing.test_shots_to_inject");
+			boost::property_tree::ptree shots_json = GetSnapshot()->root.get_child("gs_config.testing.test_shots_to_inject");
 
 			int shot_number = 1;
 			for (boost::property_tree::ptree::iterator iter = shots_json.begin(); iter != shots_json.end(); iter++) {
@@ -236,7 +367,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	bool GolfSimConfiguration::PropertyExists(const std::string& value_tag) {
 		// int count = configuration_root_.count(value_tag);
-		boost::optional<std::string> v = configuration_root_.get_optional<std::string>(value_tag);
+		boost::optional<std::string> v = GetSnapshot()->root.get_optional<std::string>(value_tag);
 
 		return ((bool)v);
 	}
@@ -244,7 +375,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, bool& constant_value) {
 		try {
-			constant_value = configuration_root_.get<bool>(tag_name, false);
+			constant_value = GetSnapshot()->root.get<bool>(tag_name, false);
 		}
 		catch (std::exception const& e)
 		{
@@ -255,7 +386,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, int& constant_value) {
 		try {
-			constant_value = configuration_root_.get<int>(tag_name, 0);
+			constant_value = GetSnapshot()->root.get<int>(tag_name, 0);
 		}
 		catch (std::exception const& e)
 		{
@@ -266,7 +397,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, long& constant_value) {
 		try {
-			constant_value = configuration_root_.get<long>(tag_name, 0);
+			constant_value = GetSnapshot()->root.get<long>(tag_name, 0);
 		}
 		catch (std::exception const& e)
 		{
@@ -277,7 +408,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	void GolfSimConfiguration::SetConstant(const std::string& tag_name, unsigned int& constant_value) {
 		try {
-			constant_value = configuration_root_.get<uint>(tag_name, 0);
+			constant_value = GetSnapshot()->root.get<uint>(tag_name, 0);
 		}
 		catch (std::exception const& e)
 		{
@@ -288,7 +419,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, float& constant_value) {
 		try {
-			constant_value = configuration_root_.get<float>(tag_name, 0.0);
+			constant_value = GetSnapshot()->root.get<float>(tag_name, 0.0);
 		}
 		catch (std::exception const& e)
 		{
@@ -299,7 +430,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, double& constant_value) {
 		try {
-			constant_value = configuration_root_.get<double>(tag_name, 0.0);
+			constant_value = GetSnapshot()->root.get<double>(tag_name, 0.0);
 		}
 		catch (std::exception const& e)
 		{
@@ -310,7 +441,7 @@ bool GolfSimConfiguration::ReadValues() {
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, std::string& constant_value) {
 		 try {
-			 constant_value = configuration_root_.get<std::string>(tag_name, "");
+			 constant_value = GetSnapshot()->root.get<std::string>(tag_name, "");
 		 }
 		 catch (std::exception const& e)
 		 {
@@ -320,9 +451,11 @@ bool GolfSimConfiguration::ReadValues() {
 	 }
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, cv::Vec3d& vec) {
+		 std::shared_ptr<const GsConfigurationSnapshot> snapshot = GetSnapshot();
+
 		 try {
 			 int i = 0;
-			 for (boost::property_tree::ptree::value_type& element : configuration_root_.get_child(tag_name)) {
+			 for (const boost::property_tree::ptree::value_type& element : snapshot->root.get_child(tag_name)) {
 				 // vec[i] = std::stod(element.second.data());
 				 vec[i] = element.second.get_value<double>();
 				 i++;
@@ -335,9 +468,11 @@ bool GolfSimConfiguration::ReadValues() {
 	 }
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, cv::Vec2d& vec) {
+		 std::shared_ptr<const GsConfigurationSnapshot> snapshot = GetSnapshot();
+
 		 try {
 			 int i = 0;
-			 for (boost::property_tree::ptree::value_type& element : configuration_root_.get_child(tag_name)) {
+			 for (const boost::property_tree::ptree::value_type& element : snapshot->root.get_child(tag_name)) {
 				 // vec[i] = std::stod(element.second.data());
 				 vec[i] = element.second.get_value<double>();
 				 i++;
@@ -350,9 +485,11 @@ bool GolfSimConfiguration::ReadValues() {
 	 }
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, std::vector<float>& vec) {
+		 std::shared_ptr<const GsConfigurationSnapshot> snapshot = GetSnapshot();
+
 		 try {
 			 int i = 0;
-			 for (boost::property_tree::ptree::value_type& element : configuration_root_.get_child(tag_name)) {
+			 for (const boost::property_tree::ptree::value_type& element : snapshot->root.get_child(tag_name)) {
 				 vec.push_back( element.second.get_value<float>() );
 				 i++;
 			 }
@@ -364,12 +501,14 @@ bool GolfSimConfiguration::ReadValues() {
 	 }
 
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, std::vector<cv::Vec3d>& matrix) {
+		 std::shared_ptr<const GsConfigurationSnapshot> snapshot = GetSnapshot();
+
 		 try {
 			 int x = 0;
-			 for (boost::property_tree::ptree::value_type& row : configuration_root_.get_child(tag_name))
+			 for (const boost::property_tree::ptree::value_type& row : snapshot->root.get_child(tag_name))
 			 {
 				 int y = 0;
-				 for (boost::property_tree::ptree::value_type& cell : row.second)
+				 for (const boost::property_tree::ptree::value_type& cell : row.second)
 				 {
 					 matrix[x][y] = cell.second.get_value<double>();
 					 y++;
@@ -386,20 +525,22 @@ bool GolfSimConfiguration::ReadValues() {
 	 void GolfSimConfiguration::SetConstant(const std::string& tag_name, cv::Mat& matrix) {
 		 bool is_1D = (matrix.rows == 1);
 
+		 std::shared_ptr<const GsConfigurationSnapshot> snapshot = GetSnapshot();
+
 		 try {
 			 if (is_1D) {
 				 int i = 0;
-				 for (boost::property_tree::ptree::value_type& element : configuration_root_.get_child(tag_name)) {
+				 for (const boost::property_tree::ptree::value_type& element : snapshot->root.get_child(tag_name)) {
 					 matrix.at<double>(0, i) = element.second.get_value<double>();
 					 i++;
 				 }
 			 }
 			 else {
 				 int x = 0;
-				 for (boost::property_tree::ptree::value_type& row : configuration_root_.get_child(tag_name))
+				 for (const boost::property_tree::ptree::value_type& row : snapshot->root.get_child(tag_name))
 				 {
 					 int y = 0;
-					 for (boost::property_tree::ptree::value_type& cell : row.second)
+					 for (const boost::property_tree::ptree::value_type& cell : row.second)
 					 {
 						 matrix.at<double>(x, y) = cell.second.get_value<double>();
 						 y++;
@@ -420,7 +561,9 @@ bool GolfSimConfiguration::ReadValues() {
 			 std::string end_node_name = "kCamera1FocalLength";
 
 			 if (PropertyExists(tag_name)) {
-				 configuration_root_.erase(tag_name);
+				 std::shared_ptr<GsConfigurationSnapshot> snapshot = CopySnapshot();
+				 snapshot->root.erase(tag_name);
+				 PublishSnapshot(snapshot);
 				 return true;
 			 }
 		 }
@@ -442,9 +585,11 @@ bool GolfSimConfiguration::ReadValues() {
 
 			 bool node_exists = PropertyExists(tag_name);
 
+			 std::shared_ptr<GsConfigurationSnapshot> snapshot = CopySnapshot();
+
 			 if (node_exists) {
 				 int i = 0;
-				 for (boost::property_tree::ptree::value_type& element : configuration_root_.get_child(tag_name)) {
+				 for (boost::property_tree::ptree::value_type& element : snapshot->root.get_child(tag_name)) {
 					 element.second.put("", vec[i++]);
 				 }
 			 }
@@ -459,8 +604,10 @@ bool GolfSimConfiguration::ReadValues() {
 				 element.put("", vec[1]);
 				 new_node.push_back(std::make_pair("", element));
 
-				 configuration_root_.add_child(tag_name, new_node);
+				 snapshot->root.add_child(tag_name, new_node);
 			 }
+
+			 PublishSnapshot(snapshot);
 		 }
 		 catch (std::exception const& e)
 		 {
@@ -478,7 +625,9 @@ bool GolfSimConfiguration::ReadValues() {
 		 // RemoveTreeNode(tag_name);
 
 		 try {
-			 configuration_root_.put(tag_name, value);
+			 std::shared_ptr<GsConfigurationSnapshot> snapshot = CopySnapshot();
+			 snapshot->root.put(tag_name, value);
+			 PublishSnapshot(snapshot);
 		 }
 		 catch (std::exception const& e)
 		 {
@@ -497,7 +646,7 @@ bool GolfSimConfiguration::ReadValues() {
 			 
 		 std::ofstream file(file_name);
 		 if (file.is_open()) {
-			 boost::property_tree::write_json(file, configuration_root_);
+			 boost::property_tree::write_json(file, GetSnapshot()->root);
 			 file.close();
 		 }
 		 else {
@@ -6,9 +6,20 @@
 // This class provides an interface to the .json configuration file that is used to set
 // various constants in the system.  It is also responsible for reading many of those
 // constant values early as the system initializes.
+//
+// The parsed file is held in an immutable snapshot.  When the file changes (or a reload
+// control message is received), a new snapshot is parsed and published in place of the old
+// one, and the constants are re-read from it at the next shot boundary.  Anything still
+// holding the old snapshot keeps seeing the old values until it lets go of it.
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
 #include <boost/program_options.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <opencv2/core.hpp>
@@ -17,6 +28,16 @@
 
 namespace golf_sim {
 
+	// One parsed version of the .json configuration file.  Never modified once published.
+	struct GsConfigurationSnapshot {
+		boost::property_tree::ptree root;
+
+		// Incremented each time a re-parsed file is published
+		uint64_t generation = 0;
+
+		std::filesystem::file_time_type file_write_time;
+	};
+
 	class GolfSimConfiguration {
 
 	public:
@@ -39,6 +60,34 @@ namespace golf_sim {
 		// e.g., there's not constructur that will be called.
 		static bool ReadValues();
 
+		// Returns the current snapshot.  Safe to call from any thread.
+		static std::shared_ptr<const GsConfigurationSnapshot> GetSnapshot();
+
+		// The generation of the current snapshot.  Objects that cache constants can compare
+		// this against the generation they were built with to know when to re-read them.
+		static uint64_t GetGeneration();
+
+		// Asks for the configuration file to be re-read at the next shot boundary,
+		// even if it does not appear to have changed.
+		static void RequestReload();
+
+		// Called at shot boundaries.  If a reload was requested, or the configuration file has
+		// been written since it was last read, parses the file into a new snapshot, publishes
+		// it, and re-reads the early constants (see ReadValues).  If the new file cannot be
+		// parsed, the current snapshot is kept.
+		// Returns true if a new snapshot was published.
+		static bool ApplyPendingReload();
+
+		// Publishes a snapshot parsed from configuration_json (for example, the configuration that
+		// a shot capture was taken with) in place of the current one, and re-reads the early
+		// constants.  The configuration file is not changed.  Returns false (and keeps the current
+		// snapshot) if the JSON cannot be parsed.
+		static bool InstallSnapshotFromJson(const std::string& configuration_json);
+
+		// Publishes a snapshot that was earlier returned by GetSnapshot (for example, the live
+		// configuration after InstallSnapshotFromJson), and re-reads the early constants.
+		static void RestoreSnapshot(const std::shared_ptr<const GsConfigurationSnapshot>& snapshot);
+
 		static bool PropertyExists(const std::string& value_tag);
 
 		static void SetConstant(const std::string& value_tag, bool& constant_value);
@@ -76,7 +125,19 @@ namespace golf_sim {
 
 	protected:
 
-		static boost::property_tree::ptree configuration_root_;
+		static bool ParseConfigurationFile(std::shared_ptr<GsConfigurationSnapshot>& snapshot);
+
+		static void PublishSnapshot(const std::shared_ptr<const GsConfigurationSnapshot>& snapshot);
+
+		// Copy-on-write for the (rare, e.g., calibration) changes made to the tree in memory
+		static std::shared_ptr<GsConfigurationSnapshot> CopySnapshot();
+
+		static std::string configuration_filename_;
+
+		static std::shared_ptr<const GsConfigurationSnapshot> snapshot_;
+		static std::mutex snapshot_mutex_;
+
+		static std::atomic<bool> reload_requested_;
 	};
 
 }
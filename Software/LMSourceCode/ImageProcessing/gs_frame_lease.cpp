@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <chrono>
+#include <memory>
+
+#include "core/rpicam_app.hpp"
+#include "core/buffer_sync.hpp"
+
+#include "logging_tools.h"
+
+#include "gs_frame_lease.h"
+
+
+namespace golf_sim {
+
+    std::atomic<uint64_t> GsFrameLease::number_leases_created_{ 0 };
+    std::atomic<uint64_t> GsFrameLease::number_leases_released_{ 0 };
+    std::atomic<uint64_t> GsFrameLease::number_frame_copies_{ 0 };
+
+    // Everything that has to stay alive while any copy of the leased Mat exists
+    struct GsFrameLeaseState {
+        CompletedRequestPtr request;
+        std::unique_ptr<BufferReadSync> read_sync;
+        std::chrono::steady_clock::time_point lease_time;
+        std::atomic<int> number_frame_copies{ 0 };
+    };
+
+    // OpenCV calls the allocator of a Mat's UMatData when the data's reference count drops
+    // to zero.  A leased Mat's UMatData uses this allocator, so that the lease is released
+    // instead of the (camera-owned) data being freed.  New Mats are never allocated with it.
+    class GsFrameLeaseAllocator : public cv::MatAllocator {
+
+    public:
+
+        cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                               cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override {
+            return cv::Mat::getDefaultAllocator()->allocate(dims, sizes, type, data, step, flags, usage_flags);
+        }
+
+        bool allocate(cv::UMatData* u, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override {
+            return cv::Mat::getDefaultAllocator()->allocate(u, access_flags, usage_flags);
+        }
+
+        void deallocate(cv::UMatData* u) const override {
+            if (u == nullptr) {
+                return;
+            }
+
+            GsFrameLease::ReleaseLease(u->userdata);
+
+            u->userdata = nullptr;
+            u->data = u->origdata = nullptr;
+            delete u;
+        }
+    };
+
+    static GsFrameLeaseAllocator lease_allocator;
+
+
+    cv::Mat GsFrameLease::LeaseFrame(RPiCamApp& app,
+                                     const CompletedRequestPtr& request,
+                                     libcamera::Stream* stream,
+                                     const int mat_type) {
+
+        if (request == nullptr || stream == nullptr) {
+            GS_LOG_MSG(error, "GsFrameLease::LeaseFrame called with a null request or stream.");
+            return cv::Mat();
+        }
+
+        auto buffer_it = request->buffers.find(stream);
+
+        if (buffer_it == request->buffers.end() || buffer_it->second == nullptr) {
+            GS_LOG_MSG(error, "GsFrameLease::LeaseFrame - request " + std::to_string(request->sequence) + " has no buffer for the stream.");
+            return cv::Mat();
+        }
+
+        auto lease = std::make_unique<GsFrameLeaseState>();
+        lease->request = request;
+        lease->read_sync = std::make_unique<BufferReadSync>(&app, buffer_it->second);
+        lease->lease_time = std::chrono::steady_clock::now();
+
+        const std::vector<libcamera::Span<uint8_t>>& mem = lease->read_sync->Get();
+
+        if (mem.empty() || mem[0].data() == nullptr) {
+            GS_LOG_MSG(error, "GsFrameLease::LeaseFrame - could not map the buffer of request " + std::to_string(request->sequence) + ".");
+            return cv::Mat();
+        }
+
+        StreamInfo info = app.GetStreamInfo(stream);
+
+        // The Mat header views the buffer directly.  Attaching our own UMatData gives the
+        // header a reference count that all of its copies will share.
+        cv::Mat frame(info.height, info.width, mat_type, mem[0].data(), info.stride);
+
+        cv::UMatData* u = new cv::UMatData(&lease_allocator);
+        u->data = u->origdata = frame.data;
+        u->size = (size_t)info.stride * info.height;
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+        u->userdata = lease.release();
+        u->refcount = 1;
+        frame.u = u;
+
+        number_leases_created_++;
+
+        GS_LOG_TRACE_MSG(trace, "GsFrameLease::LeaseFrame leased request " + std::to_string(request->sequence) +
+            " (" + std::to_string(info.width) + "x" + std::to_string(info.height) + ", stride " + std::to_string(info.stride) + ").");
+
+        return frame;
+    }
+
+    bool GsFrameLease::IsLeased(const cv::Mat& frame) {
+        return (frame.u != nullptr && frame.u->currAllocator == &lease_allocator);
+    }
+
+    cv::Mat GsFrameLease::Detach(cv::Mat& frame) {
+
+        if (!IsLeased(frame)) {
+            return frame;
+        }
+
+        GsFrameLeaseState* lease = static_cast<GsFrameLeaseState*>(frame.u->userdata);
+        lease->number_frame_copies++;
+        number_frame_copies_++;
+
+        cv::Mat copy = frame.clone();
+        frame.release();
+
+        return copy;
+    }
+
+    void GsFrameLease::ReleaseLease(void* lease_ptr) {
+
+        std::unique_ptr<GsFrameLeaseState> lease(static_cast<GsFrameLeaseState*>(lease_ptr));
+
+        if (lease == nullptr) {
+            return;
+        }
+
+        const double held_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lease->lease_time).count();
+
+        GS_LOG_TRACE_MSG(trace, "GsFrameLease released request " + std::to_string(lease->request->sequence) +
+            " after " + std::to_string(held_ms) + " ms.  Full-frame copies made from it: " + std::to_string(lease->number_frame_copies.load()));
+
+        // End the buffer's read-sync before the request can be re-queued to the camera
+        lease->read_sync.reset();
+        lease->request.reset();
+
+        number_leases_released_++;
+    }
+
+    int GsFrameLease::GetNumberOutstandingLeases() {
+        return (int)(number_leases_created_.load() - number_leases_released_.load());
+    }
+
+    void GsFrameLease::LogStatistics() {
+        GS_LOG_MSG(info, "GsFrameLease: leases created = " + std::to_string(number_leases_created_.load()) +
+            ", released = " + std::to_string(number_leases_released_.load()) +
+            ", full-frame copies = " + std::to_string(number_frame_copies_.load()) + ".");
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
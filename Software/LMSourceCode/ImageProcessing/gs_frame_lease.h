@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Lends out a camera frame as a cv::Mat that views the request's mmapped buffer directly,
+// instead of copying the frame out of the buffer.
+//
+// Building a plain cv::Mat over the buffer does not work, because the CompletedRequest
+// that owns the buffer is recycled (re-queued to the camera) as soon as the event loop
+// lets go of its message.  A leased Mat instead holds a reference to the CompletedRequest
+// and to the buffer's read-sync.  Every copy of the Mat header shares that reference, so
+// the request is only released (and re-queued) when the last copy of the Mat is released.
+//
+// The buffer mappings themselves belong to the camera app, and are unmapped when the app
+// is torn down.  So a leased frame must be released (or Detach'ed) before the app's
+// Teardown() is called.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <atomic>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+
+#include "core/completed_request.hpp"
+
+
+class RPiCamApp;
+
+namespace libcamera {
+    class Stream;
+}
+
+
+namespace golf_sim {
+
+    class GsFrameLease {
+
+    public:
+
+        // Returns a Mat (of the given type) that views the stream's buffer in the request.
+        // The request is held until the returned Mat and all copies of it are released.
+        // Returns an empty Mat if the buffer could not be mapped.
+        static cv::Mat LeaseFrame(RPiCamApp& app,
+                                  const CompletedRequestPtr& request,
+                                  libcamera::Stream* stream,
+                                  const int mat_type);
+
+        // True if the Mat (or the Mat it was copied from) was returned by LeaseFrame
+        static bool IsLeased(const cv::Mat& frame);
+
+        // Returns a deep copy of a leased frame that does not depend on the camera buffer,
+        // and releases the caller's lease.  Used where the frame has to outlive the camera app.
+        // Frames that are not leased are returned as-is.
+        static cv::Mat Detach(cv::Mat& frame);
+
+        // The number of leases that have not yet been released.  Should be 0 before the camera
+        // app is torn down.
+        static int GetNumberOutstandingLeases();
+
+        static void LogStatistics();
+
+    protected:
+
+        friend class GsFrameLeaseAllocator;
+
+        // Called when the last copy of a leased Mat has been released
+        static void ReleaseLease(void* lease);
+
+        static std::atomic<uint64_t> number_leases_created_;
+        static std::atomic<uint64_t> number_leases_released_;
+        // Full-frame copies that were made from leased frames (by Detach)
+        static std::atomic<uint64_t> number_frame_copies_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,395 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_metrics.h"
+
+#include "gs_frame_monitor.h"
+
+
+namespace golf_sim {
+
+    int GsFrameMonitor::kFrameMonitorSummaryIntervalSeconds = 10;
+    float GsFrameMonitor::kFrameMonitorLowFpsWarningFraction = 0.9F;
+
+    GsFrameMonitor::AtomicHistogram<GsFrameMonitor::kIntervalBucketEdgesUs.size()> GsFrameMonitor::intervals_us_(GsFrameMonitor::kIntervalBucketEdgesUs);
+    GsFrameMonitor::AtomicHistogram<GsFrameMonitor::kProcessingBucketEdgesUs.size()> GsFrameMonitor::processing_us_(GsFrameMonitor::kProcessingBucketEdgesUs);
+    GsFrameMonitor::AtomicHistogram<GsFrameMonitor::kQueueDepthBucketEdges.size()> GsFrameMonitor::queue_depth_(GsFrameMonitor::kQueueDepthBucketEdges);
+
+    std::atomic<uint64_t> GsFrameMonitor::number_frames_{ 0 };
+    std::atomic<uint64_t> GsFrameMonitor::number_sequence_gaps_{ 0 };
+    std::atomic<uint64_t> GsFrameMonitor::number_frames_dropped_{ 0 };
+    std::atomic<uint64_t> GsFrameMonitor::number_frames_out_of_order_{ 0 };
+
+    std::atomic<int64_t> GsFrameMonitor::last_sequence_number_{ -1 };
+    std::atomic<int64_t> GsFrameMonitor::last_sensor_timestamp_ns_{ -1 };
+
+    double GsFrameMonitor::expected_fps_ = 0.0;
+    std::chrono::steady_clock::time_point GsFrameMonitor::watching_start_time_;
+    std::chrono::steady_clock::time_point GsFrameMonitor::last_summary_time_;
+    GsFrameMonitor::Snapshot GsFrameMonitor::last_summary_snapshot_;
+
+    std::mutex GsFrameMonitor::reporter_mutex_;
+    std::condition_variable GsFrameMonitor::reporter_condition_;
+    std::deque<GsFrameMonitor::PendingReport> GsFrameMonitor::pending_reports_;
+    std::thread GsFrameMonitor::reporter_thread_;
+    bool GsFrameMonitor::reporter_stopping_ = false;
+
+    template <size_t N>
+    void GsFrameMonitor::AtomicHistogram<N>::Record(const uint64_t value) {
+        const size_t bucket = std::lower_bound(bucket_edges.begin(), bucket_edges.end(), value) - bucket_edges.begin();
+
+        counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current_max = max.load(std::memory_order_relaxed);
+        while (value > current_max && !max.compare_exchange_weak(current_max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    template <size_t N>
+    void GsFrameMonitor::AtomicHistogram<N>::Reset() {
+        for (std::atomic<uint64_t>& count : counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        sum.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    template <size_t N>
+    GsFrameMonitor::HistogramSnapshot GsFrameMonitor::AtomicHistogram<N>::GetSnapshot() const {
+        HistogramSnapshot snapshot;
+        snapshot.bucket_edges.assign(bucket_edges.begin(), bucket_edges.end());
+
+        for (const std::atomic<uint64_t>& count : counts) {
+            snapshot.counts.push_back(count.load(std::memory_order_relaxed));
+            snapshot.number_samples += snapshot.counts.back();
+        }
+
+        snapshot.sum = sum.load(std::memory_order_relaxed);
+        snapshot.max = max.load(std::memory_order_relaxed);
+
+        return snapshot;
+    }
+
+    double GsFrameMonitor::HistogramSnapshot::GetMean() const {
+        return (number_samples > 0) ? (double)sum / number_samples : 0.0;
+    }
+
+    uint64_t GsFrameMonitor::HistogramSnapshot::GetPercentileUpperBound(const double fraction) const {
+        const double threshold = fraction * number_samples;
+        uint64_t cumulative = 0;
+
+        for (size_t i = 0; i < counts.size(); i++) {
+            cumulative += counts[i];
+
+            if (cumulative > 0 && cumulative >= threshold) {
+                // The last bucket has no upper edge, so the largest value seen is the bound
+                return (i < bucket_edges.size()) ? std::min<uint64_t>(bucket_edges[i], max) : max;
+            }
+        }
+
+        return max;
+    }
+
+    double GsFrameMonitor::Snapshot::GetMeasuredFps() const {
+        const double mean_interval_us = intervals_us.GetMean();
+        return (mean_interval_us > 0.0) ? 1.0e6 / mean_interval_us : 0.0;
+    }
+
+    void GsFrameMonitor::StartWatching(const double expected_fps) {
+
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kFrameMonitorSummaryIntervalSeconds", kFrameMonitorSummaryIntervalSeconds);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kFrameMonitorLowFpsWarningFraction", kFrameMonitorLowFpsWarningFraction);
+
+        intervals_us_.Reset();
+        processing_us_.Reset();
+        queue_depth_.Reset();
+
+        number_frames_.store(0, std::memory_order_relaxed);
+        number_sequence_gaps_.store(0, std::memory_order_relaxed);
+        number_frames_dropped_.store(0, std::memory_order_relaxed);
+        number_frames_out_of_order_.store(0, std::memory_order_relaxed);
+        last_sequence_number_.store(-1, std::memory_order_relaxed);
+        last_sensor_timestamp_ns_.store(-1, std::memory_order_relaxed);
+
+        expected_fps_ = expected_fps;
+        watching_start_time_ = std::chrono::steady_clock::now();
+        last_summary_time_ = watching_start_time_;
+        last_summary_snapshot_ = GetSnapshot();
+    }
+
+    void GsFrameMonitor::EndWatching() {
+        QueueReport(GetSnapshot(), "watching period", true);
+    }
+
+    void GsFrameMonitor::QueueReport(const Snapshot& snapshot, const std::string& period_name, const bool end_of_watching) {
+        {
+            const std::lock_guard<std::mutex> lock(reporter_mutex_);
+
+            if (!reporter_thread_.joinable()) {
+                reporter_stopping_ = false;
+                reporter_thread_ = std::thread(ReporterLoop);
+            }
+
+            PendingReport report;
+            report.snapshot = snapshot;
+            report.period_name = period_name;
+            report.end_of_watching = end_of_watching;
+            pending_reports_.push_back(std::move(report));
+        }
+
+        reporter_condition_.notify_one();
+    }
+
+    void GsFrameMonitor::StopReporter() {
+        {
+            const std::lock_guard<std::mutex> lock(reporter_mutex_);
+
+            if (!reporter_thread_.joinable()) {
+                return;
+            }
+
+            reporter_stopping_ = true;
+        }
+
+        reporter_condition_.notify_all();
+        reporter_thread_.join();
+    }
+
+    void GsFrameMonitor::ReporterLoop() {
+        while (true) {
+            PendingReport report;
+
+            {
+                std::unique_lock<std::mutex> lock(reporter_mutex_);
+                reporter_condition_.wait(lock, [] { return reporter_stopping_ || !pending_reports_.empty(); });
+
+                if (pending_reports_.empty()) {
+                    return;
+                }
+
+                report = std::move(pending_reports_.front());
+                pending_reports_.pop_front();
+            }
+
+            Report(report);
+        }
+    }
+
+    void GsFrameMonitor::Report(PendingReport& report) {
+        Snapshot& snapshot = report.snapshot;
+        snapshot.cpu_temperature_c = ReadCpuTemperature();
+
+        if (report.end_of_watching) {
+            GS_LOG_MSG(info, "Watching frames: " + FormatSnapshot(snapshot));
+        }
+        else {
+            GS_LOG_MSG(info, "Watching frames (" + report.period_name + "): " + FormatSnapshot(snapshot));
+        }
+
+        CheckForProblems(snapshot, report.period_name);
+
+        if (!report.end_of_watching) {
+            return;
+        }
+
+        static GsMetricGauge& measured_fps = GsMetrics::GetGauge("pitrac_watching_fps",
+            "Measured frame rate of the last ball-watching period");
+        static GsMetricGauge& expected_fps = GsMetrics::GetGauge("pitrac_watching_expected_fps",
+            "Configured frame rate of the last ball-watching period");
+        static GsMetricCounter& frames = GsMetrics::GetCounter("pitrac_watching_frames_total",
+            "Frames delivered while watching for the ball to be hit");
+        static GsMetricCounter& frames_dropped = GsMetrics::GetCounter("pitrac_watching_frames_dropped_total",
+            "Frames dropped (gaps in the sensor frame sequence numbers) while watching for the ball to be hit");
+        static GsMetricHistogram& frame_intervals = GsMetrics::GetHistogram("pitrac_watching_max_frame_interval_seconds",
+            "Longest interval between frames in each ball-watching period", GsMetricHistogram::kLatencyBucketsSeconds);
+        static GsMetricGauge& cpu_temperature = GsMetrics::GetGauge("pitrac_cpu_temperature_celsius",
+            "CPU temperature at the end of the last ball-watching period");
+
+        measured_fps.Set(snapshot.GetMeasuredFps());
+        expected_fps.Set(snapshot.expected_fps);
+        frames.Increment(snapshot.number_frames);
+        frames_dropped.Increment(snapshot.number_frames_dropped);
+        frame_intervals.Observe(snapshot.intervals_us.max / 1.0e6);
+
+        if (snapshot.cpu_temperature_c >= 0.0) {
+            cpu_temperature.Set(snapshot.cpu_temperature_c);
+        }
+    }
+
+    void GsFrameMonitor::RecordFrame(const uint32_t sequence_number, const int64_t sensor_timestamp_ns) {
+
+        number_frames_.fetch_add(1, std::memory_order_relaxed);
+
+        // Only move the last sequence number forward, even if frames are handled out of order
+        int64_t last_sequence_number = last_sequence_number_.load(std::memory_order_relaxed);
+
+        while ((int64_t)sequence_number > last_sequence_number &&
+               !last_sequence_number_.compare_exchange_weak(last_sequence_number, sequence_number, std::memory_order_relaxed)) {
+        }
+
+        if (last_sequence_number < 0) {
+            // The first frame of the watching period.  The sensor's sequence numbers carry on from
+            // whatever the camera was last doing, so this is only the starting point for the gaps.
+            last_sensor_timestamp_ns_.store(sensor_timestamp_ns, std::memory_order_relaxed);
+            return;
+        }
+
+        if ((int64_t)sequence_number <= last_sequence_number) {
+            number_frames_out_of_order_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if ((int64_t)sequence_number > last_sequence_number + 1) {
+            number_sequence_gaps_.fetch_add(1, std::memory_order_relaxed);
+            number_frames_dropped_.fetch_add(sequence_number - last_sequence_number - 1, std::memory_order_relaxed);
+        }
+
+        const int64_t last_sensor_timestamp_ns = last_sensor_timestamp_ns_.exchange(sensor_timestamp_ns, std::memory_order_relaxed);
+
+        if (last_sensor_timestamp_ns > 0 && sensor_timestamp_ns > last_sensor_timestamp_ns) {
+            intervals_us_.Record((uint64_t)(sensor_timestamp_ns - last_sensor_timestamp_ns) / 1000);
+        }
+    }
+
+    void GsFrameMonitor::RecordProcessingTime(const std::chrono::nanoseconds processing_time) {
+        processing_us_.Record((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(processing_time).count());
+    }
+
+    void GsFrameMonitor::RecordQueueDepth(const size_t depth) {
+        queue_depth_.Record(depth);
+    }
+
+    void GsFrameMonitor::LogPeriodicSummary() {
+
+        if (kFrameMonitorSummaryIntervalSeconds <= 0) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - last_summary_time_ < std::chrono::seconds(kFrameMonitorSummaryIntervalSeconds)) {
+            return;
+        }
+
+        const Snapshot snapshot = GetSnapshot();
+        const Snapshot period = Subtract(snapshot, last_summary_snapshot_);
+
+        QueueReport(period, "last " + std::to_string(kFrameMonitorSummaryIntervalSeconds) + " seconds", false);
+
+        last_summary_time_ = now;
+        last_summary_snapshot_ = snapshot;
+    }
+
+    GsFrameMonitor::Snapshot GsFrameMonitor::GetSnapshot() {
+        Snapshot snapshot;
+
+        snapshot.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - watching_start_time_).count();
+        snapshot.expected_fps = expected_fps_;
+        snapshot.number_frames = number_frames_.load(std::memory_order_relaxed);
+        snapshot.number_sequence_gaps = number_sequence_gaps_.load(std::memory_order_relaxed);
+        snapshot.number_frames_dropped = number_frames_dropped_.load(std::memory_order_relaxed);
+        snapshot.number_frames_out_of_order = number_frames_out_of_order_.load(std::memory_order_relaxed);
+        snapshot.intervals_us = intervals_us_.GetSnapshot();
+        snapshot.processing_us = processing_us_.GetSnapshot();
+        snapshot.queue_depth = queue_depth_.GetSnapshot();
+
+        return snapshot;
+    }
+
+    GsFrameMonitor::HistogramSnapshot GsFrameMonitor::Subtract(const HistogramSnapshot& later, const HistogramSnapshot& earlier) {
+        HistogramSnapshot difference = later;
+
+        if (earlier.counts.size() != later.counts.size()) {
+            return difference;
+        }
+
+        difference.number_samples = later.number_samples - earlier.number_samples;
+        difference.sum = later.sum - earlier.sum;
+
+        for (size_t i = 0; i < difference.counts.size(); i++) {
+            difference.counts[i] = later.counts[i] - earlier.counts[i];
+        }
+
+        // The maximum cannot be split by period, so the period's is an upper bound
+
+        return difference;
+    }
+
+    GsFrameMonitor::Snapshot GsFrameMonitor::Subtract(const Snapshot& later, const Snapshot& earlier) {
+        Snapshot difference = later;
+
+        difference.elapsed_seconds = later.elapsed_seconds - earlier.elapsed_seconds;
+        difference.number_frames = later.number_frames - earlier.number_frames;
+        difference.number_sequence_gaps = later.number_sequence_gaps - earlier.number_sequence_gaps;
+        difference.number_frames_dropped = later.number_frames_dropped - earlier.number_frames_dropped;
+        difference.number_frames_out_of_order = later.number_frames_out_of_order - earlier.number_frames_out_of_order;
+        difference.intervals_us = Subtract(later.intervals_us, earlier.intervals_us);
+        difference.processing_us = Subtract(later.processing_us, earlier.processing_us);
+        difference.queue_depth = Subtract(later.queue_depth, earlier.queue_depth);
+
+        return difference;
+    }
+
+    void GsFrameMonitor::CheckForProblems(const Snapshot& snapshot, const std::string& period_name) {
+
+        const double measured_fps = snapshot.GetMeasuredFps();
+
+        if (snapshot.expected_fps > 0.0 && measured_fps > 0.0 && measured_fps < kFrameMonitorLowFpsWarningFraction * snapshot.expected_fps) {
+            GS_LOG_MSG(warning, "Watching frame rate over the " + period_name + " was " + std::to_string(measured_fps) +
+                " FPS instead of " + std::to_string(snapshot.expected_fps) + " FPS (CPU temperature " +
+                std::to_string(snapshot.cpu_temperature_c) + " C).  The camera-2 trigger may be late.  Is the Pi being throttled?");
+        }
+
+        if (snapshot.number_frames_dropped > 0) {
+            GS_LOG_MSG(warning, "Watching frames dropped over the " + period_name + ": " + std::to_string(snapshot.number_frames_dropped) +
+                " in " + std::to_string(snapshot.number_sequence_gaps) + " gaps.");
+        }
+    }
+
+    double GsFrameMonitor::ReadCpuTemperature() {
+        std::ifstream temperature_file("/sys/class/thermal/thermal_zone0/temp");
+        long millidegrees = 0;
+
+        if (!(temperature_file >> millidegrees)) {
+            return -1.0;
+        }
+
+        return millidegrees / 1000.0;
+    }
+
+    std::string GsFrameMonitor::FormatSnapshot(const Snapshot& snapshot) {
+        std::ostringstream s;
+        s.setf(std::ios::fixed);
+        s.precision(1);
+
+        s << snapshot.number_frames << " frames in " << snapshot.elapsed_seconds << " s, "
+            << snapshot.GetMeasuredFps() << " FPS (expected " << snapshot.expected_fps << "), "
+            << snapshot.number_frames_dropped << " dropped in " << snapshot.number_sequence_gaps << " gaps, "
+            << snapshot.number_frames_out_of_order << " out of order.  "
+            << "Interval (us) mean/p95/max = " << snapshot.intervals_us.GetMean() << "/"
+            << snapshot.intervals_us.GetPercentileUpperBound(0.95) << "/" << snapshot.intervals_us.max << ".  "
+            << "Motion detection (us) mean/p95/max = " << snapshot.processing_us.GetMean() << "/"
+            << snapshot.processing_us.GetPercentileUpperBound(0.95) << "/" << snapshot.processing_us.max << ".  "
+            << "Queue depth max = " << snapshot.queue_depth.max << ".";
+
+        if (snapshot.cpu_temperature_c >= 0.0) {
+            s << "  CPU " << snapshot.cpu_temperature_c << " C.";
+        }
+
+        return s.str();
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,194 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Continuous instrumentation of the high-FPS "watching" stream that camera 1 uses to detect
+// the ball being hit.  If the cropped frame rate drops (for example, when the Pi is
+// thermally throttled) or frames are dropped, the external trigger to camera 2 is sent late.
+// This monitor makes that visible.
+//
+// For each watching period (from StartWatching until EndWatching), it keeps:
+//      - the number of frames, and any gaps in the sensor's frame sequence numbers
+//        (dropped frames) or frames that arrived out of order
+//      - a histogram of the intervals between the frames' sensor timestamps
+//      - a histogram of the time the motion-detection stage takes per frame
+//      - a histogram of the depth of the camera's completed-request message queue
+//
+// The recording functions may be called from several threads at once (the post-processing
+// stage can run in parallel), and only use atomic counters, so they never block.
+//
+// A summary is logged every kFrameMonitorSummaryIntervalSeconds while watching, and at the
+// end of each watching period.  The end of each period also updates the pitrac_watching_...
+// metrics (see GsMetrics), which is how the frame rate is published outside the LM.
+//
+// The end of a watching period is right after motion was detected, so the summaries (including
+// the CPU temperature, which is read from sysfs) are handed to a reporting thread instead of
+// being logged and published by the watching thread.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace golf_sim {
+
+    class GsFrameMonitor {
+
+    public:
+
+        // The upper edges of the histogram buckets.  A final bucket holds everything larger.
+        static constexpr std::array<uint32_t, 12> kIntervalBucketEdgesUs = { 1000, 1500, 2000, 2500, 3000, 4000, 5000, 7500, 10000, 15000, 20000, 50000 };
+        static constexpr std::array<uint32_t, 10> kProcessingBucketEdgesUs = { 25, 50, 100, 200, 300, 500, 750, 1000, 2000, 5000 };
+        static constexpr std::array<uint32_t, 7> kQueueDepthBucketEdges = { 0, 1, 2, 3, 4, 8, 16 };
+
+        // A copy of one histogram's counts
+        struct HistogramSnapshot {
+            std::vector<uint32_t> bucket_edges;
+            std::vector<uint64_t> counts;       // One more than the edges
+            uint64_t number_samples = 0;
+            uint64_t sum = 0;
+            uint64_t max = 0;
+
+            double GetMean() const;
+            // An upper bound for the value below which the fraction (0-1) of the samples fall
+            uint64_t GetPercentileUpperBound(const double fraction) const;
+        };
+
+        struct Snapshot {
+            double elapsed_seconds = 0.0;
+            double expected_fps = 0.0;
+            uint64_t number_frames = 0;
+            uint64_t number_sequence_gaps = 0;
+            uint64_t number_frames_dropped = 0;
+            uint64_t number_frames_out_of_order = 0;
+            HistogramSnapshot intervals_us;
+            HistogramSnapshot processing_us;
+            HistogramSnapshot queue_depth;
+            // Negative if the CPU temperature has not been (or could not be) read.  Only the
+            // reporting thread reads it.
+            double cpu_temperature_c = -1.0;
+
+            // From the mean interval between frames
+            double GetMeasuredFps() const;
+        };
+
+        // These are set from the "motion_detect_stage" section of the .json configuration file
+        // 0 means no periodic summary (only the one at the end of each watching period)
+        static int kFrameMonitorSummaryIntervalSeconds;
+        // A warning is logged if the measured rate falls below this fraction of the expected rate
+        static float kFrameMonitorLowFpsWarningFraction;
+
+        // Resets the counters for a new watching period at the given frame rate
+        static void StartWatching(const double expected_fps);
+
+        // Queues the period's summary to be logged and published to the metrics
+        static void EndWatching();
+
+        // Reports any queued summaries, and stops the reporting thread
+        static void StopReporter();
+
+        // Called for every frame that the camera delivers.  sequence_number is the sensor's frame
+        // sequence number (from the buffer's metadata), which need not start at zero.  Only the
+        // differences between the frames of one watching period are used.
+        static void RecordFrame(const uint32_t sequence_number, const int64_t sensor_timestamp_ns);
+
+        static void RecordProcessingTime(const std::chrono::nanoseconds processing_time);
+
+        static void RecordQueueDepth(const size_t depth);
+
+        // Queues a summary of the frames since the last summary, if kFrameMonitorSummaryIntervalSeconds
+        // have passed.  Called by the thread that is waiting for the frames.
+        static void LogPeriodicSummary();
+
+        // The counts since StartWatching
+        static Snapshot GetSnapshot();
+
+        // One line, for the logs
+        static std::string FormatSnapshot(const Snapshot& snapshot);
+
+        // Records the time from its construction to its destruction as a processing time
+        class ScopedProcessingTimer {
+        public:
+            ScopedProcessingTimer() : start_time_(std::chrono::steady_clock::now()) {}
+            ~ScopedProcessingTimer() { RecordProcessingTime(std::chrono::steady_clock::now() - start_time_); }
+        private:
+            std::chrono::steady_clock::time_point start_time_;
+        };
+
+    protected:
+
+        template <size_t N>
+        struct AtomicHistogram {
+            const std::array<uint32_t, N>& bucket_edges;
+            std::array<std::atomic<uint64_t>, N + 1> counts{};
+            std::atomic<uint64_t> sum{ 0 };
+            std::atomic<uint64_t> max{ 0 };
+
+            explicit AtomicHistogram(const std::array<uint32_t, N>& edges) : bucket_edges(edges) {}
+
+            void Record(const uint64_t value);
+            void Reset();
+            HistogramSnapshot GetSnapshot() const;
+        };
+
+        // The difference between two snapshots of the same watching period
+        static Snapshot Subtract(const Snapshot& later, const Snapshot& earlier);
+        static HistogramSnapshot Subtract(const HistogramSnapshot& later, const HistogramSnapshot& earlier);
+
+        // Warns if the frame rate in the snapshot is too low or frames were dropped
+        static void CheckForProblems(const Snapshot& snapshot, const std::string& period_name);
+
+        static double ReadCpuTemperature();
+
+        struct PendingReport {
+            Snapshot snapshot;
+            std::string period_name;
+            bool end_of_watching = false;
+        };
+
+        // Starts the reporting thread if it is not running
+        static void QueueReport(const Snapshot& snapshot, const std::string& period_name, const bool end_of_watching);
+        static void ReporterLoop();
+        static void Report(PendingReport& report);
+
+        static AtomicHistogram<kIntervalBucketEdgesUs.size()> intervals_us_;
+        static AtomicHistogram<kProcessingBucketEdgesUs.size()> processing_us_;
+        static AtomicHistogram<kQueueDepthBucketEdges.size()> queue_depth_;
+
+        static std::atomic<uint64_t> number_frames_;
+        static std::atomic<uint64_t> number_sequence_gaps_;
+        static std::atomic<uint64_t> number_frames_dropped_;
+        static std::atomic<uint64_t> number_frames_out_of_order_;
+
+        // -1 until the first frame of the watching period
+        static std::atomic<int64_t> last_sequence_number_;
+        static std::atomic<int64_t> last_sensor_timestamp_ns_;
+
+        // Only used by the watching thread
+        static double expected_fps_;
+        static std::chrono::steady_clock::time_point watching_start_time_;
+        static std::chrono::steady_clock::time_point last_summary_time_;
+        static Snapshot last_summary_snapshot_;
+
+        static std::mutex reporter_mutex_;
+        static std::condition_variable reporter_condition_;
+        static std::deque<PendingReport> pending_reports_;
+        static std::thread reporter_thread_;
+        static bool reporter_stopping_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -8,6 +8,12 @@
 #ifdef __unix__  // Ignore in Windows environment
 
 
+#include <cstdio>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
 #include <variant>
 #include <thread>
 #include "gs_format_lib.h"
@@ -15,6 +21,7 @@
 #include <signal.h>
 #include <sys/signalfd.h>
 #include <poll.h>
+#include <opencv2/imgcodecs.hpp>
 
 #include "logging_tools.h"
 #include "worker_thread.h"
@@ -27,9 +34,15 @@
 #include "ball_image_proc.h"
 #include "gs_ipc_system.h"
 #include "gs_ui_system.h"
+#include "gs_ui_stream_server.h"
 #include "gs_sim_interface.h"
 #include "pulse_strobe.h"
 #include "libcamera_interface.h"
+#include "gs_replay_camera.h"
+#include "gs_shot_store.h"
+#include "gs_shot_capture.h"
+#include "gs_metrics.h"
+#include "gs_frame_monitor.h"
 
 #include "gs_fsm.h"
 
@@ -59,6 +72,211 @@ namespace golf_sim {
         template<class... Ts> struct overload : Ts... { using Ts::operator()...; };
     }
 
+    // If true, the raw placement and strobed images of each shot are saved next to the
+    // shot store so that the shot can be looked at (or replayed) later
+    static bool kShotStoreSaveRawImages = true;
+
+    // The hash of the current configuration, re-computed only when a new configuration
+    // snapshot is published
+    static uint64_t GetConfigurationHash(uint64_t& generation) {
+        static uint64_t hash_generation = 0;
+        static uint64_t hash = 0;
+
+        if (hash == 0 || hash_generation != GolfSimConfiguration::GetGeneration()) {
+            hash = GsShotStore::Hash64(GsShotCapture::GetConfigurationJson(hash_generation));
+        }
+
+        generation = hash_generation;
+        return hash;
+    }
+
+    // Labels the metrics with the configuration that is in effect, so that slow or inaccurate
+    // bays can be matched to the settings they run with
+    static void UpdateConfigurationInfoMetric() {
+        uint64_t generation = 0;
+        const uint64_t hash = GetConfigurationHash(generation);
+
+        char hash_string[17];
+        snprintf(hash_string, sizeof(hash_string), "%016llx", (unsigned long long)hash);
+
+        GsMetrics::SetInfo("pitrac_lm_info", "The camera and configuration that this launch monitor process is running",
+            "camera=\"" + std::to_string((int)GolfSimOptions::GetCommandLineOptions().GetCameraNumber()) +
+            "\",config_hash=\"" + hash_string + "\",config_generation=\"" + std::to_string(generation) + "\"");
+    }
+
+    // Queues a --shot_capture_dir capture of the shot, if shots are being captured.  Returns
+    // the capture's file name, or an empty string if there is none.  results is nullptr if
+    // the shot could not be analyzed.
+    static std::string CaptureShot(const GsResults* results,
+                                   const cv::Mat& placement_image,
+                                   const cv::Mat& pre_image,
+                                   const cv::Mat& strobed_image) {
+
+        if (!GsShotCapture::IsWriterRunning()) {
+            return "";
+        }
+
+        GsShotCapture capture;
+        capture.SetFromCurrentSystem();
+        capture.shot_number = GsSimInterface::GetShotCounter();
+
+        if (results != nullptr) {
+            capture.has_results = true;
+            capture.results = *results;
+        }
+
+        // The images are not changed after the shot, so they can be shared with the writer
+        // rather than copied
+        capture.frames.push_back({ GsShotCapture::FrameRole::kTeedBall, 0, capture.timestamp_ns, cv::Point(0, 0), placement_image });
+        capture.frames.push_back({ GsShotCapture::FrameRole::kPreImage, 0, capture.timestamp_ns, cv::Point(0, 0), pre_image });
+        capture.frames.push_back({ GsShotCapture::FrameRole::kStrobed, 0, capture.timestamp_ns, cv::Point(0, 0), strobed_image });
+
+        return GsShotCapture::Submit(std::move(capture));
+    }
+
+    // The shots are added to the history (and their raw images are saved) by this thread,
+    // so that encoding the images does not hold up the FSM
+    struct PendingHistoryShot {
+        GsShotRecord record;
+        std::string image_references;
+        // Relative to the shot store directory.  Empty if the raw images are not saved.
+        std::string image_dir;
+        std::vector<std::pair<std::string, cv::Mat>> images;
+    };
+
+    static std::mutex history_writer_mutex;
+    static std::condition_variable history_writer_condition;
+    static std::deque<PendingHistoryShot> pending_history_shots;
+    static std::thread history_writer_thread;
+    static bool history_writer_stopping = false;
+
+    static void WritePendingHistoryShot(PendingHistoryShot& pending) {
+        GsShotStore& shot_history = GsShotStore::GetShotHistory();
+
+        if (!pending.image_dir.empty()) {
+            const std::string full_image_dir = GolfSimOptions::GetCommandLineOptions().shot_store_dir_ + "/" + pending.image_dir;
+
+            std::error_code error;
+            std::filesystem::create_directories(full_image_dir, error);
+
+            for (const auto& [file_name, image] : pending.images) {
+                if (!image.empty() && cv::imwrite(full_image_dir + file_name, image)) {
+                    pending.image_references += (pending.image_references.empty() ? "" : ";") + pending.image_dir + file_name;
+                }
+            }
+        }
+
+        if (!shot_history.Append(pending.record, pending.image_references)) {
+            GS_LOG_MSG(warning, "Could not add shot " + std::to_string(pending.record.shot_number) + " to the shot history.");
+        }
+    }
+
+    static void HistoryWriterLoop() {
+        while (true) {
+            PendingHistoryShot pending;
+
+            {
+                std::unique_lock<std::mutex> lock(history_writer_mutex);
+                history_writer_condition.wait(lock, [] { return history_writer_stopping || !pending_history_shots.empty(); });
+
+                if (pending_history_shots.empty()) {
+                    return;
+                }
+
+                pending = std::move(pending_history_shots.front());
+                pending_history_shots.pop_front();
+            }
+
+            WritePendingHistoryShot(pending);
+        }
+    }
+
+    static void QueueHistoryShot(PendingHistoryShot&& pending) {
+        {
+            const std::lock_guard<std::mutex> lock(history_writer_mutex);
+
+            if (!history_writer_thread.joinable()) {
+                history_writer_stopping = false;
+                history_writer_thread = std::thread(HistoryWriterLoop);
+            }
+
+            pending_history_shots.push_back(std::move(pending));
+        }
+
+        history_writer_condition.notify_one();
+    }
+
+    // Adds any shots that are still waiting to the history, and stops the thread
+    static void StopHistoryWriter() {
+        {
+            const std::lock_guard<std::mutex> lock(history_writer_mutex);
+
+            if (!history_writer_thread.joinable()) {
+                return;
+            }
+
+            history_writer_stopping = true;
+        }
+
+        history_writer_condition.notify_all();
+        history_writer_thread.join();
+    }
+
+    // Queues the shot to be added to the --shot_store_dir history, if there is one.  results is nullptr
+    // if the shot could not be analyzed.  If the shot was captured, the capture is its image
+    // reference.  Otherwise, its raw images are saved with it (if kShotStoreSaveRawImages).
+    static void RecordShotInHistory(const GsResults* results,
+                                    const GolfBall& result_ball,
+                                    const double processing_ms,
+                                    const std::string& capture_file_name,
+                                    const cv::Mat& placement_image,
+                                    const cv::Mat& strobed_image) {
+
+        GsShotStore& shot_history = GsShotStore::GetShotHistory();
+
+        if (!shot_history.IsOpen()) {
+            return;
+        }
+
+        PendingHistoryShot pending;
+        GsShotRecord& record = pending.record;
+        // The time of the shot, rather than of when it is written
+        record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.shot_number = (uint32_t)GsSimInterface::GetShotCounter();
+        record.success = (results != nullptr) ? 1 : 0;
+        record.config_hash = GetConfigurationHash(record.config_generation);
+        record.processing_ms = processing_ms;
+
+        if (results != nullptr) {
+            record.speed_mph = results->speed_mph_;
+            record.launch_angle_deg = results->vla_deg_;
+            record.side_angle_deg = results->hla_deg_;
+            record.back_spin_rpm = results->back_spin_rpm_;
+            record.side_spin_rpm = results->side_spin_rpm_;
+            record.club_type = (int32_t)results->club_type_;
+            record.confidence = result_ball.GetConfidence();
+            record.velocity_time_period_ms = (double)result_ball.time_between_ball_positions_for_velocity_uS_ / 1000.0;
+        }
+
+        // The images are saved as captured (before undistortion), with the same names
+        // as in a --replay_camera_dir shot directory
+        if (!capture_file_name.empty()) {
+            pending.image_references = GolfSimOptions::GetCommandLineOptions().shot_capture_dir_ + "/" + capture_file_name;
+        }
+        else if (kShotStoreSaveRawImages) {
+            pending.image_dir = "images/session_" + std::to_string(shot_history.GetSessionId()) +
+                "/shot_" + std::to_string(record.shot_number) + "/";
+
+            // The images are not changed after the shot, so they can be shared with the writer
+            // rather than copied
+            pending.images.emplace_back("placement.png", placement_image);
+            pending.images.emplace_back("strobed.png", strobed_image);
+        }
+
+        QueueHistoryShot(std::move(pending));
+    }
+
     TimedCallbackThread* BallStabilizationCheckTimerThread = nullptr;
     TimedCallbackThread* ReceivedCam2ImageCheckTimerThread = nullptr;
 
@@ -126,6 +344,8 @@ namespace golf_sim {
         // Let the monitor interface know what's happening
         GsUISystem::SendIPCStatusMessage(GsIPCResultType::kInitializing);
 
+        GolfSimConfiguration::ApplyPendingReload();
+
         // If we're already armed, just start waiting for a ball to appear.
         if (GsSimInterface::GetAllSystemsArmed()) {
             GolfSimEventElement beginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
@@ -175,6 +395,8 @@ namespace golf_sim {
 
         bool found = CheckForBall(ball, img);
 
+        GsUIStreamServer::PublishPreviewFrame(img);
+
         if (img.empty()) {
             GS_LOG_MSG(warning, "CheckForBall() return image was empty - ignoring.");
         }
@@ -248,6 +470,8 @@ namespace golf_sim {
         bool found = CheckForBall(ball, img);
         // LoggingTools::LogImage("", img, std::vector < cv::Point >{}, true, "log_last_ball_2bcompared2_still.png");
 
+        GsUIStreamServer::PublishPreviewFrame(img);
+
 
         // We were called by a timer in a separate thread.  Clean up that thread
         if (BallStabilizationCheckTimerThread != nullptr) {
@@ -458,13 +682,27 @@ namespace golf_sim {
         cv::Mat exposures_image;
         std::vector<GolfBall> exposure_balls;
 
-        if (!GolfSimCamera::ProcessReceivedCam2Image(BallHitNowWaitingForCam2Image.ball_image_,
+        const auto processing_start_time = std::chrono::steady_clock::now();
+
+        const bool processed = GolfSimCamera::ProcessReceivedCam2Image(BallHitNowWaitingForCam2Image.ball_image_,
                                                     cam2_mat,
                                                     BallHitNowWaitingForCam2Image.camera2_pre_image_,
                                                     result_ball,
                                                     rotation_results,
                                                     exposures_image,
-                                                    exposure_balls)) {
+                                                    exposure_balls);
+
+        const double processing_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - processing_start_time).count();
+
+        static GsMetricHistogram& processing_succeeded_seconds = GsMetrics::GetHistogram("pitrac_shot_processing_seconds",
+            "Time to analyze the camera-2 image of each shot", GsMetricHistogram::kLatencyBucketsSeconds, "result=\"success\"");
+        static GsMetricHistogram& processing_failed_seconds = GsMetrics::GetHistogram("pitrac_shot_processing_seconds",
+            "Time to analyze the camera-2 image of each shot", GsMetricHistogram::kLatencyBucketsSeconds, "result=\"failure\"");
+
+        (processed ? processing_succeeded_seconds : processing_failed_seconds).Observe(processing_ms / 1000.0);
+        UpdateConfigurationInfoMetric();
+
+        if (!processed) {
             GS_LOG_MSG(error, "GolfSim FSM could not ProcessReceivedCam2Image.");
 #ifdef __unix__ 
             // Give the webserver UI something to show the user
@@ -473,6 +711,8 @@ namespace golf_sim {
 
             GsUISystem::SendIPCErrorStatusMessage("GolfSim FSM could not ProcessReceivedCam2Image.");
 
+            GsReplayCamera::RecordShotResult(false);
+
             GS_LOG_MSG(info, "BALL_HIT_CSV, " + std::to_string(GsSimInterface::GetShotCounter()) + ", (carry - Error), (Total - Error), (Side Dest - Error), (Smash Factor - Error), (Club Speed - Error), "
                 + std::to_string(0) + ", "
                 + std::to_string(0) + ", "
@@ -482,6 +722,11 @@ namespace golf_sim {
                 + ", (Descent Angle-Error), (Apex-Error), (Flight Time-Error), (Type-Error)"
             );
 
+            const std::string capture_file_name = CaptureShot(nullptr, BallHitNowWaitingForCam2Image.ball_image_,
+                BallHitNowWaitingForCam2Image.camera2_pre_image_, cam2_mat);
+
+            RecordShotInHistory(nullptr, result_ball, processing_ms, capture_file_name, BallHitNowWaitingForCam2Image.ball_image_, cam2_mat);
+
         }
         else {
 
@@ -494,6 +739,8 @@ namespace golf_sim {
                 GS_LOG_MSG(error, "GolfSim FSM could not SendResultsToGolfSim.");
             }
 
+            GsReplayCamera::RecordShotResult(true);
+
             GS_LOG_TRACE_MSG(trace, "Received and processed cam2ImageReceived.  Now sending an IPC Results Message:");
 
             std::string s;
@@ -512,8 +759,17 @@ namespace golf_sim {
                 exposures_image, exposure_balls);
 #endif
 
+            // After the results have gone out, so that saving the images does not delay them
+            const std::string capture_file_name = CaptureShot(&results, BallHitNowWaitingForCam2Image.ball_image_,
+                BallHitNowWaitingForCam2Image.camera2_pre_image_, cam2_mat);
+
+            RecordShotInHistory(&results, result_ball, processing_ms, capture_file_name, BallHitNowWaitingForCam2Image.ball_image_, cam2_mat);
+
         }
 
+        // Any configuration changes made during the shot apply from the next shot
+        GolfSimConfiguration::ApplyPendingReload();
+
         // Setup to go through the whole sequence again
         GolfSimEventElement beginWaitingForBallPlacedEvent{ new GolfSimEvent::BeginWaitingForBallPlaced{ } };
         GolfSimEventQueue::QueueEvent(beginWaitingForBallPlacedEvent);
@@ -602,6 +858,9 @@ namespace golf_sim {
             LoggingTools::LogImage("", image, std::vector < cv::Point >{}, true, kWebServerCamera2Image);
         }
 
+        // Any configuration changes made during the shot apply from the next shot
+        GolfSimConfiguration::ApplyPendingReload();
+
         // Get a restart queued up to start all over
         GolfSimEventElement restartEvent{ new GolfSimEvent::Restart{ } };
         GolfSimEventQueue::QueueEvent(restartEvent);
@@ -641,14 +900,32 @@ namespace golf_sim {
     }
 
 
+    // The names of the GolfSimState alternatives, in the same order, for the metrics
+    static const char* const kStateNames[] = { "InitializingCamera1System",
+                                               "Exiting",
+                                               "WaitingForSimulatorArmed",
+                                               "WaitingForBall",
+                                               "WaitingForBallStabilization",
+                                               "WaitingForBallHit",
+                                               "WaitingForCamera2PreImage",
+                                               "BallHitNowWaitingForCam2Image",
+                                               "InitializingCamera2System",
+                                               "WaitingForCameraArmMessage",
+                                               "WaitingForCameraTrigger" };
+
+    static_assert(std::size(kStateNames) == std::variant_size_v<GolfSimState>, "kStateNames must name every GolfSimState");
+
     class GolfSimStateMachine {
 
     public:
         void restartSim(const GolfSimState& starting_state) {
             state_ = starting_state;
+            state_start_time_ = std::chrono::steady_clock::now();
         }
 
         void processEvent(const PossibleEvent& event) {
+            const size_t prior_state_index = state_.index();
+
             state_ = std::visit(
                 helper::overload{
                     [](const auto& state, const auto& evt) {
@@ -657,6 +934,13 @@ namespace golf_sim {
                 },
                 state_, event);
 
+            // Events often leave the state as it was, so only a real change ends the dwell time
+            if (state_.index() != prior_state_index) {
+                const auto now = std::chrono::steady_clock::now();
+                GetStateDwellHistogram(prior_state_index).Observe(std::chrono::duration<double>(now - state_start_time_).count());
+                state_start_time_ = now;
+            }
+
             reportCurrentState();
         }
 
@@ -702,7 +986,25 @@ namespace golf_sim {
         }
 
     private:
+        static GsMetricHistogram& GetStateDwellHistogram(const size_t state_index) {
+            static const std::vector<GsMetricHistogram*> histograms = []() {
+                std::vector<GsMetricHistogram*> state_histograms;
+
+                for (const char* state_name : kStateNames) {
+                    state_histograms.push_back(&GsMetrics::GetHistogram("pitrac_fsm_state_dwell_seconds",
+                        "Time spent in each FSM state before moving to another",
+                        GsMetricHistogram::kLatencyBucketsSeconds,
+                        "state=\"" + std::string(state_name) + "\""));
+                }
+
+                return state_histograms;
+            }();
+
+            return *histograms[state_index];
+        }
+
         GolfSimState state_;
+        std::chrono::steady_clock::time_point state_start_time_ = std::chrono::steady_clock::now();
     };
 
 
@@ -723,6 +1025,10 @@ namespace golf_sim {
         else if (message_type == GsIPCControlMsgType::kClubChangeToDriver) {
             GolfSimClubs::SetCurrentClubType(GolfSimClubs::GsClubType::kDriver);
         }
+        else if (message_type == GsIPCControlMsgType::kReloadConfiguration) {
+            // Applied at the next shot boundary, not in the middle of a shot
+            GolfSimConfiguration::RequestReload();
+        }
         else {
             GS_LOG_MSG(error, "Received ControlMessage event with unknown message type.");
         }
@@ -900,8 +1206,15 @@ namespace golf_sim {
         // Only the camera1 system deals with the simulator interfaces
         if (GolfSimOptions::GetCommandLineOptions().GetCameraNumber() == GsCameraNumber::kGsCamera1) {
             GsSimInterface::DeInitializeSims();
+            GsUIStreamServer::Stop();
+            StopHistoryWriter();
+            GsShotStore::GetShotHistory().Close();
+            GsShotCapture::StopWriter();
+            GsFrameMonitor::StopReporter();
         }
 
+        GsMetrics::StopFileWriter();
+
         GS_LOG_TRACE_MSG(trace, "Shutting down IPC System");
         GolfSimIpcSystem::ShutdownIPCSystem();
 
@@ -932,6 +1245,13 @@ namespace golf_sim {
         
         GsUISystem::SendIPCStatusMessage(GsIPCResultType::kInitializing);
 
+        UpdateConfigurationInfoMetric();
+
+        // Not fatal - the metrics are still available from the embedded UI server
+        if (!GsMetrics::StartFileWriter()) {
+            GS_LOG_MSG(warning, "Failed to start writing the metrics file.");
+        }
+
         // Even if we are in kCamera2 mode, but also in still mode, we will wan to initialize
         // the GPIO system
         if (GolfSimOptions::GetCommandLineOptions().system_mode_ == SystemMode::kCamera1 ||
@@ -954,6 +1274,31 @@ namespace golf_sim {
                 GS_LOG_MSG(error, "Failed to Initialize the Golf Simulator Interface.");
                 return false;
             }
+
+            // Not fatal - the usual web interface still works without it
+            if (!GsUIStreamServer::Start()) {
+                GS_LOG_MSG(warning, "Failed to start the embedded UI server.");
+            }
+
+            const std::string& shot_store_dir = GolfSimOptions::GetCommandLineOptions().shot_store_dir_;
+
+            if (!shot_store_dir.empty()) {
+                GolfSimConfiguration::SetConstant("gs_config.logging.kShotStoreSaveRawImages", kShotStoreSaveRawImages);
+
+                // Also not fatal - the shots are still sent everywhere else
+                if (GsShotStore::GetShotHistory().Open(shot_store_dir, false,
+                        [](const std::string& message) { GS_LOG_MSG(warning, message); })) {
+                    GS_LOG_MSG(info, "Recording shots in " + shot_store_dir + " (" +
+                        std::to_string(GsShotStore::GetShotHistory().GetNumberRecords()) + " already there).");
+                }
+                else {
+                    GS_LOG_MSG(warning, "Failed to open the shot store in " + shot_store_dir + ".");
+                }
+            }
+
+            if (!GsShotCapture::StartWriter()) {
+                GS_LOG_MSG(warning, "Failed to start capturing shots.");
+            }
         }
 
         // Driver is as good a default as any if not other indication  
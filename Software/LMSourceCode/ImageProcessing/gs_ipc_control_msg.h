@@ -32,6 +32,7 @@ namespace golf_sim {
         kUnknown = 0, 
         kClubChangeToPutter = 1,
         kClubChangeToDriver = 2,
+        kReloadConfiguration = 3,
     };
 
     // This class is mostly designed to compartmentalize the details of (De)serializing
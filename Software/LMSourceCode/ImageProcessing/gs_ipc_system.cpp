@@ -12,6 +12,7 @@
 #include "gs_options.h"
 #include "gs_config.h"
 #include "gs_ipc_system.h"
+#include "gs_metrics.h"
 
 #include "gs_message_consumer.h"
 #include "gs_message_producer.h"
@@ -152,6 +153,14 @@ namespace golf_sim {
 
         GS_LOG_TRACE_MSG(trace, "DispatchReceivedIpcMessage::Dispatch Received Ipc Message.");
 
+        static GsMetricHistogram& received_bytes = GsMetrics::GetHistogram("pitrac_ipc_message_bytes",
+            "Size of the IPC message bodies", GsMetricHistogram::kSizeBucketsBytes, "direction=\"received\"");
+        static GsMetricHistogram& dispatch_seconds = GsMetrics::GetHistogram("pitrac_ipc_dispatch_seconds",
+            "Time to unpack and handle each received IPC message", GsMetricHistogram::kLatencyBucketsSeconds);
+
+        GsMetricHistogram::ScopedTimer dispatch_timer(dispatch_seconds);
+        received_bytes.Observe(message.getBodyLength());
+
         GolfSimIPCMessage* ipc_message = BuildIpcMessageFromBytesMessage(message);
 
         if (ipc_message == nullptr) {
@@ -600,7 +609,22 @@ namespace golf_sim {
             return false;
         }
 
+        static GsMetricHistogram& sent_bytes = GsMetrics::GetHistogram("pitrac_ipc_message_bytes",
+            "Size of the IPC message bodies", GsMetricHistogram::kSizeBucketsBytes, "direction=\"sent\"");
+        static GsMetricHistogram& send_seconds = GsMetrics::GetHistogram("pitrac_ipc_send_seconds",
+            "Time for the message broker to accept each sent IPC message", GsMetricHistogram::kLatencyBucketsSeconds);
+        static GsMetricCounter& send_failures = GsMetrics::GetCounter("pitrac_ipc_send_failures_total",
+            "Number of IPC messages that could not be sent");
+
+        sent_bytes.Observe(activeMQ_message->getBodyLength());
+
+        const auto send_start_time = std::chrono::steady_clock::now();
         bool result = producer_->SendMessage(activeMQ_message.get());
+        send_seconds.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - send_start_time).count());
+
+        if (!result) {
+            send_failures.Increment();
+        }
 
         std::this_thread::yield();
 
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// pitrac_log_decoder - Prints a binary log file that was written by GsAsyncLog
+// (pitrac_lm --binary_log_file=<file>) as text, in the same format as the text logs.
+//
+// Usage:  pitrac_log_decoder <binary_log_file> [--source] [--level=<0-5>]
+//
+//    --source     Also print the source file and line number of each record
+//    --level=N    Only print records at or above level N (0 = trace ... 5 = fatal)
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "gs_async_log.h"
+
+using namespace golf_sim;
+
+
+static void PrintUsage() {
+    std::cerr << "Usage:  pitrac_log_decoder <binary_log_file> [--source] [--level=<0-5>]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string file_name;
+    bool include_source_location = false;
+    int min_level = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--source") {
+            include_source_location = true;
+        }
+        else if (arg.rfind("--level=", 0) == 0) {
+            try {
+                min_level = std::stoi(arg.substr(8));
+            }
+            catch (std::exception&) {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (file_name.empty() && arg.rfind("--", 0) != 0) {
+            file_name = arg;
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (file_name.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::ifstream input(file_name, std::ios::binary);
+
+    if (!input.is_open()) {
+        std::cerr << "Could not open " << file_name << "." << std::endl;
+        return 1;
+    }
+
+    if (!GsAsyncLog::ReadFileHeader(input)) {
+        std::cerr << file_name << " is not a binary log file." << std::endl;
+        return 1;
+    }
+
+    GsBinaryLogRecordHeader header;
+    std::string record_file_name;
+    std::string message;
+    uint64_t number_records = 0;
+
+    while (GsAsyncLog::ReadRecord(input, header, record_file_name, message)) {
+        number_records++;
+
+        if (header.level < min_level) {
+            continue;
+        }
+
+        std::cout << GsAsyncLog::FormatRecord(header, record_file_name, message, include_source_location) << "\n";
+    }
+
+    if (!input.eof()) {
+        std::cerr << "Stopped at a corrupt record after " << number_records << " records." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
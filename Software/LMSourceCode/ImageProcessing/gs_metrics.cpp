@@ -0,0 +1,382 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_options.h"
+
+#include "gs_metrics.h"
+
+
+namespace golf_sim {
+
+    int GsMetrics::kMetricsFileIntervalSeconds = 15;
+
+    const std::vector<double> GsMetricHistogram::kLatencyBucketsSeconds =
+        { 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0 };
+    const std::vector<double> GsMetricHistogram::kCountBuckets =
+        { 0, 1, 2, 3, 5, 8, 12, 20, 30, 50, 100, 200, 500, 1000, 5000, 20000 };
+    const std::vector<double> GsMetricHistogram::kSizeBucketsBytes =
+        { 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216 };
+
+    // The registry and the file writer's state
+    namespace {
+
+        enum class MetricType { kCounter, kGauge, kHistogram, kInfo };
+
+        struct MetricSeries {
+            std::unique_ptr<GsMetricCounter> counter;
+            std::unique_ptr<GsMetricGauge> gauge;
+            std::unique_ptr<GsMetricHistogram> histogram;
+        };
+
+        struct MetricFamily {
+            MetricType type = MetricType::kCounter;
+            std::string help;
+            // Keyed by the labels
+            std::map<std::string, MetricSeries> series;
+        };
+
+        struct MetricsRegistry {
+            std::mutex mutex;
+            std::map<std::string, MetricFamily> families;
+
+            // Handed out when a name is re-used with a different type
+            std::vector<MetricSeries> orphans;
+
+            std::string file_name;
+            std::thread file_writer_thread;
+            std::mutex file_writer_mutex;
+            std::condition_variable file_writer_wakeup;
+            bool file_writer_stopping = false;
+        };
+
+        MetricsRegistry& GetRegistry() {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        // Returns the series for the name and labels, or nullptr if the name has another type.
+        // The registry must be locked.
+        MetricSeries* FindOrAddSeries(MetricsRegistry& registry,
+                                      const std::string& name,
+                                      const std::string& help,
+                                      const std::string& labels,
+                                      const MetricType type) {
+
+            auto family = registry.families.find(name);
+
+            if (family == registry.families.end()) {
+                family = registry.families.emplace(name, MetricFamily{ type, help, {} }).first;
+            }
+            else if (family->second.type != type) {
+                GS_LOG_MSG(error, "The metric " + name + " is already registered with a different type.");
+                return nullptr;
+            }
+
+            return &family->second.series[labels];
+        }
+
+        std::string FormatValue(const double value) {
+            if (std::isinf(value)) {
+                return (value > 0) ? "+Inf" : "-Inf";
+            }
+
+            if (std::isnan(value)) {
+                return "NaN";
+            }
+
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.10g", value);
+            return buffer;
+        }
+
+        // Returns the labels with the additional label added, in braces, or "" if there are none
+        std::string FormatLabels(const std::string& labels, const std::string& additional_label = "") {
+            if (labels.empty() && additional_label.empty()) {
+                return "";
+            }
+
+            if (labels.empty() || additional_label.empty()) {
+                return "{" + labels + additional_label + "}";
+            }
+
+            return "{" + labels + "," + additional_label + "}";
+        }
+
+        const char* FormatType(const MetricType type) {
+            switch (type) {
+            case MetricType::kCounter:
+                return "counter";
+            case MetricType::kHistogram:
+                return "histogram";
+            default:
+                return "gauge";
+            }
+        }
+    }
+
+
+    void GsMetricGauge::Add(const double amount) {
+        double current = value_.load(std::memory_order_relaxed);
+
+        while (!value_.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {
+        }
+    }
+
+
+    GsMetricHistogram::GsMetricHistogram(const std::vector<double>& bucket_edges) {
+        const size_t number_buckets = std::min(bucket_edges.size(), kMaxBuckets);
+        bucket_edges_.assign(bucket_edges.begin(), bucket_edges.begin() + number_buckets);
+    }
+
+    void GsMetricHistogram::Observe(const double value) {
+        // The bucket edges are inclusive, as Prometheus expects
+        const size_t bucket = std::lower_bound(bucket_edges_.begin(), bucket_edges_.end(), value) - bucket_edges_.begin();
+
+        counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+
+        double current_sum = sum_.load(std::memory_order_relaxed);
+
+        while (!sum_.compare_exchange_weak(current_sum, current_sum + value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void GsMetricHistogram::Format(const std::string& name, const std::string& labels, std::string& text) const {
+        uint64_t cumulative_count = 0;
+
+        for (size_t i = 0; i <= bucket_edges_.size(); i++) {
+            cumulative_count += counts_[i].load(std::memory_order_relaxed);
+
+            const std::string edge = (i < bucket_edges_.size()) ? FormatValue(bucket_edges_[i]) : "+Inf";
+            text += name + "_bucket" + FormatLabels(labels, "le=\"" + edge + "\"") + " " + std::to_string(cumulative_count) + "\n";
+        }
+
+        text += name + "_sum" + FormatLabels(labels) + " " + FormatValue(sum_.load(std::memory_order_relaxed)) + "\n";
+        text += name + "_count" + FormatLabels(labels) + " " + std::to_string(cumulative_count) + "\n";
+    }
+
+
+    GsMetricCounter& GsMetrics::GetCounter(const std::string& name, const std::string& help, const std::string& labels) {
+        MetricsRegistry& registry = GetRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mutex);
+
+        MetricSeries* series = FindOrAddSeries(registry, name, help, labels, MetricType::kCounter);
+
+        if (series == nullptr) {
+            registry.orphans.emplace_back();
+            series = &registry.orphans.back();
+        }
+
+        if (series->counter == nullptr) {
+            series->counter = std::make_unique<GsMetricCounter>();
+        }
+
+        return *series->counter;
+    }
+
+    GsMetricGauge& GsMetrics::GetGauge(const std::string& name, const std::string& help, const std::string& labels) {
+        MetricsRegistry& registry = GetRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mutex);
+
+        MetricSeries* series = FindOrAddSeries(registry, name, help, labels, MetricType::kGauge);
+
+        if (series == nullptr) {
+            registry.orphans.emplace_back();
+            series = &registry.orphans.back();
+        }
+
+        if (series->gauge == nullptr) {
+            series->gauge = std::make_unique<GsMetricGauge>();
+        }
+
+        return *series->gauge;
+    }
+
+    GsMetricHistogram& GsMetrics::GetHistogram(const std::string& name, const std::string& help,
+                                               const std::vector<double>& bucket_edges, const std::string& labels) {
+        MetricsRegistry& registry = GetRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mutex);
+
+        MetricSeries* series = FindOrAddSeries(registry, name, help, labels, MetricType::kHistogram);
+
+        if (series == nullptr) {
+            registry.orphans.emplace_back();
+            series = &registry.orphans.back();
+        }
+
+        if (series->histogram == nullptr) {
+            series->histogram = std::make_unique<GsMetricHistogram>(bucket_edges);
+        }
+
+        return *series->histogram;
+    }
+
+    void GsMetrics::SetInfo(const std::string& name, const std::string& help, const std::string& labels) {
+        MetricsRegistry& registry = GetRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mutex);
+
+        auto family = registry.families.find(name);
+
+        if (family != registry.families.end()) {
+            if (family->second.type != MetricType::kInfo) {
+                GS_LOG_MSG(error, "The metric " + name + " is already registered with a different type.");
+                return;
+            }
+
+            // Nothing else can hold on to an info metric's series, so it is safe to replace it
+            family->second.series.clear();
+        }
+
+        MetricSeries* series = FindOrAddSeries(registry, name, help, labels, MetricType::kInfo);
+        series->gauge = std::make_unique<GsMetricGauge>();
+        series->gauge->Set(1.0);
+    }
+
+    std::string GsMetrics::FormatPrometheusText() {
+        MetricsRegistry& registry = GetRegistry();
+        const std::lock_guard<std::mutex> lock(registry.mutex);
+
+        std::string text;
+
+        for (const auto& [name, family] : registry.families) {
+            text += "# HELP " + name + " " + family.help + "\n";
+            text += "# TYPE " + name + " " + FormatType(family.type) + "\n";
+
+            for (const auto& [labels, series] : family.series) {
+                if (series.counter != nullptr) {
+                    text += name + FormatLabels(labels) + " " + std::to_string(series.counter->GetValue()) + "\n";
+                }
+                else if (series.gauge != nullptr) {
+                    text += name + FormatLabels(labels) + " " + FormatValue(series.gauge->GetValue()) + "\n";
+                }
+                else if (series.histogram != nullptr) {
+                    series.histogram->Format(name, labels, text);
+                }
+            }
+        }
+
+        return text;
+    }
+
+    bool GsMetrics::WriteFile(const std::string& file_name) {
+        const std::string temporary_file_name = file_name + ".tmp";
+
+        {
+            std::ofstream file(temporary_file_name, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open()) {
+                GS_LOG_MSG(warning, "Could not open the metrics file " + temporary_file_name + ".");
+                return false;
+            }
+
+            file << FormatPrometheusText();
+
+            if (!file.good()) {
+                GS_LOG_MSG(warning, "Could not write the metrics file " + temporary_file_name + ".");
+                return false;
+            }
+        }
+
+        // Replace the file all at once, so that a reader never sees a partial one
+        std::error_code ec;
+        std::filesystem::rename(temporary_file_name, file_name, ec);
+
+        if (ec) {
+            GS_LOG_MSG(warning, "Could not rename the metrics file to " + file_name + ": " + ec.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GsMetrics::StartFileWriter() {
+        MetricsRegistry& registry = GetRegistry();
+
+        const std::string& file_name = GolfSimOptions::GetCommandLineOptions().metrics_file_;
+
+        if (file_name.empty() || registry.file_writer_thread.joinable()) {
+            return true;
+        }
+
+        GolfSimConfiguration::SetConstant("gs_config.logging.kMetricsFileIntervalSeconds", kMetricsFileIntervalSeconds);
+
+        if (kMetricsFileIntervalSeconds <= 0) {
+            GS_LOG_MSG(error, "kMetricsFileIntervalSeconds must be positive.");
+            return false;
+        }
+
+        if (!WriteFile(file_name)) {
+            return false;
+        }
+
+        registry.file_name = file_name;
+        registry.file_writer_stopping = false;
+
+        registry.file_writer_thread = std::thread([&registry]() {
+            std::unique_lock<std::mutex> lock(registry.file_writer_mutex);
+
+            while (!registry.file_writer_stopping) {
+                registry.file_writer_wakeup.wait_for(lock, std::chrono::seconds(kMetricsFileIntervalSeconds),
+                    [&registry]() { return registry.file_writer_stopping; });
+
+                WriteFile(registry.file_name);
+            }
+        });
+
+        GS_LOG_MSG(info, "Writing metrics to " + file_name + " every " + std::to_string(kMetricsFileIntervalSeconds) + " seconds.");
+
+        return true;
+    }
+
+    void GsMetrics::StopFileWriter() {
+        MetricsRegistry& registry = GetRegistry();
+
+        if (!registry.file_writer_thread.joinable()) {
+            return;
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(registry.file_writer_mutex);
+            registry.file_writer_stopping = true;
+        }
+
+        // The thread writes the file one last time before it exits
+        registry.file_writer_wakeup.notify_all();
+        registry.file_writer_thread.join();
+    }
+
+    std::string GsMetrics::EscapeLabelValue(const std::string& value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+
+        for (const char c : value) {
+            if (c == '\\' || c == '"') {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (c == '\n') {
+                escaped += "\\n";
+            }
+            else {
+                escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+
+}
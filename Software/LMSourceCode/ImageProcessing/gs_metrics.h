@@ -0,0 +1,135 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A process-wide registry of counters, gauges, and fixed-bucket histograms, exported in the
+// Prometheus text format so that the launch monitors in several bays can be scraped and
+// compared (e.g., to find the slow ones, and to see whether slowness follows a configuration).
+//
+// The metrics are available:
+//      - at /metrics on the embedded UI server (see gs_ui_stream_server.h), if it is running
+//      - in the --metrics_file file, which is re-written every kMetricsFileIntervalSeconds
+//        and when the system shuts down
+//
+// A metric is created the first time it is asked for, and lives until the process exits.
+// Getting a metric takes a lock, so callers should keep the reference, usually in a
+// function-level static:
+//
+//      static GsMetricCounter& hough_passes = GsMetrics::GetCounter("pitrac_ball_hough_passes_total",
+//                                                  "Number of Hough circle transforms performed");
+//      hough_passes.Increment();
+//
+// Updating a metric never takes a lock, so the metrics can be used from any thread,
+// including the time-critical ones.
+//
+// Labels are given as Prometheus label pairs without the braces, e.g. state="WaitingForBall".
+// Each different set of labels is a different series of the same metric.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace golf_sim {
+
+    class GsMetricCounter {
+
+    public:
+        void Increment(const uint64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+        uint64_t GetValue() const { return value_.load(std::memory_order_relaxed); }
+
+    protected:
+        std::atomic<uint64_t> value_{ 0 };
+    };
+
+
+    class GsMetricGauge {
+
+    public:
+        void Set(const double value) { value_.store(value, std::memory_order_relaxed); }
+        void Add(const double amount);
+        double GetValue() const { return value_.load(std::memory_order_relaxed); }
+
+    protected:
+        std::atomic<double> value_{ 0.0 };
+    };
+
+
+    class GsMetricHistogram {
+
+    public:
+        // The most buckets a histogram may have, not counting the final +Inf bucket
+        static constexpr size_t kMaxBuckets = 16;
+
+        // Bucket upper edges (inclusive) for durations in seconds and for small counts
+        static const std::vector<double> kLatencyBucketsSeconds;
+        static const std::vector<double> kCountBuckets;
+        static const std::vector<double> kSizeBucketsBytes;
+
+        // bucket_edges must be increasing.  Any past kMaxBuckets are ignored.
+        explicit GsMetricHistogram(const std::vector<double>& bucket_edges);
+
+        void Observe(const double value);
+
+        // Observes the time from its construction to its destruction, in seconds
+        class ScopedTimer {
+        public:
+            explicit ScopedTimer(GsMetricHistogram& histogram) : histogram_(histogram), start_time_(std::chrono::steady_clock::now()) {}
+            ~ScopedTimer() { histogram_.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count()); }
+        private:
+            GsMetricHistogram& histogram_;
+            std::chrono::steady_clock::time_point start_time_;
+        };
+
+        // Appends the _bucket, _sum, and _count lines for this series
+        void Format(const std::string& name, const std::string& labels, std::string& text) const;
+
+    protected:
+        std::vector<double> bucket_edges_;
+        // Non-cumulative.  The last one is for values above every edge.
+        std::array<std::atomic<uint64_t>, kMaxBuckets + 1> counts_{};
+        std::atomic<double> sum_{ 0.0 };
+    };
+
+
+    class GsMetrics {
+
+    public:
+
+        // These are set from the "logging" section of the .json configuration file
+        static int kMetricsFileIntervalSeconds;
+
+        // If the name is already registered with a different type, the program has a bug, and
+        // a separate, unexported metric is returned so that the caller still works.
+        static GsMetricCounter& GetCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+        static GsMetricGauge& GetGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+        static GsMetricHistogram& GetHistogram(const std::string& name, const std::string& help,
+                                               const std::vector<double>& bucket_edges, const std::string& labels = "");
+
+        // An "info" metric has a single series with a value of 1.  Its labels describe something
+        // about the process (such as the configuration it is running), and replace any earlier ones.
+        static void SetInfo(const std::string& name, const std::string& help, const std::string& labels);
+
+        // Every metric, in the Prometheus text exposition format
+        static std::string FormatPrometheusText();
+
+        // Writes FormatPrometheusText() to the file, replacing it all at once
+        static bool WriteFile(const std::string& file_name);
+
+        // Starts a thread that writes the --metrics_file every kMetricsFileIntervalSeconds.
+        // Does nothing if the file is not set.
+        static bool StartFileWriter();
+        // Writes the file one last time, and stops the thread
+        static void StopFileWriter();
+
+        // Escapes a label value (backslashes, quotes, and newlines)
+        static std::string EscapeLabelValue(const std::string& value);
+    };
+
+}
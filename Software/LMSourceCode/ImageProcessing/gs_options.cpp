@@ -72,6 +72,8 @@ bool GolfSimOptions::Parse(int argc, char *argv[])
 		{ "camera2AutoCalibrate", SystemMode::kCamera2AutoCalibrate },
 		{ "runCam2ProcessForPi1Processing", SystemMode::kRunCam2ProcessForPi1Processing },
 		{ "camera2_one_pulse_only", SystemMode::kCamera2OnePulseOnly },
+		{ "test_strobe_timing", SystemMode::kTestStrobeTiming },
+		{ "generate_synthetic_test_suite", SystemMode::kGenerateSyntheticTestSuite },
 	};
 	if (mode_table.count(system_mode_string_) == 0)
 		throw std::runtime_error("Invalid system_mode: " + system_mode_string_);
@@ -145,6 +147,16 @@ void GolfSimOptions::Print() const
 		std::cout << "    e6_host_address: " << e6_host_address_ << std::endl;
 	if (!gspro_host_address_.empty())
 		std::cout << "    gspro_host_address: " << gspro_host_address_ << std::endl;
+	if (!replay_camera_dir_.empty())
+		std::cout << "    replay_camera_dir: " << replay_camera_dir_ << std::endl;
+	if (!binary_log_file_.empty())
+		std::cout << "    binary_log_file: " << binary_log_file_ << std::endl;
+	if (!shot_store_dir_.empty())
+		std::cout << "    shot_store_dir: " << shot_store_dir_ << std::endl;
+	if (!shot_capture_dir_.empty())
+		std::cout << "    shot_capture_dir: " << shot_capture_dir_ << std::endl;
+	if (!metrics_file_.empty())
+		std::cout << "    metrics_file: " << metrics_file_ << std::endl;
 	if (!config_file_.empty())
 		std::cout << "    configuration file: " << config_file_ << std::endl;
 	std::cout << "    pulse_test: " << std::to_string(perform_pulse_test_) << std::endl;
@@ -155,6 +167,7 @@ void GolfSimOptions::Print() const
 	std::cout << "    run_single_pi: " << std::to_string(run_single_pi_) << std::endl;
 	std::cout << "    show_images: " << std::to_string(show_images_) << std::endl;
 	std::cout << "    use_non_IR_camera: " << std::to_string(use_non_IR_camera_) << std::endl;
+	std::cout << "    simulate_strobe_hardware: " << std::to_string(simulate_strobe_hardware_) << std::endl;
 	if (!command_line_file_.empty())
 		std::cout << "    config file: " << command_line_file_ << std::endl;
 	if (search_center_x_ > 0)
@@ -33,6 +33,8 @@ namespace golf_sim {
 		kCamera2AutoCalibrate = 14,
 		kRunCam2ProcessForPi1Processing = 15,  // This is for when a process is running on camera 2 for the purpose of auto-calibration or taking pictures for ball location
 		kCamera2OnePulseOnly = 16,
+		kTestStrobeTiming = 17,
+		kGenerateSyntheticTestSuite = 18,
 	};
 
 	enum LoggingLevel {
@@ -77,7 +79,7 @@ namespace golf_sim {
 				("golfer_orientation", value<std::string>(&golfer_orientation_string_)->default_value("right_handed"),
 					"Set the golfer's handed-ness (right_handed, left_handed)")
 				("system_mode", value<std::string>(&system_mode_string_)->default_value("test"),
-					"Set the system's operating mode (test, camera1, camera2, camera1Calibrate, camera2Calibrate, camera1_test_standalone, camera2_test_standalone, test_spin, camera1_ball_location, camera2_ball_location, test_gspro_message, test_gspro_server, automated_testing, camera1AutoCalibrate, camera2AutoCalibrate, runCam2ProcessForPi1Processing, camera2_one_pulse_only)")
+					"Set the system's operating mode (test, camera1, camera2, camera1Calibrate, camera2Calibrate, camera1_test_standalone, camera2_test_standalone, test_spin, camera1_ball_location, camera2_ball_location, test_gspro_message, test_gspro_server, automated_testing, camera1AutoCalibrate, camera2AutoCalibrate, runCam2ProcessForPi1Processing, camera2_one_pulse_only, test_strobe_timing, generate_synthetic_test_suite)")
 				("logging_level", value<std::string>(&logging_level_string_)->default_value("warn"),
 					"Set the system's logging level (trace, debug, info, warn, error, none)")
 				("artifact_save_level", value<std::string>(&artifact_save_level_string_)->default_value("final_results_only"),
@@ -110,6 +112,8 @@ namespace golf_sim {
 					"Set the y coordinate of the center of the ball-search circle")
 				("simulate_found_ball", value<bool>(&simulate_found_ball_)->default_value(false)->implicit_value(true),
 					"Causes camera1 system to act as though a ball was found even if none is present.")
+				("simulate_strobe_hardware", value<bool>(&simulate_strobe_hardware_)->default_value(false)->implicit_value(true),
+					"Use a simulated GPIO/SPI backend for the strobe and shutter signals instead of the Pi's lgpio hardware")
 				("camera_gain", value<double>(&camera_gain_)->default_value(1.0),
 					"Amount of gain for taking pictures")
 				("msg_broker_address", value<std::string>(&msg_broker_address_)->default_value(""),
@@ -122,6 +126,16 @@ namespace golf_sim {
 					"Specify the name or IP address of the host PC that is running the E6 simulator.  Default is: <empty string>, indicating no TruGolf sim is connected.")
 				("gspro_host_address", value<std::string>(&gspro_host_address_)->default_value(""),
 					"Specify the name or IP address of the host PC that is running the GSPro simulator.  Default is: <empty string>, indicating no GSPro sim is connected.")
+				("replay_camera_dir", value<std::string>(&replay_camera_dir_)->default_value(""),
+					"Specify a directory of recorded shots to play back in place of the cameras (see gs_replay_camera.h).  Default is: <empty string>, indicating the real cameras are used.")
+				("binary_log_file", value<std::string>(&binary_log_file_)->default_value(""),
+					"Specify a file to receive an asynchronous binary log (see gs_async_log.h).  Only warnings and errors are also written to the text logs.  Use pitrac_log_decoder to read the file.  Default is: <empty string>, indicating normal text logging.")
+				("shot_store_dir", value<std::string>(&shot_store_dir_)->default_value(""),
+					"Specify a directory in which to keep a history of every shot (see gs_shot_store.h).  Use pitrac_shot_export to read it.  Default is: <empty string>, indicating no shot history is kept.")
+				("shot_capture_dir", value<std::string>(&shot_capture_dir_)->default_value(""),
+					"Specify a directory in which to save a replayable capture file of each shot (see gs_shot_capture.h).  Default is: <empty string>, indicating shots are not captured.")
+				("metrics_file", value<std::string>(&metrics_file_)->default_value(""),
+					"Specify a file to which the metrics are periodically written in the Prometheus text format (see gs_metrics.h).  Default is: <empty string>, indicating the metrics are only available from the embedded UI server.")
 				("config_file", value<std::string>(&config_file_)->default_value("golf_sim_config.json"),
 					"Specify the filename with the JSON configuration.  Default is: golf_sim_config.json")
 				("cmd_file,cmd", value<std::string>(&command_line_file_)->implicit_value("config.txt"),
@@ -150,6 +164,7 @@ namespace golf_sim {
 		bool perform_pulse_test_;
 		bool use_non_IR_camera_;
 		bool simulate_found_ball_;
+		bool simulate_strobe_hardware_;
 		std::string output_filename_;
 		std::string system_mode_string_;
 		std::string artifact_save_level_string_;
@@ -160,6 +175,11 @@ namespace golf_sim {
 		std::string web_server_share_dir_;
 		std::string e6_host_address_;
 		std::string gspro_host_address_;
+		std::string replay_camera_dir_;
+		std::string binary_log_file_;
+		std::string shot_store_dir_;
+		std::string shot_capture_dir_;
+		std::string metrics_file_;
 		std::string config_file_;
 		std::string golfer_orientation_string_;
 		SystemMode system_mode_;
@@ -0,0 +1,381 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <numeric>
+#include <thread>
+
+#include <opencv2/imgcodecs.hpp>
+
+#include "logging_tools.h"
+#include "gs_globals.h"
+#include "gs_config.h"
+#include "gs_options.h"
+#include "gs_ipc_system.h"
+#include "gs_club_data.h"
+#include "pulse_strobe.h"
+#include "ball_watcher_image_buffer.h"
+#include "motion_detect.h"
+#include "libcamera_interface.h"
+
+#include "gs_replay_camera.h"
+
+
+namespace golf_sim {
+
+    int GsReplayCamera::kReplayWatchingFps = 0;
+    bool GsReplayCamera::kReplayLoopShots = false;
+
+    std::vector<std::string> GsReplayCamera::shot_directories_;
+    size_t GsReplayCamera::current_shot_ = 0;
+
+    std::chrono::steady_clock::time_point GsReplayCamera::replay_start_time_;
+    std::chrono::steady_clock::time_point GsReplayCamera::hit_time_;
+    bool GsReplayCamera::hit_pending_ = false;
+
+    std::vector<double> GsReplayCamera::hit_to_result_ms_;
+    int GsReplayCamera::number_shots_completed_ = 0;
+    int GsReplayCamera::number_shots_failed_ = 0;
+
+
+    bool GsReplayCamera::IsEnabled() {
+        return !GolfSimOptions::GetCommandLineOptions().replay_camera_dir_.empty();
+    }
+
+    bool GsReplayCamera::Initialize() {
+
+        GolfSimConfiguration::SetConstant("gs_config.testing.kReplayWatchingFps", kReplayWatchingFps);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kReplayLoopShots", kReplayLoopShots);
+
+        const std::string& replay_dir = GolfSimOptions::GetCommandLineOptions().replay_camera_dir_;
+
+        shot_directories_.clear();
+        current_shot_ = 0;
+
+        std::error_code error;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(replay_dir, error)) {
+            if (entry.is_directory()) {
+                shot_directories_.push_back(entry.path().string());
+            }
+        }
+
+        if (error) {
+            GS_LOG_MSG(error, "GsReplayCamera::Initialize - could not read replay directory " + replay_dir + ": " + error.message());
+            return false;
+        }
+
+        if (shot_directories_.empty()) {
+            GS_LOG_MSG(error, "GsReplayCamera::Initialize - replay directory " + replay_dir + " has no shot sub-directories.");
+            return false;
+        }
+
+        std::sort(shot_directories_.begin(), shot_directories_.end());
+
+        hit_pending_ = false;
+        hit_to_result_ms_.clear();
+        number_shots_completed_ = 0;
+        number_shots_failed_ = 0;
+        replay_start_time_ = std::chrono::steady_clock::now();
+
+        GS_LOG_MSG(info, "Replaying " + std::to_string(shot_directories_.size()) + " recorded shots from " + replay_dir +
+            " at " + (kReplayWatchingFps > 0 ? std::to_string(kReplayWatchingFps) + " FPS." : std::string("full speed.")));
+
+        return true;
+    }
+
+    std::string GsReplayCamera::GetShotFileName(const std::string& file_name) {
+        return (std::filesystem::path(shot_directories_[current_shot_]) / file_name).string();
+    }
+
+    std::vector<std::string> GsReplayCamera::GetWatchingFrameFileNames() {
+
+        std::vector<std::string> frame_file_names;
+
+        std::error_code error;
+        for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(shot_directories_[current_shot_], error)) {
+            if (entry.is_regular_file() && entry.path().filename().string().rfind("watching_", 0) == 0) {
+                frame_file_names.push_back(entry.path().string());
+            }
+        }
+
+        std::sort(frame_file_names.begin(), frame_file_names.end());
+
+        return frame_file_names;
+    }
+
+    bool GsReplayCamera::TakeStill(const GolfSimCamera& camera, cv::Mat& raw_image) {
+
+        if (current_shot_ >= shot_directories_.size()) {
+            GS_LOG_MSG(error, "GsReplayCamera::TakeStill - no more shots to replay.");
+            return false;
+        }
+
+        const std::string file_name = (camera.camera_hardware_.camera_number_ == GsCameraNumber::kGsCamera1) ?
+                                        GetShotFileName("placement.png") : GetShotFileName("strobed.png");
+
+        raw_image = cv::imread(file_name, cv::IMREAD_COLOR);
+
+        if (raw_image.empty()) {
+            GS_LOG_MSG(error, "GsReplayCamera::TakeStill - could not read " + file_name);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GsReplayCamera::WatchForBallMovement(bool& motion_detected) {
+
+        motion_detected = false;
+
+        if (current_shot_ >= shot_directories_.size()) {
+            GS_LOG_MSG(error, "GsReplayCamera::WatchForBallMovement - no more shots to replay.");
+            return false;
+        }
+
+        const std::vector<std::string> frame_file_names = GetWatchingFrameFileNames();
+
+        if (frame_file_names.empty()) {
+            GS_LOG_MSG(error, "GsReplayCamera::WatchForBallMovement - no watching frames in " + shot_directories_[current_shot_]);
+            number_shots_failed_++;
+            AdvanceToNextShot();
+            return false;
+        }
+
+        // Use the same motion-detection settings as ConfigurePostProcessing gives the real stage
+        float kDifferenceM = 0.;
+        float kDifferenceC = 0.;
+        float kRegionThreshold = 0.;
+        uint kHSkip = 0;
+        uint kVSkip = 0;
+
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceM", kDifferenceM);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kDifferenceC", kDifferenceC);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kRegionThreshold", kRegionThreshold);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kHSkip", kHSkip);
+        GolfSimConfiguration::SetConstant("gs_config.motion_detect_stage.kVSkip", kVSkip);
+
+        const uint hskip = std::max(kHSkip, 1u);
+        const uint vskip = std::max(kVSkip, 1u);
+
+        // Read all of the frames first, so that reading the files is not part of the timing
+        std::vector<cv::Mat> frames;
+        frames.reserve(frame_file_names.size());
+
+        for (const std::string& frame_file_name : frame_file_names) {
+            cv::Mat frame = cv::imread(frame_file_name, cv::IMREAD_GRAYSCALE);
+
+            if (frame.empty()) {
+                GS_LOG_MSG(warning, "GsReplayCamera::WatchForBallMovement - could not read " + frame_file_name + ". Skipping it.");
+                continue;
+            }
+
+            frames.push_back(frame);
+        }
+
+        const std::chrono::microseconds frame_period(kReplayWatchingFps > 0 ? 1000000 / kReplayWatchingFps : 0);
+        std::chrono::steady_clock::time_point next_frame_time = std::chrono::steady_clock::now();
+
+        std::vector<uint8_t> previous_frame;
+        uint frames_left_after_hit = 0;
+
+        RecentFrames.clear();
+
+        for (size_t frame_index = 0; frame_index < frames.size(); frame_index++) {
+
+            if (!GolfSimGlobals::golf_sim_running_) {
+                return false;
+            }
+
+            if (frame_period.count() > 0) {
+                std::this_thread::sleep_until(next_frame_time);
+                next_frame_time += frame_period;
+            }
+
+            const cv::Mat& frame = frames[frame_index];
+
+            // The recorded frames are already cropped to the watching area, so the whole frame is the ROI
+            const uint roi_width = (uint)frame.cols / hskip;
+            const uint roi_height = (uint)frame.rows / vskip;
+            const uint region_threshold = (uint)(kRegionThreshold * (float)roi_width * (float)roi_height);
+            const uint sampled_frame_stride = (uint)frame.step * vskip;
+
+            bool is_hit_frame = false;
+
+            if (previous_frame.size() != (size_t)roi_width * roi_height) {
+                // The first frame just becomes the frame to compare to
+                previous_frame.assign((size_t)roi_width * roi_height, 0);
+                MotionDetectStage::CountChangedPixels(frame.data, sampled_frame_stride, hskip, 0, 0, roi_width, roi_height,
+                                                      kDifferenceM, (int)kDifferenceC, roi_width * roi_height + 1, previous_frame);
+            }
+            else if (!motion_detected) {
+                const uint regions = MotionDetectStage::CountChangedPixels(frame.data, sampled_frame_stride, hskip, 0, 0, roi_width, roi_height,
+                                                                           kDifferenceM, (int)kDifferenceC, region_threshold, previous_frame);
+
+                if (regions >= region_threshold) {
+                    motion_detected = true;
+                    is_hit_frame = true;
+                    hit_time_ = std::chrono::steady_clock::now();
+                    hit_pending_ = true;
+
+                    GS_LOG_MSG(info, "Replay motion detected in frame " + std::to_string(frame_index) + " of " + shot_directories_[current_shot_]);
+
+                    // Trigger as the motion-detection stage does
+                    if (GolfSimOptions::GetCommandLineOptions().system_mode_ != SystemMode::kCamera1TestStandalone) {
+                        PulseStrobe::SendExternalTrigger();
+                    }
+
+                    frames_left_after_hit = GolfSimClubData::kGatherClubData ? GolfSimClubData::kNumberFramesToSaveAfterHit : 0;
+                }
+            }
+
+            RecentFrameInfo frame_info;
+            frame_info.requestSequence = (unsigned int)frame_index;
+            frame_info.isballHitFrame = is_hit_frame;
+            frame_info.frameRate = (float)kReplayWatchingFps;
+            frame_info.mat = frame;
+            RecentFrames.push_back(frame_info);
+
+            if (motion_detected) {
+                if (frames_left_after_hit == 0) {
+                    break;
+                }
+                frames_left_after_hit--;
+            }
+        }
+
+        if (!motion_detected) {
+            GS_LOG_MSG(warning, "GsReplayCamera::WatchForBallMovement - no motion was detected in " + shot_directories_[current_shot_] + ". Moving to the next shot.");
+            number_shots_failed_++;
+            AdvanceToNextShot();
+            return true;
+        }
+
+        return SendCamera2Image();
+    }
+
+    bool GsReplayCamera::SendCamera2Image() {
+
+        cv::Mat raw_image = cv::imread(GetShotFileName("strobed.png"), cv::IMREAD_COLOR);
+
+        if (raw_image.empty()) {
+            GS_LOG_MSG(error, "GsReplayCamera::SendCamera2Image - could not read " + GetShotFileName("strobed.png"));
+            return false;
+        }
+
+        // The camera-2 system undistorts its image before sending it
+        GolfSimCamera camera;
+        camera.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2, GolfSimCamera::kSystemSlot2CameraType);
+
+        cv::Mat image = LibCameraInterface::undistort_camera_image(raw_image, camera);
+
+        GolfSimIPCMessage sent_message(GolfSimIPCMessage::IPCMessageType::kCamera2Image);
+        sent_message.SetImageMat(image);
+
+        // A message from this system would never come back to it through the broker, so
+        // serialize and unpack the image here as a sent and received message would be
+        size_t image_mat_byte_length = 0;
+        unsigned char* data = sent_message.GetImageMatBytePointer(image_mat_byte_length);
+
+        GolfSimIPCMessage received_message(GolfSimIPCMessage::IPCMessageType::kCamera2Image);
+
+        if (!received_message.UnpackMatData((char*)data, image_mat_byte_length)) {
+            GS_LOG_MSG(error, "GsReplayCamera::SendCamera2Image - could not unpack the serialized image.");
+            return false;
+        }
+
+        return GolfSimIpcSystem::DispatchCamera2ImageMessage(received_message);
+    }
+
+    bool GsReplayCamera::WaitForCam2Trigger(cv::Mat& raw_image) {
+
+        GolfSimCamera camera;
+        camera.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2, GolfSimCamera::kSystemSlot2CameraType);
+
+        if (!TakeStill(camera, raw_image)) {
+            return false;
+        }
+
+        number_shots_completed_++;
+        AdvanceToNextShot();
+
+        return true;
+    }
+
+    void GsReplayCamera::RecordShotResult(const bool success) {
+
+        if (!IsEnabled() || !hit_pending_) {
+            return;
+        }
+
+        hit_pending_ = false;
+
+        const double hit_to_result_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hit_time_).count();
+        hit_to_result_ms_.push_back(hit_to_result_ms);
+
+        number_shots_completed_++;
+        if (!success) {
+            number_shots_failed_++;
+        }
+
+        GS_LOG_MSG(info, "Replay shot " + shot_directories_[current_shot_] + (success ? "" : " (FAILED)") +
+            " - hit-to-result latency = " + std::to_string(hit_to_result_ms) + " ms.");
+
+        AdvanceToNextShot();
+    }
+
+    void GsReplayCamera::AdvanceToNextShot() {
+
+        current_shot_++;
+
+        if (current_shot_ < shot_directories_.size()) {
+            return;
+        }
+
+        LogStatistics();
+
+        if (kReplayLoopShots) {
+            current_shot_ = 0;
+        }
+        else {
+            GS_LOG_MSG(info, "Replay finished.  Shutting down.");
+            GolfSimGlobals::golf_sim_running_ = false;
+        }
+    }
+
+    void GsReplayCamera::LogStatistics() {
+
+        const double elapsed_minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - replay_start_time_).count() / 60.0;
+        const double shots_per_minute = (elapsed_minutes > 0.0) ? number_shots_completed_ / elapsed_minutes : 0.0;
+
+        GS_LOG_MSG(info, "Replay statistics: " + std::to_string(number_shots_completed_) + " shots completed, " +
+            std::to_string(number_shots_failed_) + " failed, " + std::to_string(shots_per_minute) + " shots per minute sustained.");
+
+        if (hit_to_result_ms_.empty()) {
+            return;
+        }
+
+        std::vector<double> sorted_ms = hit_to_result_ms_;
+        std::sort(sorted_ms.begin(), sorted_ms.end());
+
+        auto percentile = [&sorted_ms](double p) {
+            return sorted_ms[(size_t)std::round(p * (sorted_ms.size() - 1))];
+        };
+
+        const double mean = std::accumulate(sorted_ms.begin(), sorted_ms.end(), 0.0) / sorted_ms.size();
+
+        GS_LOG_MSG(info, "Replay hit-to-result latency (ms): min = " + std::to_string(sorted_ms.front()) +
+            ", mean = " + std::to_string(mean) +
+            ", p50 = " + std::to_string(percentile(0.50)) +
+            ", p95 = " + std::to_string(percentile(0.95)) +
+            ", max = " + std::to_string(sorted_ms.back()));
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
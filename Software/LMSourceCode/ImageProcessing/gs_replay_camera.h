@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Plays back recorded shots in place of the cameras.  This allows the whole camera-1
+// pipeline (the FSM, ball placement, motion detection, the camera-2 image IPC message,
+// and the shot analysis) to be run and timed on a machine that has no Pi cameras.
+//
+// Enabled with --replay_camera_dir=<directory>.  The directory holds one sub-directory
+// per shot.  The shots are played in name order:
+//
+//     <directory>/shot_001/placement.png    camera 1 still of the teed-up ball
+//     <directory>/shot_001/watching_*.png   the cropped, high-FPS frames of the teed-up ball, played in name order
+//     <directory>/shot_001/strobed.png      camera 2 strobed image of the ball in flight
+//
+// All of the images are raw camera images (before undistortion), as the cameras would
+// deliver them.  The watching frames go through the same frame-differencing as the
+// motion-detection stage.  When motion is found, the external trigger is sent (to the
+// simulated strobe backend), and the shot's strobed image is passed to the camera-1
+// system as a camera-2 image IPC message, as the camera-2 system would.  In the
+// camera-2 system, WaitForCam2Trigger returns the strobed images instead.
+//
+// The time from each detected hit to its result is logged, along with the number of
+// shots per minute that have been sustained since the replay started.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_camera.h"
+
+
+namespace golf_sim {
+
+    class GsReplayCamera {
+
+    public:
+
+        // These are set from the "testing" section of the .json configuration file
+        // The rate at which the watching frames are played.  0 plays them as fast as they can be processed.
+        static int kReplayWatchingFps;
+        // If true, the replay starts over after the last shot.  Otherwise the system shuts down.
+        static bool kReplayLoopShots;
+
+        // True if a replay directory was given on the command line
+        static bool IsEnabled();
+
+        // Finds the shots to play.  Must be called before any of the methods below.
+        static bool Initialize();
+
+        // Returns the current shot's camera 1 still (or its strobed image for camera 2)
+        static bool TakeStill(const GolfSimCamera& camera, cv::Mat& raw_image);
+
+        // Plays the current shot's watching frames until motion is detected, and then
+        // delivers the shot's strobed image to the camera-1 system.
+        static bool WatchForBallMovement(bool& motion_detected);
+
+        // Returns the current shot's strobed image and moves on to the next shot
+        static bool WaitForCam2Trigger(cv::Mat& raw_image);
+
+        // Called by the camera-1 FSM when it has finished analyzing a hit
+        static void RecordShotResult(const bool success);
+
+    protected:
+
+        static std::string GetShotFileName(const std::string& file_name);
+        static std::vector<std::string> GetWatchingFrameFileNames();
+
+        static bool SendCamera2Image();
+
+        static void AdvanceToNextShot();
+        static void LogStatistics();
+
+        static std::vector<std::string> shot_directories_;
+        static size_t current_shot_;
+
+        static std::chrono::steady_clock::time_point replay_start_time_;
+        static std::chrono::steady_clock::time_point hit_time_;
+        static bool hit_pending_;
+
+        static std::vector<double> hit_to_result_ms_;
+        static int number_shots_completed_;
+        static int number_shots_failed_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,524 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#ifdef GS_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_options.h"
+#include "gs_clubs.h"
+#include "gs_shot_store.h"
+#include "pulse_strobe.h"
+
+#include "gs_shot_capture.h"
+
+
+namespace golf_sim {
+
+    const std::string GsShotCapture::kFileExtension = ".gscap";
+
+    bool GsShotCapture::kShotCaptureCompressFrames = true;
+    int GsShotCapture::kShotCaptureQueueDepth = 4;
+
+    namespace {
+
+        // The largest section that Read will accept
+        constexpr uint64_t kMaxSectionBytes = 256ull * 1024 * 1024;
+
+        struct PendingCapture {
+            std::string file_name;
+            GsShotCapture capture;
+        };
+
+        std::mutex writer_mutex;
+        std::condition_variable writer_condition;
+        std::deque<PendingCapture> pending_captures;
+        std::thread writer_thread;
+        bool writer_running = false;
+        bool writer_stopping = false;
+        std::string capture_dir;
+        uint64_t capture_session_id = 0;
+        uint32_t next_sequence_number = 1;
+
+        const std::vector<std::string> kCalibrationKeys = {
+            "kCamera1CalibrationMatrix", "kCamera1DistortionVector",
+            "kCamera2CalibrationMatrix", "kCamera2DistortionVector" };
+
+        void WriteSection(std::ostream& output, const GsShotCapture::SectionType type, const std::string& payload) {
+            GsCaptureSectionHeader header;
+            header.type = (uint32_t)type;
+            header.crc32 = GsShotStore::Crc32(payload.data(), payload.size());
+            header.size = payload.size();
+
+            output.write((const char*)&header, sizeof(header));
+            output.write(payload.data(), payload.size());
+        }
+
+        std::string EncodeFrame(const GsShotCapture::Frame& frame, const bool compress_frames) {
+            // The pixels must be contiguous to be written in one piece
+            const cv::Mat image = frame.image.isContinuous() ? frame.image : frame.image.clone();
+
+            GsCaptureFrameHeader header;
+            header.role = (uint32_t)frame.role;
+            header.sequence_number = frame.sequence_number;
+            header.timestamp_ns = frame.timestamp_ns;
+            header.width = image.cols;
+            header.height = image.rows;
+            header.cv_type = image.type();
+            header.crop_offset_x = frame.crop_offset.x;
+            header.crop_offset_y = frame.crop_offset.y;
+            header.compression = (uint32_t)GsShotCapture::Compression::kNone;
+            header.pixel_bytes = image.total() * image.elemSize();
+
+            std::string payload((const char*)&header, sizeof(header));
+
+#ifdef GS_HAVE_LZ4
+            if (compress_frames && header.pixel_bytes > 0) {
+                std::string compressed(LZ4_compressBound((int)header.pixel_bytes), '\0');
+                const int compressed_size = LZ4_compress_default((const char*)image.data, compressed.data(),
+                    (int)header.pixel_bytes, (int)compressed.size());
+
+                if (compressed_size > 0 && (uint64_t)compressed_size < header.pixel_bytes) {
+                    header.compression = (uint32_t)GsShotCapture::Compression::kLz4;
+                    memcpy(payload.data(), &header, sizeof(header));
+                    payload.append(compressed.data(), compressed_size);
+                    return payload;
+                }
+            }
+#endif
+
+            payload.append((const char*)image.data, header.pixel_bytes);
+            return payload;
+        }
+
+        bool DecodeFrame(const std::string& payload, GsShotCapture::Frame& frame) {
+            GsCaptureFrameHeader header;
+
+            if (payload.size() < sizeof(header)) {
+                return false;
+            }
+
+            memcpy(&header, payload.data(), sizeof(header));
+
+            frame.role = (GsShotCapture::FrameRole)header.role;
+            frame.sequence_number = header.sequence_number;
+            frame.timestamp_ns = header.timestamp_ns;
+            frame.crop_offset = cv::Point(header.crop_offset_x, header.crop_offset_y);
+            frame.image.create(header.height, header.width, header.cv_type);
+
+            if (frame.image.total() * frame.image.elemSize() != header.pixel_bytes) {
+                return false;
+            }
+
+            const char* pixels = payload.data() + sizeof(header);
+            const size_t stored_bytes = payload.size() - sizeof(header);
+
+            if (header.compression == (uint32_t)GsShotCapture::Compression::kNone) {
+                if (stored_bytes != header.pixel_bytes) {
+                    return false;
+                }
+                memcpy(frame.image.data, pixels, stored_bytes);
+                return true;
+            }
+
+#ifdef GS_HAVE_LZ4
+            if (header.compression == (uint32_t)GsShotCapture::Compression::kLz4) {
+                const int decompressed_size = LZ4_decompress_safe(pixels, (char*)frame.image.data,
+                    (int)stored_bytes, (int)header.pixel_bytes);
+                return decompressed_size >= 0 && (uint64_t)decompressed_size == header.pixel_bytes;
+            }
+#endif
+
+            GS_LOG_MSG(error, "GsShotCapture frame uses a compression (" + std::to_string(header.compression) + ") that this build cannot read.");
+            return false;
+        }
+
+        void WriterLoop() {
+            while (true) {
+                PendingCapture pending;
+
+                {
+                    std::unique_lock<std::mutex> lock(writer_mutex);
+                    writer_condition.wait(lock, [] { return writer_stopping || !pending_captures.empty(); });
+
+                    if (pending_captures.empty()) {
+                        return;
+                    }
+
+                    pending = std::move(pending_captures.front());
+                    pending_captures.pop_front();
+                }
+
+                const auto start_time = std::chrono::steady_clock::now();
+
+                if (!pending.capture.Write(capture_dir + "/" + pending.file_name, GsShotCapture::kShotCaptureCompressFrames)) {
+                    GS_LOG_MSG(warning, "Could not write the shot capture " + pending.file_name + ".");
+                    continue;
+                }
+
+                const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+                GS_LOG_TRACE_MSG(trace, "Wrote the shot capture " + pending.file_name + " in " + std::to_string(elapsed_ms) + " ms.");
+            }
+        }
+    }
+
+    const cv::Mat& GsShotCapture::GetFrame(const FrameRole role) const {
+        static const cv::Mat kEmptyImage;
+
+        for (const Frame& frame : frames) {
+            if (frame.role == role) {
+                return frame.image;
+            }
+        }
+
+        return kEmptyImage;
+    }
+
+    std::string GsShotCapture::GetConfigurationJson(uint64_t& generation) {
+        const std::shared_ptr<const GsConfigurationSnapshot> snapshot = GolfSimConfiguration::GetSnapshot();
+        generation = snapshot->generation;
+
+        std::ostringstream json;
+        boost::property_tree::write_json(json, snapshot->root, false);
+        return json.str();
+    }
+
+    void GsShotCapture::SetFromCurrentSystem() {
+        timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        club_type = (int)GolfSimClubs::GetCurrentClubType();
+        pulse_intervals_ms = PulseStrobe::GetPulseIntervals();
+        configuration_json = GetConfigurationJson(config_generation);
+        config_hash = GsShotStore::Hash64(configuration_json);
+    }
+
+    bool GsShotCapture::Write(const std::string& file_name, const bool compress_frames) const {
+
+        boost::property_tree::ptree metadata;
+        metadata.put("shot_number", shot_number);
+        metadata.put("session_id", session_id);
+        metadata.put("timestamp_ns", timestamp_ns);
+        metadata.put("club_type", club_type);
+        metadata.put("config_generation", config_generation);
+        // As a string, so that JSON readers that use doubles do not round it
+        metadata.put("config_hash", std::to_string(config_hash));
+
+        boost::property_tree::ptree intervals;
+        for (const float interval : pulse_intervals_ms) {
+            boost::property_tree::ptree value;
+            value.put("", interval);
+            intervals.push_back(std::make_pair("", value));
+        }
+        metadata.add_child("pulse_intervals_ms", intervals);
+
+        // The calibration is also in the configuration, but is copied here so that it can be
+        // seen without digging through the whole configuration
+        try {
+            boost::property_tree::ptree configuration;
+            std::istringstream configuration_stream(configuration_json);
+            boost::property_tree::read_json(configuration_stream, configuration);
+
+            for (const std::string& key : kCalibrationKeys) {
+                const auto calibration = configuration.get_child_optional("gs_config.cameras." + key);
+                if (calibration) {
+                    metadata.add_child("calibration." + key, *calibration);
+                }
+            }
+        }
+        catch (std::exception& ex) {
+            GS_LOG_MSG(warning, "GsShotCapture::Write could not read the calibration from the configuration - " + std::string(ex.what()));
+        }
+
+        if (has_results) {
+            metadata.put("results.speed_mph", results.speed_mph_);
+            metadata.put("results.hla_deg", results.hla_deg_);
+            metadata.put("results.vla_deg", results.vla_deg_);
+            metadata.put("results.back_spin_rpm", results.back_spin_rpm_);
+            metadata.put("results.side_spin_rpm", results.side_spin_rpm_);
+        }
+
+        std::ostringstream metadata_json;
+        boost::property_tree::write_json(metadata_json, metadata, false);
+
+        // Written to a temporary name first, so that a capture file is never seen half-written
+        const std::string temporary_file_name = file_name + ".tmp";
+        std::ofstream output(temporary_file_name, std::ios::binary | std::ios::trunc);
+
+        if (!output.is_open()) {
+            GS_LOG_MSG(error, "GsShotCapture::Write could not open " + temporary_file_name + ".");
+            return false;
+        }
+
+        output.write(kFileMagic, sizeof(kFileMagic));
+        WriteSection(output, SectionType::kMetadata, metadata_json.str());
+        WriteSection(output, SectionType::kConfiguration, configuration_json);
+
+        for (const Frame& frame : frames) {
+            if (!frame.image.empty()) {
+                WriteSection(output, SectionType::kFrame, EncodeFrame(frame, compress_frames));
+            }
+        }
+
+        output.close();
+
+        std::error_code error;
+
+        if (output.fail()) {
+            GS_LOG_MSG(error, "GsShotCapture::Write could not write " + temporary_file_name + ".");
+            std::filesystem::remove(temporary_file_name, error);
+            return false;
+        }
+
+        std::filesystem::rename(temporary_file_name, file_name, error);
+
+        if (error) {
+            GS_LOG_MSG(error, "GsShotCapture::Write could not rename " + temporary_file_name + " - " + error.message());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GsShotCapture::Read(const std::string& file_name) {
+
+        *this = GsShotCapture();
+
+        std::ifstream input(file_name, std::ios::binary);
+        char magic[sizeof(kFileMagic)];
+
+        if (!input.read(magic, sizeof(magic)) || memcmp(magic, kFileMagic, sizeof(magic)) != 0) {
+            GS_LOG_MSG(error, file_name + " is not a shot capture file.");
+            return false;
+        }
+
+        GsCaptureSectionHeader header;
+        std::string payload;
+        bool found_metadata = false;
+
+        while (input.read((char*)&header, sizeof(header))) {
+
+            if (header.size > kMaxSectionBytes) {
+                GS_LOG_MSG(error, file_name + " has a section that is too large.");
+                return false;
+            }
+
+            payload.resize(header.size);
+
+            if (!input.read(payload.data(), header.size) ||
+                GsShotStore::Crc32(payload.data(), payload.size()) != header.crc32) {
+                GS_LOG_MSG(error, file_name + " is damaged or incomplete.");
+                return false;
+            }
+
+            try {
+                switch ((SectionType)header.type) {
+                    case SectionType::kMetadata: {
+                        boost::property_tree::ptree metadata;
+                        std::istringstream metadata_stream(payload);
+                        boost::property_tree::read_json(metadata_stream, metadata);
+
+                        shot_number = metadata.get<long>("shot_number", 0);
+                        session_id = metadata.get<uint64_t>("session_id", 0);
+                        timestamp_ns = metadata.get<int64_t>("timestamp_ns", 0);
+                        club_type = metadata.get<int>("club_type", 0);
+                        config_generation = metadata.get<uint64_t>("config_generation", 0);
+                        config_hash = std::stoull(metadata.get<std::string>("config_hash", "0"));
+
+                        const auto intervals = metadata.get_child_optional("pulse_intervals_ms");
+
+                        if (intervals) {
+                            for (const auto& interval : *intervals) {
+                                pulse_intervals_ms.push_back(interval.second.get_value<float>());
+                            }
+                        }
+
+                        const auto result_values = metadata.get_child_optional("results");
+                        has_results = (bool)result_values;
+
+                        if (has_results) {
+                            results.speed_mph_ = result_values->get<float>("speed_mph", 0);
+                            results.hla_deg_ = result_values->get<float>("hla_deg", 0);
+                            results.vla_deg_ = result_values->get<float>("vla_deg", 0);
+                            results.back_spin_rpm_ = result_values->get<int>("back_spin_rpm", 0);
+                            results.side_spin_rpm_ = result_values->get<int>("side_spin_rpm", 0);
+                        }
+
+                        found_metadata = true;
+                        break;
+                    }
+
+                    case SectionType::kConfiguration: {
+                        configuration_json = payload;
+                        break;
+                    }
+
+                    case SectionType::kFrame: {
+                        Frame frame;
+                        if (!DecodeFrame(payload, frame)) {
+                            GS_LOG_MSG(error, file_name + " has a frame that could not be decoded.");
+                            return false;
+                        }
+                        frames.push_back(std::move(frame));
+                        break;
+                    }
+
+                    default: {
+                        // Sections from newer versions are skipped
+                        GS_LOG_TRACE_MSG(trace, file_name + " has an unknown section type " + std::to_string(header.type) + ".");
+                        break;
+                    }
+                }
+            }
+            catch (std::exception& ex) {
+                GS_LOG_MSG(error, file_name + " has a section that could not be read - " + std::string(ex.what()));
+                return false;
+            }
+        }
+
+        if (!found_metadata) {
+            GS_LOG_MSG(error, file_name + " has no metadata.");
+            return false;
+        }
+
+        results.shot_number_ = shot_number;
+        results.club_type_ = (GolfSimClubs::GsClubType)club_type;
+
+        return true;
+    }
+
+    bool GsShotCapture::StartWriter() {
+
+        const std::string& directory = GolfSimOptions::GetCommandLineOptions().shot_capture_dir_;
+
+        if (directory.empty()) {
+            return true;
+        }
+
+        GolfSimConfiguration::SetConstant("gs_config.testing.kShotCaptureCompressFrames", kShotCaptureCompressFrames);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kShotCaptureQueueDepth", kShotCaptureQueueDepth);
+
+        if (kShotCaptureCompressFrames && !IsLz4Available()) {
+            GS_LOG_MSG(warning, "Shot capture frames will not be compressed, because this build does not include LZ4.");
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        if (error) {
+            GS_LOG_MSG(error, "Could not create the shot capture directory " + directory + " - " + error.message());
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> lock(writer_mutex);
+
+        if (writer_running) {
+            return true;
+        }
+
+        capture_dir = directory;
+        // Use the shot store's session, so that each capture can be matched with its stored shot
+        capture_session_id = GsShotStore::GetShotHistory().IsOpen() ? GsShotStore::GetShotHistory().GetSessionId() : (uint64_t)time(nullptr);
+        writer_stopping = false;
+        writer_running = true;
+        writer_thread = std::thread(WriterLoop);
+
+        GS_LOG_MSG(info, "Capturing shots to " + directory + ".");
+
+        return true;
+    }
+
+    void GsShotCapture::StopWriter() {
+        {
+            const std::lock_guard<std::mutex> lock(writer_mutex);
+
+            if (!writer_running) {
+                return;
+            }
+
+            writer_stopping = true;
+        }
+
+        writer_condition.notify_all();
+
+        if (writer_thread.joinable()) {
+            writer_thread.join();
+        }
+
+        const std::lock_guard<std::mutex> lock(writer_mutex);
+        writer_running = false;
+    }
+
+    bool GsShotCapture::IsWriterRunning() {
+        const std::lock_guard<std::mutex> lock(writer_mutex);
+        return writer_running && !writer_stopping;
+    }
+
+    std::string GsShotCapture::Submit(GsShotCapture&& capture) {
+
+        std::string file_name;
+
+        {
+            const std::lock_guard<std::mutex> lock(writer_mutex);
+
+            if (!writer_running || writer_stopping) {
+                return "";
+            }
+
+            if ((int)pending_captures.size() >= kShotCaptureQueueDepth) {
+                GS_LOG_MSG(warning, "The shot capture writer is behind.  Shot " + std::to_string(capture.shot_number) + " will not be captured.");
+                return "";
+            }
+
+            if (capture.session_id == 0) {
+                capture.session_id = capture_session_id;
+            }
+
+            for (Frame& frame : capture.frames) {
+                if (frame.sequence_number == 0) {
+                    frame.sequence_number = next_sequence_number++;
+                }
+            }
+
+            char shot_number[16];
+            snprintf(shot_number, sizeof(shot_number), "%05ld", capture.shot_number);
+            file_name = std::to_string(capture.session_id) + "_shot_" + shot_number + kFileExtension;
+
+            pending_captures.push_back({ file_name, std::move(capture) });
+        }
+
+        writer_condition.notify_one();
+
+        return file_name;
+    }
+
+    bool GsShotCapture::IsLz4Available() {
+#ifdef GS_HAVE_LZ4
+        return true;
+#else
+        return false;
+#endif
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
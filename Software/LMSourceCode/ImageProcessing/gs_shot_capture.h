@@ -0,0 +1,149 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A single-file capture of everything that the camera-1 system used to analyze one shot,
+// so that the shot can later be re-analyzed exactly as it was during live play.
+//
+// Enabled with --shot_capture_dir=<directory>.  Each shot is written (on a background
+// thread, so that the FSM is not held up) to <directory>/<session>_shot_<NNNNN>.gscap.
+// The file is kFileMagic followed by sections, each of which is a GsCaptureSectionHeader
+// (type, CRC-32 of the payload, and payload size) and then the payload:
+//
+//      kMetadata       JSON:  the shot and session numbers, the time, the club, the strobe
+//                      pulse intervals that were in effect, the camera calibration, the
+//                      hash and generation of the configuration, and the live results
+//      kConfiguration  JSON:  the whole configuration snapshot that the shot was analyzed with
+//      kFrame          A GsCaptureFrameHeader and then the frame's pixels, optionally
+//                      LZ4-compressed.  One section per frame.
+//
+// The frames are the raw images (before undistortion) that the analysis was given:  the
+// camera-1 image of the teed-up ball, the camera-2 pre-image (if any), and the camera-2
+// strobed image.  They are stored exactly, so a replay gives the analysis the same bytes.
+//
+// If gs_config.testing.kAutomatedTestCaptureDir is set, the automated_testing mode replays
+// every capture in that directory (see GsAutomatedTesting::TestCapturedShots) instead of
+// the PNG test images.  Each capture is replayed with its own configuration snapshot.
+//
+// The session is the GsShotStore session (if the store is open), so a capture and its stored
+// shot have the same session and shot numbers.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_results.h"
+
+
+namespace golf_sim {
+
+    struct GsCaptureSectionHeader {
+        uint32_t type;
+        uint32_t crc32;             // Of the payload
+        uint64_t size;              // Of the payload
+    };
+
+    struct GsCaptureFrameHeader {
+        uint32_t role;
+        uint32_t sequence_number;
+        int64_t timestamp_ns;       // Since the system-clock epoch
+        int32_t width;
+        int32_t height;
+        int32_t cv_type;
+        int32_t crop_offset_x;      // Of the frame within the full sensor image
+        int32_t crop_offset_y;
+        uint32_t compression;
+        uint64_t pixel_bytes;       // Before any compression
+    };
+
+    class GsShotCapture {
+
+    public:
+
+        static constexpr char kFileMagic[8] = { 'G', 'S', 'C', 'A', 'P', '0', '0', '1' };
+        static const std::string kFileExtension;
+
+        enum class SectionType : uint32_t {
+            kMetadata = 1,
+            kConfiguration = 2,
+            kFrame = 3
+        };
+
+        enum class FrameRole : uint32_t {
+            kTeedBall = 0,          // Camera 1
+            kPreImage = 1,          // Camera 2, before the strobes
+            kStrobed = 2            // Camera 2
+        };
+
+        enum class Compression : uint32_t {
+            kNone = 0,
+            kLz4 = 1
+        };
+
+        struct Frame {
+            FrameRole role = FrameRole::kStrobed;
+            uint32_t sequence_number = 0;
+            int64_t timestamp_ns = 0;
+            cv::Point crop_offset;
+            cv::Mat image;
+        };
+
+        // These are set from the "testing" section of the .json configuration file
+        // If true (and the LZ4 library was available at build time), the frames are compressed
+        static bool kShotCaptureCompressFrames;
+        // The most shots that can be waiting to be written.  Further shots are not captured.
+        static int kShotCaptureQueueDepth;
+
+        long shot_number = 0;
+        uint64_t session_id = 0;
+        int64_t timestamp_ns = 0;
+        int club_type = 0;
+        std::vector<float> pulse_intervals_ms;
+
+        uint64_t config_generation = 0;
+        uint64_t config_hash = 0;
+        std::string configuration_json;
+
+        // False if the shot could not be analyzed
+        bool has_results = false;
+        GsResults results;
+
+        std::vector<Frame> frames;
+
+        // Returns an empty image if the capture has no frame with the role
+        const cv::Mat& GetFrame(const FrameRole role) const;
+
+        // Fills in the time, club, pulse intervals, and configuration from the current state
+        // of the system
+        void SetFromCurrentSystem();
+
+        bool Write(const std::string& file_name, const bool compress_frames) const;
+        bool Read(const std::string& file_name);
+
+        // The current configuration as compact JSON, as stored in the captures
+        static std::string GetConfigurationJson(uint64_t& generation);
+
+        // Starts the background thread that writes the submitted captures to the
+        // --shot_capture_dir directory.  Does nothing if the directory is not set.
+        static bool StartWriter();
+        // Writes any captures that are still waiting, and stops the thread
+        static void StopWriter();
+        static bool IsWriterRunning();
+
+        // Queues the capture to be written.  Returns the name of the file (relative to the
+        // capture directory) that it will be written to, or an empty string if it was dropped.
+        static std::string Submit(GsShotCapture&& capture);
+
+        static bool IsLz4Available();
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
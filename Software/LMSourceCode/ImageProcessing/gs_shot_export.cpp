@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// pitrac_shot_export - Lists the sessions in a shot store that was written by GsShotStore
+// (pitrac_lm --shot_store_dir=<directory>), or exports its shots as CSV or as a columnar file.
+//
+// Usage:  pitrac_shot_export <shot_store_dir> [--sessions] [--format=csv|columnar]
+//                            [--output=<file>] [--from=<seconds>] [--to=<seconds>] [--session=<id>]
+//
+//    --sessions       List each session (its id, number of shots, and first and last times)
+//    --format         csv (the default) or columnar (see GsShotStore::ExportColumnar)
+//    --output         The file to write.  Default is the standard output (CSV only).
+//    --from, --to     Only export shots at or after --from and before --to, in seconds
+//                     since the epoch (UTC)
+//    --session        Only export shots from the session with this id
+
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include "gs_shot_store.h"
+
+using namespace golf_sim;
+
+
+static void PrintUsage() {
+    std::cerr << "Usage:  pitrac_shot_export <shot_store_dir> [--sessions] [--format=csv|columnar] "
+        "[--output=<file>] [--from=<seconds>] [--to=<seconds>] [--session=<id>]" << std::endl;
+}
+
+static std::string FormatTime(const int64_t timestamp_ns) {
+    const time_t seconds = (time_t)(timestamp_ns / 1000000000);
+    struct tm tm_utc;
+    gmtime_r(&seconds, &tm_utc);
+
+    char buffer[32];
+    strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    return buffer;
+}
+
+int main(int argc, char* argv[]) {
+
+    std::string directory;
+    std::string format = "csv";
+    std::string output_file;
+    bool list_sessions = false;
+    int64_t from_ns = std::numeric_limits<int64_t>::min();
+    int64_t to_ns = std::numeric_limits<int64_t>::max();
+    uint64_t session_id = GsShotStore::kAllSessions;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        try {
+            if (arg == "--sessions") {
+                list_sessions = true;
+            }
+            else if (arg.rfind("--format=", 0) == 0) {
+                format = arg.substr(9);
+            }
+            else if (arg.rfind("--output=", 0) == 0) {
+                output_file = arg.substr(9);
+            }
+            else if (arg.rfind("--from=", 0) == 0) {
+                from_ns = std::stoll(arg.substr(7)) * 1000000000LL;
+            }
+            else if (arg.rfind("--to=", 0) == 0) {
+                to_ns = std::stoll(arg.substr(5)) * 1000000000LL;
+            }
+            else if (arg.rfind("--session=", 0) == 0) {
+                session_id = std::stoull(arg.substr(10));
+            }
+            else if (directory.empty() && arg.rfind("--", 0) != 0) {
+                directory = arg;
+            }
+            else {
+                PrintUsage();
+                return 1;
+            }
+        }
+        catch (std::exception&) {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (directory.empty() || (format != "csv" && format != "columnar") ||
+        (format == "columnar" && output_file.empty() && !list_sessions)) {
+        PrintUsage();
+        return 1;
+    }
+
+    GsShotStore store;
+
+    if (!store.Open(directory, true)) {
+        std::cerr << "Could not open the shot store in " << directory << "." << std::endl;
+        return 1;
+    }
+
+    if (list_sessions) {
+        for (const GsShotSessionSummary& session : store.GetSessions()) {
+            std::cout << session.session_id << "  " << session.number_shots << " shots  "
+                << FormatTime(session.first_timestamp_ns) << " - " << FormatTime(session.last_timestamp_ns) << std::endl;
+        }
+        return 0;
+    }
+
+    std::ofstream file;
+
+    if (!output_file.empty()) {
+        file.open(output_file, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << output_file << "." << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream& output = output_file.empty() ? std::cout : file;
+
+    const uint64_t number_shots = (format == "csv") ?
+        store.ExportCsv(output, from_ns, to_ns, session_id) :
+        store.ExportColumnar(output, from_ns, to_ns, session_id);
+
+    output.flush();
+
+    if (!output.good()) {
+        std::cerr << "Could not write all of the shots." << std::endl;
+        return 1;
+    }
+
+    std::cerr << number_shots << " shots exported." << std::endl;
+
+    return 0;
+}
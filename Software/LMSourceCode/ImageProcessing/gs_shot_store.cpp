@@ -0,0 +1,793 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gs_shot_store.h"
+
+
+namespace golf_sim {
+
+    // The columnar export writes the values straight from memory
+    static_assert(std::endian::native == std::endian::little, "The shot store assumes a little-endian machine.");
+
+    const std::string GsShotStore::kRecordFileName = "shots.gsr";
+    const std::string GsShotStore::kIndexFileName = "shots.gsi";
+
+    static constexpr size_t kFileHeaderBytes = sizeof(GsShotStore::kRecordFileMagic);
+
+    // The payload must at least hold the record_size and image_references_length fields
+    static constexpr uint32_t kMinPayloadBytes = 2 * sizeof(uint32_t);
+
+    namespace {
+
+        enum class ColumnType : uint8_t {
+            kInt64 = 0,
+            kDouble = 1,
+            kString = 2
+        };
+
+        // The columns that are exported, in order.  Only the accessor that matches the
+        // column's type is used.
+        struct ShotColumn {
+            const char* name;
+            ColumnType type;
+            int64_t (*int_value)(const GsShotRecord& record);
+            double (*double_value)(const GsShotRecord& record);
+            std::string (*string_value)(const GsShotRecord& record, const std::string& image_references);
+        };
+
+        std::string FormatUtcTime(const int64_t timestamp_ns) {
+            const time_t seconds = (time_t)(timestamp_ns / 1000000000);
+            const int milliseconds = (int)((timestamp_ns / 1000000) % 1000);
+
+            struct tm tm_utc;
+            gmtime_r(&seconds, &tm_utc);
+
+            char buffer[40];
+            const size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &tm_utc);
+            snprintf(buffer + length, sizeof(buffer) - length, ".%03dZ", milliseconds);
+
+            return buffer;
+        }
+
+        const std::vector<ShotColumn>& GetColumns() {
+            static const std::vector<ShotColumn> columns = {
+                { "timestamp_ns", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.timestamp_ns; }, nullptr, nullptr },
+                { "time_utc", ColumnType::kString, nullptr, nullptr, [](const GsShotRecord& r, const std::string&) { return FormatUtcTime(r.timestamp_ns); } },
+                { "session_id", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.session_id; }, nullptr, nullptr },
+                { "shot_number", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.shot_number; }, nullptr, nullptr },
+                { "success", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.success; }, nullptr, nullptr },
+                { "config_hash", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.config_hash; }, nullptr, nullptr },
+                { "config_generation", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.config_generation; }, nullptr, nullptr },
+                { "speed_mph", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.speed_mph; }, nullptr },
+                { "launch_angle_deg", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.launch_angle_deg; }, nullptr },
+                { "side_angle_deg", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.side_angle_deg; }, nullptr },
+                { "back_spin_rpm", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.back_spin_rpm; }, nullptr },
+                { "side_spin_rpm", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.side_spin_rpm; }, nullptr },
+                { "club_type", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.club_type; }, nullptr, nullptr },
+                { "confidence", ColumnType::kInt64, [](const GsShotRecord& r) { return (int64_t)r.confidence; }, nullptr, nullptr },
+                { "velocity_time_period_ms", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.velocity_time_period_ms; }, nullptr },
+                { "processing_ms", ColumnType::kDouble, nullptr, [](const GsShotRecord& r) { return r.processing_ms; }, nullptr },
+                { "image_references", ColumnType::kString, nullptr, nullptr, [](const GsShotRecord&, const std::string& refs) { return refs; } },
+            };
+
+            return columns;
+        }
+
+        std::string EscapeCsv(const std::string& value) {
+            if (value.find_first_of(",\"\r\n") == std::string::npos) {
+                return value;
+            }
+
+            std::string escaped = "\"";
+
+            for (const char c : value) {
+                if (c == '"') {
+                    escaped += '"';
+                }
+                escaped += c;
+            }
+
+            return escaped + "\"";
+        }
+
+        bool WriteAll(const int fd, const void* data, const size_t length, const uint64_t offset) {
+            const char* bytes = (const char*)data;
+            size_t written = 0;
+
+            while (written < length) {
+                const ssize_t result = pwrite(fd, bytes + written, length - written, (off_t)(offset + written));
+
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+
+                written += (size_t)result;
+            }
+
+            return true;
+        }
+
+        bool ReadAll(const int fd, void* data, const size_t length, const uint64_t offset) {
+            char* bytes = (char*)data;
+            size_t read_so_far = 0;
+
+            while (read_so_far < length) {
+                const ssize_t result = pread(fd, bytes + read_so_far, length - read_so_far, (off_t)(offset + read_so_far));
+
+                if (result < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (result <= 0) {
+                    return false;
+                }
+
+                read_so_far += (size_t)result;
+            }
+
+            return true;
+        }
+
+        uint64_t GetFileSize(const int fd) {
+            struct stat file_stat;
+
+            if (fstat(fd, &file_stat) != 0) {
+                return 0;
+            }
+
+            return (uint64_t)file_stat.st_size;
+        }
+
+        template <typename T>
+        void WriteValue(std::ostream& output, const T& value) {
+            output.write((const char*)&value, sizeof(value));
+        }
+    }
+
+    GsShotStore::~GsShotStore() {
+        Close();
+    }
+
+    GsShotStore& GsShotStore::GetShotHistory() {
+        static GsShotStore shot_history;
+        return shot_history;
+    }
+
+    bool GsShotStore::Open(const std::string& directory,
+                           const bool read_only,
+                           std::function<void(const std::string& message)> report) {
+
+        Close();
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+
+        directory_ = directory;
+        read_only_ = read_only;
+        report_ = std::move(report);
+
+        if (!OpenFiles()) {
+            CloseFiles();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool GsShotStore::OpenFiles() {
+
+        const std::string& directory = directory_;
+        const bool read_only = read_only_;
+
+        if (!read_only && mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            Report("GsShotStore could not create directory " + directory + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        const std::string record_file = directory + "/" + kRecordFileName;
+        const std::string index_file = directory + "/" + kIndexFileName;
+        const int flags = read_only ? O_RDONLY : (O_RDWR | O_CREAT);
+
+        record_fd_ = open(record_file.c_str(), flags | O_CLOEXEC, 0644);
+        index_fd_ = open(index_file.c_str(), flags | O_CLOEXEC, 0644);
+
+        if (record_fd_ < 0 || index_fd_ < 0) {
+            Report("GsShotStore could not open " + record_file + " or " + index_file + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        // A new store has only the file headers
+        if (!read_only && GetFileSize(record_fd_) == 0) {
+            if (!WriteAll(record_fd_, kRecordFileMagic, kFileHeaderBytes, 0) ||
+                ftruncate(index_fd_, 0) != 0 ||
+                !WriteAll(index_fd_, kIndexFileMagic, kFileHeaderBytes, 0)) {
+                Report("GsShotStore could not initialize " + directory + ".");
+                return false;
+            }
+        }
+
+        char magic[kFileHeaderBytes];
+
+        if (!ReadAll(record_fd_, magic, kFileHeaderBytes, 0) || memcmp(magic, kRecordFileMagic, kFileHeaderBytes) != 0) {
+            Report(record_file + " is not a shot store record file.");
+            return false;
+        }
+
+        record_file_size_ = GetFileSize(record_fd_);
+
+        // The index is trusted if its last entry points at the last (complete) record.
+        // Otherwise, the record file is checked from the start and the index is rebuilt.
+        size_t number_entries = 0;
+        void* mapping = nullptr;
+        size_t mapping_size = 0;
+        const GsShotIndexEntry* entries = MapIndex(number_entries, mapping, mapping_size);
+
+        bool index_matches = false;
+
+        if (mapping != nullptr) {
+            if (number_entries == 0) {
+                index_matches = (record_file_size_ == kFileHeaderBytes);
+            }
+            else {
+                GsShotRecord last_record;
+                std::string image_references;
+                index_matches = (ReadRecord(entries[number_entries - 1].record_offset, last_record, image_references) == record_file_size_);
+                last_timestamp_ns_ = entries[number_entries - 1].timestamp_ns;
+                session_id_ = entries[number_entries - 1].session_id;
+            }
+            number_records_ = number_entries;
+            UnmapIndex(mapping, mapping_size);
+        }
+
+        if (!index_matches) {
+            std::vector<GsShotIndexEntry> recovered_entries;
+
+            if (!RecoverRecordFile(recovered_entries) || !CheckOrRebuildIndex(recovered_entries)) {
+                return false;
+            }
+        }
+
+        // Each run is a new session, even if it starts within the same second as the last one
+        session_id_ = std::max((uint64_t)time(nullptr), session_id_ + 1);
+
+        return true;
+    }
+
+    void GsShotStore::Close() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        CloseFiles();
+    }
+
+    void GsShotStore::CloseFiles() {
+        if (record_fd_ >= 0) {
+            close(record_fd_);
+            record_fd_ = -1;
+        }
+        if (index_fd_ >= 0) {
+            close(index_fd_);
+            index_fd_ = -1;
+        }
+
+        record_file_size_ = 0;
+        number_records_ = 0;
+        session_id_ = 0;
+        last_timestamp_ns_ = 0;
+        index_in_memory_ = false;
+        memory_index_.clear();
+    }
+
+    void GsShotStore::Report(const std::string& message) const {
+        if (report_) {
+            report_(message);
+        }
+        else {
+            std::cerr << message << std::endl;
+        }
+    }
+
+    bool GsShotStore::IsOpen() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return record_fd_ >= 0 && index_fd_ >= 0;
+    }
+
+    uint64_t GsShotStore::GetSessionId() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return session_id_;
+    }
+
+    uint64_t GsShotStore::GetNumberRecords() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return number_records_;
+    }
+
+    uint64_t GsShotStore::ReadRecord(const uint64_t offset, GsShotRecord& record, std::string& image_references) const {
+
+        GsShotRecordFrame frame;
+
+        if (!ReadAll(record_fd_, &frame, sizeof(frame), offset) ||
+            frame.payload_size < kMinPayloadBytes || frame.payload_size > kMaxPayloadBytes) {
+            return 0;
+        }
+
+        std::vector<char> payload(frame.payload_size);
+
+        if (!ReadAll(record_fd_, payload.data(), payload.size(), offset + sizeof(frame)) ||
+            Crc32(payload.data(), payload.size()) != frame.crc32) {
+            return 0;
+        }
+
+        uint32_t record_size = 0;
+        uint32_t image_references_length = 0;
+        memcpy(&record_size, payload.data(), sizeof(record_size));
+        memcpy(&image_references_length, payload.data() + sizeof(record_size), sizeof(image_references_length));
+
+        if (record_size < kMinPayloadBytes || (uint64_t)record_size + image_references_length != frame.payload_size) {
+            return 0;
+        }
+
+        // Records from older versions may be shorter, and newer ones longer
+        record = GsShotRecord();
+        memcpy(&record, payload.data(), std::min((size_t)record_size, sizeof(GsShotRecord)));
+        record.record_size = sizeof(GsShotRecord);
+
+        image_references.assign(payload.data() + record_size, image_references_length);
+
+        return offset + sizeof(frame) + frame.payload_size;
+    }
+
+    bool GsShotStore::RecoverRecordFile(std::vector<GsShotIndexEntry>& entries) {
+
+        entries.clear();
+
+        uint64_t offset = kFileHeaderBytes;
+        GsShotRecord record;
+        std::string image_references;
+
+        while (offset < record_file_size_) {
+            const uint64_t next_offset = ReadRecord(offset, record, image_references);
+
+            if (next_offset == 0) {
+                break;
+            }
+
+            entries.push_back({ record.timestamp_ns, record.session_id, record.shot_number, 0, offset });
+            offset = next_offset;
+        }
+
+        if (offset < record_file_size_) {
+            Report("GsShotStore found a damaged or partly-written record at offset " + std::to_string(offset) + " of " + directory_ + "/" + kRecordFileName + ".  " + std::to_string(record_file_size_ - offset) + " bytes " + (read_only_ ? "will be ignored." : "are being removed."));
+
+            if (!read_only_) {
+                if (ftruncate(record_fd_, (off_t)offset) != 0) {
+                    Report("GsShotStore could not truncate the record file: " + std::string(strerror(errno)));
+                    return false;
+                }
+                fdatasync(record_fd_);
+            }
+
+            record_file_size_ = offset;
+        }
+
+        number_records_ = entries.size();
+        last_timestamp_ns_ = entries.empty() ? 0 : entries.back().timestamp_ns;
+        session_id_ = entries.empty() ? 0 : entries.back().session_id;
+
+        return true;
+    }
+
+    bool GsShotStore::CheckOrRebuildIndex(const std::vector<GsShotIndexEntry>& entries) {
+
+        if (read_only_) {
+            // The files are left alone, e.g., in case the LM is still appending to them
+            Report("GsShotStore index in " + directory_ + " does not match the records.  Using an index of the " +
+                std::to_string(entries.size()) + " complete records, rebuilt in memory.  Open the store for writing " +
+                "(e.g., by running pitrac_lm with --shot_store_dir) to rebuild the index file.");
+            memory_index_ = entries;
+            index_in_memory_ = true;
+            return true;
+        }
+
+        std::vector<char> index_file(kFileHeaderBytes + entries.size() * sizeof(GsShotIndexEntry));
+        memcpy(index_file.data(), kIndexFileMagic, kFileHeaderBytes);
+
+        if (!entries.empty()) {
+            memcpy(index_file.data() + kFileHeaderBytes, entries.data(), entries.size() * sizeof(GsShotIndexEntry));
+        }
+
+        if (ftruncate(index_fd_, 0) != 0 || !WriteAll(index_fd_, index_file.data(), index_file.size(), 0)) {
+            Report("GsShotStore could not rebuild the index in " + directory_ + ": " + std::string(strerror(errno)));
+            return false;
+        }
+
+        Report("GsShotStore rebuilt the index of " + std::to_string(entries.size()) + " shots in " + directory_ + ".");
+
+        return true;
+    }
+
+    const GsShotIndexEntry* GsShotStore::MapIndex(size_t& number_entries, void*& mapping, size_t& mapping_size) const {
+
+        number_entries = 0;
+        mapping = nullptr;
+
+        if (index_in_memory_) {
+            // Not really mapped, but not nullptr either, so that it is not taken as a failure
+            mapping = (void*)&memory_index_;
+            mapping_size = 0;
+            number_entries = memory_index_.size();
+            return memory_index_.data();
+        }
+
+        mapping_size = (size_t)GetFileSize(index_fd_);
+
+        if (mapping_size < kFileHeaderBytes) {
+            return nullptr;
+        }
+
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, index_fd_, 0);
+
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            return nullptr;
+        }
+
+        if (memcmp(mapping, kIndexFileMagic, kFileHeaderBytes) != 0) {
+            munmap(mapping, mapping_size);
+            mapping = nullptr;
+            return nullptr;
+        }
+
+        // Ignore any partly-written entry at the end
+        number_entries = (mapping_size - kFileHeaderBytes) / sizeof(GsShotIndexEntry);
+
+        return (const GsShotIndexEntry*)((const char*)mapping + kFileHeaderBytes);
+    }
+
+    void GsShotStore::UnmapIndex(void* mapping, const size_t mapping_size) const {
+        if (mapping != nullptr && mapping != (const void*)&memory_index_) {
+            munmap(mapping, mapping_size);
+        }
+    }
+
+    bool GsShotStore::Append(GsShotRecord record, const std::string& image_references) {
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+
+        if (record_fd_ < 0 || read_only_) {
+            return false;
+        }
+
+        if (image_references.size() > kMaxPayloadBytes - sizeof(GsShotRecord)) {
+            Report("GsShotStore::Append - the image references are too long.");
+            return false;
+        }
+
+        if (record.timestamp_ns == 0) {
+            record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+        // Keep the index sorted by time
+        record.timestamp_ns = std::max(record.timestamp_ns, last_timestamp_ns_);
+        record.session_id = session_id_;
+        record.record_size = sizeof(GsShotRecord);
+        record.image_references_length = (uint32_t)image_references.size();
+
+        std::vector<char> buffer(sizeof(GsShotRecordFrame) + sizeof(GsShotRecord) + image_references.size());
+        char* payload = buffer.data() + sizeof(GsShotRecordFrame);
+
+        memcpy(payload, &record, sizeof(GsShotRecord));
+        memcpy(payload + sizeof(GsShotRecord), image_references.data(), image_references.size());
+
+        GsShotRecordFrame frame;
+        frame.payload_size = (uint32_t)(sizeof(GsShotRecord) + image_references.size());
+        frame.crc32 = Crc32(payload, frame.payload_size);
+        memcpy(buffer.data(), &frame, sizeof(frame));
+
+        const uint64_t record_offset = record_file_size_;
+
+        // The record is on disk before it is indexed.  If the index entry is then lost (e.g., in
+        // a crash), the index is rebuilt when the store is next opened.
+        if (!WriteAll(record_fd_, buffer.data(), buffer.size(), record_offset) || fdatasync(record_fd_) != 0) {
+            Report("GsShotStore::Append could not write the record: " + std::string(strerror(errno)));
+            // Do not leave a partial record for the next append to follow
+            if (ftruncate(record_fd_, (off_t)record_offset) != 0) {
+                Report("GsShotStore::Append could not remove the partial record.");
+            }
+            return false;
+        }
+
+        const GsShotIndexEntry entry = { record.timestamp_ns, record.session_id, record.shot_number, 0, record_offset };
+        const uint64_t index_offset = kFileHeaderBytes + number_records_ * sizeof(GsShotIndexEntry);
+
+        if (!WriteAll(index_fd_, &entry, sizeof(entry), index_offset)) {
+            Report("GsShotStore::Append could not write the index entry: " + std::string(strerror(errno)));
+            // Leave the two files as they were, so that the next append goes where this one would have
+            if (ftruncate(record_fd_, (off_t)record_offset) != 0 || ftruncate(index_fd_, (off_t)index_offset) != 0) {
+                Report("GsShotStore::Append could not remove the unindexed record.");
+            }
+            return false;
+        }
+
+        // Only counted once both the record and its index entry are written
+        record_file_size_ += buffer.size();
+        number_records_++;
+        last_timestamp_ns_ = record.timestamp_ns;
+
+        return true;
+    }
+
+    bool GsShotStore::Query(const int64_t from_ns,
+                            const int64_t to_ns,
+                            const uint64_t session_id,
+                            const std::function<bool(const GsShotRecord& record, const std::string& image_references)>& visitor) const {
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+
+        if (record_fd_ < 0) {
+            return false;
+        }
+
+        size_t number_entries = 0;
+        void* mapping = nullptr;
+        size_t mapping_size = 0;
+        const GsShotIndexEntry* entries = MapIndex(number_entries, mapping, mapping_size);
+
+        if (mapping == nullptr) {
+            return false;
+        }
+
+        const GsShotIndexEntry* end = entries + number_entries;
+        const GsShotIndexEntry* first = std::lower_bound(entries, end, from_ns,
+            [](const GsShotIndexEntry& entry, const int64_t t) { return entry.timestamp_ns < t; });
+
+        GsShotRecord record;
+        std::string image_references;
+        bool result = true;
+
+        for (const GsShotIndexEntry* entry = first; entry < end && entry->timestamp_ns < to_ns; entry++) {
+            if (session_id != kAllSessions && entry->session_id != session_id) {
+                continue;
+            }
+
+            if (ReadRecord(entry->record_offset, record, image_references) == 0) {
+                Report("GsShotStore::Query could not read the record at offset " + std::to_string(entry->record_offset) + ".");
+                result = false;
+                break;
+            }
+
+            if (!visitor(record, image_references)) {
+                break;
+            }
+        }
+
+        UnmapIndex(mapping, mapping_size);
+
+        return result;
+    }
+
+    std::vector<GsShotSessionSummary> GsShotStore::GetSessions() const {
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+
+        std::map<uint64_t, GsShotSessionSummary> sessions;
+
+        size_t number_entries = 0;
+        void* mapping = nullptr;
+        size_t mapping_size = 0;
+        const GsShotIndexEntry* entries = MapIndex(number_entries, mapping, mapping_size);
+
+        for (size_t i = 0; i < number_entries; i++) {
+            GsShotSessionSummary& summary = sessions[entries[i].session_id];
+
+            if (summary.number_shots == 0) {
+                summary.session_id = entries[i].session_id;
+                summary.first_timestamp_ns = entries[i].timestamp_ns;
+            }
+
+            summary.number_shots++;
+            summary.last_timestamp_ns = entries[i].timestamp_ns;
+        }
+
+        UnmapIndex(mapping, mapping_size);
+
+        std::vector<GsShotSessionSummary> result;
+
+        for (const auto& [id, summary] : sessions) {
+            result.push_back(summary);
+        }
+
+        return result;
+    }
+
+    uint64_t GsShotStore::ExportCsv(std::ostream& output,
+                                    const int64_t from_ns,
+                                    const int64_t to_ns,
+                                    const uint64_t session_id) const {
+
+        const std::vector<ShotColumn>& columns = GetColumns();
+
+        for (size_t i = 0; i < columns.size(); i++) {
+            output << (i == 0 ? "" : ",") << columns[i].name;
+        }
+        output << "\n";
+
+        uint64_t number_shots = 0;
+        char number[40];
+
+        Query(from_ns, to_ns, session_id, [&](const GsShotRecord& record, const std::string& image_references) {
+            for (size_t i = 0; i < columns.size(); i++) {
+                if (i > 0) {
+                    output << ",";
+                }
+
+                switch (columns[i].type) {
+                    case ColumnType::kInt64:
+                        output << columns[i].int_value(record);
+                        break;
+                    case ColumnType::kDouble:
+                        snprintf(number, sizeof(number), "%.3f", columns[i].double_value(record));
+                        output << number;
+                        break;
+                    case ColumnType::kString:
+                        output << EscapeCsv(columns[i].string_value(record, image_references));
+                        break;
+                }
+            }
+            output << "\n";
+
+            number_shots++;
+            return output.good();
+        });
+
+        return number_shots;
+    }
+
+    uint64_t GsShotStore::ExportColumnar(std::ostream& output,
+                                         const int64_t from_ns,
+                                         const int64_t to_ns,
+                                         const uint64_t session_id) const {
+
+        const std::vector<ShotColumn>& columns = GetColumns();
+
+        output.write(kColumnarFileMagic, sizeof(kColumnarFileMagic));
+        WriteValue(output, (uint32_t)columns.size());
+
+        for (const ShotColumn& column : columns) {
+            const uint16_t name_length = (uint16_t)strlen(column.name);
+            WriteValue(output, (uint8_t)column.type);
+            WriteValue(output, name_length);
+            output.write(column.name, name_length);
+        }
+
+        // One row group's values for each column
+        std::vector<std::vector<int64_t>> int_values(columns.size());
+        std::vector<std::vector<double>> double_values(columns.size());
+        std::vector<std::vector<std::string>> string_values(columns.size());
+        uint32_t number_rows = 0;
+
+        auto write_row_group = [&]() {
+            WriteValue(output, number_rows);
+
+            for (size_t i = 0; i < columns.size(); i++) {
+                switch (columns[i].type) {
+                    case ColumnType::kInt64:
+                        output.write((const char*)int_values[i].data(), int_values[i].size() * sizeof(int64_t));
+                        int_values[i].clear();
+                        break;
+                    case ColumnType::kDouble:
+                        output.write((const char*)double_values[i].data(), double_values[i].size() * sizeof(double));
+                        double_values[i].clear();
+                        break;
+                    case ColumnType::kString:
+                        for (const std::string& value : string_values[i]) {
+                            WriteValue(output, (uint32_t)value.size());
+                        }
+                        for (const std::string& value : string_values[i]) {
+                            output.write(value.data(), value.size());
+                        }
+                        string_values[i].clear();
+                        break;
+                }
+            }
+
+            number_rows = 0;
+        };
+
+        uint64_t number_shots = 0;
+
+        Query(from_ns, to_ns, session_id, [&](const GsShotRecord& record, const std::string& image_references) {
+            for (size_t i = 0; i < columns.size(); i++) {
+                switch (columns[i].type) {
+                    case ColumnType::kInt64:
+                        int_values[i].push_back(columns[i].int_value(record));
+                        break;
+                    case ColumnType::kDouble:
+                        double_values[i].push_back(columns[i].double_value(record));
+                        break;
+                    case ColumnType::kString:
+                        string_values[i].push_back(columns[i].string_value(record, image_references));
+                        break;
+                }
+            }
+
+            number_rows++;
+            number_shots++;
+
+            if (number_rows == kColumnarRowGroupSize) {
+                write_row_group();
+            }
+
+            return output.good();
+        });
+
+        if (number_rows > 0) {
+            write_row_group();
+        }
+
+        // The (empty) row group that ends the file
+        write_row_group();
+
+        return number_shots;
+    }
+
+    uint32_t GsShotStore::Crc32(const void* data, const size_t length) {
+
+        static const std::array<uint32_t, 256> table = []() {
+            std::array<uint32_t, 256> t{};
+
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                }
+                t[i] = c;
+            }
+
+            return t;
+        }();
+
+        const uint8_t* bytes = (const uint8_t*)data;
+        uint32_t crc = 0xFFFFFFFFu;
+
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+        }
+
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    uint64_t GsShotStore::Hash64(const std::string& text) {
+        uint64_t hash = 0xcbf29ce484222325ull;
+
+        for (const unsigned char c : text) {
+            hash ^= c;
+            hash *= 0x100000001b3ull;
+        }
+
+        return hash;
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,220 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A persistent, append-only history of every shot that the launch monitor analyzes.
+//
+// Enabled with --shot_store_dir=<directory>.  The directory holds two files:
+//
+//      shots.gsr   The records.  After an 8-byte file header, each record is a
+//                  GsShotRecordFrame (payload size and CRC-32) followed by the payload:  a
+//                  GsShotRecord and then its image-reference text.  Records are only ever
+//                  appended, and the file is flushed to disk after each one.
+//      shots.gsi   The index.  After an 8-byte file header, one fixed-size GsShotIndexEntry
+//                  (time, session, shot number, and record offset) per record.  Queries
+//                  memory-map this file and binary-search it by time.
+//
+// When the store is opened, the record file is checked from the start.  A record that was
+// only partly written (e.g., power was lost) or that fails its checksum ends the file, and
+// it and anything after it are cut off.  The index is rebuilt from the records if it does
+// not match them, so the index never needs to be backed up.  A read-only open (as by the
+// export tool) changes neither file.  It ignores any damaged end of the record file and, if
+// need be, rebuilds the index in memory only.
+//
+// Times are made non-decreasing as records are appended, so that the index stays sorted
+// even if the system clock is stepped back.  Each run of the launch monitor is a new
+// session, identified by the time (in seconds) at which the store was opened.
+//
+// The pitrac_shot_export tool (gs_shot_export.cpp) queries a store and streams the shots
+// to a CSV file or to a simple column-oriented ("Parquet-like") file, described below.
+//
+// This module does not depend on boost or OpenCV so that the export tool can be built alone.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace golf_sim {
+
+    // Precedes each record's payload in the record file
+    struct GsShotRecordFrame {
+        uint32_t payload_size;
+        uint32_t crc32;             // Of the payload
+    };
+
+    // The fixed part of each record's payload.  The image references (file names,
+    // separated by ';') follow it.  New fields must only be added at the end, so that
+    // older records (with a smaller record_size) can still be read.
+    struct GsShotRecord {
+        uint32_t record_size = sizeof(GsShotRecord);
+        uint32_t image_references_length = 0;
+
+        int64_t timestamp_ns = 0;               // Since the system-clock epoch
+        uint64_t session_id = 0;
+        uint32_t shot_number = 0;
+        uint32_t success = 0;                   // 0 if the shot could not be analyzed
+
+        uint64_t config_hash = 0;               // Of the configuration used for the shot
+        uint64_t config_generation = 0;
+
+        double speed_mph = 0.0;
+        double launch_angle_deg = 0.0;          // Vertical (VLA)
+        double side_angle_deg = 0.0;            // Horizontal (HLA)
+        double back_spin_rpm = 0.0;
+        double side_spin_rpm = 0.0;
+        int32_t club_type = 0;
+        int32_t confidence = 0;
+
+        // Timings
+        double velocity_time_period_ms = 0.0;   // Between the ball positions used for the speed
+        double processing_ms = 0.0;             // To analyze the camera-2 image
+    };
+
+    struct GsShotIndexEntry {
+        int64_t timestamp_ns;
+        uint64_t session_id;
+        uint32_t shot_number;
+        uint32_t reserved;
+        uint64_t record_offset;                 // Of the record's frame in the record file
+    };
+
+    struct GsShotSessionSummary {
+        uint64_t session_id = 0;
+        uint64_t number_shots = 0;
+        int64_t first_timestamp_ns = 0;
+        int64_t last_timestamp_ns = 0;
+    };
+
+    class GsShotStore {
+
+    public:
+
+        static constexpr char kRecordFileMagic[8] = { 'G', 'S', 'S', 'H', 'O', 'T', '0', '1' };
+        static constexpr char kIndexFileMagic[8] = { 'G', 'S', 'S', 'I', 'D', 'X', '0', '1' };
+        static constexpr char kColumnarFileMagic[8] = { 'G', 'S', 'C', 'O', 'L', '0', '0', '1' };
+
+        static const std::string kRecordFileName;
+        static const std::string kIndexFileName;
+
+        // Records larger than this are treated as corrupt
+        static constexpr uint32_t kMaxPayloadBytes = 64 * 1024;
+
+        // The most rows that the columnar export keeps in memory (one row group) at a time
+        static constexpr size_t kColumnarRowGroupSize = 4096;
+
+        // Matches any session in the queries
+        static constexpr uint64_t kAllSessions = 0;
+
+        GsShotStore() = default;
+        ~GsShotStore();
+
+        GsShotStore(const GsShotStore&) = delete;
+        GsShotStore& operator=(const GsShotStore&) = delete;
+
+        // Opens (creating if necessary) the store in the directory, recovering from any
+        // partly-written record.  If read_only, nothing is created, truncated, or rebuilt.
+        // Problems and recoveries are passed to report, or written to std::cerr if it is empty.
+        bool Open(const std::string& directory,
+                  const bool read_only = false,
+                  std::function<void(const std::string& message)> report = nullptr);
+        void Close();
+
+        bool IsOpen() const;
+
+        // The session of the shots appended by this process
+        uint64_t GetSessionId() const;
+
+        // Adds the shot to the end of the store.  The record's timestamp (if zero) and
+        // session are filled in.  Returns false if the record could not be written.
+        bool Append(GsShotRecord record, const std::string& image_references);
+
+        uint64_t GetNumberRecords() const;
+
+        // Calls the visitor for each shot with from_ns <= time < to_ns in the session (or in
+        // all sessions), in time order.  The visitor returns false to stop early.
+        bool Query(const int64_t from_ns,
+                   const int64_t to_ns,
+                   const uint64_t session_id,
+                   const std::function<bool(const GsShotRecord& record, const std::string& image_references)>& visitor) const;
+
+        std::vector<GsShotSessionSummary> GetSessions() const;
+
+        // The export functions stream the query's shots to the output without keeping them
+        // all in memory.  They return the number of shots that were written.
+        uint64_t ExportCsv(std::ostream& output,
+                           const int64_t from_ns,
+                           const int64_t to_ns,
+                           const uint64_t session_id) const;
+
+        // The columnar file is:  kColumnarFileMagic, the number of columns (uint32), and for
+        // each column its type (uint8:  0 = int64, 1 = double, 2 = string) and name
+        // (uint16 length, then the characters).  Then the row groups, each of which is
+        // the number of rows (uint32) and then each column's values in turn.  Numbers are
+        // stored as arrays of little-endian int64s or doubles.  Strings are stored as an
+        // array of uint32 lengths followed by the characters.  A row group with zero rows
+        // ends the file.
+        uint64_t ExportColumnar(std::ostream& output,
+                                const int64_t from_ns,
+                                const int64_t to_ns,
+                                const uint64_t session_id) const;
+
+        static uint32_t Crc32(const void* data, const size_t length);
+
+        // FNV-1a.  Used to fingerprint the configuration of each shot.
+        static uint64_t Hash64(const std::string& text);
+
+        // The process-wide store that the FSM appends each shot to.  It is opened at
+        // startup if --shot_store_dir is set.
+        static GsShotStore& GetShotHistory();
+
+    protected:
+
+        bool OpenFiles();
+        void CloseFiles();
+
+        void Report(const std::string& message) const;
+
+        // Reads and checks the record at the offset.  Returns the offset of the next record,
+        // or 0 if the record is not complete and correct.
+        uint64_t ReadRecord(const uint64_t offset, GsShotRecord& record, std::string& image_references) const;
+
+        bool RecoverRecordFile(std::vector<GsShotIndexEntry>& entries);
+        bool CheckOrRebuildIndex(const std::vector<GsShotIndexEntry>& entries);
+
+        // Maps the current index file and returns its entries (or nullptr if there are none).
+        // If the index was rebuilt in memory, returns those entries instead.  mapping is
+        // nullptr on failure, and must otherwise be released with UnmapIndex.
+        const GsShotIndexEntry* MapIndex(size_t& number_entries, void*& mapping, size_t& mapping_size) const;
+        void UnmapIndex(void* mapping, const size_t mapping_size) const;
+
+        mutable std::mutex mutex_;
+
+        std::string directory_;
+        bool read_only_ = false;
+        int record_fd_ = -1;
+        int index_fd_ = -1;
+        uint64_t record_file_size_ = 0;
+        uint64_t number_records_ = 0;
+        uint64_t session_id_ = 0;
+        int64_t last_timestamp_ns_ = 0;
+
+        // Used instead of the index file by a read-only store whose index file does not
+        // match the records
+        bool index_in_memory_ = false;
+        std::vector<GsShotIndexEntry> memory_index_;
+
+        std::function<void(const std::string& message)> report_;
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -7,6 +7,7 @@
 #include "cv_utils.h"
 #include "gs_options.h"
 #include "gs_config.h"
+#include "gs_metrics.h"
 
 #include "gs_sim_interface.h"
 #include "gs_gspro_interface.h"
@@ -181,6 +182,11 @@ namespace golf_sim {
 
 #ifdef __unix__  // Ignore in Windows environment
 
+        static GsMetricHistogram& send_seconds = GsMetrics::GetHistogram("pitrac_sim_send_seconds",
+            "Time to send each shot's results to a golf simulator", GsMetricHistogram::kLatencyBucketsSeconds);
+        static GsMetricCounter& send_failures = GsMetrics::GetCounter("pitrac_sim_send_failures_total",
+            "Number of times a shot's results could not be sent to a golf simulator");
+
         // Loop through any interfaces that we are configured for and send the results
         for (auto interface : interfaces_) {
             if (interface == nullptr) {
@@ -188,7 +194,11 @@ namespace golf_sim {
                 continue;
             }
 
-            interface->SendResults(results);
+            GsMetricHistogram::ScopedTimer send_timer(send_seconds);
+
+            if (!interface->SendResults(results)) {
+                send_failures.Increment();
+            }
         }
 
 #endif
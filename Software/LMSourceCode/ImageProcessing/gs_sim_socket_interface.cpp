@@ -17,6 +17,7 @@
 #include "gs_config.h"
 #include "gs_events.h"
 #include "gs_ipc_control_msg.h"
+#include "gs_metrics.h"
 
 #include "gs_gspro_interface.h"
 #include "gs_gspro_response.h"
@@ -234,6 +235,11 @@ namespace golf_sim {
 
         if (receive_thread_exited_) {
             GS_LOG_MSG(error, "GsSimSocketInterface::SendResults called before the interface was intialized - trying to re-initialize.");
+
+            static GsMetricCounter& reconnects = GsMetrics::GetCounter("pitrac_sim_reconnects_total",
+                "Number of attempts to reconnect to a socket-based golf simulator before sending a shot");
+            reconnects.Increment();
+
             // If we ended the receive thread, try re-initializing the connection
             DeInitialize();
             if (!Initialize()) {
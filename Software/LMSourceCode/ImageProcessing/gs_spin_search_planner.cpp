@@ -0,0 +1,235 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_options.h"
+#include "cv_utils.h"
+
+#include "gs_spin_search_planner.h"
+
+
+namespace golf_sim {
+
+    bool GsSpinSearchPlanner::kSpinSearchPlannerEnabled = true;
+    double GsSpinSearchPlanner::kSpinSearchDriverBackSpinFactor = 80.0;
+    double GsSpinSearchPlanner::kSpinSearchDriverMinBackSpinRpm = 1200.0;
+    double GsSpinSearchPlanner::kSpinSearchDriverMaxBackSpinRpm = 5000.0;
+    double GsSpinSearchPlanner::kSpinSearchIronBackSpinFactor = 180.0;
+    double GsSpinSearchPlanner::kSpinSearchIronMinBackSpinRpm = 3000.0;
+    double GsSpinSearchPlanner::kSpinSearchIronMaxBackSpinRpm = 11000.0;
+    double GsSpinSearchPlanner::kSpinSearchWindowFraction = 0.4;
+    double GsSpinSearchPlanner::kSpinSearchMinWindowRpm = 1500.0;
+    int GsSpinSearchPlanner::kSpinSearchHistorySize = 10;
+    double GsSpinSearchPlanner::kSpinSearchHistoryWeight = 0.5;
+    double GsSpinSearchPlanner::kSpinSearchMinAcceptableScore = 0.6;
+    double GsSpinSearchPlanner::kSpinSearchMinHistoryScore = 0.6;
+
+    std::mutex GsSpinSearchPlanner::history_mutex_;
+    std::map<GolfSimClubs::GsClubType, std::deque<GsSpinSearchPlanner::RecordedSpin>> GsSpinSearchPlanner::history_;
+
+
+    void GsSpinSearchPlanner::ReadConfiguration() {
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchPlannerEnabled", kSpinSearchPlannerEnabled);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchDriverBackSpinFactor", kSpinSearchDriverBackSpinFactor);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchDriverMinBackSpinRpm", kSpinSearchDriverMinBackSpinRpm);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchDriverMaxBackSpinRpm", kSpinSearchDriverMaxBackSpinRpm);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchIronBackSpinFactor", kSpinSearchIronBackSpinFactor);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchIronMinBackSpinRpm", kSpinSearchIronMinBackSpinRpm);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchIronMaxBackSpinRpm", kSpinSearchIronMaxBackSpinRpm);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchWindowFraction", kSpinSearchWindowFraction);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchMinWindowRpm", kSpinSearchMinWindowRpm);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchHistorySize", kSpinSearchHistorySize);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchHistoryWeight", kSpinSearchHistoryWeight);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchMinAcceptableScore", kSpinSearchMinAcceptableScore);
+        GolfSimConfiguration::SetConstant("gs_config.spin_analysis.kSpinSearchMinHistoryScore", kSpinSearchMinHistoryScore);
+    }
+
+    void GsSpinSearchPlanner::NarrowAxis(const double lower_degrees,
+                                         const double upper_degrees,
+                                         const int increment,
+                                         int& start,
+                                         int& end) {
+
+        if (increment <= 0 || end <= start) {
+            return;
+        }
+
+        // Stay on the grid of the full search space, so that the narrowed search only
+        // scores rotations that the full search would have scored
+        const int grid_origin = start;
+        const int number_steps = (end - start) / increment;
+
+        const int lower_step = std::clamp((int)std::floor((lower_degrees - grid_origin) / increment), 0, number_steps);
+        const int upper_step = std::clamp((int)std::ceil((upper_degrees - grid_origin) / increment), lower_step, number_steps);
+
+        start = grid_origin + lower_step * increment;
+        end = grid_origin + upper_step * increment;
+    }
+
+    bool GsSpinSearchPlanner::GetHistoryMedians(const GolfSimClubs::GsClubType club_type, double& back_spin_rpm, double& spin_axis_deg) {
+        const std::lock_guard<std::mutex> lock(history_mutex_);
+
+        auto club_history = history_.find(club_type);
+
+        if (club_history == history_.end() || club_history->second.empty()) {
+            return false;
+        }
+
+        std::vector<double> back_spins;
+        std::vector<double> spin_axes;
+
+        for (const RecordedSpin& spin : club_history->second) {
+            back_spins.push_back(spin.back_spin_rpm);
+            spin_axes.push_back(spin.spin_axis_deg);
+        }
+
+        const size_t middle = back_spins.size() / 2;
+        std::nth_element(back_spins.begin(), back_spins.begin() + middle, back_spins.end());
+        std::nth_element(spin_axes.begin(), spin_axes.begin() + middle, spin_axes.end());
+
+        back_spin_rpm = back_spins[middle];
+        spin_axis_deg = spin_axes[middle];
+
+        return true;
+    }
+
+    bool GsSpinSearchPlanner::PlanCoarseSearchSpace(const SpinSearchHints& hints,
+                                                    const BallImageProc::RotationSearchSpace& full_search_space,
+                                                    BallImageProc::RotationSearchSpace& planned_search_space) {
+
+        planned_search_space = full_search_space;
+
+        if (!kSpinSearchPlannerEnabled || hints.interval_uS <= 0.0 || hints.ball_speed_mph <= 0.0) {
+            return false;
+        }
+
+        // The spin of a left-handed shot is reversed in the images, so its signs are not
+        // yet known well enough to narrow the search
+        if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+            return false;
+        }
+
+        double back_spin_factor = kSpinSearchDriverBackSpinFactor;
+        double min_back_spin_rpm = kSpinSearchDriverMinBackSpinRpm;
+        double max_back_spin_rpm = kSpinSearchDriverMaxBackSpinRpm;
+
+        switch (hints.club_type) {
+            case GolfSimClubs::GsClubType::kIron:
+                back_spin_factor = kSpinSearchIronBackSpinFactor;
+                min_back_spin_rpm = kSpinSearchIronMinBackSpinRpm;
+                max_back_spin_rpm = kSpinSearchIronMaxBackSpinRpm;
+                break;
+
+            case GolfSimClubs::GsClubType::kPutter:
+                // Putts are not spin-analyzed, and roll rather than spin if they are
+                return false;
+
+            default:
+                break;
+        }
+
+        const double launch_angle_radians = CvUtils::DegreesToRadians(std::max(0.0, hints.vla_deg));
+        double expected_back_spin_rpm = std::clamp(back_spin_factor * hints.ball_speed_mph * std::sin(launch_angle_radians),
+                                                   min_back_spin_rpm, max_back_spin_rpm);
+        double expected_spin_axis_deg = 0.0;
+
+        double history_back_spin_rpm = 0.0;
+        double history_spin_axis_deg = 0.0;
+
+        if (GetHistoryMedians(hints.club_type, history_back_spin_rpm, history_spin_axis_deg)) {
+            expected_back_spin_rpm = (1.0 - kSpinSearchHistoryWeight) * expected_back_spin_rpm + kSpinSearchHistoryWeight * history_back_spin_rpm;
+            expected_spin_axis_deg = history_spin_axis_deg;
+        }
+
+        const double expected_side_spin_rpm = expected_back_spin_rpm * std::tan(CvUtils::DegreesToRadians(expected_spin_axis_deg));
+        const double window_rpm = std::max(kSpinSearchMinWindowRpm, kSpinSearchWindowFraction * expected_back_spin_rpm);
+
+        // See GolfSimCamera::CalculateBallSpinRates.  GetBallRotation searches its x axis with
+        // the opposite sign to the side spin that it reports.
+        const double degrees_per_rpm = 360.0 / 60.0 * hints.interval_uS / 1000000.0;
+        const double expected_x_degrees = -expected_side_spin_rpm * degrees_per_rpm;
+        const double expected_z_degrees = expected_back_spin_rpm * degrees_per_rpm;
+        const double window_degrees = window_rpm * degrees_per_rpm;
+
+        NarrowAxis(expected_x_degrees - window_degrees, expected_x_degrees + window_degrees,
+                   full_search_space.anglex_rotation_degrees_increment,
+                   planned_search_space.anglex_rotation_degrees_start, planned_search_space.anglex_rotation_degrees_end);
+        NarrowAxis(expected_z_degrees - window_degrees, expected_z_degrees + window_degrees,
+                   full_search_space.anglez_rotation_degrees_increment,
+                   planned_search_space.anglez_rotation_degrees_start, planned_search_space.anglez_rotation_degrees_end);
+
+        GS_LOG_TRACE_MSG(trace, "PlanCoarseSearchSpace - expected back spin " + std::to_string((int)expected_back_spin_rpm) +
+            " rpm, spin axis " + std::to_string(expected_spin_axis_deg) + " degrees.  Searching x from " +
+            std::to_string(planned_search_space.anglex_rotation_degrees_start) + " to " + std::to_string(planned_search_space.anglex_rotation_degrees_end) +
+            " and z from " + std::to_string(planned_search_space.anglez_rotation_degrees_start) + " to " +
+            std::to_string(planned_search_space.anglez_rotation_degrees_end) + " degrees.");
+
+        return (planned_search_space.anglex_rotation_degrees_start != full_search_space.anglex_rotation_degrees_start ||
+                planned_search_space.anglex_rotation_degrees_end != full_search_space.anglex_rotation_degrees_end ||
+                planned_search_space.anglez_rotation_degrees_start != full_search_space.anglez_rotation_degrees_start ||
+                planned_search_space.anglez_rotation_degrees_end != full_search_space.anglez_rotation_degrees_end);
+    }
+
+    bool GsSpinSearchPlanner::ShouldWidenSearch(const RotationCandidate& best_candidate,
+                                                const BallImageProc::RotationSearchSpace& planned_search_space,
+                                                const BallImageProc::RotationSearchSpace& full_search_space) {
+
+        if (best_candidate.score < kSpinSearchMinAcceptableScore) {
+            GS_LOG_TRACE_MSG(trace, "ShouldWidenSearch - best score of " + std::to_string(best_candidate.score) + " is poor.");
+            return true;
+        }
+
+        // The best rotation may be just outside of the narrowed search space
+        const bool on_narrowed_x_edge =
+            (best_candidate.x_rotation_degrees == planned_search_space.anglex_rotation_degrees_start &&
+             planned_search_space.anglex_rotation_degrees_start != full_search_space.anglex_rotation_degrees_start) ||
+            (best_candidate.x_rotation_degrees == planned_search_space.anglex_rotation_degrees_end &&
+             planned_search_space.anglex_rotation_degrees_end != full_search_space.anglex_rotation_degrees_end);
+
+        const bool on_narrowed_z_edge =
+            (best_candidate.z_rotation_degrees == planned_search_space.anglez_rotation_degrees_start &&
+             planned_search_space.anglez_rotation_degrees_start != full_search_space.anglez_rotation_degrees_start) ||
+            (best_candidate.z_rotation_degrees == planned_search_space.anglez_rotation_degrees_end &&
+             planned_search_space.anglez_rotation_degrees_end != full_search_space.anglez_rotation_degrees_end);
+
+        if (on_narrowed_x_edge || on_narrowed_z_edge) {
+            GS_LOG_TRACE_MSG(trace, "ShouldWidenSearch - best rotation is on an edge of the narrowed search space.");
+            return true;
+        }
+
+        return false;
+    }
+
+    void GsSpinSearchPlanner::Reset() {
+        const std::lock_guard<std::mutex> lock(history_mutex_);
+        history_.clear();
+    }
+
+    void GsSpinSearchPlanner::RecordShotSpin(const GolfSimClubs::GsClubType club_type, const double side_spin_rpm, const double back_spin_rpm) {
+
+        if (kSpinSearchHistorySize <= 0 || back_spin_rpm <= 0.0) {
+            return;
+        }
+
+        RecordedSpin spin;
+        spin.back_spin_rpm = back_spin_rpm;
+        spin.spin_axis_deg = CvUtils::RadiansToDegrees(std::atan2(side_spin_rpm, back_spin_rpm));
+
+        const std::lock_guard<std::mutex> lock(history_mutex_);
+
+        std::deque<RecordedSpin>& club_history = history_[club_type];
+        club_history.push_back(spin);
+
+        while ((int)club_history.size() > kSpinSearchHistorySize) {
+            club_history.pop_front();
+        }
+    }
+
+}
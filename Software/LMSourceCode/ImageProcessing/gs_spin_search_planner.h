@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Narrows the coarse rotation search of BallImageProc::GetBallRotation to the rotations that
+// are plausible for the shot, instead of always searching the whole kCoarse... cube.
+//
+// The expected back spin comes from the ball speed and launch angle (spin grows with both),
+// bounded by the spin envelope of the club.  The expected spin axis comes from the golfer's
+// recent shots with the same club, as the launch monitor does not measure the club path.
+// Both are converted to degrees of rotation over the time between the two spin balls.
+//
+// The narrowed cube is a subset of the configured one, on the same grid.  GetBallRotation
+// falls back to the whole cube if the best match within the narrowed cube is poor, or is
+// on an edge of the narrowed cube that is not also an edge of the whole cube.
+//
+// Because of the history, the search depends on the earlier shots.  The automated tests
+// call Reset before each shot, so that each is analyzed on its own.
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include "ball_image_proc.h"
+
+
+namespace golf_sim {
+
+    class GsSpinSearchPlanner {
+
+    public:
+
+        // These are set from the "spin_analysis" section of the .json configuration file
+        static bool kSpinSearchPlannerEnabled;
+        // Expected back spin (rpm) = factor * ball speed (mph) * sin(launch angle)
+        static double kSpinSearchDriverBackSpinFactor;
+        static double kSpinSearchDriverMinBackSpinRpm;
+        static double kSpinSearchDriverMaxBackSpinRpm;
+        static double kSpinSearchIronBackSpinFactor;
+        static double kSpinSearchIronMinBackSpinRpm;
+        static double kSpinSearchIronMaxBackSpinRpm;
+        // The half-width of the search window around the expected spin, for each of the
+        // back and side spins, is the larger of these
+        static double kSpinSearchWindowFraction;
+        static double kSpinSearchMinWindowRpm;
+        // How many recent shots are remembered for each club
+        static int kSpinSearchHistorySize;
+        // 0 uses only the speed and launch angle for the expected back spin, 1 only the history
+        static double kSpinSearchHistoryWeight;
+        // A best coarse candidate whose RotationCandidate::score (the fraction of the compared
+        // pixels that matched, from CompareRotationImage) is below this is considered poor, and
+        // the whole cube is searched
+        static double kSpinSearchMinAcceptableScore;
+        // A shot's spin is only remembered if the best_match_score from GetBallRotation is at
+        // least this
+        static double kSpinSearchMinHistoryScore;
+
+        static void ReadConfiguration();
+
+        // Sets planned_search_space to the part of full_search_space that is plausible for the shot.
+        // Returns false (and sets planned_search_space to full_search_space) if the shot does not
+        // give enough information to narrow the search.
+        static bool PlanCoarseSearchSpace(const SpinSearchHints& hints,
+                                          const BallImageProc::RotationSearchSpace& full_search_space,
+                                          BallImageProc::RotationSearchSpace& planned_search_space);
+
+        // True if the best candidate from the planned search space is not good enough to
+        // rely on, and the full search space should be searched instead
+        static bool ShouldWidenSearch(const RotationCandidate& best_candidate,
+                                      const BallImageProc::RotationSearchSpace& planned_search_space,
+                                      const BallImageProc::RotationSearchSpace& full_search_space);
+
+        // Forgets the history of every club
+        static void Reset();
+
+        // Remembers the measured spin of a shot whose spin analysis matched well
+        static void RecordShotSpin(const GolfSimClubs::GsClubType club_type, const double side_spin_rpm, const double back_spin_rpm);
+
+    protected:
+
+        struct RecordedSpin {
+            double back_spin_rpm = 0.0;
+            // Degrees, positive for positive side spin
+            double spin_axis_deg = 0.0;
+        };
+
+        // Returns false if there is no history for the club
+        static bool GetHistoryMedians(const GolfSimClubs::GsClubType club_type, double& back_spin_rpm, double& spin_axis_deg);
+
+        // Narrows [start, end] of one axis to [lower, upper], keeping to the axis' grid
+        static void NarrowAxis(const double lower_degrees,
+                               const double upper_degrees,
+                               const int increment,
+                               int& start,
+                               int& end);
+
+        static std::mutex history_mutex_;
+        static std::map<GolfSimClubs::GsClubType, std::deque<RecordedSpin>> history_;
+    };
+
+}
@@ -0,0 +1,296 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <thread>
+
+#include "logging_tools.h"
+#include "gs_globals.h"
+#include "gs_config.h"
+#include "gs_camera.h"
+#include "pulse_strobe.h"
+
+#include "gs_strobe_timing_test.h"
+
+
+namespace golf_sim {
+
+    int GsStrobeTimingTest::kStrobeTimingTestIterations = 200;
+    int GsStrobeTimingTest::kStrobeTimingTestLoadThreads = 3;
+    int GsStrobeTimingTest::kStrobeTimingTestPauseBetweenTriggersMs = 20;
+    bool GsStrobeTimingTest::kStrobeTimingTestUseRealtimeThread = false;
+    int GsStrobeTimingTest::kStrobeTimingTestRealtimeCpu = -1;
+
+    // SendExternalTrigger sends a flush pulse of this length (see PulseStrobe)
+    static const double kFlushPulseWidthUs = 10000.0;
+
+
+    void GsStrobeTimingTest::ReadConfiguration() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kStrobeTimingTestIterations", kStrobeTimingTestIterations);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kStrobeTimingTestLoadThreads", kStrobeTimingTestLoadThreads);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kStrobeTimingTestPauseBetweenTriggersMs", kStrobeTimingTestPauseBetweenTriggersMs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kStrobeTimingTestUseRealtimeThread", kStrobeTimingTestUseRealtimeThread);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kStrobeTimingTestRealtimeCpu", kStrobeTimingTestRealtimeCpu);
+    }
+
+    void GsStrobeTimingTest::RunSyntheticLoad(const std::atomic<bool>& stop_load) {
+        // Just burn cpu (and a little memory bandwidth) until told to stop
+        std::vector<double> scratch(64 * 1024, 1.0);
+        double accumulator = 0.0;
+        size_t i = 0;
+
+        while (!stop_load.load(std::memory_order_relaxed)) {
+            accumulator += std::sqrt(scratch[i] + accumulator);
+            scratch[i] = accumulator;
+            i = (i + 4099) % scratch.size();
+        }
+
+        // Make sure the loop is not optimized away
+        if (accumulator < 0.0) {
+            GS_LOG_TRACE_MSG(trace, "RunSyntheticLoad accumulator = " + std::to_string(accumulator));
+        }
+    }
+
+    bool GsStrobeTimingTest::AddTriggerSamples(const std::vector<StrobeEdgeEvent>& edges,
+                                               const std::chrono::steady_clock::time_point& call_time,
+                                               const SimulatedStrobeBackend& backend,
+                                               const bool expect_flush_pulse,
+                                               const long expected_flush_delay_us,
+                                               TriggerTimingSamples& samples) {
+
+        auto microseconds_between = [](const std::chrono::steady_clock::time_point& start,
+                                       const std::chrono::steady_clock::time_point& end) {
+            return std::chrono::duration<double, std::micro>(end - start).count();
+        };
+
+        // The expected sequence is shutter-high, spi-start, spi-end, shutter-low
+        // and then possibly a flush pulse of shutter-high, shutter-low
+        const StrobeEdgeEvent* shutter_open = nullptr;
+        const StrobeEdgeEvent* spi_start = nullptr;
+        const StrobeEdgeEvent* spi_end = nullptr;
+        const StrobeEdgeEvent* shutter_close = nullptr;
+        const StrobeEdgeEvent* flush_open = nullptr;
+        const StrobeEdgeEvent* flush_close = nullptr;
+
+        for (const StrobeEdgeEvent& edge : edges) {
+            switch (edge.edge_type) {
+                case StrobeEdgeEvent::kGpioHigh:
+                    if (shutter_open == nullptr) {
+                        shutter_open = &edge;
+                    }
+                    else if (shutter_close != nullptr && flush_open == nullptr) {
+                        flush_open = &edge;
+                    }
+                    break;
+
+                case StrobeEdgeEvent::kSpiWriteStart:
+                    if (spi_start == nullptr) {
+                        spi_start = &edge;
+                    }
+                    break;
+
+                case StrobeEdgeEvent::kSpiWriteEnd:
+                    if (spi_end == nullptr) {
+                        spi_end = &edge;
+                    }
+                    break;
+
+                case StrobeEdgeEvent::kGpioLow:
+                    if (shutter_open != nullptr && shutter_close == nullptr) {
+                        shutter_close = &edge;
+                    }
+                    else if (flush_open != nullptr && flush_close == nullptr) {
+                        flush_close = &edge;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if (shutter_open == nullptr || spi_start == nullptr || spi_end == nullptr || shutter_close == nullptr) {
+            GS_LOG_MSG(warning, "GsStrobeTimingTest - incomplete edge sequence (" + std::to_string(edges.size()) + " edges).  Skipping sample.");
+            return false;
+        }
+
+        const double nominal_train_us = backend.GetNominalSpiTransferTimeUs(spi_start->number_bytes);
+        samples.nominal_strobe_train_us = nominal_train_us;
+
+        samples.trigger_latency_us.push_back(microseconds_between(call_time, shutter_open->timestamp));
+        samples.shutter_to_strobe_us.push_back(microseconds_between(shutter_open->timestamp, spi_start->timestamp));
+        samples.strobe_train_error_us.push_back(microseconds_between(spi_start->timestamp, spi_end->timestamp) - nominal_train_us);
+        samples.shutter_close_lag_us.push_back(microseconds_between(spi_end->timestamp, shutter_close->timestamp));
+
+        if (expect_flush_pulse) {
+            if (flush_open == nullptr || flush_close == nullptr) {
+                GS_LOG_MSG(warning, "GsStrobeTimingTest - expected a flush pulse, but none was seen.");
+                return false;
+            }
+
+            samples.flush_delay_error_us.push_back(microseconds_between(shutter_close->timestamp, flush_open->timestamp) - (double)expected_flush_delay_us);
+            samples.flush_width_error_us.push_back(microseconds_between(flush_open->timestamp, flush_close->timestamp) - kFlushPulseWidthUs);
+        }
+
+        return true;
+    }
+
+    void GsStrobeTimingTest::RunTriggerIterations(SimulatedStrobeBackend& backend,
+                                                  TriggerTimingSamples& shutter_samples,
+                                                  TriggerTimingSamples& external_trigger_samples) {
+
+        if (kStrobeTimingTestUseRealtimeThread) {
+            if (!PulseStrobe::ElevateCurrentThreadForStrobing(kStrobeTimingTestRealtimeCpu)) {
+                GS_LOG_MSG(warning, "GsStrobeTimingTest - could not fully elevate the strobe thread.  Results will reflect normal scheduling.");
+            }
+        }
+
+        // The same value that SendExternalTrigger will use
+        long kPauseBeforeSendingImageFlushMs = 0;
+        GolfSimConfiguration::SetConstant("gs_config.cameras.kPauseBeforeSendingImageFlushMs", kPauseBeforeSendingImageFlushMs);
+
+        const bool expect_flush_pulse = !GolfSimCamera::kCameraRequiresFlushPulse;
+
+        // Pre-size everything so that the measurement loop itself does not allocate
+        for (TriggerTimingSamples* samples : { &shutter_samples, &external_trigger_samples }) {
+            samples->trigger_latency_us.reserve(kStrobeTimingTestIterations);
+            samples->shutter_to_strobe_us.reserve(kStrobeTimingTestIterations);
+            samples->strobe_train_error_us.reserve(kStrobeTimingTestIterations);
+            samples->shutter_close_lag_us.reserve(kStrobeTimingTestIterations);
+            samples->flush_delay_error_us.reserve(kStrobeTimingTestIterations);
+            samples->flush_width_error_us.reserve(kStrobeTimingTestIterations);
+        }
+
+        for (int i = 0; i < kStrobeTimingTestIterations && GolfSimGlobals::golf_sim_running_; i++) {
+
+            backend.ClearEdges();
+            auto call_time = std::chrono::steady_clock::now();
+            PulseStrobe::SendCameraStrobeTriggerAndShutter(0);
+            AddTriggerSamples(backend.GetEdges(), call_time, backend, false, 0, shutter_samples);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(kStrobeTimingTestPauseBetweenTriggersMs));
+
+            backend.ClearEdges();
+            call_time = std::chrono::steady_clock::now();
+            PulseStrobe::SendExternalTrigger();
+            AddTriggerSamples(backend.GetEdges(), call_time, backend, expect_flush_pulse,
+                              kPauseBeforeSendingImageFlushMs * 1000, external_trigger_samples);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(kStrobeTimingTestPauseBetweenTriggersMs));
+        }
+    }
+
+    std::string GsStrobeTimingTest::FormatStatistics(const std::string& label, std::vector<double> samples_us) {
+        if (samples_us.empty()) {
+            return label + ": <no samples>";
+        }
+
+        std::sort(samples_us.begin(), samples_us.end());
+
+        auto percentile = [&samples_us](double p) {
+            size_t index = (size_t)std::round(p * (samples_us.size() - 1));
+            return samples_us[index];
+        };
+
+        const double mean = std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / samples_us.size();
+
+        return label + " (uS): min = " + std::to_string(samples_us.front()) +
+            ", mean = " + std::to_string(mean) +
+            ", p50 = " + std::to_string(percentile(0.50)) +
+            ", p99 = " + std::to_string(percentile(0.99)) +
+            ", max = " + std::to_string(samples_us.back()) +
+            ", jitter (max-min) = " + std::to_string(samples_us.back() - samples_us.front());
+    }
+
+    void GsStrobeTimingTest::LogSamples(const std::string& title, const TriggerTimingSamples& samples) {
+        GS_LOG_MSG(info, title + " - " + std::to_string(samples.trigger_latency_us.size()) + " samples.  Nominal strobe train length = " +
+            std::to_string(samples.nominal_strobe_train_us) + " uS.");
+        GS_LOG_MSG(info, "    " + FormatStatistics("Trigger latency", samples.trigger_latency_us));
+        GS_LOG_MSG(info, "    " + FormatStatistics("Shutter-open to first strobe", samples.shutter_to_strobe_us));
+        GS_LOG_MSG(info, "    " + FormatStatistics("Strobe train length error", samples.strobe_train_error_us));
+        GS_LOG_MSG(info, "    " + FormatStatistics("Strobe end to shutter-close", samples.shutter_close_lag_us));
+
+        if (!samples.flush_delay_error_us.empty()) {
+            GS_LOG_MSG(info, "    " + FormatStatistics("Flush pulse delay error", samples.flush_delay_error_us));
+            GS_LOG_MSG(info, "    " + FormatStatistics("Flush pulse width error", samples.flush_width_error_us));
+        }
+
+        // Any stretch of the strobe train scales the measured ball speed by the same ratio
+        if (!samples.strobe_train_error_us.empty() && samples.nominal_strobe_train_us > 0.0) {
+            const double worst_error_us = *std::max_element(samples.strobe_train_error_us.begin(), samples.strobe_train_error_us.end(),
+                [](double a, double b) { return std::abs(a) < std::abs(b); });
+
+            GS_LOG_MSG(info, "    Worst-case strobe train error corresponds to a ball-speed error of about " +
+                std::to_string(100.0 * std::abs(worst_error_us) / samples.nominal_strobe_train_us) + "%.");
+        }
+    }
+
+    bool GsStrobeTimingTest::RunStrobeJitterBenchmark() {
+
+        GS_LOG_MSG(info, "GsStrobeTimingTest::RunStrobeJitterBenchmark starting.");
+
+        ReadConfiguration();
+
+        if (kStrobeTimingTestIterations <= 0) {
+            GS_LOG_MSG(error, "GsStrobeTimingTest - kStrobeTimingTestIterations must be > 0.");
+            return false;
+        }
+
+        // The edges can only be timestamped by the simulated backend, so we always use it here
+        auto backend = std::make_shared<SimulatedStrobeBackend>(true /* simulate_spi_transfer_time */);
+        PulseStrobe::SetBackend(backend);
+
+        if (!PulseStrobe::InitGPIOSystem()) {
+            GS_LOG_MSG(error, "GsStrobeTimingTest - failed to InitGPIOSystem.");
+            return false;
+        }
+
+        if (!PulseStrobe::SendCameraPrimingPulses(true /* use_high_speed */)) {
+            GS_LOG_MSG(error, "GsStrobeTimingTest - failed to SendCameraPrimingPulses.");
+            PulseStrobe::DeinitGPIOSystem();
+            return false;
+        }
+
+        GS_LOG_MSG(info, "Running " + std::to_string(kStrobeTimingTestIterations) + " trigger iterations with " +
+            std::to_string(kStrobeTimingTestLoadThreads) + " load threads.  Real-time strobe thread: " +
+            std::string(kStrobeTimingTestUseRealtimeThread ? "yes" : "no"));
+
+        std::atomic<bool> stop_load(false);
+        std::vector<std::thread> load_threads;
+
+        for (int i = 0; i < kStrobeTimingTestLoadThreads; i++) {
+            load_threads.emplace_back(RunSyntheticLoad, std::cref(stop_load));
+        }
+
+        TriggerTimingSamples shutter_samples;
+        TriggerTimingSamples external_trigger_samples;
+
+        // Run the strobe path on its own thread so that it can be given a real-time
+        // priority without affecting the rest of the process
+        std::thread strobe_thread(RunTriggerIterations, std::ref(*backend),
+                                  std::ref(shutter_samples), std::ref(external_trigger_samples));
+        strobe_thread.join();
+
+        stop_load = true;
+        for (std::thread& t : load_threads) {
+            t.join();
+        }
+
+        PulseStrobe::DeinitGPIOSystem();
+
+        if (backend->GetNumberDroppedEdges() > 0) {
+            GS_LOG_MSG(warning, "GsStrobeTimingTest - " + std::to_string(backend->GetNumberDroppedEdges()) + " edges were dropped.");
+        }
+
+        LogSamples("SendCameraStrobeTriggerAndShutter", shutter_samples);
+        LogSamples("SendExternalTrigger", external_trigger_samples);
+
+        return !shutter_samples.trigger_latency_us.empty() && !external_trigger_samples.trigger_latency_us.empty();
+    }
+
+}
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Measures the scheduling jitter of the camera2 shutter and strobe trigger path
+// (PulseStrobe::SendCameraStrobeTriggerAndShutter and SendExternalTrigger) by running
+// it against the simulated strobe backend while other threads load the CPU.
+//
+// Strobe timing error shows up directly as ball-speed error, because the
+// ball-speed calculations assume that the programmed strobe intervals are exact.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "pulse_strobe_backend.h"
+
+
+namespace golf_sim {
+
+    class GsStrobeTimingTest {
+
+    public:
+
+        // These are set from the "testing" section of the .json configuration file
+        static int kStrobeTimingTestIterations;
+        static int kStrobeTimingTestLoadThreads;
+        static int kStrobeTimingTestPauseBetweenTriggersMs;
+        static bool kStrobeTimingTestUseRealtimeThread;
+        static int kStrobeTimingTestRealtimeCpu;
+
+        // Runs the benchmark and logs a summary of the timing statistics.
+        // Returns false if the strobe system could not be set up or if no
+        // timing samples could be collected.
+        static bool RunStrobeJitterBenchmark();
+
+    protected:
+
+        // All times are in microseconds
+        struct TriggerTimingSamples {
+            // From the call into PulseStrobe to the shutter signal going high
+            std::vector<double> trigger_latency_us;
+            // From the shutter opening to the start of the strobe-pulse SPI transfer
+            std::vector<double> shutter_to_strobe_us;
+            // Difference between the measured and the nominal length of the strobe pulse train
+            std::vector<double> strobe_train_error_us;
+            // From the end of the strobe pulse train to the shutter closing
+            std::vector<double> shutter_close_lag_us;
+            // SendExternalTrigger only - error of the delay and width of the flush pulse
+            std::vector<double> flush_delay_error_us;
+            std::vector<double> flush_width_error_us;
+
+            // The length of the strobe train that was expected, for reporting relative error
+            double nominal_strobe_train_us = 0.0;
+        };
+
+        static void ReadConfiguration();
+
+        static void RunSyntheticLoad(const std::atomic<bool>& stop_load);
+
+        static void RunTriggerIterations(SimulatedStrobeBackend& backend,
+                                         TriggerTimingSamples& shutter_samples,
+                                         TriggerTimingSamples& external_trigger_samples);
+
+        // Pulls the timing measurements for one trigger out of the recorded edges.
+        // If expect_flush_pulse is true, the edges are expected to include the
+        // additional flush pulse that SendExternalTrigger may send.
+        static bool AddTriggerSamples(const std::vector<StrobeEdgeEvent>& edges,
+                                      const std::chrono::steady_clock::time_point& call_time,
+                                      const SimulatedStrobeBackend& backend,
+                                      const bool expect_flush_pulse,
+                                      const long expected_flush_delay_us,
+                                      TriggerTimingSamples& samples);
+
+        static std::string FormatStatistics(const std::string& label, std::vector<double> samples_us);
+
+        static void LogSamples(const std::string& title, const TriggerTimingSamples& samples);
+    };
+
+}
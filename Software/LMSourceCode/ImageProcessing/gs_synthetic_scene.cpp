@@ -0,0 +1,505 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_options.h"
+#include "golf_ball.h"
+#include "cv_utils.h"
+
+#include "gs_synthetic_scene.h"
+
+
+namespace golf_sim {
+
+    std::string GsSyntheticScene::kSyntheticTestSuiteDirectory;
+    std::vector<float> GsSyntheticScene::kSyntheticSpeedsMph;
+    std::vector<float> GsSyntheticScene::kSyntheticLaunchAnglesDeg;
+    std::vector<float> GsSyntheticScene::kSyntheticSideAnglesDeg;
+    std::vector<float> GsSyntheticScene::kSyntheticSpinRatesRpm;
+    std::vector<float> GsSyntheticScene::kSyntheticSpinAxesDeg;
+    double GsSyntheticScene::kSyntheticFirstExposureDelayMs = 0.3;
+    double GsSyntheticScene::kSyntheticBallBrightness = 200.0;
+    double GsSyntheticScene::kSyntheticStrobedBackgroundLevel = 10.0;
+    double GsSyntheticScene::kSyntheticTeedBackgroundLevel = 40.0;
+    double GsSyntheticScene::kSyntheticNoiseSigma = 3.0;
+    double GsSyntheticScene::kSyntheticGlareStrength = 0.25;
+    double GsSyntheticScene::kSyntheticDimpleContrast = 0.35;
+    int GsSyntheticScene::kSyntheticRandomSeed = 1;
+
+    // Roughly the number of dimples on a real ball
+    static const int kNumberOfDimples = 336;
+
+    // The dimple radius as a fraction of the average distance between dimple centers
+    static const double kDimpleRadiusFraction = 0.45;
+
+    // Where the reflection of the strobe is on the ball, as a fraction of the ball's radius
+    // from its center (x to the right, y down), and how wide it is
+    static const double kGlareOffsetX = -0.15;
+    static const double kGlareOffsetY = -0.20;
+    static const double kGlareSigma = 0.12;
+
+    // The part of the ball's brightness that does not depend on the angle of its surface to the strobe
+    static const double kAmbientFraction = 0.35;
+
+    // As in GsAutomatedTesting::TestFinalShotResultData
+    static const std::string kLogImagePrefix = "gs_log_img__";
+
+
+    // SetConstant appends to a vector, so start each sweep vector empty.  A vector that is
+    // missing from the configuration sweeps just default_value.
+    static void ReadSweepVector(const std::string& tag_name, const float default_value, std::vector<float>& sweep) {
+        sweep.clear();
+        GolfSimConfiguration::SetConstant(tag_name, sweep);
+
+        if (sweep.empty()) {
+            sweep.push_back(default_value);
+        }
+    }
+
+    void GsSyntheticScene::ReadConfiguration() {
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticTestSuiteDirectory", kSyntheticTestSuiteDirectory);
+        ReadSweepVector("gs_config.testing.kSyntheticSpeedsMph", 100.0f, kSyntheticSpeedsMph);
+        ReadSweepVector("gs_config.testing.kSyntheticLaunchAnglesDeg", 12.0f, kSyntheticLaunchAnglesDeg);
+        ReadSweepVector("gs_config.testing.kSyntheticSideAnglesDeg", 0.0f, kSyntheticSideAnglesDeg);
+        ReadSweepVector("gs_config.testing.kSyntheticSpinRatesRpm", 3000.0f, kSyntheticSpinRatesRpm);
+        ReadSweepVector("gs_config.testing.kSyntheticSpinAxesDeg", 0.0f, kSyntheticSpinAxesDeg);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticFirstExposureDelayMs", kSyntheticFirstExposureDelayMs);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticBallBrightness", kSyntheticBallBrightness);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticStrobedBackgroundLevel", kSyntheticStrobedBackgroundLevel);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticTeedBackgroundLevel", kSyntheticTeedBackgroundLevel);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticNoiseSigma", kSyntheticNoiseSigma);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticGlareStrength", kSyntheticGlareStrength);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticDimpleContrast", kSyntheticDimpleContrast);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kSyntheticRandomSeed", kSyntheticRandomSeed);
+    }
+
+    std::vector<GsSyntheticScene::SyntheticShot> GsSyntheticScene::GetParameterSweep() {
+
+        std::vector<float> pulse_intervals_ms;
+        GolfSimConfiguration::SetConstant("gs_config.strobing.kStrobePulseVectorDriver", pulse_intervals_ms);
+
+        std::vector<SyntheticShot> shots;
+        long shot_number = 1;
+
+        for (const float speed_mph : kSyntheticSpeedsMph) {
+            for (const float launch_angle : kSyntheticLaunchAnglesDeg) {
+                for (const float side_angle : kSyntheticSideAnglesDeg) {
+                    for (const float spin_rate : kSyntheticSpinRatesRpm) {
+                        for (const float spin_axis : kSyntheticSpinAxesDeg) {
+                            SyntheticShot shot;
+
+                            shot.expected_results.shot_number_ = shot_number;
+                            shot.expected_results.speed_mph_ = speed_mph;
+                            shot.expected_results.vla_deg_ = launch_angle;
+                            shot.expected_results.hla_deg_ = side_angle;
+
+                            const double spin_axis_radians = CvUtils::DegreesToRadians((double)spin_axis);
+                            shot.expected_results.back_spin_rpm_ = (int)std::round(spin_rate * std::cos(spin_axis_radians));
+                            shot.expected_results.side_spin_rpm_ = (int)std::round(spin_rate * std::sin(spin_axis_radians));
+                            shot.expected_results.club_type_ = GolfSimClubs::GsClubType::kDriver;
+
+                            shot.pulse_intervals_ms = pulse_intervals_ms;
+                            shot.first_exposure_delay_ms = kSyntheticFirstExposureDelayMs;
+                            shot.noise_sigma = kSyntheticNoiseSigma;
+                            shot.glare_strength = kSyntheticGlareStrength;
+                            // Different noise for each shot, but the same noise each time the suite is generated
+                            shot.random_seed = (unsigned int)(kSyntheticRandomSeed + shot_number);
+
+                            shots.push_back(shot);
+                            shot_number++;
+                        }
+                    }
+                }
+            }
+        }
+
+        return shots;
+    }
+
+    bool GsSyntheticScene::GetTeedBallPosition(const GolfSimCamera& camera_1, cv::Vec3d& position) {
+
+        // The analysis looks for the teed ball here (see GolfSimCamera::GetExpectedBallCenter)
+        double expected_x = camera_1.camera_hardware_.resolution_x_ / 2.0;
+        double expected_y = camera_1.camera_hardware_.resolution_y_ / 2.0;
+
+        if (GolfSimOptions::GetCommandLineOptions().search_center_x_ > 0) {
+            expected_x = GolfSimOptions::GetCommandLineOptions().search_center_x_;
+        }
+
+        if (GolfSimOptions::GetCommandLineOptions().search_center_y_ > 0) {
+            expected_y = GolfSimOptions::GetCommandLineOptions().search_center_y_;
+        }
+
+        const double distance = CvUtils::GetDistance(GolfSimCamera::kCamera1PositionsFromExpectedBallMeters);
+
+        return GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective(camera_1, expected_x, expected_y, distance, position);
+    }
+
+    bool GsSyntheticScene::ProjectBall(const GolfSimCamera& camera,
+                                       const cv::Vec3d& position,
+                                       cv::Point2d& center,
+                                       double& radius_pixels) {
+
+        double distance = 0.0;
+
+        if (!GolfSimCamera::ComputePixelFromOrthoCamPerspective(camera, position, center, distance) || distance <= 0.0) {
+            return false;
+        }
+
+        // The inverse of GolfSimCamera::ComputeDistanceToBallUsingRadius
+        const CameraHardware& hardware = camera.camera_hardware_;
+        radius_pixels = hardware.resolution_x_ * GolfBall::kBallRadiusMeters * hardware.focal_length_ / (hardware.sensor_width_ * distance);
+
+        return true;
+    }
+
+    const std::vector<cv::Vec3d>& GsSyntheticScene::GetDimpleCenters() {
+
+        static const std::vector<cv::Vec3d> dimple_centers = []() {
+            std::vector<cv::Vec3d> centers;
+            centers.reserve(kNumberOfDimples);
+
+            const double golden_angle = CV_PI * (3.0 - std::sqrt(5.0));
+
+            for (int i = 0; i < kNumberOfDimples; i++) {
+                const double z = 1.0 - (2.0 * i + 1.0) / kNumberOfDimples;
+                const double radius = std::sqrt(1.0 - z * z);
+                const double theta = golden_angle * i;
+
+                centers.emplace_back(radius * std::cos(theta), radius * std::sin(theta), z);
+            }
+
+            return centers;
+        }();
+
+        return dimple_centers;
+    }
+
+    double GsSyntheticScene::GetDimpleShading(const cv::Vec3d& ball_point) {
+
+        const std::vector<cv::Vec3d>& dimple_centers = GetDimpleCenters();
+
+        double closest_dot = -1.0;
+
+        for (const cv::Vec3d& center : dimple_centers) {
+            closest_dot = std::max(closest_dot, ball_point.dot(center));
+        }
+
+        // On a unit sphere, the squared chord length is 2 - 2cos(angle), which is close enough
+        // to the squared angle for dimple-sized angles
+        const double dimple_spacing = std::sqrt(4.0 * CV_PI / kNumberOfDimples);
+        const double dimple_radius = kDimpleRadiusFraction * dimple_spacing;
+        const double fraction_squared = (2.0 - 2.0 * closest_dot) / (dimple_radius * dimple_radius);
+
+        if (fraction_squared >= 1.0) {
+            return 1.0;
+        }
+
+        // Darkest at the rim, where the dimple wall faces away from the strobe
+        return 1.0 - kSyntheticDimpleContrast * fraction_squared;
+    }
+
+    void GsSyntheticScene::AddBallExposure(const GolfSimCamera& camera,
+                                           const cv::Point2d& center,
+                                           const double radius_pixels,
+                                           const cv::Matx33d& orientation,
+                                           const double glare_strength,
+                                           cv::Mat& image) {
+
+        const CameraHardware& hardware = camera.camera_hardware_;
+        const double focal_length_pixels = hardware.focal_length_ / hardware.sensor_width_ * hardware.resolution_x_;
+
+        // The camera sees the side of the ball that faces back along its line of sight, which
+        // is not straight at the ball unless the ball is in the center of the image
+        cv::Vec3d line_of_sight(center.x - hardware.resolution_x_ / 2.0, center.y - hardware.resolution_y_ / 2.0, -focal_length_pixels);
+        const cv::Vec3d toward_camera = -cv::normalize(line_of_sight);
+        const cv::Vec3d image_right = cv::normalize(cv::Vec3d(1, 0, 0) - toward_camera[0] * toward_camera);
+        const cv::Vec3d image_down = toward_camera.cross(image_right);
+
+        const cv::Matx33d ball_from_camera = orientation.t();
+
+        const int min_x = std::max(0, (int)std::floor(center.x - radius_pixels - 1));
+        const int max_x = std::min(image.cols - 1, (int)std::ceil(center.x + radius_pixels + 1));
+        const int min_y = std::max(0, (int)std::floor(center.y - radius_pixels - 1));
+        const int max_y = std::min(image.rows - 1, (int)std::ceil(center.y + radius_pixels + 1));
+
+        for (int y = min_y; y <= max_y; y++) {
+            float* row = image.ptr<float>(y);
+
+            for (int x = min_x; x <= max_x; x++) {
+                const double dx = (x - center.x) / radius_pixels;
+                const double dy = (y - center.y) / radius_pixels;
+                const double distance_pixels = std::sqrt(dx * dx + dy * dy) * radius_pixels;
+
+                // Anti-alias the edge of the ball
+                const double coverage = std::clamp(radius_pixels + 0.5 - distance_pixels, 0.0, 1.0);
+
+                if (coverage <= 0.0) {
+                    continue;
+                }
+
+                const double facing_camera = std::sqrt(std::max(0.0, 1.0 - dx * dx - dy * dy));
+                const cv::Vec3d surface_normal = dx * image_right + dy * image_down + facing_camera * toward_camera;
+                const double shading = GetDimpleShading(ball_from_camera * surface_normal);
+
+                // The strobe is next to the lens, so the ball is brightest where it faces the camera
+                double value = kSyntheticBallBrightness * (kAmbientFraction + (1.0 - kAmbientFraction) * facing_camera) * shading;
+
+                const double glare_dx = dx - kGlareOffsetX;
+                const double glare_dy = dy - kGlareOffsetY;
+                value += glare_strength * kSyntheticBallBrightness *
+                            std::exp(-(glare_dx * glare_dx + glare_dy * glare_dy) / (2.0 * kGlareSigma * kGlareSigma));
+
+                row[x] += (float)(coverage * value);
+            }
+        }
+    }
+
+    void GsSyntheticScene::AddNoise(const double noise_sigma, const unsigned int random_seed, cv::Mat& image) {
+        if (noise_sigma <= 0.0) {
+            return;
+        }
+
+        cv::Mat noise(image.size(), CV_32FC1);
+        cv::RNG rng(random_seed);
+        rng.fill(noise, cv::RNG::NORMAL, 0.0, noise_sigma);
+
+        image += noise;
+    }
+
+    bool GsSyntheticScene::RenderTeedBallImage(const SyntheticShot& shot,
+                                               const GolfSimCamera& camera_1,
+                                               cv::Mat& image,
+                                               RenderedShot& rendered_shot) {
+
+        cv::Vec3d teed_ball_position;
+
+        if (!GetTeedBallPosition(camera_1, teed_ball_position)) {
+            GS_LOG_MSG(error, "RenderTeedBallImage - could not determine the teed ball's position.");
+            return false;
+        }
+
+        cv::Point2d center;
+
+        if (!ProjectBall(camera_1, teed_ball_position, center, rendered_shot.teed_ball_radius_pixels)) {
+            GS_LOG_MSG(error, "RenderTeedBallImage - the teed ball is not in front of camera 1.");
+            return false;
+        }
+
+        const CameraHardware& hardware = camera_1.camera_hardware_;
+        cv::Mat float_image(hardware.resolution_y_, hardware.resolution_x_, CV_32FC1, cv::Scalar(kSyntheticTeedBackgroundLevel));
+
+        // The ball has not started to spin yet
+        AddBallExposure(camera_1, center, rendered_shot.teed_ball_radius_pixels, cv::Matx33d::eye(), shot.glare_strength, float_image);
+
+        // Use a different noise pattern than the strobed image
+        AddNoise(shot.noise_sigma, shot.random_seed * 2, float_image);
+
+        cv::Mat gray_image;
+        float_image.convertTo(gray_image, CV_8UC1);
+        cv::cvtColor(gray_image, image, cv::COLOR_GRAY2BGR);
+
+        return true;
+    }
+
+    bool GsSyntheticScene::RenderStrobedImage(const SyntheticShot& shot,
+                                              const GolfSimCamera& camera_1,
+                                              const GolfSimCamera& camera_2,
+                                              cv::Mat& image,
+                                              RenderedShot& rendered_shot) {
+
+        cv::Vec3d teed_ball_position;
+
+        if (!GetTeedBallPosition(camera_1, teed_ball_position)) {
+            GS_LOG_MSG(error, "RenderStrobedImage - could not determine the teed ball's position.");
+            return false;
+        }
+
+        // The direction of flight in ball-perspective axes, where the angles are as computed by
+        // GolfSimCamera::getXYDeltaAnglesBallPerspective.  See ComputeXyzDeltaDistances for how
+        // these axes relate to the camera's.
+        const cv::Vec3d flight_ball_perspective = cv::normalize(cv::Vec3d(std::tan(CvUtils::DegreesToRadians((double)shot.expected_results.hla_deg_)),
+                                                                          std::tan(CvUtils::DegreesToRadians((double)shot.expected_results.vla_deg_)),
+                                                                          1.0));
+        const cv::Vec3d flight_camera_perspective(flight_ball_perspective[2], flight_ball_perspective[1], -flight_ball_perspective[0]);
+
+        const double speed_meters_per_second = CvUtils::MPHToMetersPerSecond((double)shot.expected_results.speed_mph_);
+
+        // The rotation vector per second, in the same axes as BallImageProc::Project2dImageTo3dBall.
+        // An x-axis rotation there turns the ball around the image's y axis, and a z-axis (back spin)
+        // rotation turns it clockwise around the image's z axis.  GetBallRotation negates the
+        // x-axis rotation to get the side spin, so it is negated here, too.
+        const double kRpmToRadiansPerSecond = 2.0 * CV_PI / 60.0;
+        const cv::Vec3d spin_radians_per_second(0.0,
+                                                -shot.expected_results.side_spin_rpm_ * kRpmToRadiansPerSecond,
+                                                -shot.expected_results.back_spin_rpm_ * kRpmToRadiansPerSecond);
+
+        const CameraHardware& hardware = camera_2.camera_hardware_;
+        cv::Mat float_image(hardware.resolution_y_, hardware.resolution_x_, CV_32FC1, cv::Scalar(kSyntheticStrobedBackgroundLevel));
+
+        rendered_shot.exposures_in_view = 0;
+        double exposure_time_ms = shot.first_exposure_delay_ms;
+
+        for (size_t pulse = 0; pulse <= shot.pulse_intervals_ms.size(); pulse++) {
+
+            if (pulse > 0) {
+                exposure_time_ms += shot.pulse_intervals_ms[pulse - 1];
+            }
+
+            const double exposure_time_seconds = exposure_time_ms / 1000.0;
+
+            // Camera 2's ortho-perspective distances are camera 1's less the offset between the cameras
+            const cv::Vec3d position_camera_1 = teed_ball_position + speed_meters_per_second * exposure_time_seconds * flight_camera_perspective;
+            const cv::Vec3d position_camera_2 = position_camera_1 - GolfSimCamera::kCamera2OffsetFromCamera1OriginMeters;
+
+            cv::Point2d center;
+            double radius_pixels = 0.0;
+
+            if (!ProjectBall(camera_2, position_camera_2, center, radius_pixels)) {
+                continue;
+            }
+
+            if (center.x + radius_pixels < 0 || center.x - radius_pixels >= hardware.resolution_x_ ||
+                center.y + radius_pixels < 0 || center.y - radius_pixels >= hardware.resolution_y_) {
+                continue;
+            }
+
+            if (rendered_shot.exposures_in_view == 0) {
+                rendered_shot.first_exposure_radius_pixels = radius_pixels;
+            }
+
+            rendered_shot.exposures_in_view++;
+
+            cv::Matx33d orientation;
+            cv::Rodrigues(exposure_time_seconds * spin_radians_per_second, orientation);
+
+            // Overlapping exposures add their light on the sensor
+            AddBallExposure(camera_2, center, radius_pixels, orientation, shot.glare_strength, float_image);
+        }
+
+        AddNoise(shot.noise_sigma, shot.random_seed, float_image);
+
+        cv::Mat gray_image;
+        float_image.convertTo(gray_image, CV_8UC1);
+        cv::cvtColor(gray_image, image, cv::COLOR_GRAY2BGR);
+
+        return true;
+    }
+
+    bool GsSyntheticScene::GenerateTestSuite() {
+
+        ReadConfiguration();
+
+        if (kSyntheticTestSuiteDirectory.empty()) {
+            GS_LOG_MSG(error, "GenerateTestSuite - kSyntheticTestSuiteDirectory must be set.");
+            return false;
+        }
+
+        if (GolfSimOptions::GetCommandLineOptions().golfer_orientation_ == GolferOrientation::kLeftHanded) {
+            GS_LOG_MSG(error, "GenerateTestSuite - only right-handed shots can be generated.");
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(kSyntheticTestSuiteDirectory, ec);
+
+        if (ec) {
+            GS_LOG_MSG(error, "GenerateTestSuite - could not create " + kSyntheticTestSuiteDirectory + ": " + ec.message());
+            return false;
+        }
+
+        std::string kWebServerLastTeedBallImageFilenamePrefix;
+        std::string kWebServerCamera2ImageFilenamePrefix;
+        std::string kAutomatedTestExpectedResultsCSV;
+
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerLastTeedBallImage", kWebServerLastTeedBallImageFilenamePrefix);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kWebServerCamera2Image", kWebServerCamera2ImageFilenamePrefix);
+        GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestExpectedResultsCSV", kAutomatedTestExpectedResultsCSV);
+
+        const std::filesystem::path suite_directory(kSyntheticTestSuiteDirectory);
+
+        std::ofstream expected_results_csv_file(suite_directory / kAutomatedTestExpectedResultsCSV);
+
+        if (!expected_results_csv_file.is_open()) {
+            GS_LOG_MSG(error, "GenerateTestSuite - could not open " + kAutomatedTestExpectedResultsCSV + ".");
+            return false;
+        }
+
+        // The first seven columns are what GsAutomatedTesting::ReadExpectedResults reads
+        expected_results_csv_file << "Shot,Speed (mph),VLA (deg),HLA (deg),Back Spin (rpm),Side Spin (rpm),Ignore,"
+                                  << "Teed Ball Radius (px),Exposures In View,First Exposure Radius (px),First Exposure Delay (ms),Noise Sigma,Glare Strength" << std::endl;
+
+        GolfSimCamera camera_1;
+        camera_1.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera1, GolfSimCamera::kSystemSlot1CameraType);
+        GolfSimCamera camera_2;
+        camera_2.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2, GolfSimCamera::kSystemSlot2CameraType);
+
+        const std::vector<SyntheticShot> shots = GetParameterSweep();
+        int number_ignored = 0;
+
+        for (const SyntheticShot& shot : shots) {
+            RenderedShot rendered_shot;
+            cv::Mat teed_ball_image;
+            cv::Mat strobed_image;
+
+            if (!RenderTeedBallImage(shot, camera_1, teed_ball_image, rendered_shot) ||
+                !RenderStrobedImage(shot, camera_1, camera_2, strobed_image, rendered_shot)) {
+                GS_LOG_MSG(error, "GenerateTestSuite - could not render shot " + std::to_string(shot.expected_results.shot_number_) + ".");
+                return false;
+            }
+
+            const std::string shot_suffix = "_Shot_" + std::to_string(shot.expected_results.shot_number_) + "_synthetic.png";
+            const std::filesystem::path teed_ball_filename = suite_directory / (kLogImagePrefix + kWebServerLastTeedBallImageFilenamePrefix + shot_suffix);
+            const std::filesystem::path strobed_filename = suite_directory / (kLogImagePrefix + kWebServerCamera2ImageFilenamePrefix + shot_suffix);
+
+            if (!cv::imwrite(teed_ball_filename.string(), teed_ball_image) || !cv::imwrite(strobed_filename.string(), strobed_image)) {
+                GS_LOG_MSG(error, "GenerateTestSuite - could not write the images for shot " + std::to_string(shot.expected_results.shot_number_) + ".");
+                return false;
+            }
+
+            // The analysis needs at least two strobed balls to measure anything
+            const bool ignore_shot = (rendered_shot.exposures_in_view < 2);
+
+            if (ignore_shot) {
+                number_ignored++;
+            }
+
+            const GsResults& expected = shot.expected_results;
+
+            expected_results_csv_file << expected.shot_number_ << ","
+                                      << expected.speed_mph_ << ","
+                                      << expected.vla_deg_ << ","
+                                      << expected.hla_deg_ << ","
+                                      << expected.back_spin_rpm_ << ","
+                                      << expected.side_spin_rpm_ << ","
+                                      << (ignore_shot ? "1" : "0") << ","
+                                      << rendered_shot.teed_ball_radius_pixels << ","
+                                      << rendered_shot.exposures_in_view << ","
+                                      << rendered_shot.first_exposure_radius_pixels << ","
+                                      << shot.first_exposure_delay_ms << ","
+                                      << shot.noise_sigma << ","
+                                      << shot.glare_strength << std::endl;
+
+            GS_LOG_TRACE_MSG(trace, "GenerateTestSuite - rendered shot " + std::to_string(expected.shot_number_) + " with " +
+                                    std::to_string(rendered_shot.exposures_in_view) + " strobed exposures in view: " + expected.Format());
+        }
+
+        GS_LOG_MSG(info, "Generated " + std::to_string(shots.size()) + " synthetic shots in " + kSyntheticTestSuiteDirectory +
+                         " (" + std::to_string(number_ignored) + " with fewer than two strobed exposures in view, which are marked to be ignored).");
+
+        return true;
+    }
+
+}
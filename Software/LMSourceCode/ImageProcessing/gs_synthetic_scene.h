@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Renders synthetic teed-ball and strobed-ball images from a known ground truth (ball speed,
+// launch angles, spin, strobe intervals, noise and glare), and writes them, along with the
+// expected results, as a test suite that GsAutomatedTesting::TestFinalShotResultData can run.
+//
+// A test suite is the cartesian product of the kSynthetic... vectors in the "testing" section
+// of the .json configuration file.  To run the suite, point kAutomatedTestSuiteDirectory at
+// kSyntheticTestSuiteDirectory and run in automated_testing mode.
+//
+// The scene uses the cameras exactly as the analysis does:
+//      - The teed ball is placed at camera 1's expected ball position, at the distance
+//        of kCamera1PositionsFromExpectedBallMeters.
+//      - The ball flies in a straight line at the given speed and launch angles, using the same
+//        ball-perspective axes as GolfSimCamera::ComputeXyzDeltaDistances.  Gravity and drag
+//        are ignored over the few milliseconds of the exposures.
+//      - Camera 2 is kCamera2OffsetFromCamera1OriginMeters away from camera 1.
+//      - Balls are placed in the images with ComputePixelFromOrthoCamPerspective, and sized
+//        using the inverse of ComputeDistanceToBallUsingRadius.
+//
+// The spin is in camera 2's frame, with the same axes and signs as the results of
+// BallImageProc::GetBallRotation (x is side spin and z is back spin).  The dimples are a
+// procedural pattern over the whole sphere, so that large rotations between exposures
+// never show a hole where the other side of the ball would be.
+//
+// Only right-handed shots are rendered.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "gs_camera.h"
+#include "gs_results.h"
+
+
+namespace golf_sim {
+
+    class GsSyntheticScene {
+
+    public:
+
+        // These are set from the "testing" section of the .json configuration file
+        static std::string kSyntheticTestSuiteDirectory;
+        static std::vector<float> kSyntheticSpeedsMph;
+        static std::vector<float> kSyntheticLaunchAnglesDeg;
+        static std::vector<float> kSyntheticSideAnglesDeg;
+        static std::vector<float> kSyntheticSpinRatesRpm;
+        // 0 is pure back spin.  Positive angles tilt the spin toward positive side spin.
+        static std::vector<float> kSyntheticSpinAxesDeg;
+        // From the ball being struck to the first strobe pulse
+        static double kSyntheticFirstExposureDelayMs;
+        static double kSyntheticBallBrightness;
+        static double kSyntheticStrobedBackgroundLevel;
+        static double kSyntheticTeedBackgroundLevel;
+        // Standard deviation of the gaussian noise added to each pixel
+        static double kSyntheticNoiseSigma;
+        // Brightness of the strobe reflection, as a fraction of kSyntheticBallBrightness
+        static double kSyntheticGlareStrength;
+        // How much darker the rim of a dimple is than the land between the dimples (0-1)
+        static double kSyntheticDimpleContrast;
+        static int kSyntheticRandomSeed;
+
+        struct SyntheticShot {
+            // The speed, angles and spins are the ground truth
+            GsResults expected_results;
+            // Between the strobe pulses, in milliseconds
+            std::vector<float> pulse_intervals_ms;
+            double first_exposure_delay_ms = 0.0;
+            double noise_sigma = 0.0;
+            double glare_strength = 0.0;
+            unsigned int random_seed = 0;
+        };
+
+        // What was actually rendered, which is useful for understanding a failed test
+        struct RenderedShot {
+            double teed_ball_radius_pixels = 0.0;
+            // Of the strobed exposures that are at least partly within camera 2's image
+            int exposures_in_view = 0;
+            double first_exposure_radius_pixels = 0.0;
+        };
+
+        // Reads the configuration, renders each shot of the sweep into kSyntheticTestSuiteDirectory,
+        // and writes kAutomatedTestExpectedResultsCSV there.  A shot with fewer than two strobed
+        // exposures in view is written, but marked to be ignored.
+        static bool GenerateTestSuite();
+
+        // Every combination of the kSynthetic... vectors, using the driver strobe intervals
+        static std::vector<SyntheticShot> GetParameterSweep();
+
+        // The images are 3-channel (gray) images at the camera's resolution
+        static bool RenderTeedBallImage(const SyntheticShot& shot,
+                                        const GolfSimCamera& camera_1,
+                                        cv::Mat& image,
+                                        RenderedShot& rendered_shot);
+
+        static bool RenderStrobedImage(const SyntheticShot& shot,
+                                       const GolfSimCamera& camera_1,
+                                       const GolfSimCamera& camera_2,
+                                       cv::Mat& image,
+                                       RenderedShot& rendered_shot);
+
+    protected:
+
+        static void ReadConfiguration();
+
+        // The teed ball's position, in camera 1's ortho-perspective distances (see
+        // GolfSimCamera::ComputeXyzDistanceFromOrthoCamPerspective)
+        static bool GetTeedBallPosition(const GolfSimCamera& camera_1, cv::Vec3d& position);
+
+        // Returns false if the ball's center is not in front of the camera
+        static bool ProjectBall(const GolfSimCamera& camera,
+                                const cv::Vec3d& position,
+                                cv::Point2d& center,
+                                double& radius_pixels);
+
+        // Adds the light from a single exposure of the ball to the (CV_32FC1) image.
+        // The orientation takes a point on the ball to where it is in camera 2's frame,
+        // with x to the right, y down, and z toward the camera.
+        static void AddBallExposure(const GolfSimCamera& camera,
+                                    const cv::Point2d& center,
+                                    const double radius_pixels,
+                                    const cv::Matx33d& orientation,
+                                    const double glare_strength,
+                                    cv::Mat& image);
+
+        // 1.0 on the land between the dimples, and darker toward the rim of a dimple
+        static double GetDimpleShading(const cv::Vec3d& ball_point);
+
+        // Evenly-spaced unit vectors (a Fibonacci sphere)
+        static const std::vector<cv::Vec3d>& GetDimpleCenters();
+
+        static void AddNoise(const double noise_sigma, const unsigned int random_seed, cv::Mat& image);
+    };
+
+}
@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <exception>
+
+#include "logging_tools.h"
+#include "gs_thread_pool.h"
+
+
+namespace golf_sim {
+
+    GsThreadPool::GsThreadPool(const unsigned int number_threads) {
+
+        unsigned int threads_to_create = number_threads;
+
+        if (threads_to_create == 0) {
+            threads_to_create = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (unsigned int i = 0; i < threads_to_create; i++) {
+            queues_.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        for (unsigned int i = 0; i < threads_to_create; i++) {
+            workers_.emplace_back(&GsThreadPool::WorkerLoop, this, i);
+        }
+
+        GS_LOG_TRACE_MSG(trace, "GsThreadPool created with " + std::to_string(threads_to_create) + " threads.");
+    }
+
+    GsThreadPool::~GsThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_condition_.notify_all();
+
+        for (std::thread& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    GsThreadPool& GsThreadPool::GetSharedPool() {
+        static GsThreadPool shared_pool;
+        return shared_pool;
+    }
+
+    void GsThreadPool::Submit(std::function<void()> task) {
+
+        const unsigned int queue_index = next_queue_.fetch_add(1, std::memory_order_relaxed) % (unsigned int)queues_.size();
+
+        {
+            std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex);
+            queues_[queue_index]->tasks.push_back(std::move(task));
+        }
+
+        // Count the task under the wake mutex so that a worker that is about to wait cannot miss it
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            number_queued_tasks_++;
+        }
+        wake_condition_.notify_one();
+    }
+
+    bool GsThreadPool::TryRunTask(const unsigned int worker_index) {
+
+        std::function<void()> task;
+        const unsigned int number_queues = (unsigned int)queues_.size();
+
+        // Newest task from our own queue first (it is the most likely to be cache-warm), then
+        // the oldest task from each of the other queues
+        for (unsigned int i = 0; i < number_queues && !task; i++) {
+            WorkerQueue& queue = *queues_[(worker_index + i) % number_queues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty()) {
+                continue;
+            }
+
+            if (i == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+
+        if (!task) {
+            return false;
+        }
+
+        number_queued_tasks_--;
+        task();
+        return true;
+    }
+
+    void GsThreadPool::WorkerLoop(const unsigned int worker_index) {
+
+        while (true) {
+            if (TryRunTask(worker_index)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_condition_.wait(lock, [this] { return stopping_ || number_queued_tasks_ > 0; });
+
+            if (stopping_ && number_queued_tasks_ == 0) {
+                return;
+            }
+        }
+    }
+
+    void GsThreadPool::ParallelFor(const size_t number_items,
+                                   const size_t chunk_size,
+                                   const std::function<void(size_t, size_t)>& body,
+                                   const unsigned int max_parallelism) {
+
+        if (number_items == 0) {
+            return;
+        }
+
+        const size_t items_per_chunk = std::max((size_t)1, chunk_size);
+        const size_t number_chunks = (number_items + items_per_chunk - 1) / items_per_chunk;
+
+        // Everything a runner needs outlives this call, because a runner may not get
+        // scheduled until after all of the chunks have already been done by others
+        struct CallState {
+            std::atomic<size_t> next_chunk{ 0 };
+            std::atomic<size_t> finished_chunks{ 0 };
+            std::mutex mutex;
+            std::condition_variable all_finished;
+            std::exception_ptr first_exception;
+        };
+
+        std::shared_ptr<CallState> state = std::make_shared<CallState>();
+
+        // body is only touched after a chunk has been claimed, and no chunk can be claimed
+        // once this call has returned, so it is safe to refer to it here
+        auto run_chunks = [state, number_items, items_per_chunk, number_chunks, &body]() {
+            while (true) {
+                const size_t chunk = state->next_chunk.fetch_add(1);
+                if (chunk >= number_chunks) {
+                    return;
+                }
+
+                const size_t begin = chunk * items_per_chunk;
+                const size_t end = std::min(number_items, begin + items_per_chunk);
+
+                try {
+                    body(begin, end);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->first_exception) {
+                        state->first_exception = std::current_exception();
+                    }
+                }
+
+                if (state->finished_chunks.fetch_add(1) + 1 == number_chunks) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->all_finished.notify_all();
+                }
+            }
+        };
+
+        size_t number_helpers = std::min((size_t)GetNumberThreads(), number_chunks - 1);
+        if (max_parallelism > 0) {
+            number_helpers = std::min(number_helpers, (size_t)max_parallelism - 1);
+        }
+
+        for (size_t i = 0; i < number_helpers; i++) {
+            Submit(run_chunks);
+        }
+
+        run_chunks();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->all_finished.wait(lock, [&] { return state->finished_chunks == number_chunks; });
+
+        if (state->first_exception) {
+            std::rethrow_exception(state->first_exception);
+        }
+    }
+
+}
@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A small work-stealing thread pool for the data-parallel parts of the image
+// processing, such as scoring spin-rotation candidates.
+//
+// Each worker has its own task queue.  A worker takes tasks from the back of its own
+// queue and, when that is empty, steals from the front of the other workers' queues.
+// ParallelFor does not create one task per item.  Instead, a few "runner" tasks (plus
+// the calling thread itself) repeatedly claim the next chunk of items until none are
+// left, so the load balances itself even when some items take longer than others.
+//
+// ParallelFor may be called from several threads at once, and from inside another
+// ParallelFor, because all the state for a call lives with that call.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace golf_sim {
+
+    class GsThreadPool {
+
+    public:
+
+        // A number_threads of 0 means one thread per hardware core
+        explicit GsThreadPool(const unsigned int number_threads = 0);
+        ~GsThreadPool();
+
+        GsThreadPool(const GsThreadPool&) = delete;
+        GsThreadPool& operator=(const GsThreadPool&) = delete;
+
+        // The pool that is shared by the image-processing code.  Created on first use.
+        static GsThreadPool& GetSharedPool();
+
+        unsigned int GetNumberThreads() const { return (unsigned int)workers_.size(); }
+
+        // Calls body(begin, end) for consecutive ranges of at most chunk_size items that together
+        // cover [0, number_items), and returns once all of them have finished.  The calling thread
+        // does some of the work as well.  At most max_parallelism threads (including the caller)
+        // work on this call; 0 means as many as the pool has, plus the caller.
+        // If body throws, the first exception is re-thrown to the caller after the other
+        // chunks have finished.
+        void ParallelFor(const size_t number_items,
+                         const size_t chunk_size,
+                         const std::function<void(size_t, size_t)>& body,
+                         const unsigned int max_parallelism = 0);
+
+    protected:
+
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void Submit(std::function<void()> task);
+        bool TryRunTask(const unsigned int worker_index);
+        void WorkerLoop(const unsigned int worker_index);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues_;
+        std::vector<std::thread> workers_;
+
+        std::mutex wake_mutex_;
+        std::condition_variable wake_condition_;
+        std::atomic<size_t> number_queued_tasks_{ 0 };
+        std::atomic<unsigned int> next_queue_{ 0 };
+        bool stopping_ = false;
+    };
+
+}
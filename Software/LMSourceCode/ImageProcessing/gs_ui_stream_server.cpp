@@ -0,0 +1,610 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "gs_results.h"
+#include "gs_metrics.h"
+
+#include "gs_ui_stream_server.h"
+
+
+namespace golf_sim {
+
+    namespace asio = boost::asio;
+    namespace beast = boost::beast;
+    namespace http = boost::beast::http;
+    namespace websocket = boost::beast::websocket;
+    using tcp = boost::asio::ip::tcp;
+
+    int GsUIStreamServer::kEmbeddedServerPort = 0;
+    std::string GsUIStreamServer::kEmbeddedServerBindAddress = "127.0.0.1";
+    double GsUIStreamServer::kEmbeddedServerPreviewMaxFps = 2.0;
+    int GsUIStreamServer::kEmbeddedServerPreviewMaxWidth = 640;
+    int GsUIStreamServer::kEmbeddedServerJpegQuality = 80;
+
+    const std::string GsUIStreamServer::kPreviewImageName = "watching_preview";
+
+    // A client that has this many messages waiting to be sent is not sent any more until it catches up
+    static constexpr size_t kMaxQueuedWebSocketMessages = 32;
+
+    static const char* kMonitorPage = R"HTML(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>PiTrac Launch Monitor</title>
+<style>
+  body { font-family: sans-serif; background: #202020; color: #e0e0e0; margin: 1em; }
+  #status { font-size: 1.4em; margin-bottom: 0.5em; }
+  table { border-collapse: collapse; margin-bottom: 1em; }
+  td { padding: 0.2em 1em 0.2em 0; }
+  .images img { max-width: 48%; margin: 0 1% 1% 0; border: 1px solid #404040; }
+</style>
+</head>
+<body>
+<div id="status">Connecting...</div>
+<table id="result"></table>
+<div class="images" id="images"></div>
+<script>
+  const images = {};
+  const fields = [["speed_mpers", "Speed (m/s)"], ["launch_angle_deg", "Launch angle (deg)"],
+                  ["side_angle_deg", "Side angle (deg)"], ["back_spin_rpm", "Back spin (rpm)"],
+                  ["side_spin_rpm", "Side spin (rpm)"]];
+
+  function showImage(name, sequence) {
+    if (!(name in images)) {
+      images[name] = document.createElement("img");
+      images[name].title = name;
+      document.getElementById("images").appendChild(images[name]);
+    }
+    images[name].src = "/images/" + encodeURIComponent(name) + ".jpg?" + sequence;
+  }
+
+  function showResult(result) {
+    document.getElementById("status").textContent = result.message;
+    if (result.result_type_name === "Hit" && "speed_mpers" in result) {
+      document.getElementById("result").innerHTML = fields.map(
+        f => "<tr><td>" + f[1] + "</td><td>" + result[f[0]] + "</td></tr>").join("");
+    }
+  }
+
+  function connect() {
+    const socket = new WebSocket("ws://" + location.host + "/ws");
+    socket.onmessage = event => {
+      const message = JSON.parse(event.data);
+      if (message.type === "result") showResult(message);
+      else if (message.type === "image") showImage(message.name, message.sequence);
+    };
+    socket.onclose = () => {
+      document.getElementById("status").textContent = "Disconnected - retrying...";
+      setTimeout(connect, 2000);
+    };
+  }
+
+  connect();
+</script>
+</body>
+</html>
+)HTML";
+
+
+    class GsUIWebSocketSession;
+
+    // Other than the mutex, thread and io_context, all of this is only used on the server's thread
+    struct GsUIStreamServerState {
+        asio::io_context io_context;
+        asio::executor_work_guard<asio::io_context::executor_type> work_guard{ asio::make_work_guard(io_context) };
+        tcp::acceptor acceptor{ io_context };
+        std::thread thread;
+
+        std::vector<std::weak_ptr<GsUIWebSocketSession>> websocket_sessions;
+
+        // The latest JPEG of each image, by name
+        std::map<std::string, std::shared_ptr<const std::string>> images;
+        uint64_t image_sequence = 0;
+
+        std::shared_ptr<const std::string> latest_status;
+    };
+
+    static std::mutex server_mutex;
+    static std::unique_ptr<GsUIStreamServerState> server;
+    static std::atomic<bool> server_running{ false };
+
+    static std::atomic<bool> preview_pending{ false };
+    static std::chrono::steady_clock::time_point last_preview_time;
+
+
+    // Sends every new result and image notice to one WebSocket client
+    class GsUIWebSocketSession : public std::enable_shared_from_this<GsUIWebSocketSession> {
+
+    public:
+
+        explicit GsUIWebSocketSession(tcp::socket&& socket) : ws_(std::move(socket)) {
+        }
+
+        void Run(http::request<http::string_body> request) {
+            ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::server));
+            ws_.async_accept(request, beast::bind_front_handler(&GsUIWebSocketSession::OnAccept, shared_from_this()));
+        }
+
+        void Send(const std::shared_ptr<const std::string>& message) {
+            if (!accepted_) {
+                return;
+            }
+
+            if (queue_.size() >= kMaxQueuedWebSocketMessages) {
+                GS_LOG_TRACE_MSG(trace, "GsUIStreamServer - WebSocket client is not keeping up.  Dropping a message.");
+                return;
+            }
+
+            queue_.push_back(message);
+
+            // Otherwise, a write is already in progress, and will send this when it is done
+            if (queue_.size() == 1) {
+                DoWrite();
+            }
+        }
+
+    protected:
+
+        void OnAccept(beast::error_code ec) {
+            if (ec) {
+                GS_LOG_TRACE_MSG(trace, "GsUIStreamServer - WebSocket accept failed: " + ec.message());
+                return;
+            }
+
+            accepted_ = true;
+            server->websocket_sessions.push_back(weak_from_this());
+
+            if (server->latest_status != nullptr) {
+                Send(server->latest_status);
+            }
+
+            DoRead();
+        }
+
+        // The clients do not send anything that we use, but reading is how a close is noticed
+        void DoRead() {
+            ws_.async_read(buffer_, beast::bind_front_handler(&GsUIWebSocketSession::OnRead, shared_from_this()));
+        }
+
+        void OnRead(beast::error_code ec, std::size_t) {
+            if (ec) {
+                return;
+            }
+
+            buffer_.consume(buffer_.size());
+            DoRead();
+        }
+
+        void DoWrite() {
+            ws_.text(true);
+            ws_.async_write(asio::buffer(*queue_.front()), beast::bind_front_handler(&GsUIWebSocketSession::OnWrite, shared_from_this()));
+        }
+
+        void OnWrite(beast::error_code ec, std::size_t) {
+            if (ec) {
+                queue_.clear();
+                return;
+            }
+
+            queue_.pop_front();
+
+            if (!queue_.empty()) {
+                DoWrite();
+            }
+        }
+
+        websocket::stream<beast::tcp_stream> ws_;
+        beast::flat_buffer buffer_;
+        std::deque<std::shared_ptr<const std::string>> queue_;
+        bool accepted_ = false;
+    };
+
+
+    // Answers plain HTTP requests, and hands WebSocket upgrades off to a GsUIWebSocketSession
+    class GsUIHttpSession : public std::enable_shared_from_this<GsUIHttpSession> {
+
+    public:
+
+        explicit GsUIHttpSession(tcp::socket&& socket) : stream_(std::move(socket)) {
+        }
+
+        void Run() {
+            DoRead();
+        }
+
+    protected:
+
+        void DoRead() {
+            request_ = {};
+            stream_.expires_after(std::chrono::seconds(30));
+            http::async_read(stream_, buffer_, request_, beast::bind_front_handler(&GsUIHttpSession::OnRead, shared_from_this()));
+        }
+
+        void OnRead(beast::error_code ec, std::size_t) {
+            if (ec == http::error::end_of_stream) {
+                Close();
+                return;
+            }
+
+            if (ec) {
+                return;
+            }
+
+            if (websocket::is_upgrade(request_) && GetPath() == "/ws") {
+                stream_.expires_never();
+                std::make_shared<GsUIWebSocketSession>(stream_.release_socket())->Run(std::move(request_));
+                return;
+            }
+
+            SendResponse(HandleRequest());
+        }
+
+        std::string GetPath() const {
+            std::string path(request_.target());
+            const size_t query_start = path.find('?');
+
+            if (query_start != std::string::npos) {
+                path.resize(query_start);
+            }
+
+            return path;
+        }
+
+        http::response<http::string_body> MakeResponse(const http::status status,
+                                                       const std::string& content_type,
+                                                       std::string body) const {
+            http::response<http::string_body> response{ status, request_.version() };
+            response.set(http::field::server, "PiTrac LM");
+            response.set(http::field::content_type, content_type);
+            response.set(http::field::cache_control, "no-store");
+            response.keep_alive(request_.keep_alive());
+            response.body() = std::move(body);
+            response.prepare_payload();
+            return response;
+        }
+
+        http::response<http::string_body> HandleRequest() const {
+
+            if (request_.method() != http::verb::get) {
+                return MakeResponse(http::status::bad_request, "text/plain", "Only GET is supported.");
+            }
+
+            const std::string path = GetPath();
+
+            if (path == "/" || path == "/index.html") {
+                return MakeResponse(http::status::ok, "text/html", kMonitorPage);
+            }
+
+            if (path == "/status") {
+                return MakeResponse(http::status::ok, "application/json", (server->latest_status != nullptr) ? *server->latest_status : "{}");
+            }
+
+            if (path == "/metrics") {
+                return MakeResponse(http::status::ok, "text/plain; version=0.0.4", GsMetrics::FormatPrometheusText());
+            }
+
+            const std::string image_prefix = "/images/";
+            const std::string image_suffix = ".jpg";
+
+            if (path.size() > image_prefix.size() + image_suffix.size() &&
+                path.compare(0, image_prefix.size(), image_prefix) == 0 &&
+                path.compare(path.size() - image_suffix.size(), image_suffix.size(), image_suffix) == 0) {
+
+                const std::string name = path.substr(image_prefix.size(), path.size() - image_prefix.size() - image_suffix.size());
+                auto image = server->images.find(name);
+
+                if (image != server->images.end()) {
+                    return MakeResponse(http::status::ok, "image/jpeg", *image->second);
+                }
+            }
+
+            return MakeResponse(http::status::not_found, "text/plain", "Not found: " + path);
+        }
+
+        void SendResponse(http::response<http::string_body>&& response) {
+            auto shared_response = std::make_shared<http::response<http::string_body>>(std::move(response));
+
+            http::async_write(stream_, *shared_response,
+                [self = shared_from_this(), shared_response](beast::error_code ec, std::size_t) {
+                    self->OnWrite(shared_response->need_eof(), ec);
+                });
+        }
+
+        void OnWrite(const bool close, beast::error_code ec) {
+            if (ec) {
+                return;
+            }
+
+            if (close) {
+                Close();
+                return;
+            }
+
+            DoRead();
+        }
+
+        void Close() {
+            beast::error_code ec;
+            stream_.socket().shutdown(tcp::socket::shutdown_send, ec);
+        }
+
+        beast::tcp_stream stream_;
+        beast::flat_buffer buffer_;
+        http::request<http::string_body> request_;
+    };
+
+
+    // The following run on the server's thread
+
+    static void DoAccept() {
+        server->acceptor.async_accept([](beast::error_code ec, tcp::socket socket) {
+            if (ec == asio::error::operation_aborted) {
+                return;
+            }
+
+            if (ec) {
+                GS_LOG_TRACE_MSG(trace, "GsUIStreamServer - accept failed: " + ec.message());
+            }
+            else {
+                std::make_shared<GsUIHttpSession>(std::move(socket))->Run();
+            }
+
+            DoAccept();
+        });
+    }
+
+    static void Broadcast(const std::shared_ptr<const std::string>& message) {
+        std::erase_if(server->websocket_sessions, [](const std::weak_ptr<GsUIWebSocketSession>& session) {
+            return session.expired();
+        });
+
+        for (const std::weak_ptr<GsUIWebSocketSession>& weak_session : server->websocket_sessions) {
+            if (std::shared_ptr<GsUIWebSocketSession> session = weak_session.lock()) {
+                session->Send(message);
+            }
+        }
+    }
+
+    static void StoreImage(const std::string& name, const cv::Mat& img) {
+        std::vector<uchar> jpeg;
+
+        try {
+            if (!cv::imencode(".jpg", img, jpeg, { cv::IMWRITE_JPEG_QUALITY, GsUIStreamServer::kEmbeddedServerJpegQuality })) {
+                GS_LOG_MSG(warning, "GsUIStreamServer - could not encode image " + name + ".");
+                return;
+            }
+        }
+        catch (const cv::Exception& e) {
+            GS_LOG_MSG(warning, "GsUIStreamServer - could not encode image " + name + ": " + std::string(e.what()));
+            return;
+        }
+
+        server->images[name] = std::make_shared<const std::string>(jpeg.begin(), jpeg.end());
+        server->image_sequence++;
+
+        boost::property_tree::ptree root;
+        root.put("type", "image");
+        root.put("name", name);
+        root.put("sequence", server->image_sequence);
+
+        Broadcast(std::make_shared<const std::string>(GsResults::GenerateStringFromJsonTree(root)));
+    }
+
+    // Hands the work to the server's thread, if the server is running
+    static void PostToServer(std::function<void()> work) {
+        const std::lock_guard<std::mutex> lock(server_mutex);
+
+        if (server != nullptr) {
+            asio::post(server->io_context, std::move(work));
+        }
+    }
+
+
+    bool GsUIStreamServer::Start() {
+
+        const std::lock_guard<std::mutex> lock(server_mutex);
+
+        if (server_running) {
+            return true;
+        }
+
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kEmbeddedServerPort", kEmbeddedServerPort);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kEmbeddedServerBindAddress", kEmbeddedServerBindAddress);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kEmbeddedServerPreviewMaxFps", kEmbeddedServerPreviewMaxFps);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kEmbeddedServerPreviewMaxWidth", kEmbeddedServerPreviewMaxWidth);
+        GolfSimConfiguration::SetConstant("gs_config.user_interface.kEmbeddedServerJpegQuality", kEmbeddedServerJpegQuality);
+
+        if (kEmbeddedServerPort <= 0) {
+            GS_LOG_TRACE_MSG(trace, "GsUIStreamServer is not enabled.");
+            return true;
+        }
+
+        beast::error_code ec;
+        const asio::ip::address_v4 bind_address = asio::ip::make_address_v4(kEmbeddedServerBindAddress, ec);
+
+        if (ec) {
+            GS_LOG_MSG(error, "GsUIStreamServer - kEmbeddedServerBindAddress (" + kEmbeddedServerBindAddress + ") is not an IPv4 address.");
+            return false;
+        }
+
+        auto state = std::make_unique<GsUIStreamServerState>();
+
+        const tcp::endpoint endpoint(bind_address, (unsigned short)kEmbeddedServerPort);
+
+        state->acceptor.open(endpoint.protocol(), ec);
+
+        if (!ec) {
+            state->acceptor.set_option(asio::socket_base::reuse_address(true), ec);
+        }
+        if (!ec) {
+            state->acceptor.bind(endpoint, ec);
+        }
+        if (!ec) {
+            state->acceptor.listen(asio::socket_base::max_listen_connections, ec);
+        }
+
+        if (ec) {
+            GS_LOG_MSG(error, "GsUIStreamServer could not listen on " + kEmbeddedServerBindAddress + ":" + std::to_string(kEmbeddedServerPort) + ": " + ec.message());
+            return false;
+        }
+
+        server = std::move(state);
+        preview_pending = false;
+
+        DoAccept();
+
+        GsUIStreamServerState* running_state = server.get();
+
+        running_state->thread = std::thread([running_state]() {
+            while (!running_state->io_context.stopped()) {
+                try {
+                    running_state->io_context.run();
+                }
+                catch (const std::exception& e) {
+                    GS_LOG_MSG(error, "GsUIStreamServer - exception on the server thread: " + std::string(e.what()));
+                }
+            }
+        });
+
+        server_running = true;
+
+        GS_LOG_MSG(info, "GsUIStreamServer listening on " + kEmbeddedServerBindAddress + ":" + std::to_string(kEmbeddedServerPort) + ".");
+
+        return true;
+    }
+
+    void GsUIStreamServer::Stop() {
+
+        const std::lock_guard<std::mutex> lock(server_mutex);
+
+        if (!server_running) {
+            return;
+        }
+
+        server_running = false;
+
+        server->io_context.stop();
+
+        if (server->thread.joinable()) {
+            server->thread.join();
+        }
+
+        server.reset();
+
+        GS_LOG_TRACE_MSG(trace, "GsUIStreamServer stopped.");
+    }
+
+    bool GsUIStreamServer::IsRunning() {
+        return server_running;
+    }
+
+    void GsUIStreamServer::PublishResult(const GsIPCResult& result) {
+
+        if (!server_running) {
+            return;
+        }
+
+        boost::property_tree::ptree root;
+        root.put("type", "result");
+        root.put("result_type", (int)result.result_type_);
+        root.put("result_type_name", result.FormatResultType(result.result_type_));
+        root.put("club_type", (int)result.club_type_);
+        root.put("message", result.message_);
+
+        if (result.result_type_ == GsIPCResultType::kHit) {
+            root.put("speed_mpers", GsResults::FormatDoubleAsString(result.speed_mpers_));
+            root.put("launch_angle_deg", GsResults::FormatDoubleAsString(result.launch_angle_deg_));
+            root.put("side_angle_deg", GsResults::FormatDoubleAsString(result.side_angle_deg_));
+            root.put("back_spin_rpm", result.back_spin_rpm_);
+            root.put("side_spin_rpm", result.side_spin_rpm_);
+            root.put("confidence", result.confidence_);
+        }
+
+        auto message = std::make_shared<const std::string>(GsResults::GenerateStringFromJsonTree(root));
+
+        PostToServer([message]() {
+            server->latest_status = message;
+            Broadcast(message);
+        });
+    }
+
+    void GsUIStreamServer::PublishImage(const std::string& name, const cv::Mat& img) {
+
+        if (!server_running || img.empty()) {
+            return;
+        }
+
+        // The caller may change its image after this returns
+        cv::Mat image_copy = img.clone();
+
+        PostToServer([name, image_copy]() {
+            StoreImage(name, image_copy);
+        });
+    }
+
+    void GsUIStreamServer::PublishPreviewFrame(const cv::Mat& img) {
+
+        if (!server_running || img.empty() || kEmbeddedServerPreviewMaxFps <= 0.0) {
+            return;
+        }
+
+        // Only one preview is in progress at a time
+        bool expected = false;
+
+        if (!preview_pending.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - last_preview_time < std::chrono::duration<double>(1.0 / kEmbeddedServerPreviewMaxFps)) {
+            preview_pending = false;
+            return;
+        }
+
+        last_preview_time = now;
+
+        cv::Mat preview;
+
+        if (kEmbeddedServerPreviewMaxWidth > 0 && img.cols > kEmbeddedServerPreviewMaxWidth) {
+            const int preview_height = (int)std::round((double)img.rows * kEmbeddedServerPreviewMaxWidth / img.cols);
+            cv::resize(img, preview, cv::Size(kEmbeddedServerPreviewMaxWidth, preview_height), 0, 0, cv::INTER_AREA);
+        }
+        else {
+            preview = img.clone();
+        }
+
+        PostToServer([preview]() {
+            StoreImage(kPreviewImageName, preview);
+            preview_pending = false;
+        });
+    }
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// An optional, lightweight HTTP and WebSocket server that runs inside the launch monitor
+// process.  It lets a browser on the same network see the LM's status, shot results, and
+// images without going through the ActiveMQ broker, the shared image directory, and the
+// separate Tomee web application.
+//
+// The server is started only if gs_config.user_interface.kEmbeddedServerPort is non-zero.
+// It listens on gs_config.user_interface.kEmbeddedServerBindAddress, which is the local
+// machine only (127.0.0.1) by default.  There is no authentication, so if it is set to
+// 0.0.0.0 (or another interface's address), anyone who can reach that interface can see
+// the shots, the images, and the metrics below.
+//
+// It serves:
+//      /                   A simple monitor page
+//      /ws                 A WebSocket that pushes a JSON message for every status or result
+//                          ("type": "result"), and for every new image ("type": "image")
+//      /status             The most recent status or result, as JSON
+//      /images/<name>.jpg  The most recent image with that name, as a JPEG, from memory
+//      /metrics            The process's metrics, in the Prometheus text format (see gs_metrics.h)
+//
+// The images are the same ones that GsUISystem::SaveWebserverImage writes to the shared
+// directory, plus low-rate, reduced-size previews of the frames that the LM is watching
+// while it waits for a ball.
+//
+// All of the networking runs on the server's own thread.  The Publish calls only copy their
+// data and hand it to that thread, so they do not hold up the caller.  A client that cannot
+// keep up has messages dropped rather than slowing anything else down.
+
+#pragma once
+
+#ifdef __unix__  // Ignore in Windows environment
+
+#include <string>
+
+#include <opencv2/core.hpp>
+
+#include "gs_ipc_result.h"
+
+
+namespace golf_sim {
+
+    class GsUIStreamServer {
+
+    public:
+
+        // 0 means the embedded server is not started
+        static int kEmbeddedServerPort;
+        // The IPv4 address to listen on.  0.0.0.0 listens on every interface (see above).
+        static std::string kEmbeddedServerBindAddress;
+        // The most watching-frame previews that are published per second
+        static double kEmbeddedServerPreviewMaxFps;
+        // Previews wider than this are reduced in size before being encoded
+        static int kEmbeddedServerPreviewMaxWidth;
+        static int kEmbeddedServerJpegQuality;
+
+        // The image name under which the watching-frame previews are published
+        static const std::string kPreviewImageName;
+
+        // Reads the configuration and starts the server if it is enabled.  Returns false only
+        // if the server is enabled but could not be started.
+        static bool Start();
+
+        static void Stop();
+
+        static bool IsRunning();
+
+        // Sends the result to all connected WebSocket clients and keeps it as the latest status
+        static void PublishResult(const GsIPCResult& result);
+
+        // Keeps a JPEG of the image under the given name and tells the clients that it has changed
+        static void PublishImage(const std::string& name, const cv::Mat& img);
+
+        // Like PublishImage (under kPreviewImageName), but skipped if the last preview was too
+        // recent or is still being encoded, and reduced in size first if necessary
+        static void PublishPreviewFrame(const cv::Mat& img);
+    };
+
+}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
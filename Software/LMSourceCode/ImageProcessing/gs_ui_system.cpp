@@ -14,6 +14,7 @@
 #include "gs_ui_system.h"
 #include "gs_sim_interface.h"
 #include "gs_camera.h"
+#include "gs_ui_stream_server.h"
 
 namespace golf_sim {
 
@@ -48,6 +49,7 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "FSM is sending an Error-Type IPC Results Message:" + error_result.Format());
 
         GolfSimIpcSystem::SendIpcMessage(ipc_message);
+        GsUIStreamServer::PublishResult(error_result);
     }
 
 
@@ -112,6 +114,7 @@ namespace golf_sim {
         GS_LOG_TRACE_MSG(trace, "FSM is sending an IPC Results Message: " + results.Format());
 
         GolfSimIpcSystem::SendIpcMessage(ipc_message);
+        GsUIStreamServer::PublishResult(results);
 
         return true;
     }
@@ -128,7 +131,7 @@ namespace golf_sim {
         results.side_angle_deg_ = result_ball.angles_ball_perspective_[0];
         results.back_spin_rpm_ = result_ball.rotation_speeds_RPM_[2];
         results.side_spin_rpm_ = result_ball.rotation_speeds_RPM_[0];
-        results.confidence_ = 5;  // TBD - Set from analysis
+        results.confidence_ = result_ball.GetConfidence();
         results.message_ = "Ball Hit - Results returned." + secondary_message;
 
         GS_LOG_MSG(info, "BALL_HIT_CSV, " + std::to_string(GsSimInterface::GetShotCounter()) + ", (carry - NA), (Total - NA), (Side Dest - NA), (Smash Factor - NA), (Club Speed - NA), "
@@ -141,6 +144,7 @@ namespace golf_sim {
             );
 
         GolfSimIpcSystem::SendIpcMessage(ipc_message);
+        GsUIStreamServer::PublishResult(results);
     }
 
 
@@ -157,6 +161,9 @@ namespace golf_sim {
 
         std::string file_name(input_file_name);
 
+        // The embedded server (if running) serves the image straight from memory
+        GsUIStreamServer::PublishImage(file_name, img);
+
         if (GolfSimCamera::kLogDiagnosticImagesToUniqueFiles  && !suppress_diagnostic_saving) {
 
             // Save a unique version of the webserver image into a directory that will not get
@@ -199,7 +206,7 @@ namespace golf_sim {
                                         const std::vector<GolfBall>& balls,
                                         bool suppress_diagnostic_saving) {
 
-        if (!GolfSimCamera::kLogWebserverImagesToFile) {
+        if (!GolfSimCamera::kLogWebserverImagesToFile && !GsUIStreamServer::IsRunning()) {
             return true;
         }
 
@@ -214,6 +221,12 @@ namespace golf_sim {
             LoggingTools::DrawCircleOutlineAndCenter(ball_image, c, label);
         }
 
+        // Whether the image is written to any files does not depend on the embedded server
+        if (!GolfSimCamera::kLogWebserverImagesToFile) {
+            GsUIStreamServer::PublishImage(file_name, ball_image);
+            return true;
+        }
+
         return SaveWebserverImage(file_name, ball_image, suppress_diagnostic_saving);
     }
 
@@ -0,0 +1,287 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <chrono>
+
+#include "logging_tools.h"
+#include "gs_thread_pool.h"
+
+#include "image_prep_graph.h"
+
+
+namespace golf_sim {
+
+    ImagePrepGraph::Node ImagePrepGraph::Clahe(const std::string& name, const int clip_limit, const int tiles_grid_size) {
+        Node node;
+        node.type = NodeType::kClahe;
+        node.name = name;
+        node.clahe_clip_limit = clip_limit;
+        node.clahe_tiles_grid_size = tiles_grid_size;
+        return node;
+    }
+
+    ImagePrepGraph::Node ImagePrepGraph::GaussianBlur(const std::string& name, const int kernel_size) {
+        Node node;
+        node.type = NodeType::kGaussianBlur;
+        node.name = name;
+        node.kernel_size = kernel_size;
+        return node;
+    }
+
+    ImagePrepGraph::Node ImagePrepGraph::MedianBlur(const std::string& name, const int kernel_size) {
+        Node node;
+        node.type = NodeType::kMedianBlur;
+        node.name = name;
+        node.kernel_size = kernel_size;
+        return node;
+    }
+
+    ImagePrepGraph::Node ImagePrepGraph::Canny(const std::string& name, const double lower, const double upper) {
+        Node node;
+        node.type = NodeType::kCanny;
+        node.name = name;
+        node.canny_lower = lower;
+        node.canny_upper = upper;
+        return node;
+    }
+
+    ImagePrepGraph::Node ImagePrepGraph::Function(const std::string& name, std::function<void(const cv::Mat&, cv::Mat&)> function) {
+        Node node;
+        node.type = NodeType::kFunction;
+        node.name = name;
+        node.function = std::move(function);
+        return node;
+    }
+
+    std::vector<double> ImagePrepGraph::GetSignature(const std::vector<Node>& nodes) {
+        std::vector<double> signature;
+
+        for (const Node& node : nodes) {
+            signature.insert(signature.end(), {
+                (double)node.type,
+                (double)node.kernel_size,
+                node.canny_lower,
+                node.canny_upper,
+                (double)node.clahe_clip_limit,
+                (double)node.clahe_tiles_grid_size });
+        }
+
+        return signature;
+    }
+
+    int ImagePrepGraph::GetHaloRows(const Node& node) {
+        if (node.type == NodeType::kGaussianBlur || node.type == NodeType::kMedianBlur) {
+            return std::max(0, node.kernel_size / 2);
+        }
+
+        return 0;
+    }
+
+    void ImagePrepGraph::Build(const std::vector<Node>& nodes, const cv::Size& frame_size, const int frame_type) {
+
+        nodes_ = nodes;
+        signature_ = GetSignature(nodes);
+        frame_size_ = frame_size;
+        frame_type_ = frame_type;
+
+        for (cv::Mat& buffer : buffers_) {
+            buffer.create(frame_size, frame_type);
+        }
+
+        // Enough bands to keep the pool (and the calling thread) busy, but no more
+        const int max_number_bands = (int)GsThreadPool::GetSharedPool().GetNumberThreads() + 1;
+        const int number_bands = std::clamp(frame_size.height / kMinimumBandRows, 1, max_number_bands);
+
+        bands_.clear();
+
+        for (int band = 0; band < number_bands; band++) {
+            bands_.emplace_back((band * frame_size.height) / number_bands, ((band + 1) * frame_size.height) / number_bands);
+        }
+
+        int max_halo_rows = 0;
+
+        for (const Node& node : nodes) {
+            max_halo_rows = std::max(max_halo_rows, GetHaloRows(node));
+        }
+
+        band_buffers_.resize(bands_.size());
+
+        for (size_t band = 0; band < bands_.size(); band++) {
+            band_buffers_[band].create(std::min(frame_size.height, bands_[band].size() + 2 * max_halo_rows), frame_size.width, frame_type);
+        }
+
+        if (clahe_.empty()) {
+            clahe_ = cv::createCLAHE();
+        }
+
+        timings_.assign(nodes.size(), NodeTiming{});
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            timings_[i].name = nodes[i].name;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "ImagePrepGraph built with " + std::to_string(nodes.size()) + " nodes and " +
+            std::to_string(bands_.size()) + " bands for a " + std::to_string(frame_size.width) + "x" + std::to_string(frame_size.height) + " image.");
+    }
+
+    bool ImagePrepGraph::IsBuiltFor(const std::vector<Node>& nodes, const cv::Size& frame_size, const int frame_type) const {
+        return frame_size == frame_size_ && frame_type == frame_type_ && GetSignature(nodes) == signature_;
+    }
+
+    bool ImagePrepGraph::Run(const std::vector<Node>& nodes,
+                             const cv::Mat& input,
+                             cv::Mat& output,
+                             const std::string& debug_name) {
+
+        if (input.empty()) {
+            GS_LOG_MSG(error, "ImagePrepGraph::Run called with no image to work with (input).");
+            return false;
+        }
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!IsBuiltFor(nodes, input.size(), input.type())) {
+            Build(nodes, input.size(), input.type());
+        }
+
+        // The functions are not part of the signature, so always use the latest ones
+        for (size_t i = 0; i < nodes.size(); i++) {
+            nodes_[i].function = nodes[i].function;
+        }
+
+        if (nodes_.empty()) {
+            if (output.data != input.data) {
+                input.copyTo(output);
+            }
+            return true;
+        }
+
+        const size_t last_node = nodes_.size() - 1;
+        // If the output is the input, the first node cannot write straight into it
+        const bool output_is_input = (output.data == input.data);
+
+        try {
+            for (size_t i = 0; i < nodes_.size(); i++) {
+                const cv::Mat& node_input = (i == 0) ? input : buffers_[(i - 1) % 2];
+                const bool write_to_output = (i == last_node && !(i == 0 && output_is_input));
+                cv::Mat& node_output = write_to_output ? output : buffers_[i % 2];
+
+                const auto start_time = std::chrono::steady_clock::now();
+
+                RunNode(i, node_input, node_output);
+
+                const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+                timings_[i].last_ms = elapsed_ms;
+                timings_[i].total_ms += elapsed_ms;
+                timings_[i].number_runs++;
+
+                LoggingTools::DebugShowImage(debug_name + "  " + nodes_[i].name, node_output);
+
+                if (i == last_node && !write_to_output) {
+                    node_output.copyTo(output);
+                }
+            }
+        }
+        catch (const cv::Exception& e) {
+            GS_LOG_MSG(error, "ImagePrepGraph::Run failed: " + std::string(e.what()));
+            return false;
+        }
+
+        GS_LOG_TRACE_MSG(trace, "ImagePrepGraph timings: " + FormatNodeTimings(timings_));
+
+        return true;
+    }
+
+    void ImagePrepGraph::RunNode(const size_t node_index, const cv::Mat& input, cv::Mat& output) {
+
+        const Node& node = nodes_[node_index];
+
+        output.create(input.size(), input.type());
+
+        switch (node.type) {
+            case NodeType::kClahe: {
+                clahe_->setClipLimit(node.clahe_clip_limit);
+                clahe_->setTilesGridSize(cv::Size(node.clahe_tiles_grid_size, node.clahe_tiles_grid_size));
+                clahe_->apply(input, output);
+                break;
+            }
+
+            case NodeType::kGaussianBlur:
+            case NodeType::kMedianBlur: {
+                if (node.kernel_size <= 1) {
+                    input.copyTo(output);
+                }
+                else {
+                    RunBanded(node, input, output);
+                }
+                break;
+            }
+
+            case NodeType::kCanny: {
+                cv::Canny(input, output, node.canny_lower, node.canny_upper);
+                break;
+            }
+
+            case NodeType::kFunction: {
+                node.function(input, output);
+                break;
+            }
+
+            default: {
+                GS_LOG_MSG(error, "ImagePrepGraph::RunNode - unknown node type.");
+                break;
+            }
+        }
+    }
+
+    void ImagePrepGraph::RunBanded(const Node& node, const cv::Mat& input, cv::Mat& output) {
+
+        const int halo_rows = GetHaloRows(node);
+
+        GsThreadPool::GetSharedPool().ParallelFor(bands_.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t band = begin; band < end; band++) {
+                const cv::Range& rows = bands_[band];
+
+                // Filter the band with its halo, and then keep only the band's own rows
+                const int first_row = std::max(0, rows.start - halo_rows);
+                const int last_row = std::min(input.rows, rows.end + halo_rows);
+
+                const cv::Mat band_input = input.rowRange(first_row, last_row);
+                cv::Mat band_output = band_buffers_[band].rowRange(0, last_row - first_row);
+
+                if (node.type == NodeType::kGaussianBlur) {
+                    cv::GaussianBlur(band_input, band_output, cv::Size(node.kernel_size, node.kernel_size), 0);
+                }
+                else {
+                    cv::medianBlur(band_input, band_output, node.kernel_size);
+                }
+
+                band_output.rowRange(rows.start - first_row, rows.end - first_row).copyTo(output.rowRange(rows));
+            }
+        });
+    }
+
+    std::vector<ImagePrepGraph::NodeTiming> ImagePrepGraph::GetNodeTimings() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return timings_;
+    }
+
+    std::string ImagePrepGraph::FormatNodeTimings(const std::vector<NodeTiming>& timings) {
+        std::string s;
+
+        for (const NodeTiming& timing : timings) {
+            if (!s.empty()) {
+                s += ", ";
+            }
+
+            const double average_ms = (timing.number_runs > 0) ? timing.total_ms / timing.number_runs : 0.0;
+            s += timing.name + " = " + std::to_string(timing.last_ms) + " ms (avg " + std::to_string(average_ms) + ")";
+        }
+
+        return s;
+    }
+
+}
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A fixed chain ("graph") of the image-preparation steps that are run on a gray-scale
+// image before the Hough circle search, such as CLAHE, blur, Canny, and blur again.
+//
+// The graph owns a pair of frame-sized ping-pong buffers that the nodes alternate between,
+// so that the chain does not allocate new images on every shot.  The blur nodes are run in
+// horizontal bands across the shared thread pool.  Each band is filtered together with
+// enough rows (the halo) above and below it that the band's own rows come out exactly as
+// they would from a full-frame filter.  CLAHE and Canny depend on the whole image (tiles and
+// edge-following), so they run on the full frame, where OpenCV already parallelizes them.
+//
+// The time that each node takes is kept, and logged (at trace level) after each run.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+
+namespace golf_sim {
+
+    class ImagePrepGraph {
+
+    public:
+
+        enum class NodeType {
+            kClahe = 0,
+            kGaussianBlur = 1,
+            kMedianBlur = 2,
+            kCanny = 3,
+            kFunction = 4
+        };
+
+        struct Node {
+            NodeType type = NodeType::kFunction;
+            // Also used as the name of the node's debug image
+            std::string name;
+
+            // The blurs
+            int kernel_size = 0;
+
+            double canny_lower = 0.0;
+            double canny_upper = 0.0;
+
+            int clahe_clip_limit = 0;
+            int clahe_tiles_grid_size = 0;
+
+            // For kFunction nodes.  Must write its result into the (pre-allocated) output.
+            std::function<void(const cv::Mat& input, cv::Mat& output)> function;
+        };
+
+        struct NodeTiming {
+            std::string name;
+            double last_ms = 0.0;
+            double total_ms = 0.0;
+            uint64_t number_runs = 0;
+        };
+
+        static Node Clahe(const std::string& name, const int clip_limit, const int tiles_grid_size);
+        static Node GaussianBlur(const std::string& name, const int kernel_size);
+        static Node MedianBlur(const std::string& name, const int kernel_size);
+        static Node Canny(const std::string& name, const double lower, const double upper);
+        static Node Function(const std::string& name, std::function<void(const cv::Mat&, cv::Mat&)> function);
+
+        // Allocates the buffers and splits the frame into bands for the given nodes and image size
+        void Build(const std::vector<Node>& nodes, const cv::Size& frame_size, const int frame_type);
+
+        // True if Build was last called with nodes that have the same types and parameters, and
+        // with the same image size and type
+        bool IsBuiltFor(const std::vector<Node>& nodes, const cv::Size& frame_size, const int frame_type) const;
+
+        // Runs the nodes on the input and leaves the result in output.  The graph is
+        // (re)built first if necessary.  The output may be the same image as the input.
+        // Images are shown (if debugging) after each node, with debug_name as a prefix.
+        // Returns false if the input is empty or a node fails.
+        bool Run(const std::vector<Node>& nodes,
+                 const cv::Mat& input,
+                 cv::Mat& output,
+                 const std::string& debug_name = "");
+
+        std::vector<NodeTiming> GetNodeTimings() const;
+
+        static std::string FormatNodeTimings(const std::vector<NodeTiming>& timings);
+
+        // Bands are not made smaller than this, so that the halos stay a small part of the work
+        static constexpr int kMinimumBandRows = 64;
+
+    protected:
+
+        // The node values that the buffers and bands depend on.  Excludes the functions.
+        static std::vector<double> GetSignature(const std::vector<Node>& nodes);
+
+        // The number of rows above and below a band that the node needs
+        static int GetHaloRows(const Node& node);
+
+        void RunNode(const size_t node_index, const cv::Mat& input, cv::Mat& output);
+
+        // Runs a blur node band by band
+        void RunBanded(const Node& node, const cv::Mat& input, cv::Mat& output);
+
+        mutable std::mutex mutex_;
+
+        std::vector<Node> nodes_;
+        std::vector<double> signature_;
+        cv::Size frame_size_;
+        int frame_type_ = -1;
+
+        cv::Mat buffers_[2];
+
+        std::vector<cv::Range> bands_;
+        // One per band, each large enough for the band plus the largest halo
+        std::vector<cv::Mat> band_buffers_;
+
+        cv::Ptr<cv::CLAHE> clahe_;
+
+        std::vector<NodeTiming> timings_;
+    };
+
+}
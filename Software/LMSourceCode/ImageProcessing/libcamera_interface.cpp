@@ -40,6 +40,9 @@
 
 #include <libcamera/logging.h>
 #include "motion_detect.h"
+#include "gs_replay_camera.h"
+#include "gs_frame_lease.h"
+#include "gs_frame_monitor.h"
 #include "libcamera_interface.h"
 
 
@@ -168,6 +171,10 @@ namespace golf_sim {
             return false;
         }
 
+        if (GsReplayCamera::IsEnabled()) {
+            return GsReplayCamera::WatchForBallMovement(motion_detected);
+        }
+
         // Setup the camera to watch at a high FPS by reducing the portion of the sensor that will
         // be processed in each frame (cropping)
 
@@ -185,6 +192,8 @@ namespace golf_sim {
         // latency.
         motion_detected = false;
 
+        GsFrameMonitor::StartWatching(app.GetOptions()->framerate.value_or(0.0F));
+
         try
         {
             if (!ball_watcher_event_loop(app, motion_detected)) {
@@ -194,9 +203,12 @@ namespace golf_sim {
         catch (std::exception const& e)
         {
             GS_LOG_MSG(error, "ERROR: *** " + std::string(e.what()) + " ***");
+            GsFrameMonitor::EndWatching();
             return false;
         }
 
+        GsFrameMonitor::EndWatching();
+
         uint frameIndex = 0;
         unsigned int numFramesToShow = 10;
 
@@ -1271,9 +1283,13 @@ bool TakeLibcameraStill(const GolfSimCamera &camera, cv::Mat& img) {
     catch (std::exception const& e)
     {
         GS_LOG_MSG(error, "ERROR: *** " + std::string(e.what()) + " ***");
+        img.release();
         return false;
     }
 
+    // The camera app is deleted below, and the leased image has to outlive it
+    img = GsFrameLease::Detach(img);
+
     if (!DeConfigureForLibcameraStill(GolfSimOptions::GetCommandLineOptions().GetCameraNumber())) {
         GS_LOG_TRACE_MSG(error, "failed to DeConfigureForLibcameraStill.");
         return false;
@@ -1293,13 +1309,22 @@ bool TakeRawPicture(const GolfSimCamera& camera, cv::Mat& img) {
     
     const CameraHardware::CameraModel  camera_model = (camera_number == GsCameraNumber::kGsCamera1) ? GolfSimCamera::kSystemSlot1CameraType : GolfSimCamera::kSystemSlot2CameraType;
 
-    // Ensure we have full resolution
-    ConfigCameraForFullScreenWatching(camera);
-
     cv::Mat initialImg;
-    if (!TakeLibcameraStill(camera, initialImg)) {
-        GS_LOG_MSG(error, "Failed to take still picture.");
-        return false;
+
+    if (GsReplayCamera::IsEnabled()) {
+        if (!GsReplayCamera::TakeStill(camera, initialImg)) {
+            GS_LOG_MSG(error, "Failed to take replayed still picture.");
+            return false;
+        }
+    }
+    else {
+        // Ensure we have full resolution
+        ConfigCameraForFullScreenWatching(camera);
+
+        if (!TakeLibcameraStill(camera, initialImg)) {
+            GS_LOG_MSG(error, "Failed to take still picture.");
+            return false;
+        }
     }
 
     if (initialImg.empty()) {
@@ -1356,6 +1381,16 @@ bool WaitForCam2Trigger(cv::Mat& return_image) {
     GolfSimCamera c;
     c.camera_hardware_.init_camera_parameters(GsCameraNumber::kGsCamera2, camera_model);
 
+    if (GsReplayCamera::IsEnabled()) {
+        if (!GsReplayCamera::WaitForCam2Trigger(raw_image)) {
+            GS_LOG_MSG(error, "Failed to get replayed camera 2 image.");
+            return false;
+        }
+
+        return_image = golf_sim::LibCameraInterface::undistort_camera_image(raw_image, c);
+        return true;
+    }
+
     try
     {
         StillOptions* options = app.GetOptions();
@@ -1435,16 +1470,26 @@ bool WaitForCam2Trigger(cv::Mat& return_image) {
         return false;
     }
 
-    // GS_LOG_TRACE_MSG(trace, "Tearing down initial camera.");
-    app.StopCamera();  // TBD - Need?
-    app.Teardown();  // TBD - Need?
-
     // LoggingTools::LogImage("", raw_image, std::vector < cv::Point >{}, true, "InitialRawImageCam2.png");
 
-    // Save the image in memory after un-distorting it for the local camera/lens
-
+    // Save the image in memory after un-distorting it for the local camera/lens.
+    // The raw image is leased directly from the camera's buffer, so this has to happen
+    // before the camera is torn down.  The un-distorted image is then the only copy of the frame.
     return_image = golf_sim::LibCameraInterface::undistort_camera_image(raw_image, c);
 
+    // If there was nothing to un-distort, the return image is still the leased view
+    return_image = GsFrameLease::Detach(return_image);
+    raw_image.release();
+
+    if (GsFrameLease::GetNumberOutstandingLeases() != 0) {
+        GS_LOG_MSG(error, "WaitForCam2Trigger - camera frame leases are still outstanding before the camera teardown.");
+        GsFrameLease::LogStatistics();
+    }
+
+    // GS_LOG_TRACE_MSG(trace, "Tearing down initial camera.");
+    app.StopCamera();  // TBD - Need?
+    app.Teardown();  // TBD - Need?
+
     if (GolfSimOptions::GetCommandLineOptions().camera_still_mode_ ) {
 
         std::string output_fname = GolfSimOptions::GetCommandLineOptions().output_filename_;
@@ -1462,6 +1507,11 @@ bool WaitForCam2Trigger(cv::Mat& return_image) {
 
 bool PerformCameraSystemStartup() {
 
+    // Recorded shots stand in for the cameras, so there is no camera hardware to set up
+    if (GsReplayCamera::IsEnabled()) {
+        return GsReplayCamera::Initialize();
+    }
+
     SetLibCameraLoggingOff();
 
     // Setup the Pi Camera to be internally or externally triggered as appropriate
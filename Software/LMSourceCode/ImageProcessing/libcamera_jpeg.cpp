@@ -34,6 +34,7 @@
 #include "libcamera_interface.h"
 #include "logging_tools.h"
 #include "ball_watcher.h"
+#include "gs_frame_lease.h"
 #include "core/rpicam_app.hpp"
 #include "core/still_options.hpp"
 
@@ -167,39 +168,23 @@ bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
 
 			StreamInfo info = app.GetStreamInfo(stream);
 
-			CompletedRequestPtr& payload = std::get<CompletedRequestPtr>(msg.payload);
-			libcamera::FrameBuffer *buffer = payload->buffers[stream];
-			BufferReadSync r(&app, buffer);
-
-			const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
+			GS_LOG_TRACE_MSG(trace, "About to lease Mat frame in kWaitingForFinalImageFlush.  Info.height, width = " + std::to_string(info.height) + 
+								", " + std::to_string(info.width) + ". Stride = " + std::to_string(info.stride));
 
-			uint32_t* image = (uint32_t*)mem[0].data();
+			// A Mat built directly on the buffer used to create a segmentation fault, because the
+			// CompletedRequest is recycled once this message goes out of scope.  So the frame used
+			// to be cloned.  The leased frame instead keeps the request (and its buffer) alive until
+			// the caller releases the image, which saves a full-resolution copy on every strobed image.
+			// TBD - Need to figure out how to get this picture to be in color again!!
+			CompletedRequestPtr& payload = std::get<CompletedRequestPtr>(msg.payload);
+			returnImg = gs::GsFrameLease::LeaseFrame(app, payload, stream, CV_8UC3);
 
-			if (image == nullptr) {
+			if (returnImg.empty()) {
 				GS_LOG_MSG(error, "Got a null image");
 				
 				return false;
 			}
 
-			GS_LOG_TRACE_MSG(trace, "About to create Mat frame in kWaitingForFinalImageFlush.  Info.height, width = " + std::to_string(info.height) + 
-								", " + std::to_string(info.width) + ". Stride = " + std::to_string(info.stride));
-
-
-			// TBD - Need to figure out how to get this picture to be in color again!!
-			cv::Mat frame = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
-			// cv::Mat frame = cv::Mat(info.height, info.width, CV_8U, image, info.stride);
-
-			// golf_sim::LoggingTools::LogImage("", frame, std::vector < cv::Point >{}, true, "Cam2_FinalImageFlush_Image.png");
-
-
-
-			GS_LOG_TRACE_MSG(trace, "Created Mat frame");
-
-			// Save the image in memory
-			returnImg = frame.clone();
-
-			// THE FOLLOWING CREATES A SEGMENTATION FAULT: returnImg = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
-			// So, that's why the frame is being cloned.
 			GS_LOG_TRACE_MSG(trace, "Returning (Final, Strobed) Viewfinder captured image");
 			// golf_sim::LoggingTools::LogImage("", returnImg, std::vector < cv::Point >{}, true, "Cam2_Strobed_Image.png");
 
@@ -441,19 +426,15 @@ bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg)
 				unsigned int h = info.height, w = info.width, stride = info.stride;
 				GS_LOG_TRACE_MSG(trace, "Still image (width, height) = (" + std::to_string(w) + "," + std::to_string(h) + ") Stride = " + std::to_string(stride));
 
+				// Lease the frame rather than copying it.  The caller must release (or detach) the
+				// image before the camera is torn down.
 				CompletedRequestPtr& payload = std::get<CompletedRequestPtr>(msg.payload);
-                libcamera::FrameBuffer *buffer = payload->buffers[stream];
+				returnImg = gs::GsFrameLease::LeaseFrame(app, payload, stream, CV_8UC3);
 
-                BufferReadSync r(&app, buffer);
-
-                const std::vector<libcamera::Span<uint8_t>> mem = r.Get();
-
-                uint32_t* image = (uint32_t*)mem[0].data();
-
-                cv::Mat frame = cv::Mat(info.height, info.width, CV_8UC3, image, info.stride);
-
-				// Save the image in memory
-				returnImg = frame.clone();
+				if (returnImg.empty()) {
+					GS_LOG_MSG(error, "Could not lease the still image.");
+					return false;
+				}
 
 				return true;
 			}
@@ -38,9 +38,12 @@
 #include "gs_sim_interface.h"
 #include "gs_e6_interface.h"
 #include "gs_automated_testing.h"
+#include "gs_strobe_timing_test.h"
+#include "gs_synthetic_scene.h"
 
 #include "gs_fsm.h"
 #include "gs_ipc_system.h"
+#include "gs_frame_monitor.h"
 #include "libcamera_interface.h"
 
 
@@ -1236,13 +1239,40 @@ void run_main(int argc, char* argv[])
 
         case SystemMode::kAutomatedTesting:
         {
-            if (!GsAutomatedTesting::TestBallPosition()) {
+            std::string kAutomatedTestCaptureDir;
+            GolfSimConfiguration::SetConstant("gs_config.testing.kAutomatedTestCaptureDir", kAutomatedTestCaptureDir);
+
+            if (!kAutomatedTestCaptureDir.empty()) {
+                if (!GsAutomatedTesting::TestCapturedShots(kAutomatedTestCaptureDir)) {
+                    GS_LOG_MSG(info, "Failed to TestCapturedShots.");
+                    return;
+                }
+            }
+            else if (!GsAutomatedTesting::TestBallPosition()) {
                 GS_LOG_MSG(info, "Failed to TestBallPosition.");
                 return;
             }
         }
         break;
 
+        case SystemMode::kTestStrobeTiming:
+        {
+            if (!GsStrobeTimingTest::RunStrobeJitterBenchmark()) {
+                GS_LOG_MSG(info, "Failed to RunStrobeJitterBenchmark.");
+                return;
+            }
+        }
+        break;
+
+        case SystemMode::kGenerateSyntheticTestSuite:
+        {
+            if (!GsSyntheticScene::GenerateTestSuite()) {
+                GS_LOG_MSG(error, "Failed to GenerateTestSuite.");
+                return;
+            }
+        }
+        break;
+
         case SystemMode::kCamera1BallLocation:
         case SystemMode::kCamera2BallLocation:
         {
@@ -1350,6 +1380,15 @@ void run_main(int argc, char* argv[])
             break;
         }
 
+        case SystemMode::kGenerateSyntheticTestSuite:
+        {
+            if (!GsSyntheticScene::GenerateTestSuite()) {
+                GS_LOG_MSG(error, "Failed to GenerateTestSuite.");
+                return;
+            }
+        }
+        break;
+
         case SystemMode::kCamera1AutoCalibrate:
         case SystemMode::kCamera2AutoCalibrate:
         {
@@ -1524,13 +1563,25 @@ int main(int argc, char *argv[])
     catch (std::exception const& e)
     {
         GS_LOG_MSG(error, "Exception occurred. ERROR: *** " + std::string(e.what()) + " ***");
+#ifdef __unix__
+        GsFrameMonitor::StopReporter();
+#endif
         return false;
     }
 
+#ifdef __unix__
+    // The FSM normally does this when it shuts down, but not every mode runs the FSM.  The
+    // reporter logs, so it must be stopped while the logging is still up.
+    GsFrameMonitor::StopReporter();
+#endif
+
     GS_LOG_TRACE_MSG(trace, "Finished run_main.");
     
     // GS_LOG_TRACE_MSG(trace, "Waiting for any keypress to end program.");
     // cv::waitKey(0);
 
     GS_LOG_TRACE_MSG(trace, "Tests Complete");
+
+    // Drains any queued binary-log records.  Other exit paths are covered by an atexit handler.
+    GsAsyncLog::Stop();
 }
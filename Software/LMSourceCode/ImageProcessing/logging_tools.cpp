@@ -169,6 +169,41 @@ namespace golf_sim {
         fsSink->set_formatter(logFmt);
         fsSink->locked_backend()->auto_flush(true);
 
+        const std::string& binary_log_file = GolfSimOptions::GetCommandLineOptions().binary_log_file_;
+
+        if (!binary_log_file.empty()) {
+            // Warnings and errors still show up in the text logs right away.  The echo
+            // must not go back through the GS_LOG macros, or it would just be re-queued.
+            auto echo = [](int level, const std::string& text) {
+                switch (level) {
+                    case severity_level::warning:
+                        BOOST_LOG_TRIVIAL(warning) << text;
+                        break;
+
+                    case severity_level::error:
+                        BOOST_LOG_TRIVIAL(error) << text;
+                        break;
+
+                    case severity_level::fatal:
+                        BOOST_LOG_TRIVIAL(fatal) << text;
+                        break;
+
+                    default:
+                        BOOST_LOG_TRIVIAL(info) << text;
+                        break;
+                }
+            };
+
+            // The LoggingLevel values line up with the boost severity levels
+            if (GsAsyncLog::Start(binary_log_file, (int)GolfSimOptions::GetCommandLineOptions().logging_level_,
+                                  severity_level::warning, echo)) {
+                BOOST_LOG_TRIVIAL(info) << "Logging to binary log file " << binary_log_file << ".";
+            }
+            else {
+                BOOST_LOG_TRIVIAL(error) << "Could not open binary log file " << binary_log_file << ".  Using the text logs only.";
+            }
+        }
+
         // Add our custom recent-messages sink to the logger.
         /*** TBD - Not Completed yet
         boost::shared_ptr <RecentMessageSink> RMSink = boost::make_shared<RecentMessageSink>();
@@ -192,6 +227,13 @@ namespace golf_sim {
 
     void LoggingTools::InternalLog(boost::log::trivial::severity_level log_level, const std::string& msg) {
 
+        if (GsAsyncLog::IsRunning()) {
+            if (GsAsyncLog::IsLevelEnabled(log_level)) {
+                GsAsyncLog::Write(log_level, "", 0, msg);
+            }
+            return;
+        }
+
         switch(log_level) {
 
             case severity_level::trace:
@@ -32,6 +32,7 @@
 
 #include "golf_ball.h"   // TBD - Something wrong here architecturally - why does logging know about specific golf types?  Does that make sense?
 #include "gs_globals.h"
+#include "gs_async_log.h"
 
 namespace golf_sim {
 
@@ -143,11 +144,26 @@ protected:
 	static boost::circular_buffer<std::string> RecentLogMessages;
 };
 
-// Used as a define so that we can get file/line-numbers in our tracing if we want
-#define GS_LOG_MSG(LEVEL, MSG) BOOST_LOG_FUNCTION();  BOOST_LOG_TRIVIAL(LEVEL) << MSG
+// Used as a define so that we can get file/line-numbers in our tracing if we want.
+// Levels below GS_LOG_COMPILE_MIN_LEVEL are compiled out.  When the asynchronous binary log
+// is running, the level is checked before MSG is built, and the record goes to the binary log
+// instead of the (synchronous) boost sinks.  See gs_async_log.h.
+#define GS_LOG_MSG(LEVEL, MSG) \
+    do { \
+        if constexpr (golf_sim::GsAsyncLog::IsCompiledIn(boost::log::trivial::LEVEL)) { \
+            if (golf_sim::GsAsyncLog::IsRunning()) { \
+                if (golf_sim::GsAsyncLog::IsLevelEnabled(boost::log::trivial::LEVEL)) { \
+                    golf_sim::GsAsyncLog::Write(boost::log::trivial::LEVEL, __FILE__, __LINE__, golf_sim::GsAsyncLog::ToLogText(MSG)); \
+                } \
+            } \
+            else { \
+                BOOST_LOG_FUNCTION();  BOOST_LOG_TRIVIAL(LEVEL) << MSG; \
+            } \
+        } \
+    } while (0)
 
 // Trace logging is everywhere, so this macro allows just that macro to be undefined
 // in order to increase performance
-#define GS_LOG_TRACE_MSG(LEVEL, MSG) BOOST_LOG_FUNCTION();  BOOST_LOG_TRIVIAL(LEVEL) << MSG
+#define GS_LOG_TRACE_MSG(LEVEL, MSG) GS_LOG_MSG(LEVEL, MSG)
 
 }
@@ -58,6 +58,20 @@ public:
 	// begins.
 	static Config incoming_configuration;
 
+	// Compares the ROI of a (possibly sub-sampled) frame with previous_frame, copying the new pixel
+	// values into previous_frame as it goes.  Returns the number of pixels whose change was
+	// more than difference_m * old_value + difference_c.  Stops at the end of the first row at
+	// which that count reaches stop_at_count.
+	// Also used to play back recorded frames without a camera (see gs_replay_camera.h).
+	static unsigned int CountChangedPixels(const uint8_t* image,
+										   unsigned int sampled_frame_stride,
+										   unsigned int hskip,
+										   unsigned int roi_x, unsigned int roi_y,
+										   unsigned int roi_width, unsigned int roi_height,
+										   float difference_m, int difference_c,
+										   unsigned int stop_at_count,
+										   std::vector<uint8_t>& previous_frame);
+
 private:
 	Stream* stream_;
 	// Here we convert the dimensions to pixel locations in the image, as if subsampled
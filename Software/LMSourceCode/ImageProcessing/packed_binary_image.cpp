@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <bit>
+
+#include "logging_tools.h"
+#include "packed_binary_image.h"
+
+
+namespace golf_sim {
+
+    void PackedBinaryImage::Reset(const int rows, const int cols) {
+        rows_ = rows;
+        cols_ = cols;
+
+        const size_t number_words = ((size_t)rows * (size_t)cols + 63) / 64;
+        valid_bits_.assign(number_words, 0);
+        value_bits_.assign(number_words, 0);
+    }
+
+    bool PackedBinaryImage::PackGrayImage(const cv::Mat& gray_image, const uchar ignore_value) {
+
+        if (gray_image.empty() || gray_image.type() != CV_8UC1) {
+            GS_LOG_MSG(error, "PackedBinaryImage::PackGrayImage - image was empty or not CV_8UC1.");
+            Reset(0, 0);
+            return false;
+        }
+
+        Reset(gray_image.rows, gray_image.cols);
+
+        size_t pixel_index = 0;
+        for (int row = 0; row < gray_image.rows; row++) {
+            const uchar* pixels = gray_image.ptr<uchar>(row);
+
+            for (int col = 0; col < gray_image.cols; col++, pixel_index++) {
+                SetPixel(pixel_index, pixels[col], ignore_value);
+            }
+        }
+
+        return true;
+    }
+
+    bool PackedBinaryImage::PackProjectedImage(const cv::Mat& projected_image, const uchar ignore_value) {
+
+        if (projected_image.empty() || projected_image.dims != 2 || projected_image.type() != CV_32SC2) {
+            GS_LOG_MSG(error, "PackedBinaryImage::PackProjectedImage - image was empty or not a 2-D CV_32SC2.");
+            Reset(0, 0);
+            return false;
+        }
+
+        Reset(projected_image.rows, projected_image.cols);
+
+        size_t pixel_index = 0;
+        for (int row = 0; row < projected_image.rows; row++) {
+            const cv::Vec2i* pixels = projected_image.ptr<cv::Vec2i>(row);
+
+            for (int col = 0; col < projected_image.cols; col++, pixel_index++) {
+                SetPixel(pixel_index, (uchar)pixels[col][1], ignore_value);
+            }
+        }
+
+        return true;
+    }
+
+    cv::Vec2i PackedBinaryImage::Compare(const PackedBinaryImage& image1, const PackedBinaryImage& image2) {
+
+        const size_t number_words = std::min(image1.valid_bits_.size(), image2.valid_bits_.size());
+
+        const uint64_t* const valid1 = image1.valid_bits_.data();
+        const uint64_t* const valid2 = image2.valid_bits_.data();
+        const uint64_t* const value1 = image1.value_bits_.data();
+        const uint64_t* const value2 = image2.value_bits_.data();
+
+        // std::popcount compiles to the hardware instruction (popcnt on x86, cnt on the Pi's
+        // ARM cores) when the target supports it
+        int pixels_examined = 0;
+        int pixels_different = 0;
+
+        for (size_t i = 0; i < number_words; i++) {
+            const uint64_t both_valid = valid1[i] & valid2[i];
+            pixels_examined += std::popcount(both_valid);
+            pixels_different += std::popcount(both_valid & (value1[i] ^ value2[i]));
+        }
+
+        return cv::Vec2i(pixels_examined - pixels_different, pixels_examined);
+    }
+
+}
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A 1-bit-per-pixel form of the black/white dimple images that are compared during spin
+// analysis.  Each pixel has a "valid" bit (cleared for pixels that hold the ignore value) and
+// a "value" bit (set for any non-zero pixel).  Two images can then be compared 64 pixels at a
+// time with AND/XOR and a population count instead of one 8-bit (or 64-bit) pixel at a time.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+
+namespace golf_sim {
+
+    class PackedBinaryImage {
+
+    public:
+
+        // Packs a CV_8UC1 image such as the output of ApplyGaborFilterToBall
+        bool PackGrayImage(const cv::Mat& gray_image, const uchar ignore_value);
+
+        // Packs the pixel values (channel 1) of a CV_32SC2 image such as the output of
+        // Project2dImageTo3dBall.  As in the unpacked comparison, each value is treated as a uchar.
+        bool PackProjectedImage(const cv::Mat& projected_image, const uchar ignore_value);
+
+        // Returns (number of pixels that match, number of pixels that were valid in both images).
+        // Both images must have the same dimensions.
+        static cv::Vec2i Compare(const PackedBinaryImage& image1, const PackedBinaryImage& image2);
+
+        int rows() const { return rows_; }
+        int cols() const { return cols_; }
+        bool empty() const { return valid_bits_.empty(); }
+
+        size_t GetSizeBytes() const { return (valid_bits_.size() + value_bits_.size()) * sizeof(uint64_t); }
+
+    protected:
+
+        void Reset(const int rows, const int cols);
+
+        void SetPixel(const size_t pixel_index, const uchar value, const uchar ignore_value) {
+            const uint64_t bit = (uint64_t)1 << (pixel_index % 64);
+            if (value != ignore_value) {
+                valid_bits_[pixel_index / 64] |= bit;
+                if (value != 0) {
+                    value_bits_[pixel_index / 64] |= bit;
+                }
+            }
+        }
+
+        int rows_ = 0;
+        int cols_ = 0;
+
+        // Row-major, 64 pixels per word.  Any bits past the last pixel are always zero.
+        std::vector<uint64_t> valid_bits_;
+        std::vector<uint64_t> value_bits_;
+    };
+
+}
@@ -38,6 +38,7 @@
 #include "pulse_strobe.h"
 #include "logging_tools.h"
 #include "gs_fsm.h"
+#include "gs_frame_monitor.h"
 #include "motion_detect.h"
 
 
@@ -177,11 +178,55 @@ void MotionDetectStage::Configure()
 	}
 }
 
+unsigned int MotionDetectStage::CountChangedPixels(const uint8_t* image,
+												  unsigned int sampled_frame_stride,
+												  unsigned int hskip,
+												  unsigned int roi_x, unsigned int roi_y,
+												  unsigned int roi_width, unsigned int roi_height,
+												  float difference_m, int difference_c,
+												  unsigned int stop_at_count,
+												  std::vector<uint8_t>& previous_frame)
+{
+	unsigned int regions = 0;
+
+	for (unsigned int y = 0; y < roi_height; y++)
+	{
+		const uint8_t* new_value_ptr = image + ((roi_y + y) * sampled_frame_stride) + (roi_x * hskip);
+		uint8_t* old_value_ptr = &previous_frame[0] + y * roi_width;
+		for (unsigned int x = 0; x < roi_width; x++, new_value_ptr += hskip)
+		{
+			int new_value = *new_value_ptr;
+			int old_value = *old_value_ptr;
+
+			*(old_value_ptr++) = new_value;
+			if (std::abs(new_value - old_value) > (difference_m * (float)old_value + difference_c)) {
+				regions++;
+			}
+		}
+
+		// Break out early if we've already figured out there's motion
+		if (regions >= stop_at_count) {
+			break;
+		}
+	}
+
+	return regions;
+}
+
 bool MotionDetectStage::Process(CompletedRequestPtr &completed_request)
 {
 	if (!stream_)
 		return false;
 
+	// Every frame counts toward the frame rate, even those that are not examined below.
+	// Prefer the sensor timestamp, as it ought to be less glitchy than the buffer timestamp.
+	// The buffer's sequence number is the sensor's frame count, which skips any frames that the
+	// sensor captured but that never reached us.  (The request's own sequence number does not.)
+	const libcamera::FrameMetadata &buffer_metadata = completed_request->buffers[stream_]->metadata();
+	auto sensor_timestamp = completed_request->metadata.get(libcamera::controls::SensorTimestamp);
+	int64_t sensor_timestamp_ns = sensor_timestamp ? *sensor_timestamp : buffer_metadata.timestamp;
+	gs::GsFrameMonitor::RecordFrame(buffer_metadata.sequence, sensor_timestamp_ns);
+
 	completed_request->post_process_metadata.Set("motion_detect.result", false);
 
 	if (detectionPaused_ && postMotionFramesToCapture_ <= 0) {
@@ -192,6 +237,7 @@ bool MotionDetectStage::Process(CompletedRequestPtr &completed_request)
 	if (config_.frame_period && completed_request->sequence % config_.frame_period)
 		return false;
 
+	gs::GsFrameMonitor::ScopedProcessingTimer processing_timer;
 
     libcamera::FrameBuffer *buffer = completed_request->buffers[stream_];
 
@@ -239,36 +285,16 @@ bool MotionDetectStage::Process(CompletedRequestPtr &completed_request)
 		local_motion_detected = true;
 	}
 
-	unsigned int regions = 0;
-
 	// Count the  pixels where the difference between the new and previous values
 	// exceeds the threshold. At the same time, update the previous image buffer.
-	for (unsigned int y = 0; !local_motion_detected && y < roi_height_; y++)
+	if (!local_motion_detected)
 	{
-		uint8_t* new_value_ptr = image + ((roi_y_ + y) * sampledFrameStride) + (roi_x_ * config_.hskip);
-		uint8_t* old_value_ptr = &previous_frame_[0] + y * roi_width_;
-		for (unsigned int x = 0; x < roi_width_; x++, new_value_ptr += config_.hskip)
-		{
-			int new_value = *new_value_ptr;
-			int old_value = *old_value_ptr;
-
-			// TBD - Remove
-			// LOG(1, "sampledFrameStride: " << sampledFrameStride << ". old= " << old_value << " new= " << new_value << " .New_ptr: " << (long)new_value_ptr << ".Old_ptr : " << (long)old_value_ptr << ".");
-
-
-			*(old_value_ptr++) = new_value;
-			if (std::abs(new_value - old_value) > (config_.difference_m * (float)old_value + config_.difference_c)) {
-				regions++;
-			}
-		}
+		unsigned int regions = CountChangedPixels(image, sampledFrameStride, config_.hskip,
+												  roi_x_, roi_y_, roi_width_, roi_height_,
+												  config_.difference_m, config_.difference_c,
+												  region_threshold_, previous_frame_);
 
 		local_motion_detected = (regions >= region_threshold_);
-
-		// Break out early if we've already figured out there's motion
-		if (local_motion_detected) {
-			// std::cout << "Motion detected - Regions = " << regions << ", y row value was: " << y << std::endl;
-			break;
-		}
 	}
 
 	// TBD - Only for testing - REMOVE
@@ -20,6 +20,9 @@
 #include <sys/time.h>
 #include <signal.h>
 #include <sys/signalfd.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/mman.h>
 
 #else
 #define NOMINMAX  // Get rid of a std::min/max compile issue
@@ -36,26 +39,21 @@ namespace golf_sim {
 	int PulseStrobe::number_bits_for_fast_on_pulse_ = 0;
 
 	std::vector<float>  PulseStrobe::pulse_intervals_slow_ms_;
+	std::vector<float>  PulseStrobe::pulse_intervals_override_ms_;
 	int PulseStrobe::number_bits_for_slow_on_pulse_ = 0;
 
 	// The on-pulses for the tail repeat vector will be the same
 	// as the slow on pulses
 	std::vector<float>  PulseStrobe::pulse_intervals_tail_repeat_ms_;
 
-	char* PulseStrobe::camera_slow_pulse_sequence_ = nullptr;
-	char* PulseStrobe::camera_fast_pulse_sequence_ = nullptr;
-	char* PulseStrobe::no_pulse_camera_sequence_ = nullptr;
-	char* PulseStrobe::tail_repeat_pulse_sequence_ = nullptr;
-
-	unsigned long PulseStrobe::camera_fast_pulse_sequence_length_ = 0;
-	unsigned long PulseStrobe::camera_slow_pulse_sequence_length_ = 0;
-	unsigned long PulseStrobe::tail_repeat_sequence_length_ = 0;
+	std::unique_ptr<const StrobeProfile> PulseStrobe::strobe_profiles_[StrobeProfile::kNumberStrobeProfiles];
 
 	int PulseStrobe::spiHandle_ = -1;
 	int PulseStrobe::lggpio_chip_handle_ = -1;
 	bool PulseStrobe::spiOpen_ = false;
 	bool PulseStrobe::kRecordAllImages = true;
 	bool PulseStrobe::gpio_system_initialized_ = false;
+	std::shared_ptr<PulseStrobeBackend> PulseStrobe::backend_ = nullptr;
 	int PulseStrobe::kPuttingStrobeDelayMs = 0;
 
 	int PulseStrobe::kLastPulsePutterRepeats = 5;
@@ -94,6 +92,70 @@ namespace golf_sim {
 	const int kTestPeriodSecs = 10; //  120;
 
 
+	void PulseStrobe::SetBackend(std::shared_ptr<PulseStrobeBackend> backend) {
+		if (gpio_system_initialized_) {
+			GS_LOG_MSG(warning, "PulseStrobe::SetBackend called after the GPIO system was initialized.");
+		}
+
+		backend_ = backend;
+		GS_LOG_TRACE_MSG(trace, "PulseStrobe backend set to: " + (backend_ == nullptr ? std::string("<none>") : backend_->GetName()));
+	}
+
+	PulseStrobeBackend& PulseStrobe::GetBackend() {
+		if (backend_ == nullptr) {
+#ifdef __unix__  // Ignore in Windows environment
+			// A replayed camera (see gs_replay_camera.h) has no strobe hardware either
+			if (GolfSimOptions::GetCommandLineOptions().simulate_strobe_hardware_ ||
+				!GolfSimOptions::GetCommandLineOptions().replay_camera_dir_.empty()) {
+				backend_ = std::make_shared<SimulatedStrobeBackend>();
+			}
+			else {
+				backend_ = std::make_shared<LgpioStrobeBackend>();
+			}
+#else
+			backend_ = std::make_shared<SimulatedStrobeBackend>();
+#endif
+			GS_LOG_TRACE_MSG(trace, "PulseStrobe using default backend: " + backend_->GetName());
+		}
+
+		return *backend_;
+	}
+
+	bool PulseStrobe::ElevateCurrentThreadForStrobing(int cpu_number) {
+#ifdef __unix__  // Ignore in Windows environment
+		bool success = true;
+
+		// Avoid page faults in the middle of a strobe sequence
+		if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+			GS_LOG_MSG(warning, "PulseStrobe::ElevateCurrentThreadForStrobing - mlockall failed.  errno = " + std::to_string(errno));
+			success = false;
+		}
+
+		if (cpu_number >= 0) {
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(cpu_number, &cpu_set);
+
+			if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+				GS_LOG_MSG(warning, "PulseStrobe::ElevateCurrentThreadForStrobing - could not pin thread to cpu " + std::to_string(cpu_number));
+				success = false;
+			}
+		}
+
+		struct sched_param sched_parameters;
+		sched_parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+
+		if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sched_parameters) != 0) {
+			GS_LOG_MSG(warning, "PulseStrobe::ElevateCurrentThreadForStrobing - could not set SCHED_FIFO priority.  Are we running with CAP_SYS_NICE?");
+			success = false;
+		}
+
+		return success;
+#else
+		return false;
+#endif // #ifdef __unix__  // Ignore in Windows environment
+	}
+
 	int PulseStrobe::AlignLengthToWordSize(int initialBufferLength, int wordSizeBits) {
 
 		int leftOver = initialBufferLength % (wordSizeBits / 8);
@@ -287,7 +349,7 @@ namespace golf_sim {
 
 		if (spiOpen_) {
 			GS_LOG_TRACE_MSG(trace, "Spi already opened - closing before re-opening.  Handle was: " + std::to_string(lggpio_chip_handle_));
-			lgSpiClose(spiHandle_);
+			GetBackend().SpiClose(spiHandle_);
 			spiHandle_ = -1;
 			spiOpen_ = false;
 		}
@@ -314,7 +376,7 @@ namespace golf_sim {
 
 		// TBD - Setup flags to allow for multi-byte (32-bit) 
 		// transfers
-		spi_handle = lgSpiOpen(kRPi5SpiDeviceNumber, kRPi5SpiDevChannel, baud, lgSpiFlags);
+		spi_handle = GetBackend().SpiOpen(kRPi5SpiDeviceNumber, kRPi5SpiDevChannel, baud, lgSpiFlags);
 
 		if (spi_handle < 0) {
 			GS_LOG_MSG(error, "lgSpiOpen failed.  Returned" + std::to_string(spi_handle));
@@ -334,49 +396,40 @@ namespace golf_sim {
 
 	bool PulseStrobe::SendCameraStrobeTriggerAndShutter(int lgGpioHandle, bool send_no_strobes) {
 
-		// The pulse sequence should have been pre-computed prior to calling this
-		unsigned long result_length = 0;
-		char* buf = 0;
+		// The pulse sequence should have been pre-compiled prior to calling this
+		StrobeProfileId profile_id = GetStrobeProfileIdForCurrentClub();
 
 		if (send_no_strobes) {
 			// DEPRECATED - REMOVE
 			GS_LOG_MSG(error, "SendCameraStrobeTriggerAndShutter sending dummy strobe sequence (with no ON strobes).");
-			buf = camera_fast_pulse_sequence_;
-			result_length = camera_fast_pulse_sequence_length_;
-		}
-		else {
-			if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
-				buf = camera_slow_pulse_sequence_;
-				result_length = camera_slow_pulse_sequence_length_;
-			}
-			else {
-				buf = camera_fast_pulse_sequence_;
-				result_length = camera_fast_pulse_sequence_length_;
-			}
+			profile_id = StrobeProfileId::kDriver;
 		}
 
-		if (camera_fast_pulse_sequence_length_ == 0 || 
-			camera_slow_pulse_sequence_length_ == 0 || 
-			buf == nullptr ) {
-			GS_LOG_MSG(error, "SendCameraStrobeTriggerAndShutter called before camera_pulse_sequence was set up.");
+		const StrobeProfile* profile = GetStrobeProfile(profile_id);
+
+		if (profile == nullptr || profile->GetLength() == 0) {
+			GS_LOG_MSG(error, "SendCameraStrobeTriggerAndShutter called before the strobe profiles were set up.");
 			return false;
 		}
 
+		const char* buf = profile->GetBuffer();
+		const unsigned long result_length = profile->GetLength();
+
 		// For putting mode, we need to wait a bit to ensure the ball is in the frame
 
 #ifdef __unix__  // Ignore in Windows environment
 
 		if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
 			// TBD - CHANGES TIMING - GS_LOG_TRACE_MSG(trace, "In putting mode.  Waiting " + std::to_string(kPuttingStrobeDelayMs) + "ms before trigger.");
-			usleep(1000 * kPuttingStrobeDelayMs);
+			GetBackend().SleepMicroseconds(1000 * kPuttingStrobeDelayMs);
 		}
 
 
 		// Open shutter - 
 		// Note - the hardware will invert the signal to the XTR camera trigger
-		lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kON);
+		GetBackend().GpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kON);
 
-		int bytes_sent = lgSpiWrite(spiHandle_, buf, result_length);
+		int bytes_sent = GetBackend().SpiWrite(spiHandle_, buf, result_length);
 		bool shutter_failure = false;
 
 		if (bytes_sent != (int)result_length) {
@@ -418,9 +471,9 @@ namespace golf_sim {
 		*****/
 
 		// Close shutter
-		lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
+		GetBackend().GpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
 
-		GS_LOG_TRACE_MSG(trace, "SendCameraStrobeTriggerAndShutter sent pulse sequence of length = " + std::to_string(camera_fast_pulse_sequence_length_) + " bytes.");
+		GS_LOG_TRACE_MSG(trace, "SendCameraStrobeTriggerAndShutter sent pulse sequence of length = " + std::to_string(result_length) + " bytes.");
 
 
 
@@ -440,15 +493,15 @@ namespace golf_sim {
 #ifdef __unix__  // Ignore in Windows environment
 
 		if (GolfSimConfiguration::GetPiModel() == GolfSimConfiguration::PiModel::kRPi5) {
-			lggpio_chip_handle_ = lgGpiochipOpen(kRPi5GpioChipNumber);
+			lggpio_chip_handle_ = GetBackend().GpiochipOpen(kRPi5GpioChipNumber);
 		}
 		else {
-			lggpio_chip_handle_ = lgGpiochipOpen(kRPi4GpioChipNumber);
+			lggpio_chip_handle_ = GetBackend().GpiochipOpen(kRPi4GpioChipNumber);
 		}
 
 		if (lggpio_chip_handle_ < 0) {
 			GS_LOG_MSG(trace, "PulseStrobe::InitGPIOSystem failed to initialize (lgGpioChipOpen). Attempting with different chip number kRPi4GpioChipNumber.");
-			lggpio_chip_handle_ = lgGpiochipOpen(kRPi4GpioChipNumber);
+			lggpio_chip_handle_ = GetBackend().GpiochipOpen(kRPi4GpioChipNumber);
 		}
 
 		if (lggpio_chip_handle_ < 0) {
@@ -456,12 +509,12 @@ namespace golf_sim {
 			return false;
 		}
 
-		if (lgGpioClaimOutput(lggpio_chip_handle_, 0, kPulseTriggerOutputPin, 0) != LG_OKAY) {
+		if (GetBackend().GpioClaimOutput(lggpio_chip_handle_, 0, kPulseTriggerOutputPin, 0) != LG_OKAY) {
 			GS_LOG_MSG(error, "PulseStrobe::InitGPIOSystem failed to ClaimOutput pin");
 			return false;
 		}
 
-		lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
+		GetBackend().GpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
 
 		if (callback_function != nullptr) {
 			/* TBD
@@ -493,18 +546,18 @@ namespace golf_sim {
 		GolfSimConfiguration::SetConstant("gs_config.strobing.kBaudRateForFastPulses", kBaudRateForFastPulses);
 		GolfSimConfiguration::SetConstant("gs_config.strobing.kBaudRateForSlowPulses", kBaudRateForSlowPulses);
 
-		// Pre-compute the pulse sequences to save time later
+		// Pre-compile every strobe profile so that the trigger path only has to select one
 		GS_LOG_TRACE_MSG(trace, "Building Fast pulse sequence.");
-		camera_fast_pulse_sequence_ = PulseStrobe::BuildPulseTrain((unsigned long)kBaudRateForFastPulses, pulse_intervals_fast_ms_, number_bits_for_fast_on_pulse_,
-														kBitsPerWord, camera_fast_pulse_sequence_length_, false);
+		strobe_profiles_[(int)StrobeProfileId::kDriver] = StrobeProfile::Compile(StrobeProfileId::kDriver, "driver",
+														(unsigned long)kBaudRateForFastPulses, pulse_intervals_fast_ms_, number_bits_for_fast_on_pulse_, kBitsPerWord);
 		GS_LOG_TRACE_MSG(trace, "Building Slow pulse sequence.");
-		camera_slow_pulse_sequence_ = PulseStrobe::BuildPulseTrain((unsigned long)kBaudRateForSlowPulses, pulse_intervals_slow_ms_, number_bits_for_slow_on_pulse_,
-														kBitsPerWord, camera_slow_pulse_sequence_length_, false);
+		strobe_profiles_[(int)StrobeProfileId::kPutter] = StrobeProfile::Compile(StrobeProfileId::kPutter, "putter",
+														(unsigned long)kBaudRateForSlowPulses, pulse_intervals_slow_ms_, number_bits_for_slow_on_pulse_, kBitsPerWord);
 		GS_LOG_TRACE_MSG(trace, "Building follow-on pulse sequence.");
-		tail_repeat_pulse_sequence_ = PulseStrobe::BuildPulseTrain((unsigned long)kBaudRateForSlowPulses, pulse_intervals_tail_repeat_ms_, number_bits_for_slow_on_pulse_,
-			kBitsPerWord, tail_repeat_sequence_length_, false);
+		strobe_profiles_[(int)StrobeProfileId::kPutterTailRepeat] = StrobeProfile::Compile(StrobeProfileId::kPutterTailRepeat, "putter_tail_repeat",
+														(unsigned long)kBaudRateForSlowPulses, pulse_intervals_tail_repeat_ms_, number_bits_for_slow_on_pulse_, kBitsPerWord);
 
-		if (camera_fast_pulse_sequence_ == nullptr || camera_slow_pulse_sequence_ == nullptr) {
+		if (strobe_profiles_[(int)StrobeProfileId::kDriver] == nullptr || strobe_profiles_[(int)StrobeProfileId::kPutter] == nullptr) {
 			GS_LOG_MSG(error, "Failed to build pulse sequences.");
 			return false;
 		}
@@ -518,26 +571,31 @@ namespace golf_sim {
 		GS_LOG_TRACE_MSG(trace, "PulseStrobe::DeinitGPIOSystem.");
 
 		if (spiOpen_) {
-			lgSpiClose(spiHandle_);
+			GetBackend().SpiClose(spiHandle_);
 			spiHandle_ = -1;
 			spiOpen_ = false;
 		}
 
-		lgGpiochipClose(lggpio_chip_handle_);
+		GetBackend().GpiochipClose(lggpio_chip_handle_);
 		lggpio_chip_handle_ = -1;
 		std::this_thread::yield();
 
 #endif // #ifdef __unix__  // Ignore in Windows environment
 
+		// The profiles will be re-compiled (possibly from new settings) by the next InitGPIOSystem
+		for (std::unique_ptr<const StrobeProfile>& profile : strobe_profiles_) {
+			profile.reset();
+		}
+
 		gpio_system_initialized_ = false;
 		return true;
 	}
 
 	void PulseStrobe::SendOnOffPulse(long length_us) {
 #ifdef __unix__  // Ignore in Windows environment
-		lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kON);
-		usleep(length_us);
-		lgGpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
+		GetBackend().GpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kON);
+		GetBackend().SleepMicroseconds(length_us);
+		GetBackend().GpioWrite(lggpio_chip_handle_, kPulseTriggerOutputPin, kOFF);
 #endif // #ifdef __unix__  // Ignore in Windows environment
 	}
 
@@ -677,7 +735,7 @@ namespace golf_sim {
 
 			long kPauseBeforeSendingImageFlushMs = 0;
 			GolfSimConfiguration::SetConstant("gs_config.cameras.kPauseBeforeSendingImageFlushMs", kPauseBeforeSendingImageFlushMs);
-			usleep(kPauseBeforeSendingImageFlushMs * 1000);
+			GetBackend().SleepMicroseconds(kPauseBeforeSendingImageFlushMs * 1000);
 
 
 			GS_LOG_TRACE_MSG(trace, "Sending additional trigger to flush last frame.");
@@ -689,8 +747,30 @@ namespace golf_sim {
 
 
 
+	const StrobeProfile* PulseStrobe::GetStrobeProfile(StrobeProfileId profile_id) {
+		const int index = (int)profile_id;
+
+		if (index < 0 || index >= StrobeProfile::kNumberStrobeProfiles) {
+			return nullptr;
+		}
+
+		return strobe_profiles_[index].get();
+	}
+
+	StrobeProfileId PulseStrobe::GetStrobeProfileIdForCurrentClub() {
+		if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
+			return StrobeProfileId::kPutter;
+		}
+
+		return StrobeProfileId::kDriver;
+	}
+
 	const std::vector<float> PulseStrobe::GetPulseIntervals() {
 
+		if (!pulse_intervals_override_ms_.empty()) {
+			return pulse_intervals_override_ms_;
+		}
+
 		std::vector<float> intervals;
 
 		if (GolfSimClubs::GetCurrentClubType() == GolfSimClubs::GsClubType::kPutter) {
@@ -709,6 +789,14 @@ namespace golf_sim {
 
 		return intervals;
 	}
+
+	const std::vector<float> PulseStrobe::GetPulseIntervalsOverride() {
+		return pulse_intervals_override_ms_;
+	}
+
+	void PulseStrobe::SetPulseIntervalsOverride(const std::vector<float>& intervals_ms) {
+		pulse_intervals_override_ms_ = intervals_ms;
+	}
 } // namespace golf_sim
 
 
@@ -9,9 +9,12 @@
 #pragma once
 
 
+#include <memory>
 #include <vector>
 
 #include "logging_tools.h"
+#include "pulse_strobe_backend.h"
+#include "pulse_strobe_profile.h"
 
 
 namespace golf_sim {
@@ -48,10 +51,10 @@ namespace golf_sim {
 		static bool SendCameraPrimingPulses(bool use_high_speed);
 		static bool SendExternalTrigger();
 
-		// Sends the already-created pulse buffer to the strobes via SPI, and also
-		// opens the shutter while the pulses are sent.
-		// requires the camera_fast_pulse_sequence_ to have already been created by
-		// the BuildPulseTrain function.
+		// Sends the already-compiled strobe profile for the current club to the strobes
+		// via SPI, and also opens the shutter while the pulses are sent.
+		// Requires the strobe profiles to have already been compiled by InitGPIOSystem.
+		// Nothing is built or allocated here.
 		// send_no_strobes can be set to true in order to get a "before" or "pre" image
 		// that shows just the ambient light.
 		static bool SendCameraStrobeTriggerAndShutter(int spiHandle, bool send_no_strobes = false);
@@ -73,12 +76,39 @@ namespace golf_sim {
 
 		static const std::vector<float> GetPulseIntervals();
 
+		// While set (non-empty), GetPulseIntervals returns these intervals instead of the
+		// configured ones.  Used to re-analyze a captured shot with the intervals that were
+		// in effect when it was taken.
+		static void SetPulseIntervalsOverride(const std::vector<float>& intervals_ms);
+		static const std::vector<float> GetPulseIntervalsOverride();
+
+		// Returns nullptr if the profile has not been compiled (e.g., before InitGPIOSystem)
+		static const StrobeProfile* GetStrobeProfile(StrobeProfileId profile_id);
+
+		// The driver or putter profile, depending on the currently-selected club
+		static StrobeProfileId GetStrobeProfileIdForCurrentClub();
+
 		static void SendOnOffPulse(long length_us);
 
 		static bool kRecordAllImages;
 
+		// All GPIO and SPI access goes through the backend.  If no backend has been set,
+		// the first call will create one - the lgpio backend on the Pi, or the simulated
+		// backend if the simulate_strobe_hardware command-line option was given.
+		// Set any backend before calling InitGPIOSystem.
+		static void SetBackend(std::shared_ptr<PulseStrobeBackend> backend);
+		static PulseStrobeBackend& GetBackend();
+
+		// Gives the calling thread a real-time (SCHED_FIFO) priority and pins it to the
+		// specified cpu (if >= 0) so that the strobe timing is less subject to
+		// scheduling delays.  Usually requires root or CAP_SYS_NICE.
+		// Returns false if the thread could not be elevated.
+		static bool ElevateCurrentThreadForStrobing(int cpu_number = -1);
+
 	protected:
 
+		static std::shared_ptr<PulseStrobeBackend> backend_;
+
 		// This vector describes the amount of time to send 0's after sending a strobe
 		// pulse.  The last pulse should be of size 0 to ensure the pulse sequence ends
 		// with the pulse turned OFF.
@@ -87,19 +117,14 @@ namespace golf_sim {
 		static std::vector<float> pulse_intervals_fast_ms_;
 		static std::vector<float> pulse_intervals_slow_ms_;
 		static std::vector<float> pulse_intervals_tail_repeat_ms_;
+		static std::vector<float> pulse_intervals_override_ms_;
 
 		static int number_bits_for_fast_on_pulse_;
 		static int number_bits_for_slow_on_pulse_;
 
-		// This is the buffer that will be written out (bit-banged) to the SPI channel
-		static char* camera_slow_pulse_sequence_;
-		static char* camera_fast_pulse_sequence_;
-		static char* no_pulse_camera_sequence_;  // Will be all 0's, but the same length as the 'real' pulse sequence
-		static unsigned long camera_fast_pulse_sequence_length_;
-		static unsigned long camera_slow_pulse_sequence_length_;
-
-		static char* tail_repeat_pulse_sequence_;
-		static unsigned long tail_repeat_sequence_length_;
+		// The pre-built buffers that will be written out (bit-banged) to the SPI channel,
+		// indexed by StrobeProfileId
+		static std::unique_ptr<const StrobeProfile> strobe_profiles_[StrobeProfile::kNumberStrobeProfiles];
 
 		static int kPuttingStrobeDelayMs;
 
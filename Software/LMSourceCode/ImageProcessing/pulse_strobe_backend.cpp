@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+#include <lgpio.h>
+#include <unistd.h>
+#endif
+
+#include <thread>
+
+#include "logging_tools.h"
+#include "pulse_strobe_backend.h"
+
+
+namespace golf_sim {
+
+	void PulseStrobeBackend::SleepMicroseconds(long time_us) {
+		if (time_us > 0) {
+			std::this_thread::sleep_for(std::chrono::microseconds(time_us));
+		}
+	}
+
+
+#ifdef __unix__  // Ignore in Windows environment
+
+	int LgpioStrobeBackend::GpiochipOpen(int chip_number) {
+		return lgGpiochipOpen(chip_number);
+	}
+
+	int LgpioStrobeBackend::GpiochipClose(int chip_handle) {
+		return lgGpiochipClose(chip_handle);
+	}
+
+	int LgpioStrobeBackend::GpioClaimOutput(int chip_handle, int flags, int pin, int level) {
+		return lgGpioClaimOutput(chip_handle, flags, pin, level);
+	}
+
+	int LgpioStrobeBackend::GpioWrite(int chip_handle, int pin, int level) {
+		return lgGpioWrite(chip_handle, pin, level);
+	}
+
+	int LgpioStrobeBackend::SpiOpen(int spi_device, int spi_channel, int baud, int flags) {
+		return lgSpiOpen(spi_device, spi_channel, baud, flags);
+	}
+
+	int LgpioStrobeBackend::SpiClose(int spi_handle) {
+		return lgSpiClose(spi_handle);
+	}
+
+	int LgpioStrobeBackend::SpiWrite(int spi_handle, const char* buf, int count) {
+		return lgSpiWrite(spi_handle, buf, count);
+	}
+
+	void LgpioStrobeBackend::SleepMicroseconds(long time_us) {
+		// Keep the same usleep-based timing that the strobe code has always used on the Pi
+		usleep(time_us);
+	}
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+
+	SimulatedStrobeBackend::SimulatedStrobeBackend(bool simulate_spi_transfer_time) {
+		simulate_spi_transfer_time_ = simulate_spi_transfer_time;
+		edges_.reserve(kMaxRecordedEdges);
+	}
+
+	int SimulatedStrobeBackend::GpiochipOpen(int chip_number) {
+		GS_LOG_TRACE_MSG(trace, "SimulatedStrobeBackend::GpiochipOpen(" + std::to_string(chip_number) + ")");
+		return next_chip_handle_++;
+	}
+
+	int SimulatedStrobeBackend::GpiochipClose(int chip_handle) {
+		return 0;
+	}
+
+	int SimulatedStrobeBackend::GpioClaimOutput(int chip_handle, int flags, int pin, int level) {
+		if (pin < 0) {
+			return -1;
+		}
+
+		if ((int)pin_levels_.size() <= pin) {
+			pin_levels_.resize(pin + 1, -1);
+		}
+
+		pin_levels_[pin] = level;
+		return 0;
+	}
+
+	int SimulatedStrobeBackend::GpioWrite(int chip_handle, int pin, int level) {
+		if (pin < 0 || pin >= (int)pin_levels_.size()) {
+			GS_LOG_MSG(error, "SimulatedStrobeBackend::GpioWrite called for unclaimed pin " + std::to_string(pin));
+			return -1;
+		}
+
+		if (pin_levels_[pin] != level) {
+			RecordEdge((level != 0) ? StrobeEdgeEvent::kGpioHigh : StrobeEdgeEvent::kGpioLow, pin);
+			pin_levels_[pin] = level;
+		}
+
+		return 0;
+	}
+
+	int SimulatedStrobeBackend::SpiOpen(int spi_device, int spi_channel, int baud, int flags) {
+		GS_LOG_TRACE_MSG(trace, "SimulatedStrobeBackend::SpiOpen with baud = " + std::to_string(baud));
+
+		if (baud <= 0) {
+			return -1;
+		}
+
+		spi_baud_ = baud;
+		return next_spi_handle_++;
+	}
+
+	int SimulatedStrobeBackend::SpiClose(int spi_handle) {
+		return 0;
+	}
+
+	double SimulatedStrobeBackend::GetNominalSpiTransferTimeUs(int number_bytes) const {
+		if (spi_baud_ <= 0) {
+			return 0.0;
+		}
+
+		return (number_bytes * 8.0 * 1000000.0) / (double)spi_baud_;
+	}
+
+	int SimulatedStrobeBackend::SpiWrite(int spi_handle, const char* buf, int count) {
+		if (buf == nullptr || count < 0) {
+			return -1;
+		}
+
+		const auto transfer_start = std::chrono::steady_clock::now();
+		RecordEdge(StrobeEdgeEvent::kSpiWriteStart, -1, count);
+
+		if (simulate_spi_transfer_time_) {
+			const auto transfer_time = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double, std::micro>(GetNominalSpiTransferTimeUs(count)));
+
+			// Like lgSpiWrite, block the caller while the (simulated) bits are clocked out.
+			std::this_thread::sleep_until(transfer_start + transfer_time);
+		}
+
+		RecordEdge(StrobeEdgeEvent::kSpiWriteEnd, -1, count);
+
+		return count;
+	}
+
+	void SimulatedStrobeBackend::RecordEdge(StrobeEdgeEvent::EdgeType edge_type, int pin, int number_bytes) {
+		// Take the timestamp before the lock so that the lock does not skew it
+		const auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(edges_mutex_);
+
+		if (edges_.size() >= kMaxRecordedEdges) {
+			number_dropped_edges_++;
+			return;
+		}
+
+		StrobeEdgeEvent edge;
+		edge.edge_type = edge_type;
+		edge.pin = pin;
+		edge.number_bytes = number_bytes;
+		edge.timestamp = now;
+
+		edges_.push_back(edge);
+	}
+
+	std::vector<StrobeEdgeEvent> SimulatedStrobeBackend::GetEdges() {
+		std::lock_guard<std::mutex> lock(edges_mutex_);
+		return edges_;
+	}
+
+	void SimulatedStrobeBackend::ClearEdges() {
+		std::lock_guard<std::mutex> lock(edges_mutex_);
+		edges_.clear();
+		number_dropped_edges_ = 0;
+	}
+
+}
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Abstracts the GPIO and SPI hardware that the PulseStrobe class uses to open the
+// camera2 shutter and fire the strobes.  The lgpio backend drives the real Pi hardware.
+// The simulated backend timestamps every "edge" so that trigger-to-strobe timing can be
+// measured and regression-tested on machines that do not have the strobe hardware.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace golf_sim {
+
+	// The return-value conventions follow lgpio's:  handles are >= 0 on success,
+	// and negative values indicate an error.
+	class PulseStrobeBackend {
+
+	public:
+
+		virtual ~PulseStrobeBackend() {}
+
+		virtual std::string GetName() const = 0;
+
+		virtual int GpiochipOpen(int chip_number) = 0;
+		virtual int GpiochipClose(int chip_handle) = 0;
+		virtual int GpioClaimOutput(int chip_handle, int flags, int pin, int level) = 0;
+		virtual int GpioWrite(int chip_handle, int pin, int level) = 0;
+
+		virtual int SpiOpen(int spi_device, int spi_channel, int baud, int flags) = 0;
+		virtual int SpiClose(int spi_handle) = 0;
+
+		// Returns the number of bytes written, which will only be less than count on error
+		virtual int SpiWrite(int spi_handle, const char* buf, int count) = 0;
+
+		// Used for the delays in the strobe path so that a backend can observe (or
+		// replace) them.  The default just sleeps the calling thread.
+		virtual void SleepMicroseconds(long time_us);
+	};
+
+
+#ifdef __unix__  // Ignore in Windows environment
+
+	// Pass-through to the lgpio library.  This is the backend used on a real Pi.
+	class LgpioStrobeBackend : public PulseStrobeBackend {
+
+	public:
+
+		std::string GetName() const override { return "lgpio"; }
+
+		int GpiochipOpen(int chip_number) override;
+		int GpiochipClose(int chip_handle) override;
+		int GpioClaimOutput(int chip_handle, int flags, int pin, int level) override;
+		int GpioWrite(int chip_handle, int pin, int level) override;
+
+		int SpiOpen(int spi_device, int spi_channel, int baud, int flags) override;
+		int SpiClose(int spi_handle) override;
+		int SpiWrite(int spi_handle, const char* buf, int count) override;
+
+		void SleepMicroseconds(long time_us) override;
+	};
+
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+
+	// One timestamped signal change (or SPI transfer boundary) seen by the simulated backend
+	struct StrobeEdgeEvent {
+
+		enum EdgeType {
+			kGpioHigh = 0,
+			kGpioLow = 1,
+			kSpiWriteStart = 2,
+			kSpiWriteEnd = 3
+		};
+
+		EdgeType edge_type = kGpioLow;
+		int pin = -1;
+		// Only set for SPI events
+		int number_bytes = 0;
+		std::chrono::steady_clock::time_point timestamp;
+	};
+
+
+	class SimulatedStrobeBackend : public PulseStrobeBackend {
+
+	public:
+
+		// The edge log is pre-allocated so that recording an edge on the strobe
+		// path never allocates.  Edges beyond this number are dropped (and counted).
+		static constexpr size_t kMaxRecordedEdges = 100000;
+
+		// If simulate_spi_transfer_time is true, SpiWrite will not return until the time
+		// that the SPI hardware would need to clock out the buffer at the opened baud rate
+		// has elapsed.  This mimics the blocking behavior of lgSpiWrite.
+		SimulatedStrobeBackend(bool simulate_spi_transfer_time = true);
+
+		std::string GetName() const override { return "simulated"; }
+
+		int GpiochipOpen(int chip_number) override;
+		int GpiochipClose(int chip_handle) override;
+		int GpioClaimOutput(int chip_handle, int flags, int pin, int level) override;
+		int GpioWrite(int chip_handle, int pin, int level) override;
+
+		int SpiOpen(int spi_device, int spi_channel, int baud, int flags) override;
+		int SpiClose(int spi_handle) override;
+		int SpiWrite(int spi_handle, const char* buf, int count) override;
+
+		// Returns a copy of the edges recorded so far, in time order
+		std::vector<StrobeEdgeEvent> GetEdges();
+
+		void ClearEdges();
+
+		long GetNumberDroppedEdges() const { return number_dropped_edges_; }
+
+		// The nominal time it takes to clock out number_bytes at the current baud rate
+		double GetNominalSpiTransferTimeUs(int number_bytes) const;
+
+	protected:
+
+		void RecordEdge(StrobeEdgeEvent::EdgeType edge_type, int pin, int number_bytes = 0);
+
+		bool simulate_spi_transfer_time_ = true;
+		int spi_baud_ = 0;
+		int next_spi_handle_ = 0;
+		int next_chip_handle_ = 0;
+		// The last level written to each pin, so that repeated writes of the same
+		// level are not logged as edges
+		std::vector<int> pin_levels_;
+
+		std::mutex edges_mutex_;
+		std::vector<StrobeEdgeEvent> edges_;
+		long number_dropped_edges_ = 0;
+	};
+
+}
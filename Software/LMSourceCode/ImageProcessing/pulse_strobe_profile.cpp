@@ -0,0 +1,212 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#ifdef __unix__  // Ignore in Windows environment
+#include <sys/mman.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <new>
+
+#include "logging_tools.h"
+#include "gs_config.h"
+#include "pulse_strobe.h"
+#include "pulse_strobe_profile.h"
+
+
+namespace golf_sim {
+
+	// BuildPulseTrain rounds each interval to the nearest bit, so the spacing between
+	// pulses should never be off by more than this
+	static const double kMaxPulseSpacingErrorBits = 1.5;
+
+	// The final off-period is also affected by the padding out to a whole SPI word
+	static const double kMaxTrailingIntervalErrorBits = 16.0;
+
+
+	std::unique_ptr<const StrobeProfile> StrobeProfile::Compile(const StrobeProfileId id,
+																const std::string& name,
+																const unsigned long baud_rate,
+																const std::vector<float>& intervals_ms,
+																const int number_bits_for_on_pulse,
+																const unsigned int bits_per_word) {
+
+		GS_LOG_TRACE_MSG(trace, "StrobeProfile::Compile - building profile " + name + " at " + std::to_string(baud_rate) + " baud.");
+
+		if (intervals_ms.empty() || baud_rate == 0) {
+			GS_LOG_MSG(error, "StrobeProfile::Compile - profile " + name + " has no intervals or no baud rate.");
+			return nullptr;
+		}
+
+		unsigned long pulse_train_length = 0;
+		char* pulse_train = PulseStrobe::BuildPulseTrain(baud_rate, intervals_ms, number_bits_for_on_pulse,
+														 bits_per_word, pulse_train_length, false);
+
+		if (pulse_train == nullptr || pulse_train_length == 0) {
+			GS_LOG_MSG(error, "StrobeProfile::Compile - failed to build pulse train for profile " + name);
+			delete[] pulse_train;
+			return nullptr;
+		}
+
+		// Use the same multiplier that BuildPulseTrain used so that the buffer can be decoded
+		double kBaudRatePulseMultiplier = 1.0;
+		GolfSimConfiguration::SetConstant("gs_config.strobing.kBaudRatePulseMultiplier", kBaudRatePulseMultiplier);
+
+		std::unique_ptr<StrobeProfile> profile(new StrobeProfile());
+		profile->id_ = id;
+		profile->name_ = name;
+		profile->baud_rate_ = baud_rate;
+		profile->effective_bits_per_second_ = (double)baud_rate * kBaudRatePulseMultiplier;
+		profile->intervals_ms_ = intervals_ms;
+		profile->number_bits_for_on_pulse_ = number_bits_for_on_pulse;
+
+		profile->length_ = pulse_train_length;
+		profile->allocated_length_ = ((pulse_train_length + kBufferAlignmentBytes - 1) / kBufferAlignmentBytes) * kBufferAlignmentBytes;
+		profile->buffer_ = static_cast<char*>(::operator new[](profile->allocated_length_, std::align_val_t(kBufferAlignmentBytes)));
+
+		memset(profile->buffer_, 0, profile->allocated_length_);
+		memcpy(profile->buffer_, pulse_train, pulse_train_length);
+		delete[] pulse_train;
+
+#ifdef __unix__  // Ignore in Windows environment
+		// Keep the buffer resident so that the SPI write can never take a page fault
+		if (mlock(profile->buffer_, profile->allocated_length_) == 0) {
+			profile->page_locked_ = true;
+		}
+		else {
+			GS_LOG_MSG(warning, "StrobeProfile::Compile - could not page-lock the buffer for profile " + name + ".  errno = " + std::to_string(errno));
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+		if (!profile->Verify()) {
+			GS_LOG_MSG(error, "StrobeProfile::Compile - the pulse train for profile " + name + " does not match its configured intervals.");
+			return nullptr;
+		}
+
+		GS_LOG_TRACE_MSG(trace, "StrobeProfile::Compile - profile " + name + " is " + std::to_string(profile->length_) + " bytes.");
+
+		return profile;
+	}
+
+	StrobeProfile::~StrobeProfile() {
+		if (buffer_ == nullptr) {
+			return;
+		}
+
+#ifdef __unix__  // Ignore in Windows environment
+		if (page_locked_) {
+			munlock(buffer_, allocated_length_);
+		}
+#endif // #ifdef __unix__  // Ignore in Windows environment
+
+		::operator delete[](buffer_, std::align_val_t(kBufferAlignmentBytes));
+		buffer_ = nullptr;
+	}
+
+	std::vector<float> StrobeProfile::DecodePulseIntervalsMs() const {
+
+		std::vector<float> decoded_intervals_ms;
+
+		if (buffer_ == nullptr || effective_bits_per_second_ <= 0.0) {
+			return decoded_intervals_ms;
+		}
+
+		const double ms_per_bit = 1000.0 / effective_bits_per_second_;
+		const unsigned long total_bits = length_ * 8;
+
+		// Bits go out on the wire most-significant bit first
+		long last_pulse_start_bit = -1;
+		bool prior_bit_on = false;
+
+		for (unsigned long bit_index = 0; bit_index < total_bits; bit_index++) {
+			const unsigned char byte_value = (unsigned char)buffer_[bit_index / 8];
+			const bool bit_on = ((byte_value >> (7 - (bit_index % 8))) & 0x01) != 0;
+
+			if (bit_on && !prior_bit_on) {
+				if (last_pulse_start_bit >= 0) {
+					decoded_intervals_ms.push_back((float)((bit_index - last_pulse_start_bit) * ms_per_bit));
+				}
+				last_pulse_start_bit = (long)bit_index;
+			}
+
+			prior_bit_on = bit_on;
+		}
+
+		if (last_pulse_start_bit >= 0) {
+			decoded_intervals_ms.push_back((float)((total_bits - last_pulse_start_bit) * ms_per_bit));
+		}
+
+		return decoded_intervals_ms;
+	}
+
+	bool StrobeProfile::Verify() const {
+
+		const std::vector<float> decoded_intervals_ms = DecodePulseIntervalsMs();
+
+		LoggingTools::Trace("StrobeProfile::Verify - decoded pulse intervals for " + name_ + " are:", decoded_intervals_ms);
+
+		if (decoded_intervals_ms.empty()) {
+			GS_LOG_MSG(error, "StrobeProfile::Verify - profile " + name_ + " contains no strobe pulses.");
+			return false;
+		}
+
+		// The still-picture and calibration modes deliberately build just a single pulse
+		if (decoded_intervals_ms.size() == 1 && intervals_ms_.size() > 1) {
+			GS_LOG_TRACE_MSG(trace, "StrobeProfile::Verify - profile " + name_ + " is a single-pulse profile.");
+			return true;
+		}
+
+		// Every interval (including a trailing 0) starts with an on-pulse
+		const size_t expected_number_pulses = intervals_ms_.size();
+
+		if (decoded_intervals_ms.size() != expected_number_pulses) {
+			GS_LOG_MSG(error, "StrobeProfile::Verify - profile " + name_ + " has " + std::to_string(decoded_intervals_ms.size()) +
+				" pulses, but should have " + std::to_string(expected_number_pulses) + ".");
+			return false;
+		}
+
+		const double ms_per_bit = 1000.0 / effective_bits_per_second_;
+		const double max_spacing_error_ms = kMaxPulseSpacingErrorBits * ms_per_bit;
+
+		for (size_t i = 0; i < decoded_intervals_ms.size() - 1; i++) {
+			if (std::abs(decoded_intervals_ms[i] - intervals_ms_[i]) > max_spacing_error_ms) {
+				GS_LOG_MSG(error, "StrobeProfile::Verify - profile " + name_ + " interval " + std::to_string(i) + " is " +
+					std::to_string(decoded_intervals_ms[i]) + " ms, but should be " + std::to_string(intervals_ms_[i]) + " ms.");
+				return false;
+			}
+		}
+
+		const size_t last_index = decoded_intervals_ms.size() - 1;
+		if (std::abs(decoded_intervals_ms[last_index] - intervals_ms_[last_index]) > kMaxTrailingIntervalErrorBits * ms_per_bit &&
+			intervals_ms_[last_index] > 0.0) {
+			GS_LOG_MSG(error, "StrobeProfile::Verify - profile " + name_ + " final off-time is " +
+				std::to_string(decoded_intervals_ms[last_index]) + " ms, but should be " + std::to_string(intervals_ms_[last_index]) + " ms.");
+			return false;
+		}
+
+		// The ball-speed and exposure-matching code works from the ratios between intervals,
+		// so check those as well, computed as in GetPulseIntervalsAndRatios.  Only the
+		// pulse-to-pulse spacings are compared, not the trailing off-time.
+		for (size_t i = 0; i + 1 < last_index && i + 2 < intervals_ms_.size(); i++) {
+
+			const double expected_ratio = (double)intervals_ms_[i + 1] / (double)intervals_ms_[i];
+			const double decoded_ratio = (double)decoded_intervals_ms[i + 1] / (double)decoded_intervals_ms[i];
+
+			// The worst-case ratio error if both intervals are off by the maximum amount
+			const double max_ratio_error = expected_ratio *
+				(max_spacing_error_ms / intervals_ms_[i] + max_spacing_error_ms / intervals_ms_[i + 1]);
+
+			if (std::abs(decoded_ratio - expected_ratio) > max_ratio_error) {
+				GS_LOG_MSG(error, "StrobeProfile::Verify - profile " + name_ + " ratio " + std::to_string(i) + " is " +
+					std::to_string(decoded_ratio) + ", but should be " + std::to_string(expected_ratio) + ".");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// A strobe profile is one configured set of strobe intervals that has been compiled
+// ahead of time into the exact byte buffer that will be written to the SPI channel.
+// Profiles are built once (when the GPIO system is initialized) and are immutable
+// afterward, so that the trigger path only has to pick a profile and write its buffer.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+namespace golf_sim {
+
+	enum class StrobeProfileId {
+		kDriver = 0,
+		kPutter = 1,
+		kPutterTailRepeat = 2
+	};
+
+	class StrobeProfile {
+
+	public:
+
+		static const int kNumberStrobeProfiles = 3;
+
+		// The SPI buffer is aligned to (and padded out to) this boundary so that it
+		// can be page-locked without also locking unrelated memory.
+		static const size_t kBufferAlignmentBytes = 4096;
+
+		// Builds the pulse train using PulseStrobe::BuildPulseTrain, copies it into a
+		// page-locked, aligned buffer, and checks that the buffer reproduces the
+		// requested intervals.  Returns nullptr on failure.
+		static std::unique_ptr<const StrobeProfile> Compile(const StrobeProfileId id,
+															const std::string& name,
+															const unsigned long baud_rate,
+															const std::vector<float>& intervals_ms,
+															const int number_bits_for_on_pulse,
+															const unsigned int bits_per_word);
+
+		~StrobeProfile();
+
+		StrobeProfile(const StrobeProfile&) = delete;
+		StrobeProfile& operator=(const StrobeProfile&) = delete;
+
+		StrobeProfileId GetId() const { return id_; }
+		const std::string& GetName() const { return name_; }
+		unsigned long GetBaudRate() const { return baud_rate_; }
+		const std::vector<float>& GetIntervalsMs() const { return intervals_ms_; }
+
+		// The buffer is only valid for as long as this profile exists
+		const char* GetBuffer() const { return buffer_; }
+		unsigned long GetLength() const { return length_; }
+		bool IsPageLocked() const { return page_locked_; }
+
+		// Reads the strobe on-pulses back out of the buffer and returns the time in ms
+		// between the start of each pulse and the start of the next.  The last element is
+		// the time from the start of the last pulse to the end of the buffer.
+		std::vector<float> DecodePulseIntervalsMs() const;
+
+		// Returns true if the decoded pulse intervals (and the ratios between them, computed
+		// the same way that GolfSimCamera::GetPulseIntervalsAndRatios does) match the
+		// intervals that the profile was compiled from.
+		bool Verify() const;
+
+	protected:
+
+		StrobeProfile() = default;
+
+		StrobeProfileId id_ = StrobeProfileId::kDriver;
+		std::string name_;
+		unsigned long baud_rate_ = 0;
+		// The rate that BuildPulseTrain actually used to lay out the bits, which
+		// includes the kBaudRatePulseMultiplier fudge factor
+		double effective_bits_per_second_ = 0.0;
+		std::vector<float> intervals_ms_;
+		int number_bits_for_on_pulse_ = 0;
+
+		char* buffer_ = nullptr;
+		unsigned long length_ = 0;
+		size_t allocated_length_ = 0;
+		bool page_locked_ = false;
+	};
+
+}
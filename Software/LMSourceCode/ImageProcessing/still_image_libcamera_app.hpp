@@ -38,7 +38,9 @@ public:
 	}
 };
 
-// The main event loops for the camera 1 and 2 systems
+// The main event loops for the camera 1 and 2 systems.
+// The returned image is leased from the camera's buffer (see gs_frame_lease.h), and must be
+// released or detached before the app is torn down.
 bool still_image_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg);
 
 bool ball_flight_camera_event_loop(LibcameraJpegApp& app, cv::Mat& returnImg);
@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "logging_tools.h"
+#include "strobe_ratio_matcher.h"
+
+
+namespace golf_sim {
+
+    // A difference in per-ratio score of this much (a 10% ratio error, squared) between two
+    // matches makes the worse one about e times less likely than the better one
+    static const double kMatchConfidenceScale = 100.0;
+
+
+    bool StrobeRatioMatcher::Build(const std::vector<float>& pulse_intervals_ms) {
+
+        pulse_intervals_ms_ = pulse_intervals_ms;
+        candidates_.clear();
+        ratio_table_.clear();
+
+        if (pulse_intervals_ms.size() < 3) {
+            GS_LOG_MSG(error, "StrobeRatioMatcher::Build - strobe pulse sequence is too short to compute ratios.");
+            return false;
+        }
+
+        const size_t number_intervals = pulse_intervals_ms.size();
+        std::vector<float> working_intervals;
+
+        // These are the same collapsed-pulse combinations that DetermineStrobeIntervals has always
+        // considered, in the same order.  Lost pulses could occur anywhere, so consider collapsed
+        // pulses all the way to the end.
+        for (int pulses_to_collapse = 0; pulses_to_collapse < (int)(number_intervals / 2); pulses_to_collapse++) {
+
+            for (size_t collapse_offset = 0; collapse_offset < (number_intervals - pulses_to_collapse) - 1; collapse_offset++) {
+
+                // We don't go through any offsets other than 0 if we are not collapsing any pulse intervals.
+                if (pulses_to_collapse == 0 && collapse_offset > 0) {
+                    break;
+                }
+
+                working_intervals = pulse_intervals_ms;
+
+                // "Collapsing" treats two pulses as one, as if the later strobed ball image was never seen
+                for (int i = 0; i < pulses_to_collapse; i++) {
+                    working_intervals[collapse_offset] += working_intervals[collapse_offset + 1];
+                    working_intervals.erase(working_intervals.begin() + collapse_offset + 1);
+                }
+
+                CollapsedPulseCandidate candidate;
+                candidate.pulses_to_collapse = pulses_to_collapse;
+                candidate.collapse_offset = (int)collapse_offset;
+                candidate.first_ratio_index = ratio_table_.size();
+                candidate.score_multiplier = (pulses_to_collapse > 0) ? (1.0 + kLostPulsePenaltyPercent / 100.) : 1.0;
+
+                // The "- 2" deals with the final off-time at the end of the sequence
+                for (size_t i = 0; i + 2 < working_intervals.size(); i++) {
+                    ratio_table_.push_back((double)working_intervals[i + 1] / (double)working_intervals[i]);
+                }
+
+                candidate.number_ratios = ratio_table_.size() - candidate.first_ratio_index;
+                candidates_.push_back(candidate);
+            }
+        }
+
+        GS_LOG_TRACE_MSG(trace, "StrobeRatioMatcher::Build - built " + std::to_string(candidates_.size()) +
+            " candidate ratio patterns with " + std::to_string(ratio_table_.size()) + " total ratios.");
+
+        return true;
+    }
+
+    bool StrobeRatioMatcher::IsBuiltFor(const std::vector<float>& pulse_intervals_ms) const {
+        return !candidates_.empty() && pulse_intervals_ms == pulse_intervals_ms_;
+    }
+
+    double StrobeRatioMatcher::ComputeRatioDistance(const double* distance_ratios,
+                                                    const double* pulse_ratios,
+                                                    const size_t number_ratios) {
+
+        // Kept branch-free so that the compiler can vectorize it
+        double difference_in_ratios = 0.0;
+
+        for (size_t i = 0; i < number_ratios; i++) {
+            // Each difference is in percent so that every element of the pattern contributes
+            // a meaningful amount, and is squared to emphasize larger errors.
+            const double single_ratio_difference = std::min(100. * std::abs(distance_ratios[i] - pulse_ratios[i]), kMaxRatioDistance);
+            difference_in_ratios += single_ratio_difference * single_ratio_difference;
+        }
+
+        return difference_in_ratios;
+    }
+
+    int StrobeRatioMatcher::FindBestMatches(const std::vector<double>& distance_ratios,
+                                            StrobeRatioMatch* matches,
+                                            int max_matches) const {
+
+        if (matches == nullptr || max_matches <= 0 || distance_ratios.empty()) {
+            return 0;
+        }
+
+        const size_t number_distance_ratios = distance_ratios.size();
+        const double* const distance_ratio_data = distance_ratios.data();
+        int number_matches = 0;
+
+        for (const CollapsedPulseCandidate& candidate : candidates_) {
+
+            if (candidate.number_ratios < number_distance_ratios) {
+                continue;
+            }
+
+            const double* const candidate_ratios = ratio_table_.data() + candidate.first_ratio_index;
+            const size_t last_offset = candidate.number_ratios - number_distance_ratios;
+
+            for (size_t offset = 0; offset <= last_offset; offset++) {
+
+                const double raw_score = ComputeRatioDistance(distance_ratio_data, candidate_ratios + offset, number_distance_ratios);
+
+                if (raw_score >= kNoMatchRatioDistance) {
+                    continue;
+                }
+
+                const double score = raw_score * candidate.score_multiplier;
+
+                // Quick reject if the list is full and this is no better than the worst kept match
+                if (number_matches == max_matches && score >= matches[number_matches - 1].score) {
+                    continue;
+                }
+
+                // Insertion into the sorted list.  Equal scores stay behind the earlier ones.
+                int insert_index = std::min(number_matches, max_matches - 1);
+                while (insert_index > 0 && matches[insert_index - 1].score > score) {
+                    matches[insert_index] = matches[insert_index - 1];
+                    insert_index--;
+                }
+
+                matches[insert_index].pulses_to_collapse = candidate.pulses_to_collapse;
+                matches[insert_index].collapse_offset = candidate.collapse_offset;
+                matches[insert_index].ratio_offset = (int)offset;
+                matches[insert_index].score = score;
+                matches[insert_index].confidence = 0.0;
+
+                number_matches = std::min(number_matches + 1, max_matches);
+            }
+        }
+
+        if (number_matches == 0) {
+            return 0;
+        }
+
+        // Treat the matches as competing hypotheses and normalize their relative likelihoods
+        const double best_score = matches[0].score;
+        double total_weight = 0.0;
+
+        for (int i = 0; i < number_matches; i++) {
+            matches[i].confidence = std::exp(-(matches[i].score - best_score) / (kMatchConfidenceScale * number_distance_ratios));
+            total_weight += matches[i].confidence;
+        }
+
+        for (int i = 0; i < number_matches; i++) {
+            matches[i].confidence /= total_weight;
+        }
+
+        return number_matches;
+    }
+
+}
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (C) 2022-2025, Verdant Consultants, LLC.
+ */
+
+// Matches the pattern of ratios between the distances of successive strobed ball
+// images against the ratios between the strobe pulse intervals in order to figure out
+// which strobe interval separates each pair of balls.
+//
+// The ratio tables for every way of "collapsing" lost pulses are computed once per
+// pulse-interval vector, so that matching a set of distance ratios is just one pass
+// over a flat table with no allocation.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+
+namespace golf_sim {
+
+    struct StrobeRatioMatch {
+        // Which (if any) pulses were collapsed together to get the ratios that matched.
+        // See GolfSimCamera::GetPulseIntervalsAndRatios.
+        int pulses_to_collapse = -1;
+        int collapse_offset = -1;
+
+        // The offset of the first distance ratio within the (collapsed) pulse ratios
+        int ratio_offset = -1;
+
+        // Sum of squared percentage differences, including any lost-pulse penalty.  Lower is better.
+        double score = 0.0;
+
+        // 0-1, relative to the other matches that were returned
+        double confidence = 0.0;
+    };
+
+
+    class StrobeRatioMatcher {
+
+    public:
+
+        static const int kMaxMatches = 8;
+
+        // Any single ratio difference (in percent) is capped at this value
+        static constexpr double kMaxRatioDistance = 1000.0;
+
+        // Scores at or above this value are not considered to be a match at all
+        static constexpr double kNoMatchRatioDistance = 99999.0;
+
+        // It shouldn't frequently be necessary to collapse pulses, because the images will widen out
+        // substantially as the ball crosses the field of view.  For that reason, matches that require
+        // collapsed pulses have their scores increased by this percentage.
+        static constexpr double kLostPulsePenaltyPercent = 70.0;
+
+        // Builds the ratio table for the pulse intervals (the last of which is the final off-time
+        // and is not part of any ratio).  Returns false if there are too few intervals.
+        bool Build(const std::vector<float>& pulse_intervals_ms);
+
+        // True if Build was last called with the same intervals
+        bool IsBuiltFor(const std::vector<float>& pulse_intervals_ms) const;
+
+        // Scores the distance ratios at every offset within every candidate (possibly collapsed)
+        // set of pulse ratios and writes the best (lowest-score) max_matches of them to matches,
+        // best first.  Returns the number of matches written, which may be 0.
+        // Ties go to the candidate that collapses fewer pulses, then to the lower offsets.
+        int FindBestMatches(const std::vector<double>& distance_ratios,
+                            StrobeRatioMatch* matches,
+                            int max_matches) const;
+
+        // Returns the sum of the squared (capped) percentage differences between
+        // distance_ratios and pulse_ratios for the first number_ratios elements.
+        static double ComputeRatioDistance(const double* distance_ratios,
+                                           const double* pulse_ratios,
+                                           const size_t number_ratios);
+
+        int GetNumberCandidates() const { return (int)candidates_.size(); }
+
+    protected:
+
+        struct CollapsedPulseCandidate {
+            int pulses_to_collapse = 0;
+            int collapse_offset = 0;
+            // Index into ratio_table_ of the first ratio for this candidate
+            size_t first_ratio_index = 0;
+            size_t number_ratios = 0;
+            double score_multiplier = 1.0;
+        };
+
+        std::vector<float> pulse_intervals_ms_;
+        std::vector<CollapsedPulseCandidate> candidates_;
+
+        // The ratios of all candidates, stored back-to-back
+        std::vector<double> ratio_table_;
+    };
+
+}